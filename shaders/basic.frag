@@ -8,6 +8,7 @@ layout(location = 0) out vec4 outColor;
 // Lighting uniform
 layout(binding = 0) uniform UniformBufferObject {
     mat4 model;
+    mat4 normalMatrix;  // Precomputed on the CPU: transpose(inverse(model))
     mat4 view;
     mat4 proj;
     vec3 lightPos;
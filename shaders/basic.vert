@@ -12,6 +12,7 @@ layout(location = 2) out vec3 fragWorldPos;
 // MVP matrices uniform
 layout(binding = 0) uniform UniformBufferObject {
     mat4 model;
+    mat4 normalMatrix;  // Precomputed on the CPU: transpose(inverse(model))
     mat4 view;
     mat4 proj;
 } ubo;
@@ -20,6 +21,6 @@ void main() {
     vec4 worldPos = ubo.model * vec4(inPosition, 1.0);
     gl_Position = ubo.proj * ubo.view * worldPos;
     fragColor = inColor;
-    fragNormal = mat3(transpose(inverse(ubo.model))) * inNormal; // Transform normal to world space
+    fragNormal = mat3(ubo.normalMatrix) * inNormal; // Transform normal to world space
     fragWorldPos = worldPos.xyz;
 }
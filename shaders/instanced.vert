@@ -0,0 +1,33 @@
+#version 450
+
+// Vertex input attributes (binding 0, per vertex)
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
+layout(location = 2) in vec3 inNormal;
+
+// Instance attributes (binding 1, per instance)
+layout(location = 3) in mat4 instanceModel;          // Locations 3-6
+layout(location = 7) in mat3x4 instanceNormalMatrix; // Locations 7-9, precomputed on the CPU
+layout(location = 10) in uint instanceID;
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec3 fragNormal;
+layout(location = 2) out vec3 fragWorldPos;
+
+layout(binding = 0) uniform UniformBufferObject {
+    mat4 model;         // Unused: each instance brings its own
+    mat4 normalMatrix;
+    mat4 view;
+    mat4 proj;
+} ubo;
+
+void main() {
+    vec4 worldPos = instanceModel * vec4(inPosition, 1.0);
+    gl_Position = ubo.proj * ubo.view * worldPos;
+
+    // Small per-object brightness variation so neighbouring instances are distinguishable
+    float tint = 0.8 + 0.2 * fract(float(instanceID) * 0.618034);
+    fragColor = inColor * tint;
+    fragNormal = mat3(instanceNormalMatrix) * inNormal;
+    fragWorldPos = worldPos.xyz;
+}
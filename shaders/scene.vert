@@ -0,0 +1,35 @@
+#version 450
+
+// Vertex input attributes
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
+layout(location = 2) in vec3 inNormal;
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec3 fragNormal;
+layout(location = 2) out vec3 fragWorldPos;
+
+layout(binding = 0) uniform UniformBufferObject {
+    mat4 model;         // Unused: each object pushes its own
+    mat4 normalMatrix;
+    mat4 view;
+    mat4 proj;
+} ubo;
+
+// Per-draw data, matches PushConstants in pipeline_layout.h
+layout(push_constant) uniform ObjectConstants {
+    mat4 model;
+    mat3x4 normalMatrix;  // Precomputed on the CPU
+    uint objectID;
+} object;
+
+void main() {
+    vec4 worldPos = object.model * vec4(inPosition, 1.0);
+    gl_Position = ubo.proj * ubo.view * worldPos;
+
+    // Small per-object brightness variation so neighbouring objects are distinguishable
+    float tint = 0.8 + 0.2 * fract(float(object.objectID) * 0.618034);
+    fragColor = inColor * tint;
+    fragNormal = mat3(object.normalMatrix) * inNormal;
+    fragWorldPos = worldPos.xyz;
+}
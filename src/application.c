@@ -13,31 +13,267 @@
 #include "sync/synchronization.h"
 #include "graphics_pipeline/graphics_pipeline.h"
 #include "rendering/draw_loop.h"
+#include "profiling/cpu_profiler.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <stddef.h>  // for offsetof
 
-int initializeApplication(ApplicationContext* app) {
-    // Initialize SDL and create window
-    if (initializeSDLWindow(&app->window) != 0) {
-        return -1;
+// Spacing between neighbouring instances of the field, in world units
+#define INSTANCE_FIELD_SPACING 1.5f
+
+// Furthest a click can pick an object, matching the far plane
+#define PICK_MAX_DISTANCE 10.0f
+
+// Model matrix of object i out of count on a square grid in the XZ plane around the origin
+static mat4 fieldObjectTransform(uint32_t i, uint32_t count) {
+    uint32_t side = (uint32_t)ceilf(sqrtf((float)count));
+    float half = (side - 1) * INSTANCE_FIELD_SPACING * 0.5f;
+    mat4 local = mat4_multiply(mat4_rotate_y(45.0f * (3.14159f / 180.0f)), mat4_scale(vec3_create(0.5f, 0.5f, 0.5f)));
+    vec3 position = vec3_create((i % side) * INSTANCE_FIELD_SPACING - half, 0.0f,
+                                -(float)(i / side) * INSTANCE_FIELD_SPACING);
+    return mat4_multiply(mat4_translate(position), local);
+}
+
+// Object-space AABB of the mesh in the vertex buffer (the cube spans -0.5..0.5)
+static void getMeshBounds(const ApplicationContext* app, vec3* outMin, vec3* outMax) {
+    if (app->mesh.num_vertices > 0) {
+        *outMin = vec3_create(app->mesh.bounds_min[0], app->mesh.bounds_min[1], app->mesh.bounds_min[2]);
+        *outMax = vec3_create(app->mesh.bounds_max[0], app->mesh.bounds_max[1], app->mesh.bounds_max[2]);
+    } else {
+        *outMin = vec3_create(-0.5f, -0.5f, -0.5f);
+        *outMax = vec3_create(0.5f, 0.5f, 0.5f);
+    }
+}
+
+// Allocate the instance arrays: CPU copies, world bounds and visibility flags
+static bool allocateInstanceArrays(ApplicationContext* app) {
+    uint32_t count = app->instanceCount;
+    size_t stride = ((size_t)count + 7) & ~(size_t)7;  // Keeps every bounds array SOA_ALIGNMENT-aligned
+    float* bounds = soa_alloc_floats(stride * 6);
+    app->instances = malloc(sizeof(InstanceData) * count);
+    app->instanceVisible = malloc(count);
+    if (!bounds || !app->instances || !app->instanceVisible) {
+        soa_free_floats(bounds);
+        free(app->instances);
+        free(app->instanceVisible);
+        app->instances = NULL;
+        app->instanceVisible = NULL;
+        return false;
+    }
+    app->instanceBounds = (AabbSoA){
+        bounds, bounds + stride, bounds + stride * 2,
+        bounds + stride * 3, bounds + stride * 4, bounds + stride * 5
+    };
+    return true;
+}
+
+static void freeInstanceArrays(ApplicationContext* app) {
+    soa_free_floats(app->instanceBounds.minX);  // Start of the shared bounds block
+    free(app->instances);
+    free(app->instanceVisible);
+    destroyBvh(&app->instanceBvh);
+    memset(&app->instanceBounds, 0, sizeof(AabbSoA));
+    app->instances = NULL;
+    app->instanceVisible = NULL;
+}
+
+static bool buildInstanceField(ApplicationContext* app) {
+    vec3 boundsMin, boundsMax;
+    getMeshBounds(app, &boundsMin, &boundsMax);
+    float local[6] = {boundsMin.x, boundsMin.y, boundsMin.z, boundsMax.x, boundsMax.y, boundsMax.z};
+    AabbSoA localBox = {&local[0], &local[1], &local[2], &local[3], &local[4], &local[5]};
+
+    AabbSoA* world = &app->instanceBounds;
+    for (uint32_t i = 0; i < app->instanceCount; i++) {
+        mat4 transform = fieldObjectTransform(i, app->instanceCount);
+        setInstanceTransform(&app->instances[i], transform, i);
+        AabbSoA slot = {world->minX + i, world->minY + i, world->minZ + i,
+                        world->maxX + i, world->maxY + i, world->maxZ + i};
+        transform_aabbs_soa_scalar(&transform, localBox, slot, 1);
+    }
+    memset(app->instanceVisible, 1, app->instanceCount);
+    app->visibleInstanceCount = app->instanceCount;
+
+    // The field never moves, so the tree is built once
+    return buildBvh(&app->instanceBvh, app->instanceBounds, app->instanceCount) == 0;
+}
+
+// Cast a ray from the camera through the crosshair and report the first object or instance hit
+static void pickAtCrosshair(ApplicationContext* app) {
+    vec3 origin = app->camera.position;
+    vec3 direction = getCameraForward(&app->camera);
+    uint32_t picked;
+    float distance;
+    bool hit = false;
+    if (app->sceneObjectCount > 0) {
+        hit = pickScene(&app->scene, origin, direction, PICK_MAX_DISTANCE, &picked, &distance);
+    } else if (app->instanceCount > 0) {
+        BvhHit bvhHit;
+        hit = raycastBvh(&app->instanceBvh, app->instanceBounds, origin, direction, PICK_MAX_DISTANCE, &bvhHit);
+        picked = bvhHit.primitive;
+        distance = bvhHit.distance;
+    } else {
+        return;
+    }
+
+    if (hit) {
+        printf("Picked object %u at distance %.2f\n", picked, distance);
+    } else {
+        printf("Picked nothing\n");
+    }
+}
+
+// GPU culling samples the depth buffer to build its depth pyramid
+static VkImageUsageFlags getDepthImageUsage(const ApplicationContext* app) {
+    return app->gpuCulling ? VK_IMAGE_USAGE_SAMPLED_BIT : 0;
+}
+
+// (Re)build the depth pyramid over the current depth buffer and point the GPU culler at it
+static VkResult createOcclusionPyramid(ApplicationContext* app) {
+    UploadBatch batch = {0};
+    VkResult result = beginUploadBatch(
+        app->logicalDevice.device,
+        app->physicalDevice,
+        &app->gpuAllocator,
+        app->commandPool,
+        app->logicalDevice.graphicsQueue,
+        &batch
+    );
+    if (result == VK_SUCCESS) {
+        result = createDepthPyramid(
+            &batch,
+            &app->pipelineCache,
+            app->depthImage,
+            app->depthImageView,
+            app->depthFormat,
+            app->swapchain.extent,
+            &app->depthPyramid
+        );
+    }
+    // The pyramid's layout transition must have run before the culler can sample it
+    if (result == VK_SUCCESS) {
+        result = submitUploadBatch(&batch);
+        if (result != VK_SUCCESS) {
+            destroyDepthPyramid(app->logicalDevice.device, &app->depthPyramid);
+        }
+    }
+    destroyUploadBatch(&batch);
+    if (result == VK_SUCCESS) {
+        setGpuCullOccluder(app->logicalDevice.device, &app->gpuCuller, &app->depthPyramid);
+    }
+    return result;
+}
+
+// Upload the instance field to the GPU culler; the whole field is one indirect draw of the loaded mesh
+static VkResult createInstanceCuller(ApplicationContext* app) {
+    if (!app->indices.graphicsHasCompute) {
+        printf("The graphics queue does not support compute, GPU culling is unavailable\n");
+        return VK_ERROR_FEATURE_NOT_PRESENT;
+    }
+
+    GpuCullDraw draw = {app->indexCount, 0, 0};
+    GpuCullerCreateInfo createInfo = {0};
+    createInfo.instances = app->instances;
+    createInfo.bounds = app->instanceBounds;
+    createInfo.drawIndices = NULL;
+    createInfo.instanceCount = app->instanceCount;
+    createInfo.draws = &draw;
+    createInfo.drawCount = 1;
+    createInfo.sliceCount = MAX_FRAMES_IN_FLIGHT;
+    createInfo.multiDrawIndirect = app->logicalDevice.enabledFeatures.multiDrawIndirect;
+    createInfo.drawIndirectFirstInstance = app->logicalDevice.enabledFeatures.drawIndirectFirstInstance;
+    createInfo.pipelineCache = &app->pipelineCache;
+
+    UploadBatch batch = {0};
+    VkResult result = beginUploadBatch(
+        app->logicalDevice.device,
+        app->physicalDevice,
+        &app->gpuAllocator,
+        app->commandPool,
+        app->logicalDevice.graphicsQueue,
+        &batch
+    );
+    if (result == VK_SUCCESS) {
+        result = createGpuCuller(&batch, &createInfo, &app->gpuCuller);
+    }
+    if (result == VK_SUCCESS) {
+        result = submitUploadBatch(&batch);
+    }
+    destroyUploadBatch(&batch);
+    // The culler always samples the pyramid, even when occlusion culling is disabled,
+    // so it is created (and moved to GENERAL) either way
+    if (result == VK_SUCCESS) {
+        result = createOcclusionPyramid(app);
+    }
+    if (result != VK_SUCCESS) {
+        destroyGpuCuller(app->logicalDevice.device, &app->gpuCuller);
     }
+    return result;
+}
+
+// Fill the scene with sceneObjectCount objects on the grid, alternating between
+// the loaded mesh and the cube so the draw list has more than one mesh to sort by
+static VkResult buildSceneField(ApplicationContext* app) {
+    uint32_t meshIndices[2];
+    uint32_t meshCount = 0;
+    vec3 boundsMin, boundsMax;
+    getMeshBounds(app, &boundsMin, &boundsMax);
+    VkResult result = addSceneMesh(&app->scene, &app->vertexBuffer, &app->indexBuffer, app->indexCount,
+                                   app->indexType, boundsMin, boundsMax, false, &meshIndices[meshCount++]);
+    if (result == VK_SUCCESS && app->mesh.num_vertices > 0) {
+        UploadBatch batch = {0};
+        result = beginUploadBatch(
+            app->logicalDevice.device,
+            app->physicalDevice,
+            &app->gpuAllocator,
+            app->commandPool,
+            app->logicalDevice.graphicsQueue,
+            &batch
+        );
+        if (result == VK_SUCCESS) {
+            result = uploadSceneMesh(&app->scene, &batch, NULL, &meshIndices[meshCount++]);
+        }
+        if (result == VK_SUCCESS) {
+            result = submitUploadBatch(&batch);
+        }
+        destroyUploadBatch(&batch);
+    }
+
+    for (uint32_t i = 0; i < app->sceneObjectCount && result == VK_SUCCESS; i++) {
+        result = addSceneObject(&app->scene, meshIndices[i % meshCount], 0,
+                                fieldObjectTransform(i, app->sceneObjectCount), NULL);
+    }
+    return result;
+}
+
+int initializeApplication(ApplicationContext* app) {
+    if (app->headless) {
+        // No window, surface or swapchain: the instance needs no WSI extensions
+        app->window = NULL;
+        app->surface = VK_NULL_HANDLE;
+        app->mouseCaptured = false;
+        printf("Headless mode: %ux%u offscreen\n", app->headlessExtent.width, app->headlessExtent.height);
+    } else {
+        // Initialize SDL and create window
+        if (initializeSDLWindow(&app->window) != 0) {
+            return -1;
+        }
 
-    // Enable relative mouse mode and hide cursor for camera control
-    SDL_SetRelativeMouseMode(SDL_TRUE);
-    SDL_ShowCursor(SDL_DISABLE);
-    app->mouseCaptured = true;
+        // Enable relative mouse mode and hide cursor for camera control
+        SDL_SetRelativeMouseMode(SDL_TRUE);
+        SDL_ShowCursor(SDL_DISABLE);
+        app->mouseCaptured = true;
+    }
 
     // Initialize Vulkan instance
     if (initializeVulkanInstance(app->window, &app->vulkanInstance) != 0) {
-        cleanupSDLWindow(app->window);
-        return -1;
+        goto fail_window;
     }
 
     // Create Vulkan surface
-    if (createVulkanSurface(app->window, app->vulkanInstance, &app->surface) != 0) {
-        destroyVulkanInstance(app->vulkanInstance);
-        cleanupSDLWindow(app->window);
-        return -1;
+    if (!app->headless && createVulkanSurface(app->window, app->vulkanInstance, &app->surface) != 0) {
+        goto fail_instance;
     }
 
     // Enumerate and select physical device
@@ -46,10 +282,7 @@ int initializeApplication(ApplicationContext* app) {
     app->physicalDevice = pickPhysicalDevice(app->vulkanInstance, app->surface);
     if (app->physicalDevice == VK_NULL_HANDLE) {
         printf("Failed to find a suitable GPU!\n");
-        destroyVulkanSurface(app->vulkanInstance, app->surface);
-        destroyVulkanInstance(app->vulkanInstance);
-        cleanupSDLWindow(app->window);
-        return -1;
+        goto fail_surface;
     }
 
     app->indices = findQueueFamilies(app->physicalDevice, app->surface);
@@ -58,35 +291,50 @@ int initializeApplication(ApplicationContext* app) {
     VkResult result = createLogicalDevice(app->physicalDevice, app->indices, &app->logicalDevice);
     if (result != VK_SUCCESS) {
         printf("Failed to create logical device!\n");
-        destroyVulkanSurface(app->vulkanInstance, app->surface);
-        destroyVulkanInstance(app->vulkanInstance);
-        cleanupSDLWindow(app->window);
-        return -1;
+        goto fail_surface;
     }
 
     // default VSYNC enabled
     app->vsyncEnabled = true;
 
-    // Create swapchain
-    result = createSwapchain(app->logicalDevice.device, app->physicalDevice, app->surface, app->indices, &app->swapchain, app->vsyncEnabled);
+    // Create swapchain (offscreen color images, one per frame slot, when headless)
+    if (app->headless) {
+        result = createOffscreenSwapchain(
+            app->logicalDevice.device,
+            app->physicalDevice,
+            app->headlessExtent,
+            VK_FORMAT_R8G8B8A8_SRGB,
+            MAX_FRAMES_IN_FLIGHT,
+            &app->swapchain
+        );
+    } else {
+        result = createSwapchain(app->logicalDevice.device, app->physicalDevice, app->surface, app->indices, &app->swapchain, app->vsyncEnabled);
+    }
     if (result != VK_SUCCESS) {
         printf("Failed to create swapchain!\n");
-        destroyLogicalDevice(&app->logicalDevice);
-        destroyVulkanSurface(app->vulkanInstance, app->surface);
-        destroyVulkanInstance(app->vulkanInstance);
-        cleanupSDLWindow(app->window);
-        return -1;
+        goto fail_device;
     } // Image views already created within the swapchain, don't need to worry bout creating a new func for dat
 
 
-    // Find a supported depth format
+    // Find a supported depth format; GPU culling also samples it
     VkFormat depthFormat = findDepthFormat(app->physicalDevice);
+    if (app->gpuCulling) {
+        VkFormat sampledFormats[] = {
+            VK_FORMAT_D32_SFLOAT,
+            VK_FORMAT_D32_SFLOAT_S8_UINT,
+            VK_FORMAT_D24_UNORM_S8_UINT
+        };
+        depthFormat = findSupportedFormat(
+            app->physicalDevice,
+            sampledFormats,
+            3,
+            VK_IMAGE_TILING_OPTIMAL,
+            VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT
+        );
+    }
     if (depthFormat == VK_FORMAT_UNDEFINED) {
         printf("No suitable depth format found!\n");
-        destroyVulkanSurface(app->vulkanInstance, app->surface);
-        destroyVulkanInstance(app->vulkanInstance);
-        cleanupSDLWindow(app->window);
-        return -1;
+        goto fail_swapchain;
     }
     printf("Using depth format: %d\n", (int)depthFormat);
 
@@ -94,18 +342,16 @@ int initializeApplication(ApplicationContext* app) {
     app->depthFormat = depthFormat;
 
     // Create render pass
+    // Offscreen images end the pass ready to be copied out instead of presented
     result = createRenderPass(app->logicalDevice.device,
                                     app->swapchain.imageFormat,
                                     depthFormat,
+                                    app->headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                                    app->gpuCulling && !app->occlusionDisabled,
                                     &app->renderPass);
     if (result != VK_SUCCESS) {
         printf("Failed to create render pass!\n");
-        destroySwapchain(app->logicalDevice.device, &app->swapchain);
-        destroyLogicalDevice(&app->logicalDevice);
-        destroyVulkanSurface(app->vulkanInstance, app->surface);
-        destroyVulkanInstance(app->vulkanInstance);
-        cleanupSDLWindow(app->window);
-        return -1;
+        goto fail_swapchain;
     }
 
     // Skip depth resources for now
@@ -120,19 +366,14 @@ int initializeApplication(ApplicationContext* app) {
         app->logicalDevice.device,
         app->swapchain.extent,
         app->depthFormat,
+        getDepthImageUsage(app),
         &app->depthImage,
         &app->depthImageMemory,
         &app->depthImageView
     );
     if (result != VK_SUCCESS) {
         printf("Failed to create depth resources!\n");
-        destroyRenderPass(app->logicalDevice.device, app->renderPass);
-        destroySwapchain(app->logicalDevice.device, &app->swapchain);
-        destroyLogicalDevice(&app->logicalDevice);
-        destroyVulkanSurface(app->vulkanInstance, app->surface);
-        destroyVulkanInstance(app->vulkanInstance);
-        cleanupSDLWindow(app->window);
-        return -1;
+        goto fail_render_pass;
     }
     printf("\nDepth Resources: Ready\n");
 
@@ -143,16 +384,7 @@ int initializeApplication(ApplicationContext* app) {
         if (props.limits.maxPushConstantsSize < sizeof(PushConstants)) {
             printf("Device supports only %u bytes of push constants, needed %zu.\n",
                    props.limits.maxPushConstantsSize, sizeof(PushConstants));
-            destroyCommandPool(app->logicalDevice.device, app->commandPool);
-            destroyFramebuffers(app->logicalDevice.device, app->framebuffers, app->framebufferCount);
-            destroyDepthResources(app->logicalDevice.device, app->depthImage, app->depthImageMemory, app->depthImageView);
-            destroyRenderPass(app->logicalDevice.device, app->renderPass);
-            destroySwapchain(app->logicalDevice.device, &app->swapchain);
-            destroyLogicalDevice(&app->logicalDevice);
-            destroyVulkanSurface(app->vulkanInstance, app->surface);
-            destroyVulkanInstance(app->vulkanInstance);
-            cleanupSDLWindow(app->window);
-            return -1;
+            goto fail_depth;
         }
     }
 
@@ -160,17 +392,7 @@ int initializeApplication(ApplicationContext* app) {
     result = createPipelineLayouts(app->logicalDevice.device, &app->pipelineLayouts);
     if (result != VK_SUCCESS) {
         printf("Failed to create pipeline layouts!\n");
-        // Cleanup in reverse order
-        destroyCommandPool(app->logicalDevice.device, app->commandPool);
-        destroyFramebuffers(app->logicalDevice.device, app->framebuffers, app->framebufferCount);
-        destroyDepthResources(app->logicalDevice.device, app->depthImage, app->depthImageMemory, app->depthImageView);
-        destroyRenderPass(app->logicalDevice.device, app->renderPass);
-        destroySwapchain(app->logicalDevice.device, &app->swapchain);
-        destroyLogicalDevice(&app->logicalDevice);
-        destroyVulkanSurface(app->vulkanInstance, app->surface);
-        destroyVulkanInstance(app->vulkanInstance);
-        cleanupSDLWindow(app->window);
-        return -1;
+        goto fail_depth;
     }
 
     // Create framebuffers
@@ -184,14 +406,7 @@ int initializeApplication(ApplicationContext* app) {
     );
     if (result != VK_SUCCESS) {
         printf("Failed to create framebuffers!\n");
-        destroyDepthResources(app->logicalDevice.device, app->depthImage, app->depthImageMemory, app->depthImageView);
-        destroyRenderPass(app->logicalDevice.device, app->renderPass);
-        destroySwapchain(app->logicalDevice.device, &app->swapchain);
-        destroyLogicalDevice(&app->logicalDevice);
-        destroyVulkanSurface(app->vulkanInstance, app->surface);
-        destroyVulkanInstance(app->vulkanInstance);
-        cleanupSDLWindow(app->window);
-        return -1;
+        goto fail_pipeline_layouts;
     }
 
     // Create command pool
@@ -202,69 +417,101 @@ int initializeApplication(ApplicationContext* app) {
     );
     if (result != VK_SUCCESS) {
         printf("Failed to create command pool!\n");
-        destroyFramebuffers(app->logicalDevice.device, app->framebuffers, app->framebufferCount);
-        destroyDepthResources(app->logicalDevice.device, app->depthImage, app->depthImageMemory, app->depthImageView);
-        destroyRenderPass(app->logicalDevice.device, app->renderPass);
-        destroySwapchain(app->logicalDevice.device, &app->swapchain);
-        destroyLogicalDevice(&app->logicalDevice);
-        destroyVulkanSurface(app->vulkanInstance, app->surface);
-        destroyVulkanInstance(app->vulkanInstance);
-        cleanupSDLWindow(app->window);
-        return -1;
+        goto fail_framebuffers;
+    }
+
+    // Buffers are sub-allocated from shared device memory blocks
+    result = createGpuAllocator(
+        app->logicalDevice.device,
+        app->physicalDevice,
+        GPU_ALLOCATOR_BLOCK_SIZE,
+        &app->gpuAllocator
+    );
+    if (result != VK_SUCCESS) {
+        printf("Failed to create GPU memory allocator!\n");
+        goto fail_command_pool;
     }
 
     // Create vertex buffer
     printf("\n=== Creating Vertex Buffer ===\n");
     VkDeviceSize bufferSize;
     if (app->mesh.num_vertices > 0) {
-        bufferSize = app->mesh.num_indices * sizeof(Vertex);
+        bufferSize = app->mesh.num_vertices * sizeof(Vertex);
+        app->indexCount = (uint32_t)app->mesh.num_indices;
+        app->indexType = chooseIndexType((uint32_t)app->mesh.num_vertices);
     } else {
-        bufferSize = 36 * sizeof(Vertex); // Cube
+        bufferSize = CUBE_VERTEX_COUNT * sizeof(Vertex); // Cube
+        app->indexCount = CUBE_INDEX_COUNT;
+        app->indexType = VK_INDEX_TYPE_UINT16;
     }
     result = createVertexBuffer(
         app->logicalDevice.device,
         app->physicalDevice,
+        &app->gpuAllocator,
         bufferSize,
         &app->vertexBuffer
     );
     if (result != VK_SUCCESS) {
         printf("Failed to create vertex buffer!\n");
-        destroyCommandPool(app->logicalDevice.device, app->commandPool);
-        destroyFramebuffers(app->logicalDevice.device, app->framebuffers, app->framebufferCount);
-        destroyDepthResources(app->logicalDevice.device, app->depthImage, app->depthImageMemory, app->depthImageView);
-        destroyRenderPass(app->logicalDevice.device, app->renderPass);
-        destroySwapchain(app->logicalDevice.device, &app->swapchain);
-        destroyLogicalDevice(&app->logicalDevice);
-        destroyVulkanSurface(app->vulkanInstance, app->surface);
-        destroyVulkanInstance(app->vulkanInstance);
-        cleanupSDLWindow(app->window);
-        return -1;
+        goto fail_allocator;
     }
     printf("\nVertex Buffer: Ready\n");
 
-    // Update vertex buffer with triangle data
+    result = createIndexBuffer(
+        app->logicalDevice.device,
+        app->physicalDevice,
+        &app->gpuAllocator,
+        app->indexCount,
+        app->indexType,
+        &app->indexBuffer
+    );
+    if (result != VK_SUCCESS) {
+        printf("Failed to create index buffer!\n");
+        goto fail_vertex_buffer;
+    }
+    printf("\nIndex Buffer: Ready\n");
+
+    // Upload vertex data through staging memory into the device-local vertex buffer
     printf("\n=== Updating Vertex Buffer with Triangle Data ===\n");
-    if (app->mesh.num_vertices > 0) {
-        printf("Loading model from OBJ file (%zu vertices, %zu indices)\n", app->mesh.num_vertices, app->mesh.num_indices);
-        result = updateVertexBufferWithMesh(app->logicalDevice.device, &app->vertexBuffer, &app->mesh, &app->vertexCount);
-    } else {
-        printf("Loading default cube model (36 vertices)\n");
-        result = updateVertexBufferWithCube(app->logicalDevice.device, &app->vertexBuffer);
-        app->vertexCount = 36;
+    UploadBatch uploadBatch = {0};
+    result = beginUploadBatch(
+        app->logicalDevice.device,
+        app->physicalDevice,
+        &app->gpuAllocator,
+        app->commandPool,
+        app->logicalDevice.graphicsQueue,
+        &uploadBatch
+    );
+    if (result == VK_SUCCESS) {
+        if (app->mesh.num_vertices > 0) {
+            printf("Loading model from OBJ file (%zu vertices, %zu indices)\n", app->mesh.num_vertices, app->mesh.num_indices);
+            if (app->bakedMesh.header) {
+                result = updateVertexBufferWithBakedMesh(&uploadBatch, &app->vertexBuffer, &app->bakedMesh, &app->vertexCount);
+                if (result == VK_SUCCESS) {
+                    result = updateIndexBufferWithBakedMesh(&uploadBatch, &app->indexBuffer, &app->bakedMesh, app->indexType);
+                }
+            } else {
+                result = updateVertexBufferWithMesh(&uploadBatch, &app->vertexBuffer, &app->mesh, &app->vertexCount);
+                if (result == VK_SUCCESS) {
+                    result = updateIndexBufferWithMesh(&uploadBatch, &app->indexBuffer, &app->mesh, app->indexType);
+                }
+            }
+        } else {
+            printf("Loading default cube model (%d vertices, %d indices)\n", CUBE_VERTEX_COUNT, CUBE_INDEX_COUNT);
+            result = updateVertexBufferWithCube(&uploadBatch, &app->vertexBuffer);
+            if (result == VK_SUCCESS) {
+                result = updateIndexBufferWithCube(&uploadBatch, &app->indexBuffer);
+            }
+            app->vertexCount = CUBE_VERTEX_COUNT;
+        }
+    }
+    if (result == VK_SUCCESS) {
+        result = submitUploadBatch(&uploadBatch);
     }
+    destroyUploadBatch(&uploadBatch);
     if (result != VK_SUCCESS) {
         printf("Failed to update vertex buffer with triangle data!\n");
-        destroyBuffer(app->logicalDevice.device, &app->vertexBuffer);
-        destroyCommandPool(app->logicalDevice.device, app->commandPool);
-        destroyFramebuffers(app->logicalDevice.device, app->framebuffers, app->framebufferCount);
-        destroyDepthResources(app->logicalDevice.device, app->depthImage, app->depthImageMemory, app->depthImageView);
-        destroyRenderPass(app->logicalDevice.device, app->renderPass);
-        destroySwapchain(app->logicalDevice.device, &app->swapchain);
-        destroyLogicalDevice(&app->logicalDevice);
-        destroyVulkanSurface(app->vulkanInstance, app->surface);
-        destroyVulkanInstance(app->vulkanInstance);
-        cleanupSDLWindow(app->window);
-        return -1;
+        goto fail_index_buffer;
     }
     printf("\nVertex Buffer: Loaded with data\n");
 
@@ -273,24 +520,49 @@ int initializeApplication(ApplicationContext* app) {
     result = createUniformBuffer(
         app->logicalDevice.device,
         app->physicalDevice,
-        &app->uniformBuffer
+        &app->gpuAllocator,
+        MAX_FRAMES_IN_FLIGHT,
+        &app->uniformRing
     );
     if (result != VK_SUCCESS) {
         printf("Failed to create uniform buffer!\n");
-        destroyBuffer(app->logicalDevice.device, &app->vertexBuffer);
-        destroyCommandPool(app->logicalDevice.device, app->commandPool);
-        destroyFramebuffers(app->logicalDevice.device, app->framebuffers, app->framebufferCount);
-        destroyDepthResources(app->logicalDevice.device, app->depthImage, app->depthImageMemory, app->depthImageView);
-        destroyRenderPass(app->logicalDevice.device, app->renderPass);
-        destroySwapchain(app->logicalDevice.device, &app->swapchain);
-        destroyLogicalDevice(&app->logicalDevice);
-        destroyVulkanSurface(app->vulkanInstance, app->surface);
-        destroyVulkanInstance(app->vulkanInstance);
-        cleanupSDLWindow(app->window);
-        return -1;
+        goto fail_index_buffer;
     }
     printf("\nUniform Buffer: Ready\n");
 
+    // Per-instance transforms for drawing a field of copies in one call
+    if (app->instanceCount > 0) {
+        printf("\n=== Creating Instance Buffer ===\n");
+        // With GPU culling the compute pass writes the drawn instances, so no per-frame ring is needed
+        if (!app->gpuCulling) {
+            result = createInstanceBuffer(
+                app->logicalDevice.device,
+                app->physicalDevice,
+                &app->gpuAllocator,
+                app->instanceCount,
+                MAX_FRAMES_IN_FLIGHT,
+                &app->instanceBuffer
+            );
+        }
+        if (result != VK_SUCCESS || !allocateInstanceArrays(app) || !buildInstanceField(app)) {
+            printf("Failed to create instance buffer!\n");
+            goto fail_instances;
+        }
+        printf("\nInstance Buffer: %u instances\n", app->instanceCount);
+    }
+
+    // Scene of independently drawn objects, one push constant block each
+    if (app->sceneObjectCount > 0) {
+        printf("\n=== Building Scene ===\n");
+        initScene(&app->scene);
+        result = buildSceneField(app);
+        if (result != VK_SUCCESS) {
+            printf("Failed to build scene!\n");
+            goto fail_scene;
+        }
+        printf("\nScene: %u meshes, %u objects\n", app->scene.meshCount, app->scene.objectCount);
+    }
+
     // Update uniform buffer with initial MVP matrices
     printf("\n=== Setting Up Initial MVP Matrices ===\n");
     UniformBufferObject ubo = {0};
@@ -300,6 +572,7 @@ int initializeApplication(ApplicationContext* app) {
     mat4 rotation = mat4_rotate_y(45.0f * (3.14159f / 180.0f));
     mat4 scaling = mat4_scale(vec3_create(0.5f, 0.5f, 0.5f));
     ubo.model = mat4_multiply(rotation, scaling);
+    ubo.normalMatrix = mat4_normal_matrix(ubo.model);
     
     // View matrix: from camera
     ubo.view = getCameraViewMatrix(&app->camera);
@@ -316,22 +589,8 @@ int initializeApplication(ApplicationContext* app) {
     ubo.lightColor = vec3_create(1.0f, 1.0f, 1.0f);  // White light
     ubo.viewPos = vec3_create(0.0f, 0.0f, 3.0f);     // Camera position
     
-    result = updateUniformBuffer(app->logicalDevice.device, &app->uniformBuffer, &ubo);
-    if (result != VK_SUCCESS) {
-        printf("Failed to update uniform buffer with MVP matrices!\n");
-        destroyBuffer(app->logicalDevice.device, &app->uniformBuffer);
-        destroyBuffer(app->logicalDevice.device, &app->vertexBuffer);
-        destroyCommandPool(app->logicalDevice.device, app->commandPool);
-        destroyFramebuffers(app->logicalDevice.device, app->framebuffers, app->framebufferCount);
-        destroyDepthResources(app->logicalDevice.device, app->depthImage, app->depthImageMemory, app->depthImageView);
-        destroyRenderPass(app->logicalDevice.device, app->renderPass);
-        destroySwapchain(app->logicalDevice.device, &app->swapchain);
-        destroyLogicalDevice(&app->logicalDevice);
-        destroyVulkanSurface(app->vulkanInstance, app->surface);
-        destroyVulkanInstance(app->vulkanInstance);
-        cleanupSDLWindow(app->window);
-        return -1;
-    }
+    // draw_frame writes this into the uniform ring each frame, so nothing is uploaded here
+    app->frameUniforms = ubo;
     printf("\nMVP Matrices: Set up (Model: identity, View: look-at, Proj: perspective)\n");
 
     // Initialize temporary camera system
@@ -341,7 +600,7 @@ int initializeApplication(ApplicationContext* app) {
     // Create descriptor pool
     printf("\n=== Creating Descriptor Pool ===\n");
     VkDescriptorPoolSize poolSize = {0};
-    poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     poolSize.descriptorCount = 1;
 
     VkDescriptorPoolCreateInfo poolInfo = {0};
@@ -353,22 +612,11 @@ int initializeApplication(ApplicationContext* app) {
     result = vkCreateDescriptorPool(app->logicalDevice.device, &poolInfo, NULL, &app->descriptorPool);
     if (result != VK_SUCCESS) {
         printf("Failed to create descriptor pool!\n");
-        destroyBuffer(app->logicalDevice.device, &app->uniformBuffer);
-        destroyBuffer(app->logicalDevice.device, &app->vertexBuffer);
-        destroyCommandPool(app->logicalDevice.device, app->commandPool);
-        destroyFramebuffers(app->logicalDevice.device, app->framebuffers, app->framebufferCount);
-        destroyDepthResources(app->logicalDevice.device, app->depthImage, app->depthImageMemory, app->depthImageView);
-        destroyRenderPass(app->logicalDevice.device, app->renderPass);
-        destroySwapchain(app->logicalDevice.device, &app->swapchain);
-        destroyLogicalDevice(&app->logicalDevice);
-        destroyVulkanSurface(app->vulkanInstance, app->surface);
-        destroyVulkanInstance(app->vulkanInstance);
-        cleanupSDLWindow(app->window);
-        return -1;
+        goto fail_scene;
     }
     printf("\nDescriptor Pool: Created\n");
 
-    // Allocate descriptor set
+    // Allocate descriptor set; each frame picks its ring sub-allocation with a dynamic offset
     printf("\n=== Allocating Descriptor Set ===\n");
     VkDescriptorSetAllocateInfo allocInfo = {0};
     allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
@@ -379,25 +627,13 @@ int initializeApplication(ApplicationContext* app) {
     result = vkAllocateDescriptorSets(app->logicalDevice.device, &allocInfo, &app->descriptorSet);
     if (result != VK_SUCCESS) {
         printf("Failed to allocate descriptor set!\n");
-        vkDestroyDescriptorPool(app->logicalDevice.device, app->descriptorPool, NULL);
-        destroyBuffer(app->logicalDevice.device, &app->uniformBuffer);
-        destroyBuffer(app->logicalDevice.device, &app->vertexBuffer);
-        destroyCommandPool(app->logicalDevice.device, app->commandPool);
-        destroyFramebuffers(app->logicalDevice.device, app->framebuffers, app->framebufferCount);
-        destroyDepthResources(app->logicalDevice.device, app->depthImage, app->depthImageMemory, app->depthImageView);
-        destroyRenderPass(app->logicalDevice.device, app->renderPass);
-        destroySwapchain(app->logicalDevice.device, &app->swapchain);
-        destroyLogicalDevice(&app->logicalDevice);
-        destroyVulkanSurface(app->vulkanInstance, app->surface);
-        destroyVulkanInstance(app->vulkanInstance);
-        cleanupSDLWindow(app->window);
-        return -1;
+        goto fail_descriptor_pool;
     }
     printf("\nDescriptor Set: Allocated\n");
 
-    // Bind uniform buffer to descriptor set
+    // Bind the uniform ring; the window is one UBO wide and slid by the dynamic offset
     VkDescriptorBufferInfo bufferInfo = {0};
-    bufferInfo.buffer = app->uniformBuffer.buffer;
+    bufferInfo.buffer = app->uniformRing.buffer.buffer;
     bufferInfo.offset = 0;
     bufferInfo.range = sizeof(UniformBufferObject);
 
@@ -406,33 +642,12 @@ int initializeApplication(ApplicationContext* app) {
     descriptorWrite.dstSet = app->descriptorSet;
     descriptorWrite.dstBinding = 0;
     descriptorWrite.dstArrayElement = 0;
-    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     descriptorWrite.descriptorCount = 1;
     descriptorWrite.pBufferInfo = &bufferInfo;
 
     vkUpdateDescriptorSets(app->logicalDevice.device, 1, &descriptorWrite, 0, NULL);
-    printf("\nDescriptor Set: Bound to uniform buffer\n");
-
-    result = allocateCommandBuffers(
-        app->logicalDevice.device,
-        app->commandPool,
-        app->framebufferCount,
-        &app->commandBuffers
-    );
-    if (result != VK_SUCCESS) {
-        printf("Failed to allocate command buffers!\n");
-        destroyCommandPool(app->logicalDevice.device, app->commandPool);
-        destroyFramebuffers(app->logicalDevice.device, app->framebuffers, app->framebufferCount);
-        destroyDepthResources(app->logicalDevice.device, app->depthImage, app->depthImageMemory, app->depthImageView);
-        destroyRenderPass(app->logicalDevice.device, app->renderPass);
-        destroySwapchain(app->logicalDevice.device, &app->swapchain);
-        destroyLogicalDevice(&app->logicalDevice);
-        destroyVulkanSurface(app->vulkanInstance, app->surface);
-        destroyVulkanInstance(app->vulkanInstance);
-        cleanupSDLWindow(app->window);
-        return -1;
-    }
-    app->commandBufferCount = app->framebufferCount;
+    printf("\nDescriptor Set: Bound to uniform ring (dynamic offset)\n");
 
     // Test buffer system
     printf("\n=== Testing Buffer System ===\n");
@@ -442,6 +657,7 @@ int initializeApplication(ApplicationContext* app) {
     testBufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
     testBufferInfo.properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | 
                                 VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    testBufferInfo.allocator = &app->gpuAllocator;
     
     Buffer testBuffer = {0};
     result = createBuffer(
@@ -475,23 +691,46 @@ int initializeApplication(ApplicationContext* app) {
 
     // Create synchronization primitives
     printf("\n=== Creating Synchronization Primitives ===\n");
-    result = createFrameSync(app->logicalDevice.device, &app->frameSync);
+    result = createFrameSync(
+        app->logicalDevice.device,
+        app->commandPool,
+        MAX_FRAMES_IN_FLIGHT,
+        app->swapchain.imageCount,
+        &app->frameSync
+    );
     if (result != VK_SUCCESS) {
         printf("Failed to create frame synchronization!\n");
-        destroyCommandPool(app->logicalDevice.device, app->commandPool);
-        destroyFramebuffers(app->logicalDevice.device, app->framebuffers, app->framebufferCount);
-        destroyDepthResources(app->logicalDevice.device, app->depthImage, app->depthImageMemory, app->depthImageView);
-        destroyRenderPass(app->logicalDevice.device, app->renderPass);
-        destroySwapchain(app->logicalDevice.device, &app->swapchain);
-        destroyPipelineLayouts(app->logicalDevice.device, &app->pipelineLayouts);
-        destroyLogicalDevice(&app->logicalDevice);
-        destroyVulkanSurface(app->vulkanInstance, app->surface);
-        destroyVulkanInstance(app->vulkanInstance);
-        cleanupSDLWindow(app->window);
-        return -1;
+        goto fail_descriptor_pool;
     }
     printf("\nFrame Synchronization: Ready\n");
 
+    // Timestamp queries for per-pass GPU timings
+    printf("\n=== Creating GPU Profiler ===\n");
+    result = createGpuProfiler(
+        app->logicalDevice.device,
+        app->physicalDevice,
+        app->indices.graphicsFamily,
+        app->frameSync.frameCount,
+        &app->gpuProfiler
+    );
+    if (result != VK_SUCCESS) {
+        printf("Failed to create GPU profiler!\n");
+        goto fail_frame_sync;
+    }
+
+    // Load the pipeline cache from a previous run
+    printf("\n=== Creating Pipeline Cache ===\n");
+    result = createPipelineCache(
+        app->logicalDevice.device,
+        app->physicalDevice,
+        PIPELINE_CACHE_DEFAULT_PATH,
+        &app->pipelineCache
+    );
+    if (result != VK_SUCCESS) {
+        printf("Failed to create pipeline cache!\n");
+        goto fail_gpu_profiler;
+    }
+
     // Create graphics pipeline
     printf("\n=== Creating Graphics Pipeline ===\n");
     GraphicsPipelineConfig config = createDefaultPipelineConfig(
@@ -536,33 +775,123 @@ int initializeApplication(ApplicationContext* app) {
     config.vertexBindingCount = 1;
     config.vertexAttributes = vertexAttributes;
     config.vertexAttributeCount = 3;
+
+    // Instancing adds a per-instance binding with the model and normal matrices
+    VertexBindingDescription instancedBindings[2];
+    VertexAttributeDescription instancedAttributes[3 + INSTANCE_ATTRIBUTE_COUNT];
+    if (app->sceneObjectCount > 0) {
+        // Scene objects push their model and normal matrices per draw
+        config.vertShaderPath = "shaders/scene.vert.spv";
+    } else if (app->instanceCount > 0) {
+        instancedBindings[0] = vertexBindings[0];
+        memcpy(instancedAttributes, vertexAttributes, sizeof(vertexAttributes));
+        getInstanceVertexInput(&instancedBindings[1], &instancedAttributes[3]);
+
+        config.vertShaderPath = "shaders/instanced.vert.spv";
+        config.vertexBindings = instancedBindings;
+        config.vertexBindingCount = 2;
+        config.vertexAttributes = instancedAttributes;
+        config.vertexAttributeCount = 3 + INSTANCE_ATTRIBUTE_COUNT;
+    }
     
     config.enableDepthTest = true;
     config.enableDepthWrite = true;
     config.cullMode = VK_CULL_MODE_NONE;
+    config.pipelineCache = &app->pipelineCache;
     
     result = createGraphicsPipeline(&config, &app->graphicsPipeline);
     
     if (result != VK_SUCCESS) {
         printf("Failed to create graphics pipeline!\n");
-        destroyFrameSync(app->logicalDevice.device, &app->frameSync);
-        destroyCommandPool(app->logicalDevice.device, app->commandPool);
-        destroyFramebuffers(app->logicalDevice.device, app->framebuffers, app->framebufferCount);
-        destroyDepthResources(app->logicalDevice.device, app->depthImage, app->depthImageMemory, app->depthImageView);
-        destroyRenderPass(app->logicalDevice.device, app->renderPass);
-        destroySwapchain(app->logicalDevice.device, &app->swapchain);
-        destroyPipelineLayouts(app->logicalDevice.device, &app->pipelineLayouts);
-        destroyLogicalDevice(&app->logicalDevice);
-        destroyVulkanSurface(app->vulkanInstance, app->surface);
-        destroyVulkanInstance(app->vulkanInstance);
-        cleanupSDLWindow(app->window);
-        return -1;
+        goto fail_pipeline_cache;
     }
     printf("\nGraphics Pipeline: Ready\n");
 
+    // Compute pass that culls the instance field and writes the indirect draws
+    if (app->gpuCulling) {
+        printf("\n=== Creating GPU Culler ===\n");
+        result = createInstanceCuller(app);
+        if (result != VK_SUCCESS) {
+            printf("Failed to create GPU culler!\n");
+            goto fail_graphics_pipeline;
+        }
+        printf("\nGPU Culler: Ready\n");
+    }
+
+    // Jobs recording the scene's draw list into secondary command buffers
+    if (app->recordChunkCount > 0 && app->sceneObjectCount > 0) {
+        printf("\n=== Creating Parallel Recorder ===\n");
+        result = createParallelRecorder(app->logicalDevice.device, app->indices, &app->jobSystem,
+                                        app->recordChunkCount, &app->parallelRecorder);
+        if (result != VK_SUCCESS) {
+            printf("Failed to create parallel recorder!\n");
+            goto fail_gpu_culler;
+        }
+        printf("\nParallel Recorder: Ready\n");
+    }
+    reportPipelineCache(&app->pipelineCache);
+
     app->running = true;
 
     return 0;
+
+    // Each step jumps to the label that releases everything initialized before it
+fail_gpu_culler:
+    if (app->gpuCulling) {
+        destroyDepthPyramid(app->logicalDevice.device, &app->depthPyramid);
+        destroyGpuCuller(app->logicalDevice.device, &app->gpuCuller);
+    }
+fail_graphics_pipeline:
+    destroyGraphicsPipeline(app->logicalDevice.device, &app->graphicsPipeline);
+fail_pipeline_cache:
+    destroyPipelineCache(app->logicalDevice.device, &app->pipelineCache);
+fail_gpu_profiler:
+    destroyGpuProfiler(&app->gpuProfiler);
+fail_frame_sync:
+    destroyFrameSync(app->logicalDevice.device, app->commandPool, &app->frameSync);
+fail_descriptor_pool:
+    vkDestroyDescriptorPool(app->logicalDevice.device, app->descriptorPool, NULL);
+    app->descriptorPool = VK_NULL_HANDLE;
+fail_scene:
+    if (app->sceneObjectCount > 0) {
+        destroyScene(app->logicalDevice.device, &app->scene);
+    }
+fail_instances:
+    if (app->instanceCount > 0) {
+        destroyInstanceBuffer(app->logicalDevice.device, &app->instanceBuffer);
+        freeInstanceArrays(app);
+    }
+    destroyBufferRing(app->logicalDevice.device, &app->uniformRing);
+fail_index_buffer:
+    destroyBuffer(app->logicalDevice.device, &app->indexBuffer);
+fail_vertex_buffer:
+    destroyBuffer(app->logicalDevice.device, &app->vertexBuffer);
+fail_allocator:
+    destroyGpuAllocator(&app->gpuAllocator);
+fail_command_pool:
+    destroyCommandPool(app->logicalDevice.device, app->commandPool);
+    app->commandPool = VK_NULL_HANDLE;
+fail_framebuffers:
+    destroyFramebuffers(app->logicalDevice.device, app->framebuffers, app->framebufferCount);
+    app->framebuffers = NULL;
+    app->framebufferCount = 0;
+fail_pipeline_layouts:
+    destroyPipelineLayouts(app->logicalDevice.device, &app->pipelineLayouts);
+fail_depth:
+    destroyDepthResources(app->logicalDevice.device, app->depthImage, app->depthImageMemory, app->depthImageView);
+fail_render_pass:
+    destroyRenderPass(app->logicalDevice.device, app->renderPass);
+fail_swapchain:
+    destroySwapchain(app->logicalDevice.device, &app->swapchain);
+fail_device:
+    destroyLogicalDevice(&app->logicalDevice);
+fail_surface:
+    destroyVulkanSurface(app->vulkanInstance, app->surface);
+fail_instance:
+    destroyVulkanInstance(app->vulkanInstance);
+fail_window:
+    cleanupSDLWindow(app->window);
+    return -1;
 }
 
 void printDeviceInfo(ApplicationContext* app) {
@@ -573,24 +902,27 @@ void printDeviceInfo(ApplicationContext* app) {
     printf("Graphics Support: %s\n", app->indices.hasGraphics ? "Yes" : "No");
     printf("Present Support: %s\n", app->indices.hasPresent ? "Yes" : "No");
 
-    // Query and print swapchain support details
-    SwapChainSupportDetails sc = querySwapChainSupport(app->physicalDevice, app->surface);
-    VkSurfaceFormatKHR chosenFormat = chooseSwapSurfaceFormat(sc.formats, sc.formatCount);
-    VkPresentModeKHR chosenPresentMode = chooseSwapPresentMode(sc.presentModes, sc.presentModeCount);
-
-    printf("\nSwapchain Support:\n");
-    printf("  Capabilities: minImages=%u maxImages=%u currentExtent=%ux%u\n",
-           sc.capabilities.minImageCount,
-           sc.capabilities.maxImageCount,
-           sc.capabilities.currentExtent.width,
-           sc.capabilities.currentExtent.height);
-    printf("  Available Formats: %u\n", sc.formatCount);
-    printf("  Available Present Modes: %u\n", sc.presentModeCount);
-    printf("  Chosen Format: %d (colorSpace=%d)\n", (int)chosenFormat.format, (int)chosenFormat.colorSpace);
-    printf("  Chosen Present Mode: %d\n", (int)chosenPresentMode);
-    printf("  VSYNC: %s\n", app->vsyncEnabled ? "On" : "Off");
-
-    freeSwapChainSupport(&sc);
+    // Surface capabilities only exist with a window
+    if (!app->headless) {
+        // Query and print swapchain support details
+        SwapChainSupportDetails sc = querySwapChainSupport(app->physicalDevice, app->surface);
+        VkSurfaceFormatKHR chosenFormat = chooseSwapSurfaceFormat(sc.formats, sc.formatCount);
+        VkPresentModeKHR chosenPresentMode = chooseSwapPresentMode(sc.presentModes, sc.presentModeCount);
+
+        printf("\nSwapchain Support:\n");
+        printf("  Capabilities: minImages=%u maxImages=%u currentExtent=%ux%u\n",
+               sc.capabilities.minImageCount,
+               sc.capabilities.maxImageCount,
+               sc.capabilities.currentExtent.width,
+               sc.capabilities.currentExtent.height);
+        printf("  Available Formats: %u\n", sc.formatCount);
+        printf("  Available Present Modes: %u\n", sc.presentModeCount);
+        printf("  Chosen Format: %d (colorSpace=%d)\n", (int)chosenFormat.format, (int)chosenFormat.colorSpace);
+        printf("  Chosen Present Mode: %d\n", (int)chosenPresentMode);
+        printf("  VSYNC: %s\n", app->vsyncEnabled ? "On" : "Off");
+
+        freeSwapChainSupport(&sc);
+    }
 
     // Print actual created swapchain information
     printf("\nCreated Swapchain:\n");
@@ -630,10 +962,10 @@ void printDeviceInfo(ApplicationContext* app) {
     // Print command pool and buffer info
     printf("\nCommand Pool & Buffers:\n");
     printf("  Command Pool Handle: %p\n", (void*)app->commandPool);
-    if (app->commandBuffers && app->commandBufferCount > 0) {
-        printf("  Command Buffer Count: %u\n", app->commandBufferCount);
-        for (uint32_t i = 0; i < app->commandBufferCount; i++) {
-            printf("  CommandBuffer[%u]: %p\n", i, (void*)app->commandBuffers[i]);
+    if (app->frameSync.frameCount > 0) {
+        printf("  Command Buffer Count: %u (one per frame slot)\n", app->frameSync.frameCount);
+        for (uint32_t i = 0; i < app->frameSync.frameCount; i++) {
+            printf("  CommandBuffer[%u]: %p\n", i, (void*)app->frameSync.frames[i].commandBuffer);
         }
     } else {
         printf("  Command Buffers: Not allocated yet\n");
@@ -646,6 +978,17 @@ void printDeviceInfo(ApplicationContext* app) {
     printf("  Size: %llu bytes\n", (unsigned long long)app->vertexBuffer.size);
     printf("  Status: Ready for vertex data\n");
 
+    // Print GPU memory allocator info
+    printf("\nGPU Memory Allocator:\n");
+    printGpuAllocatorStats(&app->gpuAllocator);
+
+    // Print index buffer info
+    printf("\nIndex Buffer:\n");
+    printf("  Buffer Handle: %p\n", (void*)app->indexBuffer.buffer);
+    printf("  Size: %llu bytes\n", (unsigned long long)app->indexBuffer.size);
+    printf("  Index Count: %u (%s)\n", app->indexCount, app->indexType == VK_INDEX_TYPE_UINT16 ? "16-bit" : "32-bit");
+    printf("  Unique Vertices: %u\n", app->vertexCount);
+
     // Print logical device information
     printf("\nLogical Device:\n");
     printf("  Device Handle: %p\n", (void*)app->logicalDevice.device);
@@ -655,7 +998,7 @@ void printDeviceInfo(ApplicationContext* app) {
     // Print pipeline layouts information
     printf("\nPipeline Layouts:\n");
     printf("  Global Set Layout (set=0): %p\n", (void*)app->pipelineLayouts.globalSetLayout);
-    printf("    Binding[0]: UNIFORM_BUFFER (VS|FS) — camera + lights UBO\n");
+    printf("    Binding[0]: UNIFORM_BUFFER_DYNAMIC (VS|FS) — camera + lights UBO, offset per frame slot into the uniform ring\n");
 
     printf("  Material Set Layout (set=1): %p\n", (void*)app->pipelineLayouts.materialSetLayout);
     const char* materialBindingNames[4] = {"albedo", "metalness", "roughness", "normal"};
@@ -683,9 +1026,14 @@ void printDeviceInfo(ApplicationContext* app) {
 
     // Print synchronization info
     printf("\nFrame Synchronization:\n");
-    printf("  Image Available Semaphore: %p (%s)\n", (void*)app->frameSync.imageAvailableSemaphore, app->frameSync.imageAvailableSemaphore != VK_NULL_HANDLE ? "Valid" : "Invalid");
-    printf("  Render Finished Semaphore: %p (%s)\n", (void*)app->frameSync.renderFinishedSemaphore, app->frameSync.renderFinishedSemaphore != VK_NULL_HANDLE ? "Valid" : "Invalid");
-    printf("  In-Flight Fence: %p (%s)\n", (void*)app->frameSync.inFlightFence, app->frameSync.inFlightFence != VK_NULL_HANDLE ? "Valid" : "Invalid");
+    printf("  Frames In Flight: %u\n", app->frameSync.frameCount);
+    for (uint32_t i = 0; i < app->frameSync.frameCount; i++) {
+        const FrameSlot* slot = &app->frameSync.frames[i];
+        printf("  Slot[%u]:\n", i);
+        printf("    Image Available Semaphore: %p (%s)\n", (void*)slot->imageAvailableSemaphore, slot->imageAvailableSemaphore != VK_NULL_HANDLE ? "Valid" : "Invalid");
+        printf("    In-Flight Fence: %p (%s)\n", (void*)slot->inFlightFence, slot->inFlightFence != VK_NULL_HANDLE ? "Valid" : "Invalid");
+    }
+    printf("  Render Finished Semaphores: %u (one per swapchain image)\n", app->frameSync.imageCount);
     printf("  Status: Ready for frame rendering\n");
 
     // Print graphics pipeline info
@@ -714,15 +1062,6 @@ void handleWindowResize(ApplicationContext* app, int width, int height) {
     vkDeviceWaitIdle(app->logicalDevice.device);
     printf("Device is now idle\n");
 
-    // Free command buffers (they reference the old framebuffers)
-    printf("Freeing command buffers...\n");
-    if (app->commandBuffers) {
-        freeCommandBuffers(app->logicalDevice.device, app->commandPool, app->commandBuffers, app->commandBufferCount);
-        app->commandBuffers = NULL;
-        app->commandBufferCount = 0;
-    }
-    printf("Command buffers freed\n");
-
     // Destroy framebuffers before recreating swapchain
     printf("Destroying framebuffers...\n");
     if (app->framebuffers) {
@@ -735,6 +1074,7 @@ void handleWindowResize(ApplicationContext* app, int width, int height) {
     // Destroy depth resources before recreating swapchain
     printf("Destroying depth resources...\n");
     destroyDepthResources(app->logicalDevice.device, app->depthImage, app->depthImageMemory, app->depthImageView);
+    destroyDepthPyramid(app->logicalDevice.device, &app->depthPyramid);
     printf("Depth resources destroyed\n");
 
     // Recreate swapchain with new dimensions
@@ -755,6 +1095,7 @@ void handleWindowResize(ApplicationContext* app, int width, int height) {
         app->logicalDevice.device,
         app->swapchain.extent,
         app->depthFormat,
+        getDepthImageUsage(app),
         &app->depthImage,
         &app->depthImageMemory,
         &app->depthImageView
@@ -766,6 +1107,16 @@ void handleWindowResize(ApplicationContext* app, int width, int height) {
     }
     printf("Depth resources recreated: image=%p, view=%p\n", (void*)app->depthImage, (void*)app->depthImageView);
 
+    // The depth pyramid follows the depth buffer's size
+    if (app->gpuCulling) {
+        result = createOcclusionPyramid(app);
+        if (result != VK_SUCCESS) {
+            printf("Failed to recreate the depth pyramid during window resize!\n");
+            app->running = false;
+            return;
+        }
+    }
+
     // Recreate framebuffers
     printf("Recreating framebuffers...\n");
     result = createFramebuffers(
@@ -783,21 +1134,13 @@ void handleWindowResize(ApplicationContext* app, int width, int height) {
     }
     printf("Framebuffers recreated\n");
 
-    // Reallocate command buffers
-    printf("Reallocating command buffers...\n");
-    result = allocateCommandBuffers(
-        app->logicalDevice.device,
-        app->commandPool,
-        app->framebufferCount,
-        &app->commandBuffers
-    );
+    // Frame slot command buffers are re-recorded every frame; only the per-image fences and semaphores need resetting
+    result = resetFrameSyncImages(app->logicalDevice.device, &app->frameSync, app->swapchain.imageCount);
     if (result != VK_SUCCESS) {
-        printf("Failed to reallocate command buffers during window resize!\n");
+        printf("Failed to reset frame sync image tracking during window resize!\n");
         app->running = false;
         return;
     }
-    app->commandBufferCount = app->framebufferCount;
-    printf("Command buffers reallocated\n");
 
     printf("Successfully handled window resize to %dx%d\n", app->swapchain.extent.width, app->swapchain.extent.height);
     printf("=== handleWindowResize COMPLETED ===\n");
@@ -823,6 +1166,9 @@ void handleEvents(ApplicationContext* app) {
                         SDL_ShowCursor(SDL_ENABLE);
                         printf("Mouse released - use normally\n");
                     }
+                } else if (event.key.keysym.sym == SDLK_g) {
+                    // Print rolling GPU timings per scope
+                    printGpuProfilerStats(&app->gpuProfiler);
                 } else if (event.key.keysym.sym == SDLK_f) {
                     // Toggle fullscreen
                     Uint32 flags = SDL_GetWindowFlags(app->window);
@@ -847,6 +1193,8 @@ void handleEvents(ApplicationContext* app) {
                     SDL_SetRelativeMouseMode(SDL_TRUE);
                     SDL_ShowCursor(SDL_DISABLE);
                     printf("Mouse recaptured for camera control\n");
+                } else if (event.button.button == SDL_BUTTON_LEFT) {
+                    pickAtCrosshair(app);
                 }
                 break;
             case SDL_WINDOWEVENT:
@@ -867,8 +1215,136 @@ void handleEvents(ApplicationContext* app) {
     }
 }
 
-void runApplication(ApplicationContext* app) {
+// Cull scene objects or instances against this frame's frustum before any command is recorded
+static void cullFrame(ApplicationContext* app, mat4 viewProj) {
+    if (app->cullingDisabled || (app->sceneObjectCount == 0 && app->instanceCount == 0)) return;
+
+    cpuZoneBegin("frustum_cull");
+    app->frustum = frustum_from_matrix(viewProj);
+    app->cullViewProj = viewProj;
+    uint32_t total;
+    uint32_t visible;
+    uint32_t occluded = 0;
+    if (app->sceneObjectCount > 0) {
+        total = app->scene.objectCount;
+        visible = cullScene(&app->scene, &app->frustum);
+    } else if (app->gpuCulling) {
+        // The compute pass culls with this frustum; its counts come back once the slot is reused
+        total = app->instanceCount;
+        visible = app->gpuCuller.lastVisibleCount;
+        occluded = app->gpuCuller.lastOccludedCount;
+    } else {
+        total = app->instanceCount;
+        visible = cullBvh(&app->instanceBvh, app->instanceBounds, &app->frustum, app->instanceVisible);
+        app->visibleInstanceCount = visible;
+    }
+
+    CullStats* stats = &app->cullStats;
+    stats->drawn = visible;
+    stats->culled = total - visible;
+    stats->occluded = occluded;
+    stats->totalDrawn += stats->drawn;
+    stats->totalCulled += stats->culled;
+    stats->totalOccluded += stats->occluded;
+    stats->frames++;
+    cpuZoneEnd();
+}
+
+// Build this frame's uniforms from the camera; draw_frame copies them into the current slot's ring slice
+static void updateFrameUniforms(ApplicationContext* app) {
+    cpuZoneBegin("ubo_update");
+    UniformBufferObject ubo = {0};
+    ubo.model = mat4_multiply(mat4_rotate_y(45.0f * (3.14159f / 180.0f)), mat4_scale(vec3_create(0.5f, 0.5f, 0.5f)));
+    ubo.normalMatrix = mat4_normal_matrix(ubo.model);
+    ubo.view = getCameraViewMatrix(&app->camera);
+    float aspect = (float)app->swapchain.extent.width / (float)app->swapchain.extent.height;
+    mat4 proj = mat4_perspective(60.0f * (3.14159f / 180.0f), aspect, 0.1f, 10.0f);
+    proj.m[0] = proj.m[0];
+    proj.m[5] = -proj.m[5]; // Flip y-axis for Vulkan viewport
+    ubo.proj = proj;
+
+    // Cull with the same view-projection the frame is drawn with
+    cullFrame(app, mat4_multiply(ubo.proj, ubo.view));
+
+    // Lighting data
+    ubo.lightPos = vec3_create(10.0f, 10.0f, 10.0f);    // Light position
+    ubo.lightColor = vec3_create(1.0f, 1.0f, 1.0f);  // White light
+    ubo.viewPos = app->camera.position;               // Camera position from camera struct
+    app->frameUniforms = ubo;
+    cpuZoneEnd();
+}
+
+// Render a fixed number of frames offscreen and stream them out
+static void runHeadless(ApplicationContext* app) {
+    printf("\n=== Rendering %u Headless Frames ===\n", app->benchmark
+        ? app->benchmark->warmupFrames + app->benchmark->measuredFrames : app->headlessFrameCount);
+
+    ReadbackRing readback = {0};
+    VkResult result = createReadbackRing(
+        app->logicalDevice.device,
+        app->physicalDevice,
+        app->swapchain.extent,
+        app->frameSync.frameCount,
+        &readback
+    );
+    if (result != VK_SUCCESS) {
+        printf("Failed to create readback ring!\n");
+        return;
+    }
+
+    FrameWriter writer = {0};
+    FrameWriter* output = NULL;
+    if (app->headlessOutputPath) {
+        FrameFormat format = frameFormatFromPath(app->headlessOutputPath);
+        if (openFrameWriter(app->headlessOutputPath, format,
+                            app->swapchain.extent.width, app->swapchain.extent.height, 60, &writer) != 0) {
+            destroyReadbackRing(&readback);
+            return;
+        }
+        output = &writer;
+    }
+
+    Uint64 startCounter = SDL_GetPerformanceCounter();
+    uint32_t frame = 0;
+    for (; app->running; frame++) {
+        // A benchmark decides its own length and poses the camera
+        if (app->benchmark) {
+            if (!benchmarkNextFrame(app->benchmark, &app->camera)) break;
+        } else if (frame >= app->headlessFrameCount) {
+            break;
+        }
+
+        cpuZoneBegin("frame");
+        updateFrameUniforms(app);
+        draw_offscreen_frame(app, &readback, output);
+        cpuZoneEnd();
+    }
+
+    // Frames still in flight are written once the GPU is done with them
+    vkDeviceWaitIdle(app->logicalDevice.device);
+    flushReadbackRing(&readback, output);
+    double elapsedMs = (double)(SDL_GetPerformanceCounter() - startCounter) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+
+    printf("Rendered %u frames in %.1f ms (%.1f fps)", frame, elapsedMs,
+           elapsedMs > 0.0 ? frame * 1000.0 / elapsedMs : 0.0);
+    if (output) {
+        printf(", wrote %u to %s", writer.framesWritten, app->headlessOutputPath);
+    }
+    printf("\n");
+
+    closeFrameWriter(&writer);
+    destroyReadbackRing(&readback);
+}
+
+// Interactive loop: live input, or a scripted camera when benchmarking
+static void runWindowed(ApplicationContext* app) {
+    // Measure rendering, not the display refresh
+    if (app->benchmark && app->vsyncEnabled) {
+        toggle_vsync(app, false);
+    }
+
     app->lastTime = SDL_GetTicks() / 1000.0f;  // Initialize time
+    float recordTime = 0.0f;
 
     while (app->running) {
         // Calculate delta time
@@ -876,30 +1352,60 @@ void runApplication(ApplicationContext* app) {
         float deltaTime = currentTime - app->lastTime;
         app->lastTime = currentTime;
 
+        cpuZoneBegin("frame");
+
+        cpuZoneBegin("events");
         handleEvents(app);
+        // Work that jobs handed to the main thread (SDL, presentation)
+        runMainThreadJobs(&app->jobSystem);
+        cpuZoneEnd();
 
         // Update camera based on input only if mouse is captured
-        if (app->mouseCaptured) {
+        cpuZoneBegin("camera_update");
+        if (app->benchmark) {
+            if (!benchmarkNextFrame(app->benchmark, &app->camera)) {
+                cpuZoneEnd();
+                cpuZoneEnd();
+                break;
+            }
+        } else if (app->mouseCaptured) {
             updateCamera(&app->camera, app->window, deltaTime);
         }
+        if (app->cameraRecordFile) {
+            writeCameraPathSample(app->cameraRecordFile, recordTime, &app->camera);
+            recordTime += deltaTime;
+        }
+        cpuZoneEnd();
 
-        // Update view matrix in uniform buffer
-        UniformBufferObject ubo;
-        ubo.model = mat4_multiply(mat4_rotate_y(45.0f * (3.14159f / 180.0f)), mat4_scale(vec3_create(0.5f, 0.5f, 0.5f)));
-        ubo.view = getCameraViewMatrix(&app->camera);
-        float aspect = (float)app->swapchain.extent.width / (float)app->swapchain.extent.height;
-        mat4 proj = mat4_perspective(60.0f * (3.14159f / 180.0f), aspect, 0.1f, 10.0f);
-        proj.m[0] = proj.m[0];
-        proj.m[5] = -proj.m[5]; // Flip y-axis for Vulkan viewport
-        ubo.proj = proj;
-
-        // Lighting data
-        ubo.lightPos = vec3_create(10.0f, 10.0f, 10.0f);    // Light position
-        ubo.lightColor = vec3_create(1.0f, 1.0f, 1.0f);  // White light
-        ubo.viewPos = app->camera.position;               // Camera position from camera struct
-        updateUniformBuffer(app->logicalDevice.device, &app->uniformBuffer, &ubo);
+        // Update view matrix; draw_frame copies it into the current slot's uniform ring slice
+        updateFrameUniforms(app);
 
         draw_frame(app);
+
+        cpuZoneEnd();
+    }
+}
+
+void runApplication(ApplicationContext* app) {
+    if (app->headless) {
+        runHeadless(app);
+    } else {
+        runWindowed(app);
+    }
+
+    const CullStats* cull = &app->cullStats;
+    if (cull->frames > 0) {
+        printf("Frustum culling: %.1f drawn, %.1f culled per frame on average (last frame: %u drawn, %u culled)\n",
+               (double)cull->totalDrawn / cull->frames, (double)cull->totalCulled / cull->frames,
+               cull->drawn, cull->culled);
+        if (app->gpuCulling && !app->occlusionDisabled) {
+            printf("Occlusion culling: %.1f of the culled were occluded per frame on average (last frame: %u)\n",
+                   (double)cull->totalOccluded / cull->frames, cull->occluded);
+        }
+    }
+
+    if (app->benchmark) {
+        writeBenchmarkReport(app->benchmark, &app->gpuProfiler, app->benchmarkOutputPath);
     }
 }
 
@@ -911,13 +1417,40 @@ void cleanupApplication(ApplicationContext* app) {
     printf("\n=== Cleaning Up Graphics Pipeline ===\n");
     destroyGraphicsPipeline(app->logicalDevice.device, &app->graphicsPipeline);
 
-    // Destroy vertex buffer
+    // Persist the pipeline cache so the next run skips shader compilation
+    printf("\n=== Saving Pipeline Cache ===\n");
+    savePipelineCache(app->logicalDevice.device, &app->pipelineCache);
+    destroyPipelineCache(app->logicalDevice.device, &app->pipelineCache);
+
+    // Destroy vertex and index buffers
     printf("\n=== Cleaning Up Vertex Buffer ===\n");
+    destroyBuffer(app->logicalDevice.device, &app->indexBuffer);
     destroyBuffer(app->logicalDevice.device, &app->vertexBuffer);
 
-    // Destroy uniform buffer
+    // Destroy uniform ring
     printf("\n=== Cleaning Up Uniform Buffer ===\n");
-    destroyBuffer(app->logicalDevice.device, &app->uniformBuffer);
+    destroyBufferRing(app->logicalDevice.device, &app->uniformRing);
+
+    if (app->instanceCount > 0) {
+        printf("\n=== Cleaning Up Instance Buffer ===\n");
+        destroyInstanceBuffer(app->logicalDevice.device, &app->instanceBuffer);
+        destroyGpuCuller(app->logicalDevice.device, &app->gpuCuller);
+        destroyDepthPyramid(app->logicalDevice.device, &app->depthPyramid);
+        freeInstanceArrays(app);
+    }
+
+    if (app->sceneObjectCount > 0) {
+        printf("\n=== Cleaning Up Scene ===\n");
+        destroyParallelRecorder(&app->parallelRecorder);
+        printf("  Last frame: %u draws, %u pipeline binds, %u mesh binds\n",
+               app->scene.lastStats.draws, app->scene.lastStats.pipelineBinds, app->scene.lastStats.meshBinds);
+        destroyScene(app->logicalDevice.device, &app->scene);
+    }
+
+    // Every buffer is gone, so the memory blocks can be released
+    printf("\n=== Cleaning Up GPU Memory Allocator ===\n");
+    printGpuAllocatorStats(&app->gpuAllocator);
+    destroyGpuAllocator(&app->gpuAllocator);
 
     // Destroy descriptor pool
     printf("\n=== Cleaning Up Descriptor Pool ===\n");
@@ -926,17 +1459,16 @@ void cleanupApplication(ApplicationContext* app) {
         app->descriptorPool = VK_NULL_HANDLE;
     }
 
+    // Destroy GPU profiler
+    printf("\n=== Cleaning Up GPU Profiler ===\n");
+    printGpuProfilerStats(&app->gpuProfiler);
+    destroyGpuProfiler(&app->gpuProfiler);
+
     // Destroy synchronization objects
     printf("\n=== Cleaning Up Synchronization ===\n");
-    destroyFrameSync(app->logicalDevice.device, &app->frameSync);
-
-    // Destroy command buffers and command pool
-    if (app->commandBuffers) {
-        freeCommandBuffers(app->logicalDevice.device, app->commandPool, app->commandBuffers, app->commandBufferCount);
-        app->commandBuffers = NULL;
-        app->commandBufferCount = 0;
-    }
+    destroyFrameSync(app->logicalDevice.device, app->commandPool, &app->frameSync);
 
+    // Destroy command pool
     if (app->commandPool != VK_NULL_HANDLE) {
         destroyCommandPool(app->logicalDevice.device, app->commandPool);
         app->commandPool = VK_NULL_HANDLE;
@@ -971,12 +1503,8 @@ void toggle_vsync(ApplicationContext* app, bool vsyncEnabled) {
     if (app->vsyncEnabled == vsyncEnabled) return;
     app->vsyncEnabled = vsyncEnabled;
 
-    // Free command buffers (they reference the old framebuffers)
-    if (app->commandBuffers) {
-        freeCommandBuffers(app->logicalDevice.device, app->commandPool, app->commandBuffers, app->commandBufferCount);
-        app->commandBuffers = NULL;
-        app->commandBufferCount = 0;
-    }
+    // Earlier frame slots may still be in flight and referencing the framebuffers
+    vkDeviceWaitIdle(app->logicalDevice.device);
 
     // Destroy framebuffers before recreating swapchain
     if (app->framebuffers) {
@@ -987,6 +1515,7 @@ void toggle_vsync(ApplicationContext* app, bool vsyncEnabled) {
 
     // Destroy depth resources before recreating swapchain
     destroyDepthResources(app->logicalDevice.device, app->depthImage, app->depthImageMemory, app->depthImageView);
+    destroyDepthPyramid(app->logicalDevice.device, &app->depthPyramid);
 
     // Recreate swapchain
     destroySwapchain(app->logicalDevice.device, &app->swapchain);
@@ -1003,6 +1532,7 @@ void toggle_vsync(ApplicationContext* app, bool vsyncEnabled) {
         app->logicalDevice.device,
         app->swapchain.extent,
         app->depthFormat,
+        getDepthImageUsage(app),
         &app->depthImage,
         &app->depthImageMemory,
         &app->depthImageView
@@ -1013,6 +1543,15 @@ void toggle_vsync(ApplicationContext* app, bool vsyncEnabled) {
         return;
     }
 
+    if (app->gpuCulling) {
+        result = createOcclusionPyramid(app);
+        if (result != VK_SUCCESS) {
+            printf("Failed to recreate the depth pyramid when toggling vsync!\n");
+            app->running = false;
+            return;
+        }
+    }
+
     // Recreate framebuffers
     result = createFramebuffers(
         app->logicalDevice.device,
@@ -1028,17 +1567,10 @@ void toggle_vsync(ApplicationContext* app, bool vsyncEnabled) {
         return;
     }
 
-    // Reallocate command buffers
-    result = allocateCommandBuffers(
-        app->logicalDevice.device,
-        app->commandPool,
-        app->framebufferCount,
-        &app->commandBuffers
-    );
+    result = resetFrameSyncImages(app->logicalDevice.device, &app->frameSync, app->swapchain.imageCount);
     if (result != VK_SUCCESS) {
-        printf("Failed to reallocate command buffers when toggling vsync!\n");
+        printf("Failed to reset frame sync image tracking when toggling vsync!\n");
         app->running = false;
         return;
     }
-    app->commandBufferCount = app->framebufferCount;
 }
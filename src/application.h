@@ -10,11 +10,33 @@
 #include "graphics_pipeline/pipeline_layout.h"
 #include "graphics_pipeline/graphics_pipeline.h"
 #include "sync/synchronization.h"
+#include "profiling/gpu_profiler.h"
 #include "graphics_pipeline/buffer.h"
 #include "math/matrix.h"
-#include "graphics_pipeline/buffer.h"
+#include "uniform_buffer/uniform_buffer.h"
+#include "vertex_buffer/instance_buffer.h"
+#include "scene/scene.h"
+#include "culling/gpu_culling.h"
+#include "rendering/parallel_recorder.h"
+#include "jobs/job_system.h"
+#include "math/frustum.h"
 #include "model_loaders/objloader.h"  // For Mesh
+#include "model_loaders/mesh_cache.h"
 #include "input/input.h"  // Temporary input system
+#include "benchmark/benchmark.h"
+
+/**
+ * Frustum culling results
+ */
+typedef struct {
+    uint32_t drawn;           // Last frame
+    uint32_t culled;
+    uint32_t occluded;        // Of the culled, those inside the frustum but hidden (GPU culling only)
+    uint64_t totalDrawn;      // Summed over every culled frame
+    uint64_t totalCulled;
+    uint64_t totalOccluded;
+    uint32_t frames;
+} CullStats;
 
 /**
  * Application context structure to hold all necessary data
@@ -39,27 +61,68 @@ typedef struct {
     VkFramebuffer* framebuffers;
     uint32_t framebufferCount;
 
-    // Command pool and buffers
+    // Command pool (per-frame command buffers live in frameSync)
     VkCommandPool commandPool;
-    VkCommandBuffer* commandBuffers;
-    uint32_t commandBufferCount;
 
     // Graphics pipeline layouts (descriptor set layouts + pipeline layout)
     PipelineLayouts pipelineLayouts;
 
     // Graphics pipeline
     GraphicsPipeline graphicsPipeline;
+    PipelineCache pipelineCache;
 
-    // Frame synchronization
+    // Frame synchronization (ring of MAX_FRAMES_IN_FLIGHT slots)
     FrameSync frameSync;
+    GpuProfiler gpuProfiler;
 
-    // Vertex buffer
-    Buffer vertexBuffer;
-
-    // Uniform buffer for MVP matrices
-    Buffer uniformBuffer;
+    // Sub-allocator all buffers draw their device memory from
+    GpuAllocator gpuAllocator;
 
-    // Descriptor pool and set for uniform buffer
+    // Vertex and index buffers (device-local)
+    Buffer vertexBuffer;
+    Buffer indexBuffer;
+
+    // Persistently mapped uniform ring, one slice per frame slot
+    BufferRing uniformRing;
+    UniformBufferObject frameUniforms;  // Written into the current slot's slice by draw_frame
+
+    // Instancing: instanceCount copies of the mesh in one draw (0 draws it once with ubo.model)
+    InstanceBuffer instanceBuffer;
+    InstanceData* instances;          // CPU copy, written into the current slot's slice each frame
+    uint32_t instanceCount;
+
+    // Scene: sceneObjectCount objects drawn one by one with push constants (0 disables)
+    Scene scene;
+    uint32_t sceneObjectCount;
+
+    // Frustum culling of scene objects and instances, run by updateFrameUniforms
+    bool cullingDisabled;
+    Frustum frustum;                  // World-space planes of proj * view
+    AabbSoA instanceBounds;           // World bounds of each instance (one aligned block)
+    uint8_t* instanceVisible;         // Per-instance result of the last cull
+    Bvh instanceBvh;                  // Over instanceBounds, for culling and picking
+    uint32_t visibleInstanceCount;
+    CullStats cullStats;
+
+    // GPU-driven culling: a compute pass culls the instances and writes indirect draws
+    bool gpuCulling;
+    GpuCuller gpuCuller;
+
+    // Occlusion culling for gpuCulling: the depth buffer is reduced into a pyramid after
+    // each frame and the next frame's cull tests instance bounds against it
+    bool occlusionDisabled;
+    DepthPyramid depthPyramid;
+    mat4 cullViewProj;                // Camera of the frame being recorded
+
+    // Scene draws recorded as recordChunkCount jobs into secondary command buffers (0 records inline)
+    uint32_t recordChunkCount;
+    ParallelRecorder parallelRecorder;
+
+    // Engine-wide task scheduler, created by main before the model is loaded
+    uint32_t jobThreadCount;          // Workers besides the main thread, 0 for one per remaining core
+    JobSystem jobSystem;
+
+    // Descriptor pool and set (dynamic uniform buffer bound at ring offsets)
     VkDescriptorPool descriptorPool;
     VkDescriptorSet descriptorSet;
 
@@ -71,9 +134,23 @@ typedef struct {
     bool running;
     bool mouseCaptured;  // Whether mouse is captured for camera control
 
+    // Headless mode: no window or surface, frames go to offscreen images and are read back
+    bool headless;
+    VkExtent2D headlessExtent;        // Offscreen image size
+    uint32_t headlessFrameCount;      // Frames to render before exiting
+    const char* headlessOutputPath;   // Raw/PPM/Y4M stream, NULL discards the frames
+
+    // Benchmark mode: the camera follows a scripted path at a fixed timestep (owned by main)
+    Benchmark* benchmark;             // NULL for interactive camera
+    const char* benchmarkOutputPath;  // JSON report, NULL prints it to stdout
+    FILE* cameraRecordFile;           // Interactive camera poses are appended here when set
+
     // Mesh data
     Mesh mesh;
+    BakedMesh bakedMesh;    // Mapped from the mesh cache; mesh then only holds counts and bounds
     uint32_t vertexCount;
+    uint32_t indexCount;
+    VkIndexType indexType;
 } ApplicationContext;
 
 /**
@@ -0,0 +1,218 @@
+// Microbenchmark: job system spawn, steal and wait overhead and scaling (make bench-jobs)
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "../jobs/job_system.h"
+
+#define BENCH_EMPTY_BATCH 1024       // Jobs per runJobs call
+#define BENCH_EMPTY_ROUNDS 1000
+#define BENCH_NESTED_PARENTS 64      // Each spawns BENCH_NESTED_CHILDREN and waits for them
+#define BENCH_NESTED_CHILDREN 64
+#define BENCH_NESTED_ROUNDS 200
+#define BENCH_WORK_JOBS 4096         // Scaling workload: jobs of BENCH_WORK_STEPS steps each
+#define BENCH_WORK_STEPS 20000
+#define BENCH_MAIN_ROUNDS 2000
+
+static JobSystem jobSystem;
+static atomic_uint_fast64_t checksum;
+static volatile uint32_t sink;  // Keeps the compiler from discarding results
+
+static double nowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static void emptyJob(void* data) {
+    (void)data;
+    atomic_fetch_add_explicit(&checksum, 1, memory_order_relaxed);
+}
+
+static void childJob(void* data) {
+    (void)data;
+    atomic_fetch_add_explicit(&checksum, 1, memory_order_relaxed);
+}
+
+// Spawns children and waits inside the job, so workers run other jobs while blocked
+static void parentJob(void* data) {
+    (void)data;
+    JobDecl children[BENCH_NESTED_CHILDREN];
+    for (int i = 0; i < BENCH_NESTED_CHILDREN; i++) {
+        children[i] = (JobDecl){childJob, NULL};
+    }
+    JobCounter counter = {0};
+    runJobs(&jobSystem, children, BENCH_NESTED_CHILDREN, &counter);
+    waitForCounter(&jobSystem, &counter);
+}
+
+// Fixed amount of integer work (xorshift steps), seeded by the job index
+static void workJob(void* data) {
+    uint32_t x = (uint32_t)(uintptr_t)data + 1u;
+    for (int i = 0; i < BENCH_WORK_STEPS; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+    }
+    atomic_fetch_add_explicit(&checksum, x, memory_order_relaxed);
+}
+
+typedef struct {
+    double submitMs;
+    double latencyMs;
+    uint32_t ranOn;
+} MainThreadProbe;
+
+static void mainThreadJob(void* data) {
+    MainThreadProbe* probe = data;
+    probe->latencyMs += nowMs() - probe->submitMs;
+    probe->ranOn = getJobThreadIndex();
+}
+
+// Runs on a worker and hands a job to the main thread
+static void requestMainThreadJob(void* data) {
+    MainThreadProbe* probe = data;
+    probe->submitMs = nowMs();
+    runMainThreadJob(&jobSystem, (JobDecl){mainThreadJob, probe}, NULL);
+}
+
+static uint64_t runWorkload(void) {
+    static JobDecl jobs[BENCH_WORK_JOBS];
+    for (uint32_t i = 0; i < BENCH_WORK_JOBS; i++) {
+        jobs[i] = (JobDecl){workJob, (void*)(uintptr_t)i};
+    }
+    atomic_store(&checksum, 0);
+    JobCounter counter = {0};
+    runJobs(&jobSystem, jobs, BENCH_WORK_JOBS, &counter);
+    waitForCounter(&jobSystem, &counter);
+    return atomic_load(&checksum);
+}
+
+static int benchOverhead(uint32_t workerCount) {
+    if (createJobSystem(workerCount, &jobSystem) != 0) return -1;
+
+    // Baseline: the same calls made directly
+    double start = nowMs();
+    for (int round = 0; round < BENCH_EMPTY_ROUNDS; round++) {
+        for (int i = 0; i < BENCH_EMPTY_BATCH; i++) emptyJob(NULL);
+    }
+    double directMs = nowMs() - start;
+
+    JobDecl jobs[BENCH_EMPTY_BATCH];
+    for (int i = 0; i < BENCH_EMPTY_BATCH; i++) {
+        jobs[i] = (JobDecl){emptyJob, NULL};
+    }
+    atomic_store(&checksum, 0);
+    atomic_store(&jobSystem.stolenCount, 0);
+    start = nowMs();
+    for (int round = 0; round < BENCH_EMPTY_ROUNDS; round++) {
+        JobCounter counter = {0};
+        runJobs(&jobSystem, jobs, BENCH_EMPTY_BATCH, &counter);
+        waitForCounter(&jobSystem, &counter);
+    }
+    double spawnMs = nowMs() - start;
+    uint64_t emptyRan = atomic_load(&checksum);
+    uint64_t emptyStolen = atomic_load(&jobSystem.stolenCount);
+
+    // Single job round trip: spawn, steal or pop, finish, observe the counter
+    start = nowMs();
+    for (int round = 0; round < BENCH_EMPTY_ROUNDS * 10; round++) {
+        JobCounter counter = {0};
+        runJobs(&jobSystem, jobs, 1, &counter);
+        waitForCounter(&jobSystem, &counter);
+    }
+    double singleMs = nowMs() - start;
+
+    JobDecl parents[BENCH_NESTED_PARENTS];
+    for (int i = 0; i < BENCH_NESTED_PARENTS; i++) {
+        parents[i] = (JobDecl){parentJob, NULL};
+    }
+    atomic_store(&checksum, 0);
+    start = nowMs();
+    for (int round = 0; round < BENCH_NESTED_ROUNDS; round++) {
+        JobCounter counter = {0};
+        runJobs(&jobSystem, parents, BENCH_NESTED_PARENTS, &counter);
+        waitForCounter(&jobSystem, &counter);
+    }
+    double nestedMs = nowMs() - start;
+    uint64_t nestedRan = atomic_load(&checksum);
+
+    // Worker -> main thread handoff, drained by the main thread while it waits
+    MainThreadProbe probe = {0, 0.0, UINT32_MAX};
+    JobDecl request = {requestMainThreadJob, &probe};
+    for (int round = 0; round < BENCH_MAIN_ROUNDS; round++) {
+        JobCounter counter = {0};
+        runJobs(&jobSystem, &request, 1, &counter);
+        waitForCounter(&jobSystem, &counter);
+        while (probe.ranOn == UINT32_MAX) runMainThreadJobs(&jobSystem);
+        if (probe.ranOn != 0) {
+            printf("  main-thread job ran on thread %u\n", probe.ranOn);
+            destroyJobSystem(&jobSystem);
+            return -1;
+        }
+        probe.ranOn = UINT32_MAX;
+    }
+
+    double jobCount = (double)BENCH_EMPTY_ROUNDS * BENCH_EMPTY_BATCH;
+    double nestedCount = (double)BENCH_NESTED_ROUNDS * BENCH_NESTED_PARENTS * (BENCH_NESTED_CHILDREN + 1);
+    printf("overhead with %u workers + main thread\n", jobSystem.threadCount - 1);
+    printf("  %-22s %9.2f ns/job\n", "direct call", directMs * 1e6 / jobCount);
+    printf("  %-22s %9.2f ns/job   %.1f%% stolen\n", "spawn + wait (batch)",
+           spawnMs * 1e6 / jobCount, 100.0 * emptyStolen / jobCount);
+    printf("  %-22s %9.2f ns/job\n", "spawn + wait (single)", singleMs * 1e6 / (BENCH_EMPTY_ROUNDS * 10.0));
+    printf("  %-22s %9.2f ns/job\n", "nested spawn + wait", nestedMs * 1e6 / nestedCount);
+    printf("  %-22s %9.2f us\n", "main-thread handoff", probe.latencyMs * 1e3 / BENCH_MAIN_ROUNDS);
+
+    destroyJobSystem(&jobSystem);
+    uint64_t expectedNested = (uint64_t)BENCH_NESTED_ROUNDS * BENCH_NESTED_PARENTS * BENCH_NESTED_CHILDREN;
+    if (emptyRan != (uint64_t)jobCount || nestedRan != expectedNested) {
+        printf("  lost jobs: %llu of %.0f, %llu of %llu nested\n", (unsigned long long)emptyRan, jobCount,
+               (unsigned long long)nestedRan, (unsigned long long)expectedNested);
+        return -1;
+    }
+    return 0;
+}
+
+static int benchScaling(uint32_t maxWorkers) {
+    printf("scaling: %d jobs x %d steps\n", BENCH_WORK_JOBS, BENCH_WORK_STEPS);
+    printf("  %-8s %10s %8s\n", "threads", "time", "speedup");
+
+    // Serial baseline without the job system
+    atomic_store(&checksum, 0);
+    double start = nowMs();
+    for (uint32_t i = 0; i < BENCH_WORK_JOBS; i++) workJob((void*)(uintptr_t)i);
+    double serialMs = nowMs() - start;
+    uint64_t expected = atomic_load(&checksum);
+    printf("  %-8s %7.2f ms %7.2fx\n", "serial", serialMs, 1.0);
+
+    for (uint32_t workers = 1; maxWorkers > 0; workers *= 2) {
+        if (workers > maxWorkers) workers = maxWorkers;
+        if (createJobSystem(workers, &jobSystem) != 0) return -1;
+
+        runWorkload();  // Warm-up
+        start = nowMs();
+        uint64_t result = runWorkload();
+        double elapsed = nowMs() - start;
+        uint32_t threads = jobSystem.threadCount;
+        destroyJobSystem(&jobSystem);
+
+        if (result != expected) {
+            printf("  checksum mismatch with %u threads\n", threads);
+            return -1;
+        }
+        printf("  %-8u %7.2f ms %7.2fx\n", threads, elapsed, serialMs / elapsed);
+        sink = (uint32_t)result;
+        if (workers == maxWorkers) break;
+    }
+    return 0;
+}
+
+int main(void) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t maxWorkers = cores > 1 ? (uint32_t)(cores - 1) : 0;
+    if (maxWorkers > JOB_SYSTEM_MAX_THREADS - 1) maxWorkers = JOB_SYSTEM_MAX_THREADS - 1;
+
+    if (benchOverhead(maxWorkers) != 0) return 1;
+    if (benchScaling(maxWorkers) != 0) return 1;
+    return 0;
+}
@@ -0,0 +1,272 @@
+// Microbenchmark: scalar vs SIMD mat4 kernels, batch transforms and frustum culling (make bench-math)
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../math/matrix.h"
+#include "../math/matrix_simd.h"
+#include "../math/transform_batch.h"
+#include "../math/frustum.h"
+
+#define BENCH_MATRIX_COUNT 1024   // Working set stays in L1/L2, so this measures the kernels
+#define BENCH_ITERATIONS 20000
+#define BENCH_BATCH_COUNT 262144  // Elements per batch transform (larger than L2)
+#define BENCH_BATCH_ITERATIONS 100
+
+typedef void (*BinaryKernel)(float*, const float*, const float*);
+typedef void (*UnaryKernel)(float*, const float*);
+
+static mat4a matricesA[BENCH_MATRIX_COUNT];
+static mat4a matricesB[BENCH_MATRIX_COUNT];
+static mat4a results[BENCH_MATRIX_COUNT];
+static vec4a vectors[BENCH_MATRIX_COUNT];
+static vec4a vectorResults[BENCH_MATRIX_COUNT];
+
+static volatile float sink;  // Keeps the compiler from discarding results
+
+static double nowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+// Random rigid transform: rotation about a random axis plus translation
+static mat4 randomRigid(void) {
+    float angle = (float)rand() / RAND_MAX * 6.28318f;
+    vec3 axis = vec3_normalize(vec3_create((float)rand() / RAND_MAX - 0.5f,
+                                           (float)rand() / RAND_MAX - 0.5f,
+                                           (float)rand() / RAND_MAX - 0.5f));
+    mat4 rotation = mat4_multiply(mat4_rotate_y(angle * axis.y), mat4_rotate_x(angle * axis.x));
+    rotation = mat4_multiply(rotation, mat4_rotate_z(angle * axis.z));
+    mat4 translation = mat4_translate(vec3_create((float)rand() / RAND_MAX * 10.0f,
+                                                  (float)rand() / RAND_MAX * 10.0f,
+                                                  (float)rand() / RAND_MAX * 10.0f));
+    return mat4_multiply(translation, rotation);
+}
+
+static double timeBinary(BinaryKernel kernel) {
+    double start = nowMs();
+    for (int iter = 0; iter < BENCH_ITERATIONS; iter++) {
+        for (int i = 0; i < BENCH_MATRIX_COUNT; i++) {
+            kernel(results[i].m, matricesA[i].m, matricesB[i].m);
+        }
+        sink = results[iter % BENCH_MATRIX_COUNT].m[0];
+    }
+    return nowMs() - start;
+}
+
+static double timeUnary(UnaryKernel kernel) {
+    double start = nowMs();
+    for (int iter = 0; iter < BENCH_ITERATIONS; iter++) {
+        for (int i = 0; i < BENCH_MATRIX_COUNT; i++) {
+            kernel(results[i].m, matricesA[i].m);
+        }
+        sink = results[iter % BENCH_MATRIX_COUNT].m[0];
+    }
+    return nowMs() - start;
+}
+
+static double timeVec4(void (*kernel)(float*, const float*, const float*)) {
+    double start = nowMs();
+    for (int iter = 0; iter < BENCH_ITERATIONS; iter++) {
+        for (int i = 0; i < BENCH_MATRIX_COUNT; i++) {
+            kernel(vectorResults[i].v, matricesA[i].m, vectors[i].v);
+        }
+        sink = vectorResults[iter % BENCH_MATRIX_COUNT].v[0];
+    }
+    return nowMs() - start;
+}
+
+// Largest element difference between the two paths over the whole working set
+static float compareBinary(BinaryKernel a, BinaryKernel b) {
+    float maxError = 0.0f;
+    for (int i = 0; i < BENCH_MATRIX_COUNT; i++) {
+        float ra[16], rb[16];
+        a(ra, matricesA[i].m, matricesB[i].m);
+        b(rb, matricesA[i].m, matricesB[i].m);
+        for (int k = 0; k < 16; k++) maxError = fmaxf(maxError, fabsf(ra[k] - rb[k]));
+    }
+    return maxError;
+}
+
+static float compareUnary(UnaryKernel a, UnaryKernel b) {
+    float maxError = 0.0f;
+    for (int i = 0; i < BENCH_MATRIX_COUNT; i++) {
+        float ra[16], rb[16];
+        a(ra, matricesA[i].m);
+        b(rb, matricesA[i].m);
+        for (int k = 0; k < 16; k++) maxError = fmaxf(maxError, fabsf(ra[k] - rb[k]));
+    }
+    return maxError;
+}
+
+static float compareVec4(void) {
+    float maxError = 0.0f;
+    for (int i = 0; i < BENCH_MATRIX_COUNT; i++) {
+        float ra[4], rb[4];
+        mat4_scalar_multiply_vec4(ra, matricesA[i].m, vectors[i].v);
+        mat4_simd_multiply_vec4(rb, matricesA[i].m, vectors[i].v);
+        for (int k = 0; k < 4; k++) maxError = fmaxf(maxError, fabsf(ra[k] - rb[k]));
+    }
+    return maxError;
+}
+
+static void reportPer(const char* name, double calls, double scalarMs, double simdMs, float maxError) {
+    printf("  %-14s %8.2f ns %8.2f ns %7.2fx   max error %.2e\n", name,
+           scalarMs * 1e6 / calls, simdMs * 1e6 / calls, scalarMs / simdMs, maxError);
+}
+
+static void report(const char* name, double scalarMs, double simdMs, float maxError) {
+    reportPer(name, (double)BENCH_ITERATIONS * BENCH_MATRIX_COUNT, scalarMs, simdMs, maxError);
+}
+
+typedef void (*Vec3BatchKernel)(const mat4*, Vec3SoA, Vec3SoA, size_t);
+typedef void (*AabbBatchKernel)(const mat4*, AabbSoA, AabbSoA, size_t);
+
+static double timeVec3Batch(Vec3BatchKernel kernel, const mat4* m, Vec3SoA in, Vec3SoA out) {
+    double start = nowMs();
+    for (int iter = 0; iter < BENCH_BATCH_ITERATIONS; iter++) {
+        kernel(m, in, out, BENCH_BATCH_COUNT);
+        sink = out.x[iter];
+    }
+    return nowMs() - start;
+}
+
+static double timeAabbBatch(AabbBatchKernel kernel, const mat4* m, AabbSoA in, AabbSoA out) {
+    double start = nowMs();
+    for (int iter = 0; iter < BENCH_BATCH_ITERATIONS; iter++) {
+        kernel(m, in, out, BENCH_BATCH_COUNT);
+        sink = out.minX[iter];
+    }
+    return nowMs() - start;
+}
+
+typedef size_t (*CullKernel)(const Frustum*, AabbSoA, size_t, uint8_t*);
+
+static double timeCull(CullKernel kernel, const Frustum* frustum, AabbSoA boxes, uint8_t* outVisible) {
+    double start = nowMs();
+    for (int iter = 0; iter < BENCH_BATCH_ITERATIONS; iter++) {
+        sink = (float)kernel(frustum, boxes, BENCH_BATCH_COUNT, outVisible);
+    }
+    return nowMs() - start;
+}
+
+static float compareArrays(float* const* a, float* const* b, int arrayCount) {
+    float maxError = 0.0f;
+    for (int k = 0; k < arrayCount; k++) {
+        for (size_t i = 0; i < BENCH_BATCH_COUNT; i++) {
+            maxError = fmaxf(maxError, fabsf(a[k][i] - b[k][i]));
+        }
+    }
+    return maxError;
+}
+
+// Batch transforms over SoA arrays, reported per element
+static int benchBatchTransforms(void) {
+    float* arrays[18];
+    for (int k = 0; k < 18; k++) {
+        arrays[k] = soa_alloc_floats(BENCH_BATCH_COUNT);
+        if (!arrays[k]) {
+            printf("Out of memory\n");
+            return -1;
+        }
+    }
+    // Points in -10..10; arrays 3-5 are box maxima, up to 10 above the minima
+    for (int k = 0; k < 6; k++) {
+        for (size_t i = 0; i < BENCH_BATCH_COUNT; i++) {
+            arrays[k][i] = k < 3 ? (float)rand() / RAND_MAX * 20.0f - 10.0f
+                                 : arrays[k - 3][i] + (float)rand() / RAND_MAX * 10.0f;
+        }
+    }
+
+    mat4 m = mat4_multiply(randomRigid(), mat4_scale(vec3_create(1.5f, 0.75f, 2.0f)));
+    mat4 normalMatrix = mat4_normal_matrix(m);
+    Vec3SoA points = {arrays[0], arrays[1], arrays[2]};
+    Vec3SoA scalarOut = {arrays[6], arrays[7], arrays[8]};
+    Vec3SoA simdOut = {arrays[12], arrays[13], arrays[14]};
+    AabbSoA boxes = {arrays[0], arrays[1], arrays[2], arrays[3], arrays[4], arrays[5]};
+    AabbSoA scalarBoxes = {arrays[6], arrays[7], arrays[8], arrays[9], arrays[10], arrays[11]};
+    AabbSoA simdBoxes = {arrays[12], arrays[13], arrays[14], arrays[15], arrays[16], arrays[17]};
+    double elements = (double)BENCH_BATCH_ITERATIONS * BENCH_BATCH_COUNT;
+
+    printf("batch transforms: %d elements x %d iterations, per element\n",
+           BENCH_BATCH_COUNT, BENCH_BATCH_ITERATIONS);
+    double scalarMs = timeVec3Batch(transform_points_soa_scalar, &m, points, scalarOut);
+    double simdMs = timeVec3Batch(transform_points_soa, &m, points, simdOut);
+    reportPer("points", elements, scalarMs, simdMs, compareArrays(&arrays[6], &arrays[12], 3));
+
+    scalarMs = timeVec3Batch(transform_normals_soa_scalar, &normalMatrix, points, scalarOut);
+    simdMs = timeVec3Batch(transform_normals_soa, &normalMatrix, points, simdOut);
+    reportPer("normals", elements, scalarMs, simdMs, compareArrays(&arrays[6], &arrays[12], 3));
+
+    scalarMs = timeAabbBatch(transform_aabbs_soa_scalar, &m, boxes, scalarBoxes);
+    simdMs = timeAabbBatch(transform_aabbs_soa, &m, boxes, simdBoxes);
+    reportPer("aabbs", elements, scalarMs, simdMs, compareArrays(&arrays[6], &arrays[12], 6));
+
+    // Camera outside the box cloud so only part of it is in view; "error" counts disagreeing flags
+    uint8_t* scalarVisible = malloc(BENCH_BATCH_COUNT);
+    uint8_t* simdVisible = malloc(BENCH_BATCH_COUNT);
+    if (scalarVisible && simdVisible) {
+        mat4 view = mat4_look_at(vec3_create(0.0f, 0.0f, 25.0f), vec3_create(0.0f, 0.0f, 0.0f), vec3_create(0.0f, 1.0f, 0.0f));
+        Frustum frustum = frustum_from_matrix(mat4_multiply(mat4_perspective(1.0f, 1.5f, 0.1f, 30.0f), view));
+        scalarMs = timeCull(frustum_cull_aabbs_soa_scalar, &frustum, boxes, scalarVisible);
+        simdMs = timeCull(frustum_cull_aabbs_soa, &frustum, boxes, simdVisible);
+        size_t mismatches = 0;
+        for (size_t i = 0; i < BENCH_BATCH_COUNT; i++) mismatches += scalarVisible[i] != simdVisible[i];
+        reportPer("frustum_cull", elements, scalarMs, simdMs, (float)mismatches);
+    }
+    free(scalarVisible);
+    free(simdVisible);
+
+    for (int k = 0; k < 18; k++) soa_free_floats(arrays[k]);
+    return 0;
+}
+
+int main(void) {
+    srand(1234);
+    for (int i = 0; i < BENCH_MATRIX_COUNT; i++) {
+        matricesA[i] = mat4a_from_mat4(randomRigid());
+        matricesB[i] = mat4a_from_mat4(randomRigid());
+        vectors[i] = (vec4a){{(float)rand() / RAND_MAX, (float)rand() / RAND_MAX, (float)rand() / RAND_MAX, 1.0f}};
+    }
+
+    printf("mat4 kernels: scalar vs %s (%d matrices x %d iterations)\n",
+           MATH_SIMD_NAME, BENCH_MATRIX_COUNT, BENCH_ITERATIONS);
+    printf("  %-14s %11s %11s %8s\n", "kernel", "scalar", "simd", "speedup");
+
+    report("multiply", timeBinary(mat4_scalar_multiply), timeBinary(mat4_simd_multiply),
+           compareBinary(mat4_scalar_multiply, mat4_simd_multiply));
+    report("multiply_vec4", timeVec4(mat4_scalar_multiply_vec4), timeVec4(mat4_simd_multiply_vec4),
+           compareVec4());
+    report("transpose", timeUnary(mat4_scalar_transpose), timeUnary(mat4_simd_transpose),
+           compareUnary(mat4_scalar_transpose, mat4_simd_transpose));
+    report("inverse_rigid", timeUnary(mat4_scalar_inverse_rigid), timeUnary(mat4_simd_inverse_rigid),
+           compareUnary(mat4_scalar_inverse_rigid, mat4_simd_inverse_rigid));
+
+    // The general inverse is checked on non-rigid matrices too
+    for (int i = 0; i < BENCH_MATRIX_COUNT; i += 2) {
+        mat4 scaled = mat4_multiply(mat4_from_mat4a(&matricesA[i]),
+                                    mat4_scale(vec3_create(0.5f + i % 7, 2.0f, 0.25f + i % 3)));
+        matricesA[i] = mat4a_from_mat4(i % 4 == 0
+            ? mat4_multiply(mat4_perspective(1.0f, 1.5f, 0.1f, 100.0f), scaled)
+            : scaled);
+    }
+    report("inverse", timeUnary(mat4_scalar_inverse), timeUnary(mat4_simd_inverse),
+           compareUnary(mat4_scalar_inverse, mat4_simd_inverse));
+
+    // Sanity check: M * M^-1 should be the identity
+    float worst = 0.0f;
+    for (int i = 0; i < BENCH_MATRIX_COUNT; i++) {
+        mat4a inverse, product;
+        mat4a_inverse(&inverse, &matricesA[i]);
+        mat4a_multiply(&product, &matricesA[i], &inverse);
+        for (int k = 0; k < 16; k++) {
+            float expected = (k % 5 == 0) ? 1.0f : 0.0f;
+            worst = fmaxf(worst, fabsf(product.m[k] - expected));
+        }
+    }
+    printf("  max |M * inverse(M) - I| = %.2e\n", worst);
+
+    if (benchBatchTransforms() != 0) return 1;
+    return worst < 1e-3f ? 0 : 1;
+}
@@ -0,0 +1,171 @@
+#include "benchmark.h"
+#include <SDL2/SDL.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int createBenchmark(
+    CameraPath path,
+    uint32_t measuredFrames,
+    uint32_t warmupFrames,
+    float timestep,
+    Benchmark* outBenchmark
+) {
+    if (!outBenchmark || measuredFrames == 0 || timestep <= 0.0f) {
+        return -1;
+    }
+
+    memset(outBenchmark, 0, sizeof(Benchmark));
+    outBenchmark->frameTimesMs = calloc(measuredFrames, sizeof(double));
+    if (!outBenchmark->frameTimesMs) {
+        return -1;
+    }
+    outBenchmark->path = path;
+    outBenchmark->timestep = timestep;
+    outBenchmark->warmupFrames = warmupFrames;
+    outBenchmark->measuredFrames = measuredFrames;
+
+    printf("Benchmark: path %s, %u frames (+%u warmup), timestep %.4f s\n",
+           path.name ? path.name : "?", measuredFrames, warmupFrames, timestep);
+    return 0;
+}
+
+bool benchmarkNextFrame(Benchmark* benchmark, Camera* camera) {
+    uint64_t now = SDL_GetPerformanceCounter();
+
+    // The previous frame ends where this one starts; frames before the first measured one are warmup
+    if (benchmark->frameIndex > benchmark->warmupFrames) {
+        uint32_t measured = benchmark->frameIndex - benchmark->warmupFrames - 1;
+        benchmark->frameTimesMs[measured] =
+            (double)(now - benchmark->lastCounter) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+    }
+    benchmark->lastCounter = now;
+
+    if (benchmark->frameIndex >= benchmark->warmupFrames + benchmark->measuredFrames) {
+        return false;
+    }
+
+    float time = (float)benchmark->frameIndex * benchmark->timestep;
+    evaluateCameraPath(&benchmark->path, time, camera);
+    benchmark->frameIndex++;
+    return true;
+}
+
+static int compareDouble(const void* a, const void* b) {
+    double da = *(const double*)a;
+    double db = *(const double*)b;
+    return (da > db) - (da < db);
+}
+
+// Nearest-rank percentile of a sorted array
+static double percentile(const double* sorted, uint32_t count, double p) {
+    uint32_t rank = (uint32_t)ceil(p / 100.0 * count);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return sorted[rank - 1];
+}
+
+void computeFrameTimeStats(const double* frameTimesMs, uint32_t count, FrameTimeStats* outStats) {
+    memset(outStats, 0, sizeof(FrameTimeStats));
+    if (!frameTimesMs || count == 0) return;
+
+    double* sorted = malloc(sizeof(double) * count);
+    if (!sorted) return;
+    memcpy(sorted, frameTimesMs, sizeof(double) * count);
+    qsort(sorted, count, sizeof(double), compareDouble);
+
+    double sum = 0.0;
+    for (uint32_t i = 0; i < count; i++) sum += sorted[i];
+    double mean = sum / count;
+    double variance = 0.0;
+    for (uint32_t i = 0; i < count; i++) variance += (sorted[i] - mean) * (sorted[i] - mean);
+
+    outStats->count = count;
+    outStats->meanMs = mean;
+    outStats->minMs = sorted[0];
+    outStats->maxMs = sorted[count - 1];
+    outStats->stddevMs = sqrt(variance / count);
+    outStats->p50Ms = percentile(sorted, count, 50.0);
+    outStats->p90Ms = percentile(sorted, count, 90.0);
+    outStats->p95Ms = percentile(sorted, count, 95.0);
+    outStats->p99Ms = percentile(sorted, count, 99.0);
+
+    double stutterThreshold = outStats->p50Ms * BENCHMARK_STUTTER_FACTOR;
+    for (uint32_t i = 0; i < count; i++) {
+        if (frameTimesMs[i] > stutterThreshold) outStats->stutterCount++;
+    }
+    free(sorted);
+}
+
+int writeBenchmarkReport(
+    const Benchmark* benchmark,
+    const GpuProfiler* gpuProfiler,
+    const char* path
+) {
+    if (!benchmark) return -1;
+
+    uint32_t measured = benchmark->frameIndex > benchmark->warmupFrames
+        ? benchmark->frameIndex - benchmark->warmupFrames : 0;
+    if (measured > benchmark->measuredFrames) measured = benchmark->measuredFrames;
+    // The last started frame is only timed when the next call to benchmarkNextFrame ends it
+    FrameTimeStats stats;
+    computeFrameTimeStats(benchmark->frameTimesMs, measured, &stats);
+
+    FILE* file = path ? fopen(path, "w") : stdout;
+    if (!file) {
+        printf("Failed to open benchmark report: %s\n", path);
+        return -1;
+    }
+
+    fprintf(file, "{\n");
+    fprintf(file, "  \"path\": \"%s\",\n", benchmark->path.name ? benchmark->path.name : "");
+    fprintf(file, "  \"timestep\": %.6f,\n", benchmark->timestep);
+    fprintf(file, "  \"warmup_frames\": %u,\n", benchmark->warmupFrames);
+    fprintf(file, "  \"frames\": %u,\n", stats.count);
+    fprintf(file, "  \"fps_mean\": %.3f,\n", stats.meanMs > 0.0 ? 1000.0 / stats.meanMs : 0.0);
+    fprintf(file, "  \"frame_ms\": {\n");
+    fprintf(file, "    \"mean\": %.4f,\n", stats.meanMs);
+    fprintf(file, "    \"min\": %.4f,\n", stats.minMs);
+    fprintf(file, "    \"max\": %.4f,\n", stats.maxMs);
+    fprintf(file, "    \"stddev\": %.4f,\n", stats.stddevMs);
+    fprintf(file, "    \"p50\": %.4f,\n", stats.p50Ms);
+    fprintf(file, "    \"p90\": %.4f,\n", stats.p90Ms);
+    fprintf(file, "    \"p95\": %.4f,\n", stats.p95Ms);
+    fprintf(file, "    \"p99\": %.4f\n", stats.p99Ms);
+    fprintf(file, "  },\n");
+    fprintf(file, "  \"stutter_factor\": %.2f,\n", BENCHMARK_STUTTER_FACTOR);
+    fprintf(file, "  \"stutters\": %u,\n", stats.stutterCount);
+
+    // GPU timings cover the profiler's rolling window, i.e. the end of the run
+    fprintf(file, "  \"gpu_ms\": {");
+    bool first = true;
+    if (gpuProfiler && gpuProfiler->supported) {
+        for (uint32_t i = 0; i < gpuProfiler->scopeCount; i++) {
+            GpuScopeTiming timing;
+            if (!getGpuScopeTiming(gpuProfiler, gpuProfiler->scopes[i].name, &timing)) continue;
+            fprintf(file, "%s\n    \"%s\": {\"min\": %.4f, \"avg\": %.4f, \"p99\": %.4f, \"samples\": %u}",
+                    first ? "" : ",", gpuProfiler->scopes[i].name,
+                    timing.minMs, timing.avgMs, timing.p99Ms, timing.samples);
+            first = false;
+        }
+    }
+    fprintf(file, "%s}\n", first ? "" : "\n  ");
+    fprintf(file, "}\n");
+
+    if (path) {
+        fclose(file);
+        printf("Benchmark report written to %s\n", path);
+    }
+    printf("Benchmark: %u frames, mean %.3f ms (%.1f fps), p99 %.3f ms, %u stutters\n",
+           stats.count, stats.meanMs, stats.meanMs > 0.0 ? 1000.0 / stats.meanMs : 0.0,
+           stats.p99Ms, stats.stutterCount);
+    return 0;
+}
+
+void destroyBenchmark(Benchmark* benchmark) {
+    if (!benchmark) return;
+    free(benchmark->frameTimesMs);
+    benchmark->frameTimesMs = NULL;
+    freeCameraPath(&benchmark->path);
+}
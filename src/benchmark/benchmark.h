@@ -0,0 +1,105 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "camera_path.h"
+#include "../profiling/gpu_profiler.h"
+
+#define BENCHMARK_DEFAULT_FRAMES 600
+#define BENCHMARK_DEFAULT_WARMUP 60
+#define BENCHMARK_DEFAULT_TIMESTEP (1.0f / 60.0f)
+
+// A frame counts as a stutter when it takes longer than this multiple of the median
+#define BENCHMARK_STUTTER_FACTOR 2.0
+
+/**
+ * Summary of measured frame times
+ */
+typedef struct {
+    uint32_t count;
+    double meanMs;
+    double minMs;
+    double maxMs;
+    double stddevMs;
+    double p50Ms;
+    double p90Ms;
+    double p95Ms;
+    double p99Ms;
+    uint32_t stutterCount;
+} FrameTimeStats;
+
+/**
+ * Deterministic benchmark run
+ * The camera follows a scripted path at simulated time frame * timestep, so
+ * every run renders the same sequence of views regardless of how fast it goes.
+ */
+typedef struct {
+    CameraPath path;
+    float timestep;            // Simulated seconds per frame
+    uint32_t warmupFrames;     // Rendered but not measured (pipeline warm-up, caches)
+    uint32_t measuredFrames;
+    uint32_t frameIndex;       // Frames started so far, warmup included
+
+    double* frameTimesMs;      // Wall-clock time of each measured frame
+    uint64_t lastCounter;      // Performance counter at the start of the previous frame
+} Benchmark;
+
+/**
+ * Prepare a benchmark run (takes ownership of the path)
+ *
+ * @param path - Camera path to play
+ * @param measuredFrames - Frames to measure after warmup
+ * @param warmupFrames - Frames rendered before measuring
+ * @param timestep - Simulated seconds per frame
+ * @param outBenchmark - Output benchmark
+ * @return 0 on success, -1 on failure
+ */
+int createBenchmark(
+    CameraPath path,
+    uint32_t measuredFrames,
+    uint32_t warmupFrames,
+    float timestep,
+    Benchmark* outBenchmark
+);
+
+/**
+ * Start the next frame: time the previous one and pose the camera
+ *
+ * @param benchmark - Benchmark run
+ * @param camera - Camera to pose along the path
+ * @return false once every frame has been rendered
+ */
+bool benchmarkNextFrame(Benchmark* benchmark, Camera* camera);
+
+/**
+ * Compute statistics over frame times
+ *
+ * @param frameTimesMs - Frame times in milliseconds
+ * @param count - Number of frame times
+ * @param outStats - Output statistics
+ */
+void computeFrameTimeStats(const double* frameTimesMs, uint32_t count, FrameTimeStats* outStats);
+
+/**
+ * Write the results as JSON and print a one-line summary
+ *
+ * @param benchmark - Finished benchmark run
+ * @param gpuProfiler - GPU scope timings to include (may be NULL)
+ * @param path - Output file, NULL writes to stdout
+ * @return 0 on success, -1 on failure
+ */
+int writeBenchmarkReport(
+    const Benchmark* benchmark,
+    const GpuProfiler* gpuProfiler,
+    const char* path
+);
+
+/**
+ * Free frame times and the camera path
+ *
+ * @param benchmark - Benchmark run
+ */
+void destroyBenchmark(Benchmark* benchmark);
+
+#endif // BENCHMARK_H
@@ -0,0 +1,142 @@
+#include "camera_path.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEG_PER_RAD (180.0f / 3.14159f)
+
+int loadCameraPath(const char* path, CameraPath* outPath) {
+    if (!path || !outPath) return -1;
+
+    memset(outPath, 0, sizeof(CameraPath));
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        printf("Failed to open camera path: %s\n", path);
+        return -1;
+    }
+
+    uint32_t capacity = 64;
+    CameraKeyframe* keyframes = malloc(sizeof(CameraKeyframe) * capacity);
+    uint32_t count = 0;
+    char line[256];
+    uint32_t lineNumber = 0;
+
+    while (keyframes && fgets(line, sizeof(line), file)) {
+        lineNumber++;
+        char* text = line;
+        while (*text == ' ' || *text == '\t') text++;
+        if (*text == '#' || *text == '\n' || *text == '\r' || *text == '\0') continue;
+
+        CameraKeyframe key;
+        if (sscanf(text, "%f %f %f %f %f %f", &key.time, &key.position.x, &key.position.y,
+                   &key.position.z, &key.yaw, &key.pitch) != 6) {
+            printf("Camera path %s:%u: expected \"time x y z yaw pitch\"\n", path, lineNumber);
+            free(keyframes);
+            fclose(file);
+            return -1;
+        }
+        if (count > 0 && key.time < keyframes[count - 1].time) {
+            printf("Camera path %s:%u: times must not decrease\n", path, lineNumber);
+            free(keyframes);
+            fclose(file);
+            return -1;
+        }
+
+        if (count == capacity) {
+            capacity *= 2;
+            CameraKeyframe* grown = realloc(keyframes, sizeof(CameraKeyframe) * capacity);
+            if (!grown) {
+                free(keyframes);
+                keyframes = NULL;
+                break;
+            }
+            keyframes = grown;
+        }
+        keyframes[count++] = key;
+    }
+    fclose(file);
+
+    if (!keyframes || count == 0) {
+        printf("Camera path %s has no keyframes\n", path);
+        free(keyframes);
+        return -1;
+    }
+
+    outPath->type = CAMERA_PATH_KEYFRAMES;
+    outPath->name = path;
+    outPath->keyframes = keyframes;
+    outPath->keyframeCount = count;
+    printf("Loaded camera path %s: %u keyframes, %.2f s\n", path, count, keyframes[count - 1].time);
+    return 0;
+}
+
+void createOrbitCameraPath(float radius, float height, float period, CameraPath* outPath) {
+    memset(outPath, 0, sizeof(CameraPath));
+    outPath->type = CAMERA_PATH_ORBIT;
+    outPath->name = "orbit";
+    outPath->radius = radius;
+    outPath->height = height;
+    outPath->period = period > 0.0f ? period : 10.0f;
+}
+
+// Interpolate yaw along the shorter arc; the interactive camera wraps it to [0, 360)
+static float lerpAngle(float a, float b, float t) {
+    float delta = fmodf(b - a, 360.0f);
+    if (delta > 180.0f) delta -= 360.0f;
+    if (delta < -180.0f) delta += 360.0f;
+    return a + delta * t;
+}
+
+void evaluateCameraPath(const CameraPath* path, float time, Camera* camera) {
+    if (!path || !camera) return;
+
+    if (path->type == CAMERA_PATH_ORBIT) {
+        float angle = 2.0f * 3.14159f * (time / path->period);
+        camera->position = vec3_create(path->radius * cosf(angle), path->height, path->radius * sinf(angle));
+        // Face the origin
+        camera->yaw = atan2f(-camera->position.z, -camera->position.x) * DEG_PER_RAD;
+        camera->pitch = atan2f(-path->height, path->radius) * DEG_PER_RAD;
+        return;
+    }
+
+    const CameraKeyframe* keys = path->keyframes;
+    uint32_t count = path->keyframeCount;
+    if (count == 0) return;
+
+    const CameraKeyframe* a = &keys[0];
+    const CameraKeyframe* b = &keys[0];
+    if (time <= keys[0].time) {
+        a = b = &keys[0];
+    } else if (time >= keys[count - 1].time) {
+        a = b = &keys[count - 1];
+    } else {
+        // Binary search for the segment containing time
+        uint32_t lo = 0, hi = count - 1;
+        while (hi - lo > 1) {
+            uint32_t mid = (lo + hi) / 2;
+            if (keys[mid].time <= time) lo = mid; else hi = mid;
+        }
+        a = &keys[lo];
+        b = &keys[hi];
+    }
+
+    float span = b->time - a->time;
+    float t = span > 0.0f ? (time - a->time) / span : 0.0f;
+    camera->position = vec3_add(a->position, vec3_mul(vec3_sub(b->position, a->position), t));
+    camera->yaw = lerpAngle(a->yaw, b->yaw, t);
+    camera->pitch = a->pitch + (b->pitch - a->pitch) * t;
+}
+
+void freeCameraPath(CameraPath* path) {
+    if (!path) return;
+    free(path->keyframes);
+    path->keyframes = NULL;
+    path->keyframeCount = 0;
+}
+
+void writeCameraPathSample(FILE* file, float time, const Camera* camera) {
+    if (!file || !camera) return;
+    fprintf(file, "%.4f %.5f %.5f %.5f %.4f %.4f\n", time,
+            camera->position.x, camera->position.y, camera->position.z,
+            camera->yaw, camera->pitch);
+}
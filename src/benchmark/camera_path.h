@@ -0,0 +1,85 @@
+#ifndef CAMERA_PATH_H
+#define CAMERA_PATH_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "../input/input.h"
+
+/**
+ * Camera pose at a point in time
+ */
+typedef struct {
+    float time;       // Seconds from the start of the path
+    vec3 position;
+    float yaw;        // Degrees, same convention as Camera
+    float pitch;
+} CameraKeyframe;
+
+typedef enum {
+    CAMERA_PATH_KEYFRAMES,   // Linear interpolation between recorded poses
+    CAMERA_PATH_ORBIT        // Procedural circle around the origin, looking at it
+} CameraPathType;
+
+/**
+ * Scripted camera motion, evaluated at simulated (not wall-clock) time
+ */
+typedef struct {
+    CameraPathType type;
+    const char* name;
+
+    // CAMERA_PATH_KEYFRAMES
+    CameraKeyframe* keyframes;
+    uint32_t keyframeCount;
+
+    // CAMERA_PATH_ORBIT
+    float radius;
+    float height;
+    float period;     // Seconds per revolution
+} CameraPath;
+
+/**
+ * Load a keyframe path from a text file
+ * One pose per line: "time x y z yaw pitch"; blank lines and lines starting with # are ignored.
+ *
+ * @param path - File path
+ * @param outPath - Output camera path
+ * @return 0 on success, -1 on failure
+ */
+int loadCameraPath(const char* path, CameraPath* outPath);
+
+/**
+ * Create a procedural orbit around the origin
+ *
+ * @param radius - Distance from the origin in the XZ plane
+ * @param height - Camera height
+ * @param period - Seconds per revolution
+ * @param outPath - Output camera path
+ */
+void createOrbitCameraPath(float radius, float height, float period, CameraPath* outPath);
+
+/**
+ * Pose the camera at time t (clamped to the ends of a keyframe path)
+ *
+ * @param path - Camera path
+ * @param time - Simulated seconds
+ * @param camera - Camera to update (speed and sensitivity are left alone)
+ */
+void evaluateCameraPath(const CameraPath* path, float time, Camera* camera);
+
+/**
+ * Free keyframes
+ *
+ * @param path - Camera path
+ */
+void freeCameraPath(CameraPath* path);
+
+/**
+ * Append the camera pose to a path file being recorded (same format loadCameraPath reads)
+ *
+ * @param file - Open output file
+ * @param time - Seconds since recording started
+ * @param camera - Camera to record
+ */
+void writeCameraPathSample(FILE* file, float time, const Camera* camera);
+
+#endif // CAMERA_PATH_H
@@ -20,4 +20,9 @@
 #define BACKGROUND_G 25
 #define BACKGROUND_B 112
 
+// Number of frames the CPU may record ahead of the GPU (override with -DMAX_FRAMES_IN_FLIGHT=N)
+#ifndef MAX_FRAMES_IN_FLIGHT
+#define MAX_FRAMES_IN_FLIGHT 2
+#endif
+
 #endif // COMMON_H
@@ -0,0 +1,367 @@
+#include "depth_pyramid.h"
+#include "../graphics_pipeline/shader_module.h"
+#include "../vulkan/vulkan_depth.h"
+#include <stdio.h>
+#include <string.h>
+
+// Bindings of shaders/depth_pyramid.comp
+#define DEPTH_PYRAMID_BINDING_SOURCE 0
+#define DEPTH_PYRAMID_BINDING_DESTINATION 1
+
+#define DEPTH_PYRAMID_FORMAT VK_FORMAT_R32_SFLOAT
+
+// Largest power of two not above size, so every level after 0 halves exactly
+static uint32_t previousPowerOfTwo(uint32_t size) {
+    uint32_t result = 1;
+    while (result * 2 <= size) {
+        result *= 2;
+    }
+    return result;
+}
+
+static VkResult createPyramidImage(VkDevice device, VkPhysicalDevice physicalDevice, DepthPyramid* pyramid) {
+    VkImageCreateInfo imageInfo = {0};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent.width = pyramid->width;
+    imageInfo.extent.height = pyramid->height;
+    imageInfo.extent.depth = 1;
+    imageInfo.mipLevels = pyramid->levelCount;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = DEPTH_PYRAMID_FORMAT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    VkResult result = vkCreateImage(device, &imageInfo, NULL, &pyramid->image);
+    if (result != VK_SUCCESS) return result;
+
+    VkMemoryRequirements memRequirements;
+    vkGetImageMemoryRequirements(device, pyramid->image, &memRequirements);
+    VkMemoryAllocateInfo allocInfo = {0};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memRequirements.size;
+    allocInfo.memoryTypeIndex = findMemoryType(physicalDevice, memRequirements.memoryTypeBits,
+                                               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    result = vkAllocateMemory(device, &allocInfo, NULL, &pyramid->memory);
+    if (result != VK_SUCCESS) return result;
+    result = vkBindImageMemory(device, pyramid->image, pyramid->memory, 0);
+    if (result != VK_SUCCESS) return result;
+
+    VkImageViewCreateInfo viewInfo = {0};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = pyramid->image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = DEPTH_PYRAMID_FORMAT;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.levelCount = pyramid->levelCount;
+    viewInfo.subresourceRange.layerCount = 1;
+    result = vkCreateImageView(device, &viewInfo, NULL, &pyramid->view);
+    for (uint32_t level = 0; result == VK_SUCCESS && level < pyramid->levelCount; level++) {
+        viewInfo.subresourceRange.baseMipLevel = level;
+        viewInfo.subresourceRange.levelCount = 1;
+        result = vkCreateImageView(device, &viewInfo, NULL, &pyramid->levelViews[level]);
+    }
+    if (result != VK_SUCCESS) return result;
+
+    VkSamplerCreateInfo samplerInfo = {0};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_NEAREST;
+    samplerInfo.minFilter = VK_FILTER_NEAREST;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.maxLod = (float)pyramid->levelCount;
+    return vkCreateSampler(device, &samplerInfo, NULL, &pyramid->sampler);
+}
+
+// Every level goes UNDEFINED -> GENERAL once; builds and the culling pass then keep it in GENERAL
+static void recordPyramidInitialLayout(VkCommandBuffer cmdBuffer, const DepthPyramid* pyramid) {
+    VkImageMemoryBarrier barrier = {0};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = pyramid->image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.levelCount = pyramid->levelCount;
+    barrier.subresourceRange.layerCount = 1;
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 0, NULL, 0, NULL, 1, &barrier);
+}
+
+static VkResult createPyramidPipeline(VkDevice device, PipelineCache* pipelineCache, DepthPyramid* pyramid) {
+    VkDescriptorSetLayoutBinding bindings[2] = {0};
+    bindings[0].binding = DEPTH_PYRAMID_BINDING_SOURCE;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    bindings[1].binding = DEPTH_PYRAMID_BINDING_DESTINATION;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo = {0};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = 2;
+    layoutInfo.pBindings = bindings;
+    VkResult result = vkCreateDescriptorSetLayout(device, &layoutInfo, NULL, &pyramid->setLayout);
+    if (result != VK_SUCCESS) return result;
+
+    VkPushConstantRange pushRange = {0};
+    pushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushRange.size = sizeof(DepthPyramidPushConstants);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo = {0};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &pyramid->setLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushRange;
+    result = vkCreatePipelineLayout(device, &pipelineLayoutInfo, NULL, &pyramid->pipelineLayout);
+    if (result != VK_SUCCESS) return result;
+
+    VkShaderModule shaderModule = VK_NULL_HANDLE;
+    result = createShaderModuleFromFile(device, DEPTH_PYRAMID_SHADER_PATH, &shaderModule);
+    if (result != VK_SUCCESS) {
+        printf("Failed to load compute shader: %s\n", DEPTH_PYRAMID_SHADER_PATH);
+        return result;
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo = {0};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = shaderModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = pyramid->pipelineLayout;
+
+    double compileStart = pipelineCacheTimestampMs();
+    result = vkCreateComputePipelines(
+        device,
+        pipelineCache ? pipelineCache->cache : VK_NULL_HANDLE,
+        1,
+        &pipelineInfo,
+        NULL,
+        &pyramid->pipeline
+    );
+    if (result == VK_SUCCESS && pipelineCache) {
+        recordPipelineCompile(pipelineCache, pipelineCacheTimestampMs() - compileStart);
+    }
+    destroyShaderModule(device, shaderModule);
+    return result;
+}
+
+// One set per level: level 0 reduces the depth buffer, every other level the one before it
+static VkResult createPyramidDescriptorSets(VkDevice device, VkImageView depthView, DepthPyramid* pyramid) {
+    VkDescriptorPoolSize poolSizes[2] = {
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, pyramid->levelCount},
+        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, pyramid->levelCount}
+    };
+    VkDescriptorPoolCreateInfo poolInfo = {0};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = 2;
+    poolInfo.pPoolSizes = poolSizes;
+    poolInfo.maxSets = pyramid->levelCount;
+    VkResult result = vkCreateDescriptorPool(device, &poolInfo, NULL, &pyramid->descriptorPool);
+    if (result != VK_SUCCESS) return result;
+
+    VkDescriptorSetLayout layouts[DEPTH_PYRAMID_MAX_LEVELS];
+    for (uint32_t level = 0; level < pyramid->levelCount; level++) {
+        layouts[level] = pyramid->setLayout;
+    }
+    VkDescriptorSetAllocateInfo allocInfo = {0};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = pyramid->descriptorPool;
+    allocInfo.descriptorSetCount = pyramid->levelCount;
+    allocInfo.pSetLayouts = layouts;
+    result = vkAllocateDescriptorSets(device, &allocInfo, pyramid->levelSets);
+    if (result != VK_SUCCESS) return result;
+
+    for (uint32_t level = 0; level < pyramid->levelCount; level++) {
+        VkDescriptorImageInfo source = {0};
+        source.sampler = pyramid->sampler;
+        source.imageView = level == 0 ? depthView : pyramid->levelViews[level - 1];
+        source.imageLayout = level == 0 ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_GENERAL;
+        VkDescriptorImageInfo destination = {0};
+        destination.imageView = pyramid->levelViews[level];
+        destination.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        VkWriteDescriptorSet writes[2] = {0};
+        writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[0].dstSet = pyramid->levelSets[level];
+        writes[0].dstBinding = DEPTH_PYRAMID_BINDING_SOURCE;
+        writes[0].descriptorCount = 1;
+        writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        writes[0].pImageInfo = &source;
+        writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[1].dstSet = pyramid->levelSets[level];
+        writes[1].dstBinding = DEPTH_PYRAMID_BINDING_DESTINATION;
+        writes[1].descriptorCount = 1;
+        writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        writes[1].pImageInfo = &destination;
+        vkUpdateDescriptorSets(device, 2, writes, 0, NULL);
+    }
+    return VK_SUCCESS;
+}
+
+VkResult createDepthPyramid(
+    UploadBatch* batch,
+    PipelineCache* pipelineCache,
+    VkImage depthImage,
+    VkImageView depthView,
+    VkFormat depthFormat,
+    VkExtent2D depthExtent,
+    DepthPyramid* outPyramid
+) {
+    if (!batch || !batch->recording || !outPyramid || depthImage == VK_NULL_HANDLE || depthView == VK_NULL_HANDLE ||
+        depthExtent.width == 0 || depthExtent.height == 0) {
+        printf("Depth pyramid creation failed: Invalid parameters\n");
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    memset(outPyramid, 0, sizeof(DepthPyramid));
+    outPyramid->width = previousPowerOfTwo(depthExtent.width);
+    outPyramid->height = previousPowerOfTwo(depthExtent.height);
+    uint32_t largest = outPyramid->width > outPyramid->height ? outPyramid->width : outPyramid->height;
+    while ((1u << outPyramid->levelCount) <= largest && outPyramid->levelCount < DEPTH_PYRAMID_MAX_LEVELS) {
+        outPyramid->levelCount++;
+    }
+    outPyramid->depthImage = depthImage;
+    outPyramid->depthExtent = depthExtent;
+    outPyramid->depthAspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+    if (depthFormat == VK_FORMAT_D32_SFLOAT_S8_UINT || depthFormat == VK_FORMAT_D24_UNORM_S8_UINT) {
+        outPyramid->depthAspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+    outPyramid->viewProj = mat4_identity();
+    printf("  Creating depth pyramid: %ux%u, %u levels\n", outPyramid->width, outPyramid->height,
+           outPyramid->levelCount);
+
+    VkDevice device = batch->device;
+    VkResult result = createPyramidImage(device, batch->physicalDevice, outPyramid);
+    if (result == VK_SUCCESS) {
+        recordPyramidInitialLayout(batch->commandBuffer, outPyramid);
+    }
+    if (result == VK_SUCCESS) {
+        result = createPyramidPipeline(device, pipelineCache, outPyramid);
+    }
+    if (result == VK_SUCCESS) {
+        result = createPyramidDescriptorSets(device, depthView, outPyramid);
+    }
+    if (result != VK_SUCCESS) {
+        printf("    Failed to create depth pyramid! Error: %d\n", result);
+        destroyDepthPyramid(device, outPyramid);
+        return result;
+    }
+    return VK_SUCCESS;
+}
+
+void recordDepthPyramidBuild(DepthPyramid* pyramid, VkCommandBuffer cmdBuffer, mat4 viewProj) {
+    if (!pyramid || !pyramid->pipeline) return;
+
+    // The pass's depth writes become readable; the pyramid may still be read by this frame's culling
+    VkImageMemoryBarrier barriers[2] = {0};
+    barriers[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barriers[0].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    barriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barriers[0].oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    barriers[0].newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+    barriers[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barriers[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barriers[0].image = pyramid->depthImage;
+    barriers[0].subresourceRange.aspectMask = pyramid->depthAspect;
+    barriers[0].subresourceRange.levelCount = 1;
+    barriers[0].subresourceRange.layerCount = 1;
+    barriers[1].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barriers[1].srcAccessMask = 0;
+    barriers[1].dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barriers[1].oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barriers[1].newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barriers[1].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barriers[1].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barriers[1].image = pyramid->image;
+    barriers[1].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barriers[1].subresourceRange.levelCount = pyramid->levelCount;
+    barriers[1].subresourceRange.layerCount = 1;
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, NULL, 0, NULL, 2, barriers);
+
+    vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pyramid->pipeline);
+
+    // Level 0 keeps the size ratio to the depth buffer (between 1 and 2), every later level halves
+    DepthPyramidPushConstants constants;
+    constants.sourceSize[0] = pyramid->depthExtent.width;
+    constants.sourceSize[1] = pyramid->depthExtent.height;
+    for (uint32_t level = 0; level < pyramid->levelCount; level++) {
+        uint32_t width = pyramid->width >> level;
+        uint32_t height = pyramid->height >> level;
+        constants.destinationSize[0] = width > 0 ? width : 1;
+        constants.destinationSize[1] = height > 0 ? height : 1;
+
+        vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pyramid->pipelineLayout,
+                                0, 1, &pyramid->levelSets[level], 0, NULL);
+        vkCmdPushConstants(cmdBuffer, pyramid->pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT,
+                           0, sizeof(DepthPyramidPushConstants), &constants);
+        vkCmdDispatch(cmdBuffer,
+                      (constants.destinationSize[0] + DEPTH_PYRAMID_WORKGROUP_SIZE - 1) / DEPTH_PYRAMID_WORKGROUP_SIZE,
+                      (constants.destinationSize[1] + DEPTH_PYRAMID_WORKGROUP_SIZE - 1) / DEPTH_PYRAMID_WORKGROUP_SIZE,
+                      1);
+
+        // The next level reads this one
+        VkMemoryBarrier levelBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+        levelBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        levelBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0, 1, &levelBarrier, 0, NULL, 0, NULL);
+        constants.sourceSize[0] = constants.destinationSize[0];
+        constants.sourceSize[1] = constants.destinationSize[1];
+    }
+
+    // The next frame's render pass clears the depth buffer only after the reduction has read it
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                         0, 0, NULL, 0, NULL, 0, NULL);
+
+    pyramid->viewProj = viewProj;
+    pyramid->built = true;
+}
+
+void destroyDepthPyramid(VkDevice device, DepthPyramid* pyramid) {
+    if (!device || !pyramid) return;
+
+    if (pyramid->pipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(device, pyramid->pipeline, NULL);
+    }
+    if (pyramid->pipelineLayout != VK_NULL_HANDLE) {
+        vkDestroyPipelineLayout(device, pyramid->pipelineLayout, NULL);
+    }
+    if (pyramid->descriptorPool != VK_NULL_HANDLE) {
+        vkDestroyDescriptorPool(device, pyramid->descriptorPool, NULL);
+    }
+    if (pyramid->setLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(device, pyramid->setLayout, NULL);
+    }
+    if (pyramid->sampler != VK_NULL_HANDLE) {
+        vkDestroySampler(device, pyramid->sampler, NULL);
+    }
+    for (uint32_t level = 0; level < DEPTH_PYRAMID_MAX_LEVELS; level++) {
+        if (pyramid->levelViews[level] != VK_NULL_HANDLE) {
+            vkDestroyImageView(device, pyramid->levelViews[level], NULL);
+        }
+    }
+    if (pyramid->view != VK_NULL_HANDLE) {
+        vkDestroyImageView(device, pyramid->view, NULL);
+    }
+    if (pyramid->image != VK_NULL_HANDLE) {
+        vkDestroyImage(device, pyramid->image, NULL);
+    }
+    if (pyramid->memory != VK_NULL_HANDLE) {
+        vkFreeMemory(device, pyramid->memory, NULL);
+    }
+    memset(pyramid, 0, sizeof(DepthPyramid));
+}
@@ -0,0 +1,101 @@
+#ifndef DEPTH_PYRAMID_H
+#define DEPTH_PYRAMID_H
+
+#include <vulkan/vulkan.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "../graphics_pipeline/pipeline_cache.h"
+#include "../graphics_pipeline/buffer.h"
+#include "../math/matrix.h"
+
+// Invocations per workgroup side of shaders/depth_pyramid.comp (local_size_x/y)
+#define DEPTH_PYRAMID_WORKGROUP_SIZE 8
+
+// Enough levels for a 32768 texel wide level 0
+#define DEPTH_PYRAMID_MAX_LEVELS 16
+
+#define DEPTH_PYRAMID_SHADER_PATH "shaders/depth_pyramid.comp.spv"
+
+/**
+ * Push constants of shaders/depth_pyramid.comp (16 bytes)
+ */
+typedef struct {
+    uint32_t sourceSize[2];
+    uint32_t destinationSize[2];
+} DepthPyramidPushConstants;
+
+/**
+ * Hierarchical-Z pyramid of a depth buffer
+ * Level 0 is the largest power of two that fits the depth buffer and every
+ * texel holds the farthest depth it covers, so a box whose nearest depth is
+ * beyond a texel is hidden behind what was drawn there.
+ */
+typedef struct {
+    VkImage image;                    // R32_SFLOAT, always in GENERAL layout
+    VkDeviceMemory memory;
+    VkImageView view;                 // Every level, sampled by the culling pass
+    VkImageView levelViews[DEPTH_PYRAMID_MAX_LEVELS];  // One level each, written as storage images
+    VkSampler sampler;                // Nearest; the shaders only use texelFetch
+    uint32_t width;
+    uint32_t height;
+    uint32_t levelCount;
+
+    VkImage depthImage;               // Source of level 0, owned by the caller
+    VkExtent2D depthExtent;
+    VkImageAspectFlags depthAspect;   // Aspects transitioned with the depth image
+
+    VkDescriptorSetLayout setLayout;
+    VkDescriptorPool descriptorPool;
+    VkDescriptorSet levelSets[DEPTH_PYRAMID_MAX_LEVELS];  // Previous level (or depth) in, this level out
+    VkPipelineLayout pipelineLayout;
+    VkPipeline pipeline;
+
+    mat4 viewProj;                    // Camera the pyramid was last built from
+    bool built;                       // False until the first build is recorded
+} DepthPyramid;
+
+/**
+ * Create a depth pyramid reduced from a depth image
+ * The depth image needs VK_IMAGE_USAGE_SAMPLED_BIT and must be stored by the render pass.
+ * The pyramid image is moved to GENERAL by the batch, so it can be bound for sampling
+ * before the first build (or without any build when occlusion culling is off).
+ *
+ * @param batch - Upload batch in the recording state; the pyramid is usable once it is submitted
+ * @param pipelineCache - Pipeline cache for the compute pipeline, may be NULL
+ * @param depthImage - Depth image, transitioned for sampling by each build
+ * @param depthView - Depth-aspect view of depthImage
+ * @param depthFormat - Format of depthImage
+ * @param depthExtent - Size of depthImage
+ * @param outPyramid - Output pyramid
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult createDepthPyramid(
+    UploadBatch* batch,
+    PipelineCache* pipelineCache,
+    VkImage depthImage,
+    VkImageView depthView,
+    VkFormat depthFormat,
+    VkExtent2D depthExtent,
+    DepthPyramid* outPyramid
+);
+
+/**
+ * Record the reduction of the depth buffer into every level (after the render pass)
+ * The depth image must be in DEPTH_STENCIL_ATTACHMENT_OPTIMAL; it is left in
+ * DEPTH_STENCIL_READ_ONLY_OPTIMAL, which the next render pass discards.
+ *
+ * @param pyramid - Depth pyramid
+ * @param cmdBuffer - Command buffer in the recording state
+ * @param viewProj - Camera the depth buffer was rendered with
+ */
+void recordDepthPyramidBuild(DepthPyramid* pyramid, VkCommandBuffer cmdBuffer, mat4 viewProj);
+
+/**
+ * Destroy the pyramid's image, views and pipeline
+ *
+ * @param device - VkDevice handle
+ * @param pyramid - Pyramid to destroy
+ */
+void destroyDepthPyramid(VkDevice device, DepthPyramid* pyramid);
+
+#endif // DEPTH_PYRAMID_H
@@ -0,0 +1,401 @@
+#include "gpu_culling.h"
+#include "../graphics_pipeline/shader_module.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Bindings of shaders/cull.comp
+#define GPU_CULL_BINDING_INSTANCES 0
+#define GPU_CULL_BINDING_BOUNDS 1
+#define GPU_CULL_BINDING_VISIBLE 2
+#define GPU_CULL_BINDING_COMMANDS 3
+#define GPU_CULL_BINDING_UNIFORMS 4
+#define GPU_CULL_BINDING_DEPTH_PYRAMID 5
+#define GPU_CULL_BINDING_COUNT 6
+
+// Counters and commands of one frame slot
+static VkDeviceSize commandsSize(uint32_t drawCount) {
+    return sizeof(GpuCullCounters) + sizeof(VkDrawIndexedIndirectCommand) * drawCount;
+}
+
+static VkResult createCullBuffer(UploadBatch* batch, VkDeviceSize size, VkBufferUsageFlags usage, Buffer* outBuffer) {
+    BufferCreateInfo info = {0};
+    info.size = size;
+    info.usage = usage;
+    info.properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    info.allocator = batch->allocator;
+    return createBuffer(batch->device, batch->physicalDevice, &info, outBuffer);
+}
+
+// Stage the instances and their bounds into device-local storage buffers
+static VkResult uploadCullInputs(UploadBatch* batch, const GpuCullerCreateInfo* createInfo, GpuCuller* culler) {
+    uint32_t count = createInfo->instanceCount;
+    VkResult result = createCullBuffer(batch, (VkDeviceSize)count * sizeof(InstanceData),
+                                       VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                       &culler->instanceBuffer);
+    if (result == VK_SUCCESS) {
+        result = createCullBuffer(batch, (VkDeviceSize)count * sizeof(GpuCullBounds),
+                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                  &culler->boundsBuffer);
+    }
+    if (result == VK_SUCCESS) {
+        result = createCullBuffer(batch, (VkDeviceSize)count * sizeof(InstanceData),
+                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                  &culler->visibleBuffer);
+    }
+    if (result != VK_SUCCESS) return result;
+
+    result = stageBufferUpload(batch, &culler->instanceBuffer, createInfo->instances,
+                               (VkDeviceSize)count * sizeof(InstanceData), 0);
+    if (result != VK_SUCCESS) return result;
+
+    GpuCullBounds* bounds = malloc(sizeof(GpuCullBounds) * count);
+    if (!bounds) return VK_ERROR_OUT_OF_HOST_MEMORY;
+    AabbSoA soa = createInfo->bounds;
+    for (uint32_t i = 0; i < count; i++) {
+        bounds[i].boundsMin[0] = soa.minX[i];
+        bounds[i].boundsMin[1] = soa.minY[i];
+        bounds[i].boundsMin[2] = soa.minZ[i];
+        bounds[i].drawIndex = createInfo->drawIndices ? createInfo->drawIndices[i] : 0;
+        bounds[i].boundsMax[0] = soa.maxX[i];
+        bounds[i].boundsMax[1] = soa.maxY[i];
+        bounds[i].boundsMax[2] = soa.maxZ[i];
+        bounds[i]._pad = 0;
+    }
+    result = stageBufferUpload(batch, &culler->boundsBuffer, bounds, (VkDeviceSize)count * sizeof(GpuCullBounds), 0);
+    free(bounds);
+    return result;
+}
+
+// Commands with no instances yet; each draw's compacted instances start after the previous draw's
+static VkResult buildCommandTemplate(const GpuCullerCreateInfo* createInfo, GpuCuller* culler) {
+    culler->commandTemplate = calloc(createInfo->drawCount, sizeof(VkDrawIndexedIndirectCommand));
+    if (!culler->commandTemplate) return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+    uint32_t* drawSizes = calloc(createInfo->drawCount, sizeof(uint32_t));
+    if (!drawSizes) return VK_ERROR_OUT_OF_HOST_MEMORY;
+    for (uint32_t i = 0; i < createInfo->instanceCount; i++) {
+        uint32_t draw = createInfo->drawIndices ? createInfo->drawIndices[i] : 0;
+        if (draw >= createInfo->drawCount) {
+            printf("GPU culler creation failed: instance %u uses draw %u of %u\n", i, draw, createInfo->drawCount);
+            free(drawSizes);
+            return VK_ERROR_INITIALIZATION_FAILED;
+        }
+        drawSizes[draw]++;
+    }
+
+    uint32_t firstInstance = 0;
+    for (uint32_t d = 0; d < createInfo->drawCount; d++) {
+        VkDrawIndexedIndirectCommand* command = &culler->commandTemplate[d];
+        command->indexCount = createInfo->draws[d].indexCount;
+        command->instanceCount = 0;
+        command->firstIndex = createInfo->draws[d].firstIndex;
+        command->vertexOffset = createInfo->draws[d].vertexOffset;
+        command->firstInstance = firstInstance;
+        firstInstance += drawSizes[d];
+    }
+    free(drawSizes);
+    return VK_SUCCESS;
+}
+
+static VkResult createCullPipeline(VkDevice device, PipelineCache* pipelineCache, GpuCuller* culler) {
+    VkDescriptorSetLayoutBinding bindings[GPU_CULL_BINDING_COUNT] = {0};
+    for (uint32_t i = 0; i < GPU_CULL_BINDING_COUNT; i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    // The commands and uniforms move with the frame slot, like the uniform ring
+    bindings[GPU_CULL_BINDING_COMMANDS].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    bindings[GPU_CULL_BINDING_UNIFORMS].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    bindings[GPU_CULL_BINDING_DEPTH_PYRAMID].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo = {0};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = GPU_CULL_BINDING_COUNT;
+    layoutInfo.pBindings = bindings;
+    VkResult result = vkCreateDescriptorSetLayout(device, &layoutInfo, NULL, &culler->setLayout);
+    if (result != VK_SUCCESS) return result;
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo = {0};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &culler->setLayout;
+    result = vkCreatePipelineLayout(device, &pipelineLayoutInfo, NULL, &culler->pipelineLayout);
+    if (result != VK_SUCCESS) return result;
+
+    VkShaderModule shaderModule = VK_NULL_HANDLE;
+    result = createShaderModuleFromFile(device, GPU_CULL_SHADER_PATH, &shaderModule);
+    if (result != VK_SUCCESS) {
+        printf("Failed to load compute shader: %s\n", GPU_CULL_SHADER_PATH);
+        return result;
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo = {0};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = shaderModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = culler->pipelineLayout;
+
+    double compileStart = pipelineCacheTimestampMs();
+    result = vkCreateComputePipelines(
+        device,
+        pipelineCache ? pipelineCache->cache : VK_NULL_HANDLE,
+        1,
+        &pipelineInfo,
+        NULL,
+        &culler->pipeline
+    );
+    if (result == VK_SUCCESS && pipelineCache) {
+        recordPipelineCompile(pipelineCache, pipelineCacheTimestampMs() - compileStart);
+    }
+    destroyShaderModule(device, shaderModule);
+    return result;
+}
+
+static VkResult createCullDescriptorSet(VkDevice device, GpuCuller* culler) {
+    VkDescriptorPoolSize poolSizes[4] = {
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1},
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1}
+    };
+    VkDescriptorPoolCreateInfo poolInfo = {0};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = 4;
+    poolInfo.pPoolSizes = poolSizes;
+    poolInfo.maxSets = 1;
+    VkResult result = vkCreateDescriptorPool(device, &poolInfo, NULL, &culler->descriptorPool);
+    if (result != VK_SUCCESS) return result;
+
+    VkDescriptorSetAllocateInfo allocInfo = {0};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = culler->descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &culler->setLayout;
+    result = vkAllocateDescriptorSets(device, &allocInfo, &culler->descriptorSet);
+    if (result != VK_SUCCESS) return result;
+
+    // The depth pyramid is written later by setGpuCullOccluder
+    VkDescriptorBufferInfo bufferInfos[GPU_CULL_BINDING_DEPTH_PYRAMID] = {
+        {culler->instanceBuffer.buffer, 0, VK_WHOLE_SIZE},
+        {culler->boundsBuffer.buffer, 0, VK_WHOLE_SIZE},
+        {culler->visibleBuffer.buffer, 0, VK_WHOLE_SIZE},
+        // One slot's counters and commands wide, slid by the dynamic offset
+        {culler->indirectRing.buffer.buffer, 0, commandsSize(culler->drawCount)},
+        {culler->indirectRing.buffer.buffer, 0, sizeof(GpuCullUniforms)}
+    };
+    VkWriteDescriptorSet writes[GPU_CULL_BINDING_DEPTH_PYRAMID] = {0};
+    for (uint32_t i = 0; i < GPU_CULL_BINDING_DEPTH_PYRAMID; i++) {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = culler->descriptorSet;
+        writes[i].dstBinding = i;
+        writes[i].descriptorCount = 1;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].pBufferInfo = &bufferInfos[i];
+    }
+    writes[GPU_CULL_BINDING_COMMANDS].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    writes[GPU_CULL_BINDING_UNIFORMS].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    vkUpdateDescriptorSets(device, GPU_CULL_BINDING_DEPTH_PYRAMID, writes, 0, NULL);
+    return VK_SUCCESS;
+}
+
+VkResult createGpuCuller(
+    UploadBatch* batch,
+    const GpuCullerCreateInfo* createInfo,
+    GpuCuller* outCuller
+) {
+    if (!batch || !createInfo || !outCuller || !createInfo->instances || createInfo->instanceCount == 0 ||
+        !createInfo->draws || createInfo->drawCount == 0 || createInfo->sliceCount == 0) {
+        printf("GPU culler creation failed: Invalid parameters\n");
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+    if (createInfo->drawCount > 1 && !createInfo->drawIndirectFirstInstance) {
+        printf("GPU culler creation failed: %u draws need drawIndirectFirstInstance\n", createInfo->drawCount);
+        return VK_ERROR_FEATURE_NOT_PRESENT;
+    }
+
+    memset(outCuller, 0, sizeof(GpuCuller));
+    outCuller->instanceCount = createInfo->instanceCount;
+    outCuller->drawCount = createInfo->drawCount;
+    outCuller->multiDrawIndirect = createInfo->multiDrawIndirect;
+    printf("  Creating GPU culler: %u instances, %u indirect draws (%s)\n", createInfo->instanceCount,
+           createInfo->drawCount, createInfo->multiDrawIndirect ? "multi-draw" : "one call per draw");
+
+    VkDevice device = batch->device;
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(batch->physicalDevice, &props);
+
+    VkResult result = buildCommandTemplate(createInfo, outCuller);
+    if (result == VK_SUCCESS) {
+        result = uploadCullInputs(batch, createInfo, outCuller);
+    }
+    if (result == VK_SUCCESS) {
+        // Host-visible so the CPU resets the commands each frame and reads the counts back
+        VkDeviceSize alignment = props.limits.minStorageBufferOffsetAlignment;
+        if (props.limits.minUniformBufferOffsetAlignment > alignment) {
+            alignment = props.limits.minUniformBufferOffsetAlignment;
+        }
+        VkDeviceSize alignedCommandsSize = (commandsSize(createInfo->drawCount) + alignment - 1) & ~(alignment - 1);
+        result = createBufferRing(
+            device,
+            batch->physicalDevice,
+            batch->allocator,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+            alignment,
+            alignedCommandsSize + sizeof(GpuCullUniforms),
+            createInfo->sliceCount,
+            &outCuller->indirectRing
+        );
+    }
+    // Every slot starts out reset, so the first read back of each sees zero instances
+    for (uint32_t slot = 0; result == VK_SUCCESS && slot < createInfo->sliceCount; slot++) {
+        result = beginGpuCullFrame(outCuller, slot);
+    }
+    if (result == VK_SUCCESS) {
+        result = createCullPipeline(device, createInfo->pipelineCache, outCuller);
+    }
+    if (result == VK_SUCCESS) {
+        result = createCullDescriptorSet(device, outCuller);
+    }
+    if (result != VK_SUCCESS) {
+        printf("    Failed to create GPU culler! Error: %d\n", result);
+        destroyGpuCuller(device, outCuller);
+        return result;
+    }
+
+    outCuller->lastVisibleCount = 0;
+    outCuller->lastOccludedCount = 0;
+    return VK_SUCCESS;
+}
+
+void setGpuCullOccluder(VkDevice device, GpuCuller* culler, const DepthPyramid* pyramid) {
+    if (!device || !culler || !culler->descriptorSet || !pyramid) return;
+
+    VkDescriptorImageInfo imageInfo = {0};
+    imageInfo.sampler = pyramid->sampler;
+    imageInfo.imageView = pyramid->view;
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    VkWriteDescriptorSet write = {0};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = culler->descriptorSet;
+    write.dstBinding = GPU_CULL_BINDING_DEPTH_PYRAMID;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.pImageInfo = &imageInfo;
+    vkUpdateDescriptorSets(device, 1, &write, 0, NULL);
+}
+
+VkResult beginGpuCullFrame(GpuCuller* culler, uint32_t slot) {
+    if (!culler) return VK_ERROR_INITIALIZATION_FAILED;
+
+    beginBufferRingFrame(&culler->indirectRing, slot);
+    RingAllocation commandsAllocation;
+    RingAllocation uniformAllocation;
+    VkDeviceSize size = commandsSize(culler->drawCount);
+    VkResult result = allocateFromBufferRing(&culler->indirectRing, size, &commandsAllocation);
+    if (result == VK_SUCCESS) {
+        result = allocateFromBufferRing(&culler->indirectRing, sizeof(GpuCullUniforms), &uniformAllocation);
+    }
+    if (result != VK_SUCCESS) return result;
+
+    // The slot's fence has signalled, so the counts its last frame produced are final
+    GpuCullCounters* counters = commandsAllocation.data;
+    VkDrawIndexedIndirectCommand* commands = (VkDrawIndexedIndirectCommand*)(counters + 1);
+    uint32_t visible = 0;
+    for (uint32_t d = 0; d < culler->drawCount; d++) {
+        visible += commands[d].instanceCount;
+    }
+    culler->lastVisibleCount = visible;
+    culler->lastOccludedCount = counters->occludedCount;
+
+    memset(counters, 0, sizeof(GpuCullCounters));
+    memcpy(commands, culler->commandTemplate, sizeof(VkDrawIndexedIndirectCommand) * culler->drawCount);
+    culler->countersOffset = commandsAllocation.offset;
+    culler->indirectOffset = commandsAllocation.offset + sizeof(GpuCullCounters);
+    culler->uniformOffset = uniformAllocation.offset;
+    culler->uniforms = uniformAllocation.data;
+    return VK_SUCCESS;
+}
+
+void recordGpuCull(GpuCuller* culler, VkCommandBuffer cmdBuffer, const Frustum* frustum, const DepthPyramid* occluder) {
+    if (!culler || !culler->pipeline || !culler->uniforms || !frustum) return;
+
+    // The previous frame's draws may still read the compacted instances this dispatch overwrites
+    VkMemoryBarrier readBeforeWrite = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 1, &readBeforeWrite, 0, NULL, 0, NULL);
+
+    // Occlusion is tested against the camera of the frame that built the pyramid, so objects
+    // uncovered by this frame's camera motion show up one frame late
+    GpuCullUniforms* uniforms = culler->uniforms;
+    memcpy(uniforms->planes, frustum->planes, sizeof(uniforms->planes));
+    uniforms->instanceCount = culler->instanceCount;
+    uniforms->occlusionEnabled = occluder && occluder->built ? 1 : 0;
+    if (uniforms->occlusionEnabled) {
+        uniforms->occlusionViewProj = occluder->viewProj;
+        uniforms->pyramidSize[0] = (float)occluder->width;
+        uniforms->pyramidSize[1] = (float)occluder->height;
+    }
+
+    // Dynamic offsets follow binding order: commands, then uniforms
+    uint32_t dynamicOffsets[2] = {(uint32_t)culler->countersOffset, (uint32_t)culler->uniformOffset};
+    vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, culler->pipeline);
+    vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, culler->pipelineLayout,
+                            0, 1, &culler->descriptorSet, 2, dynamicOffsets);
+    vkCmdDispatch(cmdBuffer, (culler->instanceCount + GPU_CULL_WORKGROUP_SIZE - 1) / GPU_CULL_WORKGROUP_SIZE, 1, 1);
+
+    // Commands and instances feed the draws; the counts are also read back by the host
+    VkMemoryBarrier writeBeforeRead = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+    writeBeforeRead.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    writeBeforeRead.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT |
+                                    VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+                         0, 1, &writeBeforeRead, 0, NULL, 0, NULL);
+}
+
+void cmdDrawGpuCulled(const GpuCuller* culler, VkCommandBuffer cmdBuffer) {
+    if (!culler || !culler->pipeline) return;
+
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(cmdBuffer, INSTANCE_BINDING, 1, &culler->visibleBuffer.buffer, &offset);
+
+    VkBuffer indirectBuffer = culler->indirectRing.buffer.buffer;
+    uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+    if (culler->multiDrawIndirect) {
+        vkCmdDrawIndexedIndirect(cmdBuffer, indirectBuffer, culler->indirectOffset, culler->drawCount, stride);
+    } else {
+        // Without multiDrawIndirect every call is limited to a single command
+        for (uint32_t d = 0; d < culler->drawCount; d++) {
+            vkCmdDrawIndexedIndirect(cmdBuffer, indirectBuffer, culler->indirectOffset + (VkDeviceSize)d * stride, 1, stride);
+        }
+    }
+}
+
+void destroyGpuCuller(VkDevice device, GpuCuller* culler) {
+    if (!device || !culler) return;
+
+    if (culler->pipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(device, culler->pipeline, NULL);
+    }
+    if (culler->pipelineLayout != VK_NULL_HANDLE) {
+        vkDestroyPipelineLayout(device, culler->pipelineLayout, NULL);
+    }
+    if (culler->descriptorPool != VK_NULL_HANDLE) {
+        vkDestroyDescriptorPool(device, culler->descriptorPool, NULL);
+    }
+    if (culler->setLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(device, culler->setLayout, NULL);
+    }
+    destroyBufferRing(device, &culler->indirectRing);
+    destroyBuffer(device, &culler->visibleBuffer);
+    destroyBuffer(device, &culler->boundsBuffer);
+    destroyBuffer(device, &culler->instanceBuffer);
+    free(culler->commandTemplate);
+    memset(culler, 0, sizeof(GpuCuller));
+}
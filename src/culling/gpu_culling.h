@@ -0,0 +1,171 @@
+#ifndef GPU_CULLING_H
+#define GPU_CULLING_H
+
+#include <vulkan/vulkan.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "../graphics_pipeline/buffer.h"
+#include "../graphics_pipeline/pipeline_cache.h"
+#include "../vertex_buffer/instance_buffer.h"
+#include "../math/frustum.h"
+#include "../math/transform_batch.h"
+#include "depth_pyramid.h"
+
+// Invocations per workgroup of shaders/cull.comp (local_size_x)
+#define GPU_CULL_WORKGROUP_SIZE 64
+
+#define GPU_CULL_SHADER_PATH "shaders/cull.comp.spv"
+
+/**
+ * Per-instance bounds read by shaders/cull.comp (32 bytes, std430)
+ */
+typedef struct {
+    float boundsMin[3];
+    uint32_t drawIndex;       // Indirect command the instance is counted into
+    float boundsMax[3];
+    uint32_t _pad;
+} GpuCullBounds;
+
+/**
+ * Uniforms of shaders/cull.comp, written per frame slot (176 bytes, std140)
+ */
+typedef struct {
+    float planes[FRUSTUM_PLANE_COUNT][4];
+    mat4 occlusionViewProj;           // Camera the depth pyramid was built from
+    float pyramidSize[2];             // Level 0 size in texels
+    uint32_t instanceCount;
+    uint32_t occlusionEnabled;        // 0 skips the depth pyramid test
+} GpuCullUniforms;
+
+/**
+ * Counters ahead of the indirect commands in each frame slot (16 bytes, std430)
+ */
+typedef struct {
+    uint32_t occludedCount;           // Instances inside the frustum but behind the depth pyramid
+    uint32_t _pad[3];
+} GpuCullCounters;
+
+/**
+ * Mesh range drawn by one indirect command
+ * Every draw reads the same vertex and index buffers, bound by the caller.
+ */
+typedef struct {
+    uint32_t indexCount;
+    uint32_t firstIndex;
+    int32_t vertexOffset;
+} GpuCullDraw;
+
+/**
+ * Inputs of createGpuCuller
+ */
+typedef struct {
+    const InstanceData* instances;
+    AabbSoA bounds;                   // World bounds of each instance
+    const uint32_t* drawIndices;      // Draw of each instance, NULL puts every instance in draw 0
+    uint32_t instanceCount;
+    const GpuCullDraw* draws;
+    uint32_t drawCount;
+    uint32_t sliceCount;              // Frame slots; each has its own indirect commands
+    bool multiDrawIndirect;           // Device feature enabled: all draws go out in one call
+    bool drawIndirectFirstInstance;   // Device feature enabled: required for more than one draw
+    PipelineCache* pipelineCache;     // May be NULL
+} GpuCullerCreateInfo;
+
+/**
+ * Frustum and occlusion culling on the GPU feeding indirect draws
+ * A compute pass tests every instance's bounds against the frustum and the
+ * previous frame's depth pyramid, appends the visible ones to a compacted
+ * instance buffer and counts them into their draw's VkDrawIndexedIndirectCommand,
+ * so the CPU never touches individual instances.
+ */
+typedef struct {
+    // Uploaded once
+    Buffer instanceBuffer;            // InstanceData per instance
+    Buffer boundsBuffer;              // GpuCullBounds per instance
+
+    // Written by the compute pass every frame
+    Buffer visibleBuffer;             // Compacted visible instances, bound as the instance vertex buffer
+    BufferRing indirectRing;          // Per frame slot: counters, drawCount commands, then the uniforms
+    VkDrawIndexedIndirectCommand* commandTemplate;  // Commands with instanceCount 0, copied in each frame
+    VkDeviceSize countersOffset;      // This frame's counters in indirectRing
+    VkDeviceSize indirectOffset;      // This frame's commands, right after the counters
+    VkDeviceSize uniformOffset;       // This frame's uniforms
+    GpuCullUniforms* uniforms;        // Mapped pointer to them
+
+    uint32_t instanceCount;
+    uint32_t drawCount;
+    bool multiDrawIndirect;
+    uint32_t lastVisibleCount;        // Visible instances of the slot's previous frame, read back on reuse
+    uint32_t lastOccludedCount;       // Occluded instances of the same frame
+
+    VkDescriptorSetLayout setLayout;
+    VkDescriptorPool descriptorPool;
+    VkDescriptorSet descriptorSet;
+    VkPipelineLayout pipelineLayout;
+    VkPipeline pipeline;
+} GpuCuller;
+
+/**
+ * Create the culling buffers and compute pipeline, staging the static instance data
+ * The data is on the GPU once the batch has been submitted. Set an occluder
+ * with setGpuCullOccluder before recording the first cull.
+ *
+ * @param batch - Recording upload batch (its device and allocator create the resources)
+ * @param createInfo - Instances, draws and device features
+ * @param outCuller - Output culler
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult createGpuCuller(
+    UploadBatch* batch,
+    const GpuCullerCreateInfo* createInfo,
+    GpuCuller* outCuller
+);
+
+/**
+ * Point the occlusion test at a depth pyramid
+ * Call after creation and whenever the pyramid is recreated, while no cull is in flight.
+ *
+ * @param device - VkDevice handle
+ * @param culler - GPU culler
+ * @param pyramid - Depth pyramid sampled by the culling pass
+ */
+void setGpuCullOccluder(VkDevice device, GpuCuller* culler, const DepthPyramid* pyramid);
+
+/**
+ * Switch to a frame slot: read back its last visible and occluded counts, then reset its commands
+ * Call once the slot's previous submission has completed.
+ *
+ * @param culler - GPU culler
+ * @param slot - Frame slot index
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult beginGpuCullFrame(GpuCuller* culler, uint32_t slot);
+
+/**
+ * Record the culling dispatch and the barriers around it (outside a render pass)
+ *
+ * @param culler - GPU culler
+ * @param cmdBuffer - Command buffer in the recording state
+ * @param frustum - World-space frustum
+ * @param occluder - Depth pyramid built by an earlier frame, NULL (or not yet built) culls by frustum only
+ */
+void recordGpuCull(GpuCuller* culler, VkCommandBuffer cmdBuffer, const Frustum* frustum, const DepthPyramid* occluder);
+
+/**
+ * Draw the instances that survived culling
+ * The mesh vertex/index buffers and an instanced pipeline must already be bound.
+ *
+ * @param culler - GPU culler
+ * @param cmdBuffer - Command buffer inside a render pass
+ */
+void cmdDrawGpuCulled(const GpuCuller* culler, VkCommandBuffer cmdBuffer);
+
+/**
+ * Destroy the culler's buffers and pipeline
+ *
+ * @param device - VkDevice handle
+ * @param culler - Culler to destroy
+ */
+void destroyGpuCuller(VkDevice device, GpuCuller* culler);
+
+#endif // GPU_CULLING_H
@@ -1,5 +1,6 @@
 #include "buffer.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 static uint32_t findMemoryType(
@@ -61,6 +62,32 @@ VkResult createBuffer(
     printf("      Required size: %llu bytes\n", (unsigned long long)memRequirements.size);
     printf("      Alignment: %llu bytes\n", (unsigned long long)memRequirements.alignment);
 
+    // Sub-allocate from a shared block when an allocator is provided
+    if (createInfo->allocator) {
+        result = gpuAllocate(createInfo->allocator, &memRequirements, createInfo->properties, &outBuffer->allocation);
+        if (result != VK_SUCCESS) {
+            printf("    Failed to sub-allocate buffer memory! Error: %d\n", result);
+            vkDestroyBuffer(device, outBuffer->buffer, NULL);
+            outBuffer->buffer = VK_NULL_HANDLE;
+            return result;
+        }
+        outBuffer->memory = outBuffer->allocation.memory;
+        printf("    Sub-allocated: block %p + %llu\n",
+               (void*)outBuffer->memory, (unsigned long long)outBuffer->allocation.offset);
+
+        result = vkBindBufferMemory(device, outBuffer->buffer, outBuffer->memory, outBuffer->allocation.offset);
+        if (result != VK_SUCCESS) {
+            printf("    Failed to bind buffer memory! Error: %d\n", result);
+            gpuFree(&outBuffer->allocation);
+            vkDestroyBuffer(device, outBuffer->buffer, NULL);
+            outBuffer->buffer = VK_NULL_HANDLE;
+            outBuffer->memory = VK_NULL_HANDLE;
+            return result;
+        }
+        printf("    Buffer successfully bound to memory\n");
+        return VK_SUCCESS;
+    }
+
     // Allocate memory
     VkMemoryAllocateInfo allocInfo = {0};
     allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
@@ -117,6 +144,16 @@ VkResult updateBuffer(
         return VK_ERROR_INITIALIZATION_FAILED;
     }
 
+    // Sub-allocated host-visible memory is already mapped by its block
+    if (buffer->allocation.block) {
+        if (!buffer->allocation.mapped) {
+            printf("Buffer update failed: Memory is not host-visible\n");
+            return VK_ERROR_MEMORY_MAP_FAILED;
+        }
+        memcpy((char*)buffer->allocation.mapped + offset, data, size);
+        return VK_SUCCESS;
+    }
+
     void* mappedData = NULL;
     VkResult result = vkMapMemory(device, buffer->memory, offset, size, 0, &mappedData);
     if (result != VK_SUCCESS) {
@@ -144,6 +181,15 @@ VkResult mapBuffer(
         return VK_SUCCESS;
     }
 
+    if (buffer->allocation.block) {
+        if (!buffer->allocation.mapped) {
+            return VK_ERROR_MEMORY_MAP_FAILED;
+        }
+        buffer->mapped = buffer->allocation.mapped;
+        *outMappedData = buffer->mapped;
+        return VK_SUCCESS;
+    }
+
     VkResult result = vkMapMemory(device, buffer->memory, 0, buffer->size, 0, &buffer->mapped);
     if (result == VK_SUCCESS) {
         *outMappedData = buffer->mapped;
@@ -157,12 +203,30 @@ void unmapBuffer(
     Buffer* buffer
 ) {
     if (device && buffer && buffer->mapped) {
-        vkUnmapMemory(device, buffer->memory);
+        // Block mappings are owned by the allocator and stay mapped
+        if (!buffer->allocation.block) {
+            vkUnmapMemory(device, buffer->memory);
+        }
         buffer->mapped = NULL;
         printf("  Buffer unmapped: %p\n", (void*)buffer->buffer);
     }
 }
 
+void recordCopyBuffer(
+    VkCommandBuffer commandBuffer,
+    const Buffer* srcBuffer,
+    VkDeviceSize srcOffset,
+    const Buffer* dstBuffer,
+    VkDeviceSize dstOffset,
+    VkDeviceSize size
+) {
+    VkBufferCopy copyRegion = {0};
+    copyRegion.srcOffset = srcOffset;
+    copyRegion.dstOffset = dstOffset;
+    copyRegion.size = size;
+    vkCmdCopyBuffer(commandBuffer, srcBuffer->buffer, dstBuffer->buffer, 1, &copyRegion);
+}
+
 VkResult copyBuffer(
     VkDevice device,
     VkCommandPool commandPool,
@@ -193,17 +257,25 @@ VkResult copyBuffer(
         return result;
     }
 
+    // Wait on a fence for this submission only instead of draining the whole queue
+    VkFenceCreateInfo fenceInfo = {0};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+    VkFence fence;
+    result = vkCreateFence(device, &fenceInfo, NULL, &fence);
+    if (result != VK_SUCCESS) {
+        printf("    Failed to create copy fence! Error: %d\n", result);
+        vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
+        return result;
+    }
+
     // Begin recording
     VkCommandBufferBeginInfo beginInfo = {0};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
     beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
     vkBeginCommandBuffer(commandBuffer, &beginInfo);
-
-    VkBufferCopy copyRegion = {0};
-    copyRegion.size = size;
-    vkCmdCopyBuffer(commandBuffer, srcBuffer->buffer, dstBuffer->buffer, 1, &copyRegion);
-
+    recordCopyBuffer(commandBuffer, srcBuffer, 0, dstBuffer, 0, size);
     vkEndCommandBuffer(commandBuffer);
 
     // Submit and wait
@@ -212,18 +284,323 @@ VkResult copyBuffer(
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &commandBuffer;
 
-    result = vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
+    result = vkQueueSubmit(queue, 1, &submitInfo, fence);
     if (result == VK_SUCCESS) {
-        vkQueueWaitIdle(queue);
+        result = vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX);
         printf("    Buffer copy completed\n");
     } else {
         printf("    Buffer copy failed! Error: %d\n", result);
     }
 
+    vkDestroyFence(device, fence, NULL);
     vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
     return result;
 }
 
+VkResult beginUploadBatch(
+    VkDevice device,
+    VkPhysicalDevice physicalDevice,
+    GpuAllocator* allocator,
+    VkCommandPool commandPool,
+    VkQueue queue,
+    UploadBatch* outBatch
+) {
+    if (!device || !physicalDevice || !commandPool || !queue || !outBatch) {
+        printf("Upload batch creation failed: Invalid parameters\n");
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    memset(outBatch, 0, sizeof(UploadBatch));
+    outBatch->device = device;
+    outBatch->physicalDevice = physicalDevice;
+    outBatch->allocator = allocator;
+    outBatch->commandPool = commandPool;
+    outBatch->queue = queue;
+
+    VkCommandBufferAllocateInfo allocInfo = {0};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandPool = commandPool;
+    allocInfo.commandBufferCount = 1;
+
+    VkResult result = vkAllocateCommandBuffers(device, &allocInfo, &outBatch->commandBuffer);
+    if (result != VK_SUCCESS) {
+        printf("  Failed to allocate upload command buffer! Error: %d\n", result);
+        return result;
+    }
+
+    VkFenceCreateInfo fenceInfo = {0};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+    result = vkCreateFence(device, &fenceInfo, NULL, &outBatch->fence);
+    if (result != VK_SUCCESS) {
+        printf("  Failed to create upload fence! Error: %d\n", result);
+        vkFreeCommandBuffers(device, commandPool, 1, &outBatch->commandBuffer);
+        outBatch->commandBuffer = VK_NULL_HANDLE;
+        return result;
+    }
+
+    VkCommandBufferBeginInfo beginInfo = {0};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    result = vkBeginCommandBuffer(outBatch->commandBuffer, &beginInfo);
+    if (result != VK_SUCCESS) {
+        printf("  Failed to begin upload command buffer! Error: %d\n", result);
+        destroyUploadBatch(outBatch);
+        return result;
+    }
+
+    outBatch->recording = true;
+    return VK_SUCCESS;
+}
+
+static VkResult addStagingChunk(UploadBatch* batch, VkDeviceSize minSize) {
+    if (batch->stagingChunkCount == batch->stagingChunkCapacity) {
+        uint32_t newCapacity = batch->stagingChunkCapacity ? batch->stagingChunkCapacity * 2 : 4;
+        Buffer* chunks = (Buffer*)realloc(batch->stagingChunks, sizeof(Buffer) * newCapacity);
+        if (!chunks) {
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
+        batch->stagingChunks = chunks;
+        batch->stagingChunkCapacity = newCapacity;
+    }
+
+    BufferCreateInfo createInfo = {0};
+    createInfo.size = minSize > UPLOAD_STAGING_CHUNK_SIZE ? minSize : UPLOAD_STAGING_CHUNK_SIZE;
+    createInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    createInfo.properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    createInfo.allocator = batch->allocator;
+
+    Buffer* chunk = &batch->stagingChunks[batch->stagingChunkCount];
+    VkResult result = createBuffer(batch->device, batch->physicalDevice, &createInfo, chunk);
+    if (result != VK_SUCCESS) {
+        return result;
+    }
+
+    void* mapped = NULL;
+    result = mapBuffer(batch->device, chunk, &mapped);
+    if (result != VK_SUCCESS) {
+        destroyBuffer(batch->device, chunk);
+        return result;
+    }
+
+    batch->stagingChunkCount++;
+    batch->chunkOffset = 0;
+    return VK_SUCCESS;
+}
+
+VkResult stageBufferUpload(
+    UploadBatch* batch,
+    Buffer* dstBuffer,
+    const void* data,
+    VkDeviceSize size,
+    VkDeviceSize dstOffset
+) {
+    if (!batch || !batch->recording || !dstBuffer || !data || size == 0) {
+        printf("Staged upload failed: Invalid parameters\n");
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    if (dstOffset + size > dstBuffer->size) {
+        printf("Staged upload failed: Size exceeds buffer bounds\n");
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    // Keep copy source offsets 16-byte aligned, which satisfies every texel/vertex format
+    VkDeviceSize srcOffset = (batch->chunkOffset + 15) & ~(VkDeviceSize)15;
+    Buffer* chunk = batch->stagingChunkCount > 0 ? &batch->stagingChunks[batch->stagingChunkCount - 1] : NULL;
+    if (!chunk || srcOffset + size > chunk->size) {
+        VkResult result = addStagingChunk(batch, size);
+        if (result != VK_SUCCESS) {
+            printf("  Failed to allocate staging memory! Error: %d\n", result);
+            return result;
+        }
+        chunk = &batch->stagingChunks[batch->stagingChunkCount - 1];
+        srcOffset = 0;
+    }
+
+    memcpy((char*)chunk->mapped + srcOffset, data, size);
+    recordCopyBuffer(batch->commandBuffer, chunk, srcOffset, dstBuffer, dstOffset, size);
+
+    batch->chunkOffset = srcOffset + size;
+    batch->copyCount++;
+    batch->bytesStaged += size;
+    return VK_SUCCESS;
+}
+
+VkResult submitUploadBatch(UploadBatch* batch) {
+    if (!batch || !batch->recording) {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    batch->recording = false;
+
+    // One global barrier makes every copy of the batch visible to the stages that read the buffers
+    if (batch->copyCount > 0) {
+        VkMemoryBarrier barrier = {0};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+                                VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT |
+                                VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+        vkCmdPipelineBarrier(batch->commandBuffer,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+                             VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0, 1, &barrier, 0, NULL, 0, NULL);
+    }
+
+    VkResult result = vkEndCommandBuffer(batch->commandBuffer);
+    if (result != VK_SUCCESS) {
+        printf("  Failed to end upload command buffer! Error: %d\n", result);
+        return result;
+    }
+
+    VkSubmitInfo submitInfo = {0};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &batch->commandBuffer;
+
+    result = vkQueueSubmit(batch->queue, 1, &submitInfo, batch->fence);
+    if (result != VK_SUCCESS) {
+        printf("  Upload batch submit failed! Error: %d\n", result);
+        return result;
+    }
+
+    result = vkWaitForFences(batch->device, 1, &batch->fence, VK_TRUE, UINT64_MAX);
+    if (result != VK_SUCCESS) {
+        printf("  Upload batch wait failed! Error: %d\n", result);
+        return result;
+    }
+
+    printf("  Upload batch completed: %u copies, %llu bytes, %u staging chunks\n",
+           batch->copyCount, (unsigned long long)batch->bytesStaged, batch->stagingChunkCount);
+    return VK_SUCCESS;
+}
+
+void destroyUploadBatch(UploadBatch* batch) {
+    if (!batch || !batch->device) return;
+
+    for (uint32_t i = 0; i < batch->stagingChunkCount; i++) {
+        destroyBuffer(batch->device, &batch->stagingChunks[i]);
+    }
+    free(batch->stagingChunks);
+
+    if (batch->fence != VK_NULL_HANDLE) {
+        vkDestroyFence(batch->device, batch->fence, NULL);
+    }
+    if (batch->commandBuffer != VK_NULL_HANDLE) {
+        vkFreeCommandBuffers(batch->device, batch->commandPool, 1, &batch->commandBuffer);
+    }
+
+    memset(batch, 0, sizeof(UploadBatch));
+}
+
+VkResult createBufferRing(
+    VkDevice device,
+    VkPhysicalDevice physicalDevice,
+    GpuAllocator* allocator,
+    VkBufferUsageFlags usage,
+    VkDeviceSize alignment,
+    VkDeviceSize sliceSize,
+    uint32_t sliceCount,
+    BufferRing* outRing
+) {
+    if (!device || !physicalDevice || sliceSize == 0 || sliceCount == 0 || !outRing) {
+        printf("Buffer ring creation failed: Invalid parameters\n");
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+    if (alignment == 0) {
+        alignment = 1;
+    }
+    if ((alignment & (alignment - 1)) != 0) {
+        printf("Buffer ring creation failed: Alignment %llu is not a power of two\n", (unsigned long long)alignment);
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    memset(outRing, 0, sizeof(BufferRing));
+    outRing->alignment = alignment;
+    // Slices start on an aligned boundary so slice-relative alignment is also absolute alignment
+    outRing->sliceSize = (sliceSize + alignment - 1) & ~(alignment - 1);
+    outRing->sliceCount = sliceCount;
+
+    printf("  Creating buffer ring: %u slices x %llu bytes (alignment %llu)\n",
+           sliceCount, (unsigned long long)outRing->sliceSize, (unsigned long long)alignment);
+
+    BufferCreateInfo createInfo = {0};
+    createInfo.size = outRing->sliceSize * sliceCount;
+    createInfo.usage = usage;
+    createInfo.properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    createInfo.allocator = allocator;
+
+    VkResult result = createBuffer(device, physicalDevice, &createInfo, &outRing->buffer);
+    if (result != VK_SUCCESS) {
+        printf("    Failed to create buffer ring!\n");
+        return result;
+    }
+
+    // Mapped once for the lifetime of the ring; coherent memory needs no explicit flushes
+    void* mapped = NULL;
+    result = mapBuffer(device, &outRing->buffer, &mapped);
+    if (result != VK_SUCCESS) {
+        printf("    Failed to map buffer ring! Error: %d\n", result);
+        destroyBuffer(device, &outRing->buffer);
+        return result;
+    }
+
+    return VK_SUCCESS;
+}
+
+void beginBufferRingFrame(BufferRing* ring, uint32_t slice) {
+    if (!ring || ring->sliceCount == 0) return;
+
+    if (ring->head > ring->peakUsage) {
+        ring->peakUsage = ring->head;
+    }
+    ring->currentSlice = slice % ring->sliceCount;
+    ring->head = 0;
+}
+
+VkResult allocateFromBufferRing(
+    BufferRing* ring,
+    VkDeviceSize size,
+    RingAllocation* outAllocation
+) {
+    if (!ring || !ring->buffer.mapped || size == 0 || !outAllocation) {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    VkDeviceSize start = (ring->head + ring->alignment - 1) & ~(ring->alignment - 1);
+    if (start + size > ring->sliceSize) {
+        printf("Buffer ring slice exhausted: %llu + %llu > %llu bytes\n",
+               (unsigned long long)start, (unsigned long long)size, (unsigned long long)ring->sliceSize);
+        return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+    }
+
+    VkDeviceSize offset = (VkDeviceSize)ring->currentSlice * ring->sliceSize + start;
+    outAllocation->data = (char*)ring->buffer.mapped + offset;
+    outAllocation->offset = offset;
+    outAllocation->size = size;
+
+    ring->head = start + size;
+    return VK_SUCCESS;
+}
+
+void destroyBufferRing(
+    VkDevice device,
+    BufferRing* ring
+) {
+    if (!device || !ring) return;
+
+    // destroyBuffer unmaps the persistent mapping
+    destroyBuffer(device, &ring->buffer);
+    memset(ring, 0, sizeof(BufferRing));
+}
+
 void destroyBuffer(
     VkDevice device,
     Buffer* buffer
@@ -231,7 +608,9 @@ void destroyBuffer(
     if (!device || !buffer) return;
 
     if (buffer->mapped) {
-        vkUnmapMemory(device, buffer->memory);
+        if (!buffer->allocation.block) {
+            vkUnmapMemory(device, buffer->memory);
+        }
         buffer->mapped = NULL;
     }
 
@@ -241,7 +620,12 @@ void destroyBuffer(
         buffer->buffer = VK_NULL_HANDLE;
     }
 
-    if (buffer->memory != VK_NULL_HANDLE) {
+    if (buffer->allocation.block) {
+        printf("  Releasing sub-allocation: %p + %llu\n",
+               (void*)buffer->memory, (unsigned long long)buffer->allocation.offset);
+        gpuFree(&buffer->allocation);
+        buffer->memory = VK_NULL_HANDLE;
+    } else if (buffer->memory != VK_NULL_HANDLE) {
         printf("  Freeing buffer memory: %p\n", (void*)buffer->memory);
         vkFreeMemory(device, buffer->memory, NULL);
         buffer->memory = VK_NULL_HANDLE;
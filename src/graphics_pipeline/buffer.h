@@ -4,15 +4,17 @@
 #include <vulkan/vulkan.h>
 #include <stddef.h>
 #include <stdbool.h>
+#include "../memory/gpu_allocator.h"
 
 /**
  * Buffer wrapper with memory info
  */
 typedef struct {
     VkBuffer buffer;
-    VkDeviceMemory memory;
+    VkDeviceMemory memory;      // Backing memory (a shared block when sub-allocated)
     VkDeviceSize size;
     void* mapped;  // Non-NULL if persistently mapped
+    GpuAllocation allocation;   // Block + offset when created through a GpuAllocator
 } Buffer;
 
 /**
@@ -22,6 +24,7 @@ typedef struct {
     VkDeviceSize size;
     VkBufferUsageFlags usage;         // e.g., VK_BUFFER_USAGE_VERTEX_BUFFER_BIT
     VkMemoryPropertyFlags properties; // e.g., VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+    GpuAllocator* allocator;          // Sub-allocate from here; NULL for a dedicated vkAllocateMemory
 } BufferCreateInfo;
 
 /**
@@ -83,6 +86,56 @@ void unmapBuffer(
     Buffer* buffer
 );
 
+// Minimum size of each staging chunk an UploadBatch allocates; larger uploads get a dedicated chunk
+#define UPLOAD_STAGING_CHUNK_SIZE (4 * 1024 * 1024)
+
+/**
+ * Batches many host -> device-local uploads into one command buffer
+ * submitted with a single fence. Staging memory is sub-allocated linearly
+ * from host-visible chunks that live until the batch is destroyed.
+ */
+typedef struct {
+    VkDevice device;
+    VkPhysicalDevice physicalDevice;
+    GpuAllocator* allocator;
+    VkCommandPool commandPool;
+    VkQueue queue;
+    VkCommandBuffer commandBuffer;
+    VkFence fence;
+    Buffer* stagingChunks;
+    uint32_t stagingChunkCount;
+    uint32_t stagingChunkCapacity;
+    VkDeviceSize chunkOffset;    // Write cursor inside the last chunk
+    uint32_t copyCount;          // Copies recorded since begin
+    VkDeviceSize bytesStaged;
+    bool recording;
+} UploadBatch;
+
+/**
+ * Persistently mapped ring of per-frame-slot slices
+ * Each frame slot owns one slice; sub-allocations inside the slice are
+ * bump-allocated and reset when the slot comes around again, i.e. after
+ * its fence has signalled, so the CPU never writes memory the GPU reads.
+ */
+typedef struct {
+    Buffer buffer;              // Host-visible, coherent, mapped for its whole lifetime
+    VkDeviceSize alignment;     // Offset alignment of every sub-allocation
+    VkDeviceSize sliceSize;     // Bytes reserved per frame slot
+    uint32_t sliceCount;
+    uint32_t currentSlice;
+    VkDeviceSize head;          // Next free byte relative to the current slice
+    VkDeviceSize peakUsage;     // Largest number of bytes used by any slice so far
+} BufferRing;
+
+/**
+ * A sub-allocation handed out by a BufferRing
+ */
+typedef struct {
+    void* data;             // CPU write pointer into the mapped buffer
+    VkDeviceSize offset;    // Offset from the start of the buffer (usable as a dynamic offset)
+    VkDeviceSize size;
+} RingAllocation;
+
 /**
  * Copy data from one buffer to another using a command buffer
  * 
@@ -103,6 +156,137 @@ VkResult copyBuffer(
     VkDeviceSize size
 );
 
+/**
+ * Record a buffer-to-buffer copy into an already recording command buffer
+ *
+ * @param commandBuffer - Command buffer in the recording state
+ * @param srcBuffer - Source buffer
+ * @param srcOffset - Byte offset in the source buffer
+ * @param dstBuffer - Destination buffer
+ * @param dstOffset - Byte offset in the destination buffer
+ * @param size - Number of bytes to copy
+ */
+void recordCopyBuffer(
+    VkCommandBuffer commandBuffer,
+    const Buffer* srcBuffer,
+    VkDeviceSize srcOffset,
+    const Buffer* dstBuffer,
+    VkDeviceSize dstOffset,
+    VkDeviceSize size
+);
+
+/**
+ * Start a batch of staged uploads
+ *
+ * @param device - VkDevice handle
+ * @param physicalDevice - VkPhysicalDevice for staging memory type lookup
+ * @param allocator - Allocator for staging chunks (NULL for dedicated allocations)
+ * @param commandPool - Pool the batch command buffer is allocated from
+ * @param queue - Queue the batch is submitted to (must support transfers)
+ * @param outBatch - Output batch, recording on success
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult beginUploadBatch(
+    VkDevice device,
+    VkPhysicalDevice physicalDevice,
+    GpuAllocator* allocator,
+    VkCommandPool commandPool,
+    VkQueue queue,
+    UploadBatch* outBatch
+);
+
+/**
+ * Copy data into staging memory and record a copy into the destination buffer
+ * The destination must have been created with VK_BUFFER_USAGE_TRANSFER_DST_BIT.
+ *
+ * @param batch - Recording upload batch
+ * @param dstBuffer - Destination (typically device-local) buffer
+ * @param data - Source data pointer
+ * @param size - Number of bytes to upload
+ * @param dstOffset - Offset in the destination buffer
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult stageBufferUpload(
+    UploadBatch* batch,
+    Buffer* dstBuffer,
+    const void* data,
+    VkDeviceSize size,
+    VkDeviceSize dstOffset
+);
+
+/**
+ * Submit all recorded copies and wait on the batch fence
+ *
+ * @param batch - Recording upload batch
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult submitUploadBatch(UploadBatch* batch);
+
+/**
+ * Free the batch command buffer, fence and staging chunks
+ *
+ * @param batch - Batch to destroy (must not be pending on the GPU)
+ */
+void destroyUploadBatch(UploadBatch* batch);
+
+/**
+ * Create a persistently mapped ring buffer with one slice per frame slot
+ *
+ * @param device - VkDevice handle
+ * @param physicalDevice - VkPhysicalDevice for querying memory properties
+ * @param allocator - Allocator to sub-allocate from (NULL for a dedicated allocation)
+ * @param usage - Buffer usage (e.g. VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
+ * @param alignment - Required offset alignment of sub-allocations (power of two)
+ * @param sliceSize - Bytes available to each frame slot
+ * @param sliceCount - Number of frame slots
+ * @param outRing - Output ring
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult createBufferRing(
+    VkDevice device,
+    VkPhysicalDevice physicalDevice,
+    GpuAllocator* allocator,
+    VkBufferUsageFlags usage,
+    VkDeviceSize alignment,
+    VkDeviceSize sliceSize,
+    uint32_t sliceCount,
+    BufferRing* outRing
+);
+
+/**
+ * Switch the ring to a frame slot's slice and discard its previous allocations
+ * Call only once the slot's previous submission has completed.
+ *
+ * @param ring - Ring buffer
+ * @param slice - Frame slot index
+ */
+void beginBufferRingFrame(BufferRing* ring, uint32_t slice);
+
+/**
+ * Sub-allocate aligned memory from the current slice
+ *
+ * @param ring - Ring buffer
+ * @param size - Number of bytes needed
+ * @param outAllocation - Output write pointer and buffer offset
+ * @return VK_SUCCESS on success, VK_ERROR_OUT_OF_DEVICE_MEMORY if the slice is full
+ */
+VkResult allocateFromBufferRing(
+    BufferRing* ring,
+    VkDeviceSize size,
+    RingAllocation* outAllocation
+);
+
+/**
+ * Unmap and destroy a ring buffer
+ *
+ * @param device - VkDevice handle
+ * @param ring - Ring to destroy
+ */
+void destroyBufferRing(
+    VkDevice device,
+    BufferRing* ring
+);
+
 /**
  * Destroy buffer and free memory
  * 
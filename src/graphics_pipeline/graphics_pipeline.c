@@ -241,14 +241,18 @@ VkResult createGraphicsPipeline(
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
     pipelineInfo.basePipelineIndex = -1;
 
+    double compileStart = pipelineCacheTimestampMs();
     result = vkCreateGraphicsPipelines(
         config->device,
-        VK_NULL_HANDLE, // pipeline cache (optional)
+        config->pipelineCache ? config->pipelineCache->cache : VK_NULL_HANDLE,
         1,
         &pipelineInfo,
         NULL,
         &outPipeline->pipeline
     );
+    if (result == VK_SUCCESS && config->pipelineCache) {
+        recordPipelineCompile(config->pipelineCache, pipelineCacheTimestampMs() - compileStart);
+    }
 
     // Cleanup temporary allocations
     free(vkBindings);
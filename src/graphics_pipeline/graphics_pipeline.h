@@ -3,6 +3,7 @@
 
 #include <vulkan/vulkan.h>
 #include <stdbool.h>
+#include "pipeline_cache.h"
 
 /**
  * Graphics pipeline container holding the pipeline and associated shader modules
@@ -69,6 +70,9 @@ typedef struct {
     
     VkPrimitiveTopology topology;
     float lineWidth;
+
+    // Optional: persistent pipeline cache (NULL compiles without one)
+    PipelineCache* pipelineCache;
 } GraphicsPipelineConfig;
 
 /**
@@ -0,0 +1,266 @@
+#include "pipeline_cache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PIPELINE_CACHE_MAGIC 0x48435054u   // "TPCH"
+#define PIPELINE_CACHE_FILE_VERSION 2u
+
+// Size of VkPipelineCacheHeaderVersionOne: headerSize, headerVersion, vendorID, deviceID, UUID
+#define VK_PIPELINE_CACHE_HEADER_ONE_SIZE (16 + VK_UUID_SIZE)
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vendorID;
+    uint32_t deviceID;
+    uint32_t driverVersion;
+    uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+    double coldCompileMs;
+    uint32_t coldPipelineCount;
+    uint32_t reserved;
+    uint64_t dataSize;
+} PipelineCacheFileHeader;
+
+double pipelineCacheTimestampMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+// Check the driver's own header at the start of the blob against this device
+static bool validateDriverHeader(const PipelineCache* cache, const uint8_t* data, size_t size) {
+    if (size < VK_PIPELINE_CACHE_HEADER_ONE_SIZE) return false;
+
+    uint32_t headerSize, headerVersion, vendorID, deviceID;
+    memcpy(&headerSize, data + 0, sizeof(uint32_t));
+    memcpy(&headerVersion, data + 4, sizeof(uint32_t));
+    memcpy(&vendorID, data + 8, sizeof(uint32_t));
+    memcpy(&deviceID, data + 12, sizeof(uint32_t));
+
+    return headerSize >= VK_PIPELINE_CACHE_HEADER_ONE_SIZE &&
+           headerSize <= size &&
+           headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           vendorID == cache->vendorID &&
+           deviceID == cache->deviceID &&
+           memcmp(data + 16, cache->pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+// Returns the blob to seed the cache with, or NULL if the file is missing or stale
+static uint8_t* loadCacheFile(PipelineCache* cache, size_t* outSize) {
+    *outSize = 0;
+
+    FILE* file = fopen(cache->path, "rb");
+    if (!file) {
+        printf("  Pipeline cache: no file at %s\n", cache->path);
+        return NULL;
+    }
+
+    PipelineCacheFileHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1) {
+        printf("  Pipeline cache: truncated header, ignoring %s\n", cache->path);
+        fclose(file);
+        return NULL;
+    }
+
+    if (header.magic != PIPELINE_CACHE_MAGIC || header.version != PIPELINE_CACHE_FILE_VERSION) {
+        printf("  Pipeline cache: unknown file format, ignoring %s\n", cache->path);
+        fclose(file);
+        return NULL;
+    }
+
+    if (header.vendorID != cache->vendorID || header.deviceID != cache->deviceID ||
+        header.driverVersion != cache->driverVersion ||
+        memcmp(header.pipelineCacheUUID, cache->pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+        printf("  Pipeline cache: written for a different device or driver, ignoring\n");
+        fclose(file);
+        return NULL;
+    }
+
+    if (header.dataSize == 0 || header.dataSize > (64ull * 1024 * 1024)) {
+        printf("  Pipeline cache: implausible data size %llu, ignoring\n", (unsigned long long)header.dataSize);
+        fclose(file);
+        return NULL;
+    }
+
+    uint8_t* data = (uint8_t*)malloc((size_t)header.dataSize);
+    if (!data) {
+        fclose(file);
+        return NULL;
+    }
+    if (fread(data, 1, (size_t)header.dataSize, file) != header.dataSize) {
+        printf("  Pipeline cache: truncated data, ignoring %s\n", cache->path);
+        free(data);
+        fclose(file);
+        return NULL;
+    }
+    fclose(file);
+
+    if (!validateDriverHeader(cache, data, (size_t)header.dataSize)) {
+        printf("  Pipeline cache: driver header mismatch, ignoring\n");
+        free(data);
+        return NULL;
+    }
+
+    cache->coldCompileMs = header.coldCompileMs;
+    cache->coldPipelineCount = header.coldPipelineCount;
+    *outSize = (size_t)header.dataSize;
+    return data;
+}
+
+VkResult createPipelineCache(
+    VkDevice device,
+    VkPhysicalDevice physicalDevice,
+    const char* path,
+    PipelineCache* outCache
+) {
+    if (!device || !physicalDevice || !path || !outCache) {
+        printf("Pipeline cache creation failed: Invalid parameters\n");
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    memset(outCache, 0, sizeof(PipelineCache));
+    outCache->path = path;
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(physicalDevice, &props);
+    outCache->vendorID = props.vendorID;
+    outCache->deviceID = props.deviceID;
+    outCache->driverVersion = props.driverVersion;
+    memcpy(outCache->pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE);
+
+    size_t initialSize = 0;
+    uint8_t* initialData = loadCacheFile(outCache, &initialSize);
+
+    VkPipelineCacheCreateInfo createInfo = {0};
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    createInfo.initialDataSize = initialSize;
+    createInfo.pInitialData = initialData;
+
+    VkResult result = vkCreatePipelineCache(device, &createInfo, NULL, &outCache->cache);
+    if (result != VK_SUCCESS && initialData) {
+        // The driver rejected the blob; start empty rather than failing startup
+        printf("  Pipeline cache: driver rejected cached data (%d), starting empty\n", result);
+        createInfo.initialDataSize = 0;
+        createInfo.pInitialData = NULL;
+        result = vkCreatePipelineCache(device, &createInfo, NULL, &outCache->cache);
+        free(initialData);
+        initialData = NULL;
+        initialSize = 0;
+    }
+    free(initialData);
+
+    if (result != VK_SUCCESS) {
+        printf("  Failed to create pipeline cache! Error: %d\n", result);
+        return result;
+    }
+
+    outCache->hit = initialSize > 0;
+    printf("  Pipeline cache: %s (%zu bytes from %s)\n", outCache->hit ? "loaded" : "empty", initialSize, path);
+    return VK_SUCCESS;
+}
+
+// The cold time only compares with this run if it built the same set of pipelines
+static bool coldTimingComparable(const PipelineCache* cache) {
+    return cache->hit && cache->coldCompileMs > 0.0 && cache->coldPipelineCount == cache->pipelineCount;
+}
+
+void recordPipelineCompile(PipelineCache* cache, double milliseconds) {
+    if (!cache) return;
+    cache->compileMs += milliseconds;
+    cache->pipelineCount++;
+}
+
+void reportPipelineCache(const PipelineCache* cache) {
+    if (!cache) return;
+
+    printf("\nPipeline Cache:\n");
+    printf("  File: %s\n", cache->path);
+    printf("  Result: %s\n", cache->hit ? "HIT" : "MISS");
+    printf("  Pipelines: %u, creation time %.2f ms\n", cache->pipelineCount, cache->compileMs);
+    if (coldTimingComparable(cache)) {
+        printf("  Cold compile time: %.2f ms, saved %.2f ms\n",
+               cache->coldCompileMs, cache->coldCompileMs - cache->compileMs);
+    } else if (cache->hit) {
+        printf("  Cold compile time: not comparable (%u pipelines then), recording this run as cold\n",
+               cache->coldPipelineCount);
+    }
+}
+
+VkResult savePipelineCache(
+    VkDevice device,
+    const PipelineCache* cache
+) {
+    if (!device || !cache || cache->cache == VK_NULL_HANDLE) {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    size_t dataSize = 0;
+    VkResult result = vkGetPipelineCacheData(device, cache->cache, &dataSize, NULL);
+    if (result != VK_SUCCESS || dataSize == 0) {
+        printf("  Pipeline cache: nothing to save (%d)\n", result);
+        return result;
+    }
+
+    uint8_t* data = (uint8_t*)malloc(dataSize);
+    if (!data) {
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+    result = vkGetPipelineCacheData(device, cache->cache, &dataSize, data);
+    if (result != VK_SUCCESS) {
+        printf("  Pipeline cache: failed to read cache data! Error: %d\n", result);
+        free(data);
+        return result;
+    }
+
+    PipelineCacheFileHeader header = {0};
+    header.magic = PIPELINE_CACHE_MAGIC;
+    header.version = PIPELINE_CACHE_FILE_VERSION;
+    header.vendorID = cache->vendorID;
+    header.deviceID = cache->deviceID;
+    header.driverVersion = cache->driverVersion;
+    memcpy(header.pipelineCacheUUID, cache->pipelineCacheUUID, VK_UUID_SIZE);
+    // Keep the cold time from the run that populated the cache, so savings stay comparable;
+    // a run that built a different set of pipelines becomes the new cold measurement
+    bool keepCold = coldTimingComparable(cache);
+    header.coldCompileMs = keepCold ? cache->coldCompileMs : cache->compileMs;
+    header.coldPipelineCount = keepCold ? cache->coldPipelineCount : cache->pipelineCount;
+    header.dataSize = dataSize;
+
+    // Write a temporary file and rename it so a crash never leaves a torn cache behind
+    char tempPath[1024];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", cache->path);
+
+    FILE* file = fopen(tempPath, "wb");
+    if (!file) {
+        printf("  Pipeline cache: cannot write %s\n", tempPath);
+        free(data);
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(data, 1, dataSize, file) == dataSize;
+    ok = (fclose(file) == 0) && ok;
+    free(data);
+
+    if (!ok || rename(tempPath, cache->path) != 0) {
+        printf("  Pipeline cache: failed to write %s\n", cache->path);
+        remove(tempPath);
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    printf("  Pipeline cache: saved %zu bytes to %s\n", dataSize, cache->path);
+    return VK_SUCCESS;
+}
+
+void destroyPipelineCache(
+    VkDevice device,
+    PipelineCache* cache
+) {
+    if (!device || !cache) return;
+
+    if (cache->cache != VK_NULL_HANDLE) {
+        vkDestroyPipelineCache(device, cache->cache, NULL);
+        cache->cache = VK_NULL_HANDLE;
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef PIPELINE_CACHE_H
+#define PIPELINE_CACHE_H
+
+#include <vulkan/vulkan.h>
+#include <stdbool.h>
+
+// Cache file written next to the working directory, like the shader paths
+#define PIPELINE_CACHE_DEFAULT_PATH "pipeline_cache.bin"
+
+/**
+ * Driver pipeline cache persisted across runs
+ * The file stores our own header (device identity and the compile time and
+ * pipeline count of the run that produced it) followed by the vkGetPipelineCacheData blob.
+ */
+typedef struct {
+    VkPipelineCache cache;
+    const char* path;
+
+    // Identity the cache data must match
+    uint32_t vendorID;
+    uint32_t deviceID;
+    uint32_t driverVersion;
+    uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+
+    bool hit;                // Valid data for this device was loaded from disk
+    double coldCompileMs;    // Pipeline creation time of the run that built the cache
+    uint32_t coldPipelineCount;  // Pipelines created in that run
+    double compileMs;        // Pipeline creation time in this run
+    uint32_t pipelineCount;  // Pipelines created through this cache in this run
+} PipelineCache;
+
+/**
+ * Create a pipeline cache, seeded from disk when the file matches this device
+ *
+ * @param device - VkDevice handle
+ * @param physicalDevice - VkPhysicalDevice whose properties validate the file
+ * @param path - Cache file path
+ * @param outCache - Output pipeline cache
+ * @return VK_SUCCESS on success, error code otherwise (a missing or stale file is not an error)
+ */
+VkResult createPipelineCache(
+    VkDevice device,
+    VkPhysicalDevice physicalDevice,
+    const char* path,
+    PipelineCache* outCache
+);
+
+/**
+ * Monotonic timestamp used to time pipeline creation
+ *
+ * @return Milliseconds since an arbitrary epoch
+ */
+double pipelineCacheTimestampMs(void);
+
+/**
+ * Account the time spent creating one pipeline through the cache
+ *
+ * @param cache - Pipeline cache
+ * @param milliseconds - Time spent in vkCreate*Pipelines
+ */
+void recordPipelineCompile(PipelineCache* cache, double milliseconds);
+
+/**
+ * Print hit/miss and compile time saved relative to the cold run
+ *
+ * @param cache - Pipeline cache
+ */
+void reportPipelineCache(const PipelineCache* cache);
+
+/**
+ * Serialize the cache to its file (written to a temporary file, then renamed)
+ *
+ * @param device - VkDevice handle
+ * @param cache - Pipeline cache
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult savePipelineCache(
+    VkDevice device,
+    const PipelineCache* cache
+);
+
+/**
+ * Destroy the pipeline cache object
+ *
+ * @param device - VkDevice handle
+ * @param cache - Pipeline cache
+ */
+void destroyPipelineCache(
+    VkDevice device,
+    PipelineCache* cache
+);
+
+#endif // PIPELINE_CACHE_H
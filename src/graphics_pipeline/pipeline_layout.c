@@ -10,9 +10,10 @@ VkResult createPipelineLayouts(
     memset(outLayouts, 0, sizeof(*outLayouts));
 
     // 1) Global set (set=0): one uniform buffer binding for camera + lighting data
+    //    Dynamic so each frame can point it at its own uniform ring sub-allocation
     VkDescriptorSetLayoutBinding globalBinding = {0};
     globalBinding.binding = 0; // binding 0
-    globalBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    globalBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     globalBinding.descriptorCount = 1;
     globalBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT; // visible in VS/FS
     globalBinding.pImmutableSamplers = NULL;
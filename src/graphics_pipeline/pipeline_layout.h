@@ -4,8 +4,10 @@
 #include <vulkan/vulkan.h>
 #include <stdint.h>
 
+// Per-draw data (116 bytes, within the 128 bytes every device guarantees)
 typedef struct {
     float model[16];  
+    float normalMatrix[12];  // Columns of transpose(inverse(model)), padded to vec4
     uint32_t objectID;
 } PushConstants;
 
@@ -0,0 +1,158 @@
+#include "frame_writer.h"
+#include <stdlib.h>
+#include <string.h>
+
+FrameFormat frameFormatFromPath(const char* path) {
+    const char* extension = path ? strrchr(path, '.') : NULL;
+    if (extension && strcmp(extension, ".ppm") == 0) return FRAME_FORMAT_PPM;
+    if (extension && strcmp(extension, ".y4m") == 0) return FRAME_FORMAT_Y4M;
+    return FRAME_FORMAT_RAW;
+}
+
+int openFrameWriter(
+    const char* path,
+    FrameFormat format,
+    uint32_t width,
+    uint32_t height,
+    uint32_t fps,
+    FrameWriter* outWriter
+) {
+    if (!path || !outWriter || width == 0 || height == 0) {
+        return -1;
+    }
+
+    memset(outWriter, 0, sizeof(FrameWriter));
+    outWriter->format = format;
+    outWriter->width = width;
+    outWriter->height = height;
+
+    size_t pixels = (size_t)width * height;
+    size_t chromaPixels = (size_t)((width + 1) / 2) * ((height + 1) / 2);
+    if (format == FRAME_FORMAT_PPM) {
+        outWriter->scratchSize = pixels * 3;
+    } else if (format == FRAME_FORMAT_Y4M) {
+        outWriter->scratchSize = pixels + chromaPixels * 2;
+    }
+    if (outWriter->scratchSize > 0) {
+        outWriter->scratch = malloc(outWriter->scratchSize);
+        if (!outWriter->scratch) {
+            return -1;
+        }
+    }
+
+    outWriter->file = fopen(path, "wb");
+    if (!outWriter->file) {
+        printf("Failed to open frame output: %s\n", path);
+        free(outWriter->scratch);
+        outWriter->scratch = NULL;
+        return -1;
+    }
+
+    if (format == FRAME_FORMAT_Y4M) {
+        fprintf(outWriter->file, "YUV4MPEG2 W%u H%u F%u:1 Ip A1:1 C420jpeg\n", width, height, fps ? fps : 60);
+    }
+    return 0;
+}
+
+static inline uint8_t clampByte(float value) {
+    if (value <= 0.0f) return 0;
+    if (value >= 255.0f) return 255;
+    return (uint8_t)(value + 0.5f);
+}
+
+// Full-range BT.601 (the "jpeg" colour space in the Y4M header), chroma averaged over 2x2 blocks
+static void convertToYuv420(const FrameWriter* writer, const uint8_t* rgba, uint8_t* yuv) {
+    uint32_t width = writer->width;
+    uint32_t height = writer->height;
+    uint32_t chromaWidth = (width + 1) / 2;
+    uint32_t chromaHeight = (height + 1) / 2;
+    uint8_t* planeY = yuv;
+    uint8_t* planeU = planeY + (size_t)width * height;
+    uint8_t* planeV = planeU + (size_t)chromaWidth * chromaHeight;
+
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t* row = rgba + (size_t)y * width * 4;
+        for (uint32_t x = 0; x < width; x++) {
+            const uint8_t* p = row + x * 4;
+            planeY[(size_t)y * width + x] = clampByte(0.299f * p[0] + 0.587f * p[1] + 0.114f * p[2]);
+        }
+    }
+
+    for (uint32_t cy = 0; cy < chromaHeight; cy++) {
+        for (uint32_t cx = 0; cx < chromaWidth; cx++) {
+            float r = 0.0f, g = 0.0f, b = 0.0f;
+            uint32_t samples = 0;
+            for (uint32_t dy = 0; dy < 2; dy++) {
+                uint32_t y = cy * 2 + dy;
+                if (y >= height) break;
+                for (uint32_t dx = 0; dx < 2; dx++) {
+                    uint32_t x = cx * 2 + dx;
+                    if (x >= width) break;
+                    const uint8_t* p = rgba + ((size_t)y * width + x) * 4;
+                    r += p[0];
+                    g += p[1];
+                    b += p[2];
+                    samples++;
+                }
+            }
+            r /= samples;
+            g /= samples;
+            b /= samples;
+            size_t index = (size_t)cy * chromaWidth + cx;
+            planeU[index] = clampByte(128.0f - 0.168736f * r - 0.331264f * g + 0.5f * b);
+            planeV[index] = clampByte(128.0f + 0.5f * r - 0.418688f * g - 0.081312f * b);
+        }
+    }
+}
+
+int writeFrame(FrameWriter* writer, const uint8_t* rgba) {
+    if (!writer || !writer->file || !rgba) {
+        return -1;
+    }
+
+    size_t pixels = (size_t)writer->width * writer->height;
+    size_t written = 0;
+    size_t expected = 0;
+
+    switch (writer->format) {
+        case FRAME_FORMAT_RAW:
+            expected = pixels * 4;
+            written = fwrite(rgba, 1, expected, writer->file);
+            break;
+        case FRAME_FORMAT_PPM:
+            for (size_t i = 0; i < pixels; i++) {
+                writer->scratch[i * 3 + 0] = rgba[i * 4 + 0];
+                writer->scratch[i * 3 + 1] = rgba[i * 4 + 1];
+                writer->scratch[i * 3 + 2] = rgba[i * 4 + 2];
+            }
+            fprintf(writer->file, "P6\n%u %u\n255\n", writer->width, writer->height);
+            expected = writer->scratchSize;
+            written = fwrite(writer->scratch, 1, expected, writer->file);
+            break;
+        case FRAME_FORMAT_Y4M:
+            convertToYuv420(writer, rgba, writer->scratch);
+            fputs("FRAME\n", writer->file);
+            expected = writer->scratchSize;
+            written = fwrite(writer->scratch, 1, expected, writer->file);
+            break;
+    }
+
+    if (written != expected) {
+        printf("Failed to write frame %u\n", writer->framesWritten);
+        return -1;
+    }
+    writer->framesWritten++;
+    return 0;
+}
+
+void closeFrameWriter(FrameWriter* writer) {
+    if (!writer) return;
+
+    if (writer->file) {
+        fclose(writer->file);
+        writer->file = NULL;
+    }
+    free(writer->scratch);
+    writer->scratch = NULL;
+    writer->scratchSize = 0;
+}
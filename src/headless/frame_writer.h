@@ -0,0 +1,74 @@
+#ifndef FRAME_WRITER_H
+#define FRAME_WRITER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Stream formats for rendered frames
+ */
+typedef enum {
+    FRAME_FORMAT_RAW,   // Tightly packed RGBA8, frames back to back
+    FRAME_FORMAT_PPM,   // One binary P6 image per frame (ffmpeg -f image2pipe)
+    FRAME_FORMAT_Y4M    // YUV4MPEG2, 4:2:0 JPEG-range (ffmpeg, mpv, x264 read it directly)
+} FrameFormat;
+
+/**
+ * Output stream of RGBA8 frames
+ */
+typedef struct {
+    FILE* file;
+    FrameFormat format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t framesWritten;
+    uint8_t* scratch;    // Converted frame (RGB or planar YUV)
+    size_t scratchSize;
+} FrameWriter;
+
+/**
+ * Pick the stream format from a file extension (.ppm, .y4m, anything else is raw)
+ *
+ * @param path - Output path
+ * @return Frame format
+ */
+FrameFormat frameFormatFromPath(const char* path);
+
+/**
+ * Open an output stream
+ *
+ * @param path - Output file path
+ * @param format - Stream format
+ * @param width - Frame width in pixels
+ * @param height - Frame height in pixels
+ * @param fps - Frame rate recorded in the Y4M header
+ * @param outWriter - Output writer
+ * @return 0 on success, -1 on failure
+ */
+int openFrameWriter(
+    const char* path,
+    FrameFormat format,
+    uint32_t width,
+    uint32_t height,
+    uint32_t fps,
+    FrameWriter* outWriter
+);
+
+/**
+ * Append one frame
+ *
+ * @param writer - Frame writer
+ * @param rgba - RGBA8 pixels, rows of width * 4 bytes
+ * @return 0 on success, -1 on failure
+ */
+int writeFrame(FrameWriter* writer, const uint8_t* rgba);
+
+/**
+ * Flush and close the stream
+ *
+ * @param writer - Frame writer
+ */
+void closeFrameWriter(FrameWriter* writer);
+
+#endif // FRAME_WRITER_H
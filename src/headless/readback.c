@@ -0,0 +1,162 @@
+#include "readback.h"
+#include <stdio.h>
+#include <string.h>
+
+VkResult createReadbackRing(
+    VkDevice device,
+    VkPhysicalDevice physicalDevice,
+    VkExtent2D extent,
+    uint32_t slotCount,
+    ReadbackRing* outRing
+) {
+    if (!device || !physicalDevice || !outRing || slotCount == 0) {
+        printf("Readback ring creation failed: Invalid parameters\n");
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    memset(outRing, 0, sizeof(ReadbackRing));
+    outRing->device = device;
+    outRing->extent = extent;
+    outRing->slotCount = slotCount > MAX_FRAMES_IN_FLIGHT ? MAX_FRAMES_IN_FLIGHT : slotCount;
+    outRing->frameSize = (VkDeviceSize)extent.width * extent.height * 4;
+
+    // CPU reads of uncached memory are very slow; prefer cached and invalidate instead
+    for (uint32_t i = 0; i < outRing->slotCount; i++) {
+        BufferCreateInfo createInfo = {0};
+        createInfo.size = outRing->frameSize;
+        createInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        createInfo.properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+        createInfo.allocator = NULL;  // Dedicated memory so whole-range invalidates stay atom-aligned
+
+        outRing->slots[i].hostCached = true;
+        VkResult result = createBuffer(device, physicalDevice, &createInfo, &outRing->slots[i].buffer);
+        if (result != VK_SUCCESS) {
+            outRing->slots[i].hostCached = false;
+            createInfo.properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+            result = createBuffer(device, physicalDevice, &createInfo, &outRing->slots[i].buffer);
+        }
+        if (result != VK_SUCCESS) {
+            printf("Failed to create readback buffer %u! Error: %d\n", i, result);
+            destroyReadbackRing(outRing);
+            return result;
+        }
+
+        void* mapped = NULL;
+        result = mapBuffer(device, &outRing->slots[i].buffer, &mapped);
+        if (result != VK_SUCCESS) {
+            printf("Failed to map readback buffer %u! Error: %d\n", i, result);
+            destroyReadbackRing(outRing);
+            return result;
+        }
+    }
+
+    printf("  Readback ring: %u x %llu bytes (%s)\n", outRing->slotCount,
+           (unsigned long long)outRing->frameSize, outRing->slots[0].hostCached ? "host cached" : "host coherent");
+    return VK_SUCCESS;
+}
+
+void recordReadbackCopy(
+    ReadbackRing* ring,
+    VkCommandBuffer commandBuffer,
+    VkImage image,
+    uint32_t slot
+) {
+    if (!ring || slot >= ring->slotCount) return;
+
+    ReadbackSlot* readback = &ring->slots[slot];
+
+    // The render pass left the image in TRANSFER_SRC_OPTIMAL behind an outgoing dependency
+    VkBufferImageCopy region = {0};
+    region.bufferOffset = 0;
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent.width = ring->extent.width;
+    region.imageExtent.height = ring->extent.height;
+    region.imageExtent.depth = 1;
+    vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           readback->buffer.buffer, 1, &region);
+
+    // Make the transfer visible to host reads once the fence signals
+    VkBufferMemoryBarrier barrier = {0};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = readback->buffer.buffer;
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+                         0, 0, NULL, 1, &barrier, 0, NULL);
+
+    readback->pending = true;
+    readback->frameIndex = ring->framesRecorded++;
+}
+
+VkResult collectReadback(
+    ReadbackRing* ring,
+    uint32_t slot,
+    FrameWriter* writer
+) {
+    if (!ring || slot >= ring->slotCount) return VK_ERROR_INITIALIZATION_FAILED;
+
+    ReadbackSlot* readback = &ring->slots[slot];
+    if (!readback->pending) return VK_SUCCESS;
+    readback->pending = false;
+
+    if (readback->hostCached) {
+        VkMappedMemoryRange range = {0};
+        range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+        range.memory = readback->buffer.memory;
+        range.offset = 0;
+        range.size = VK_WHOLE_SIZE;
+        VkResult result = vkInvalidateMappedMemoryRanges(ring->device, 1, &range);
+        if (result != VK_SUCCESS) {
+            printf("Failed to invalidate readback memory! Error: %d\n", result);
+            return result;
+        }
+    }
+
+    if (writer && writeFrame(writer, (const uint8_t*)readback->buffer.mapped) != 0) {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+    return VK_SUCCESS;
+}
+
+VkResult flushReadbackRing(
+    ReadbackRing* ring,
+    FrameWriter* writer
+) {
+    if (!ring) return VK_ERROR_INITIALIZATION_FAILED;
+
+    // Emit the oldest frame first so the stream stays in order
+    for (;;) {
+        uint32_t oldest = UINT32_MAX;
+        for (uint32_t i = 0; i < ring->slotCount; i++) {
+            if (ring->slots[i].pending &&
+                (oldest == UINT32_MAX || ring->slots[i].frameIndex < ring->slots[oldest].frameIndex)) {
+                oldest = i;
+            }
+        }
+        if (oldest == UINT32_MAX) return VK_SUCCESS;
+
+        VkResult result = collectReadback(ring, oldest, writer);
+        if (result != VK_SUCCESS) return result;
+    }
+}
+
+void destroyReadbackRing(ReadbackRing* ring) {
+    if (!ring || !ring->device) return;
+
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        if (ring->slots[i].buffer.buffer != VK_NULL_HANDLE) {
+            unmapBuffer(ring->device, &ring->slots[i].buffer);
+            destroyBuffer(ring->device, &ring->slots[i].buffer);
+        }
+        ring->slots[i].pending = false;
+    }
+}
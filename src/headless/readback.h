@@ -0,0 +1,101 @@
+#ifndef READBACK_H
+#define READBACK_H
+
+#include <vulkan/vulkan.h>
+#include <stdbool.h>
+#include "../common.h"
+#include "../graphics_pipeline/buffer.h"
+#include "frame_writer.h"
+
+/**
+ * Staging buffer receiving one frame slot's color image
+ */
+typedef struct {
+    Buffer buffer;
+    bool pending;          // Filled by a submission whose pixels were not written out yet
+    uint64_t frameIndex;   // Frame number copied into the buffer
+    bool hostCached;       // Cached memory must be invalidated before reading
+} ReadbackSlot;
+
+/**
+ * Ring of host-visible staging buffers, one per frame slot
+ * The copy is recorded into the slot's own command buffer; the pixels are
+ * consumed the next time the slot comes around, after its fence was waited
+ * on anyway, so the CPU never blocks on a readback.
+ */
+typedef struct {
+    VkDevice device;
+    ReadbackSlot slots[MAX_FRAMES_IN_FLIGHT];
+    uint32_t slotCount;
+    VkExtent2D extent;
+    VkDeviceSize frameSize;    // width * height * 4
+    uint64_t framesRecorded;
+} ReadbackRing;
+
+/**
+ * Create one staging buffer per frame slot
+ *
+ * @param device - VkDevice handle
+ * @param physicalDevice - VkPhysicalDevice for memory types
+ * @param extent - Size of the copied images
+ * @param slotCount - Number of frame slots (clamped to MAX_FRAMES_IN_FLIGHT)
+ * @param outRing - Output ring
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult createReadbackRing(
+    VkDevice device,
+    VkPhysicalDevice physicalDevice,
+    VkExtent2D extent,
+    uint32_t slotCount,
+    ReadbackRing* outRing
+);
+
+/**
+ * Record the copy of a color image (in TRANSFER_SRC_OPTIMAL) into the slot's staging buffer
+ *
+ * @param ring - Readback ring
+ * @param commandBuffer - Command buffer of the slot, after the render pass
+ * @param image - Color image to copy (RGBA8)
+ * @param slot - Frame slot index
+ */
+void recordReadbackCopy(
+    ReadbackRing* ring,
+    VkCommandBuffer commandBuffer,
+    VkImage image,
+    uint32_t slot
+);
+
+/**
+ * Write out the slot's pending frame; the slot's fence must have signaled
+ *
+ * @param ring - Readback ring
+ * @param slot - Frame slot index
+ * @param writer - Destination stream (NULL discards the frame)
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult collectReadback(
+    ReadbackRing* ring,
+    uint32_t slot,
+    FrameWriter* writer
+);
+
+/**
+ * Write out every pending frame in submission order; the device must be idle
+ *
+ * @param ring - Readback ring
+ * @param writer - Destination stream (NULL discards the frames)
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult flushReadbackRing(
+    ReadbackRing* ring,
+    FrameWriter* writer
+);
+
+/**
+ * Destroy the staging buffers
+ *
+ * @param ring - Readback ring
+ */
+void destroyReadbackRing(ReadbackRing* ring);
+
+#endif // READBACK_H
@@ -10,6 +10,15 @@ void initCamera(Camera* camera, vec3 position) {
     camera->sensitivity = 0.1f;
 }
 
+vec3 getCameraForward(const Camera* camera) {
+    vec3 front = vec3_create(
+        cosf(camera->yaw * (3.14159f / 180.0f)) * cosf(camera->pitch * (3.14159f / 180.0f)),
+        sinf(camera->pitch * (3.14159f / 180.0f)),
+        sinf(camera->yaw * (3.14159f / 180.0f)) * cosf(camera->pitch * (3.14159f / 180.0f))
+    );
+    return vec3_normalize(front);
+}
+
 void updateCamera(Camera* camera, SDL_Window* window, float deltaTime) {
     // Mouse look using relative movement
     int mouseX, mouseY;
@@ -32,12 +41,7 @@ void updateCamera(Camera* camera, SDL_Window* window, float deltaTime) {
     // Keyboard movement
     const Uint8* keys = SDL_GetKeyboardState(NULL);
 
-    vec3 front = vec3_create(
-        cosf(camera->yaw * (3.14159f / 180.0f)) * cosf(camera->pitch * (3.14159f / 180.0f)),
-        sinf(camera->pitch * (3.14159f / 180.0f)),
-        sinf(camera->yaw * (3.14159f / 180.0f)) * cosf(camera->pitch * (3.14159f / 180.0f))
-    );
-    front = vec3_normalize(front);
+    vec3 front = getCameraForward(camera);
 
     vec3 right = vec3_cross(front, vec3_create(0.0f, 1.0f, 0.0f));
     right = vec3_normalize(right);
@@ -61,12 +65,7 @@ void updateCamera(Camera* camera, SDL_Window* window, float deltaTime) {
 }
 
 mat4 getCameraViewMatrix(Camera* camera) {
-    vec3 front = vec3_create(
-        cosf(camera->yaw * (3.14159f / 180.0f)) * cosf(camera->pitch * (3.14159f / 180.0f)),
-        sinf(camera->pitch * (3.14159f / 180.0f)),
-        sinf(camera->yaw * (3.14159f / 180.0f)) * cosf(camera->pitch * (3.14159f / 180.0f))
-    );
-    front = vec3_normalize(front);
+    vec3 front = getCameraForward(camera);
 
     vec3 center = vec3_add(camera->position, front);
     vec3 up = vec3_create(0.0f, 1.0f, 0.0f);
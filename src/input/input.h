@@ -19,6 +19,9 @@ typedef struct {
 // Initialize camera with default values
 void initCamera(Camera* camera, vec3 position);
 
+// Unit vector the camera looks along
+vec3 getCameraForward(const Camera* camera);
+
 // Update camera based on input (called each frame)
 void updateCamera(Camera* camera, SDL_Window* window, float deltaTime);
 
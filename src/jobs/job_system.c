@@ -0,0 +1,347 @@
+#include "job_system.h"
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Failed searches before an idle worker goes to sleep
+#define JOB_IDLE_SPINS 64
+
+#define JOB_DEQUE_MASK (JOB_DEQUE_CAPACITY - 1)
+#define JOB_POOL_MASK (JOB_POOL_CAPACITY - 1)
+
+// Thread the caller runs on, NULL outside the job system
+static _Thread_local JobThread* currentThread = NULL;
+
+// --- Chase-Lev deque (Le, Pop, Cohen, Zappa Nardelli 2013, fixed capacity) ---
+
+// Owner only; false when full
+static bool dequePush(JobDeque* deque, Job* job) {
+    int_fast64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    int_fast64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    if (bottom - top >= JOB_DEQUE_CAPACITY) {
+        return false;
+    }
+    atomic_store_explicit(&deque->slots[bottom & JOB_DEQUE_MASK], job, memory_order_relaxed);
+    // Publishes the slot and the job's fields to thieves
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_release);
+    return true;
+}
+
+// Owner only; takes the newest job
+static Job* dequePop(JobDeque* deque) {
+    int_fast64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int_fast64_t top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    if (top > bottom) {
+        // Empty
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+        return NULL;
+    }
+    Job* job = atomic_load_explicit(&deque->slots[bottom & JOB_DEQUE_MASK], memory_order_relaxed);
+    if (top == bottom) {
+        // Last job: race the thieves for it
+        if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                                                     memory_order_seq_cst, memory_order_relaxed)) {
+            job = NULL;
+        }
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    }
+    return job;
+}
+
+// Any thread; takes the oldest job, NULL when empty or another thread won the race
+static Job* dequeSteal(JobDeque* deque) {
+    int_fast64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int_fast64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+    if (top >= bottom) {
+        return NULL;
+    }
+    Job* job = atomic_load_explicit(&deque->slots[top & JOB_DEQUE_MASK], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed)) {
+        return NULL;
+    }
+    return job;
+}
+
+// --- Scheduling ---
+
+static uint32_t nextRandom(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static void executeJob(JobSystem* system, Job* job) {
+    // Copied out so the slot is free while the job runs: a running job may be
+    // waiting for children allocated from the same pool
+    JobDecl decl = {job->function, job->data};
+    JobCounter* counter = job->counter;
+    atomic_store_explicit(&job->taken, true, memory_order_release);
+
+    decl.function(decl.data);
+    if (counter) {
+        atomic_fetch_sub_explicit(&counter->pending, 1, memory_order_acq_rel);
+    }
+    atomic_fetch_add_explicit(&system->executedCount, 1, memory_order_relaxed);
+}
+
+// Own deque first, then the other threads' starting at a random victim
+static Job* findJob(JobSystem* system, JobThread* self) {
+    Job* job = dequePop(&self->deque);
+    if (!job) {
+        uint32_t start = nextRandom(&self->stealSeed) % system->threadCount;
+        for (uint32_t i = 0; i < system->threadCount && !job; i++) {
+            JobThread* victim = &system->threads[(start + i) % system->threadCount];
+            if (victim == self) continue;
+            job = dequeSteal(&victim->deque);
+            if (job) {
+                atomic_fetch_add_explicit(&system->stolenCount, 1, memory_order_relaxed);
+            }
+        }
+    }
+    if (job) {
+        atomic_fetch_sub(&system->queuedJobs, 1);
+    }
+    return job;
+}
+
+// Run one queued job if there is one; returns whether it did
+static bool helpWithJob(JobSystem* system, JobThread* self) {
+    if (!self) return false;
+    if (self->index == 0 && runMainThreadJobs(system) > 0) return true;
+    Job* job = findJob(system, self);
+    if (!job) return false;
+    executeJob(system, job);
+    return true;
+}
+
+// The pool is a ring: a slot is reused only after its previous job was dequeued
+static Job* allocateJob(JobSystem* system, JobThread* self) {
+    Job* job = &self->pool[self->poolNext++ & JOB_POOL_MASK];
+    while (!atomic_load_explicit(&job->taken, memory_order_acquire)) {
+        if (!helpWithJob(system, self)) {
+            sched_yield();
+        }
+    }
+    return job;
+}
+
+static void wakeWorkers(JobSystem* system) {
+    if (atomic_load(&system->sleepingCount) == 0) return;
+    pthread_mutex_lock(&system->sleepMutex);
+    pthread_cond_broadcast(&system->wake);
+    pthread_mutex_unlock(&system->sleepMutex);
+}
+
+static void* jobWorkerMain(void* argument) {
+    JobThread* self = argument;
+    JobSystem* system = self->system;
+    currentThread = self;
+
+    uint32_t idleSpins = 0;
+    while (!atomic_load(&system->quit)) {
+        Job* job = findJob(system, self);
+        if (job) {
+            executeJob(system, job);
+            idleSpins = 0;
+            continue;
+        }
+        if (++idleSpins < JOB_IDLE_SPINS) {
+            sched_yield();
+            continue;
+        }
+
+        // queuedJobs is raised before sleepingCount is checked by submitters, so no wake-up is lost
+        pthread_mutex_lock(&system->sleepMutex);
+        atomic_fetch_add(&system->sleepingCount, 1);
+        while (atomic_load(&system->queuedJobs) == 0 && !atomic_load(&system->quit)) {
+            pthread_cond_wait(&system->wake, &system->sleepMutex);
+        }
+        atomic_fetch_sub(&system->sleepingCount, 1);
+        pthread_mutex_unlock(&system->sleepMutex);
+        idleSpins = 0;
+    }
+    return NULL;
+}
+
+int createJobSystem(uint32_t workerCount, JobSystem* outSystem) {
+    if (!outSystem) return -1;
+    if (currentThread) {
+        printf("Job system creation failed: The calling thread already belongs to a job system\n");
+        return -1;
+    }
+
+    if (workerCount == 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        workerCount = cores > 1 ? (uint32_t)(cores - 1) : 0;
+    }
+    if (workerCount > JOB_SYSTEM_MAX_THREADS - 1) {
+        workerCount = JOB_SYSTEM_MAX_THREADS - 1;
+    }
+
+    memset(outSystem, 0, sizeof(JobSystem));
+    outSystem->threadCount = workerCount + 1;
+    outSystem->threads = aligned_alloc(64, sizeof(JobThread) * outSystem->threadCount);
+    if (!outSystem->threads) {
+        printf("Job system creation failed: Out of memory\n");
+        return -1;
+    }
+    memset(outSystem->threads, 0, sizeof(JobThread) * outSystem->threadCount);
+    pthread_mutex_init(&outSystem->mainMutex, NULL);
+    pthread_mutex_init(&outSystem->sleepMutex, NULL);
+    pthread_cond_init(&outSystem->wake, NULL);
+
+    for (uint32_t i = 0; i < outSystem->threadCount; i++) {
+        JobThread* thread = &outSystem->threads[i];
+        thread->system = outSystem;
+        thread->index = i;
+        thread->stealSeed = i * 2654435761u + 1u;
+        for (uint32_t j = 0; j < JOB_POOL_CAPACITY; j++) {
+            atomic_init(&thread->pool[j].taken, true);
+        }
+    }
+    currentThread = &outSystem->threads[0];
+
+    for (uint32_t i = 1; i < outSystem->threadCount; i++) {
+        JobThread* thread = &outSystem->threads[i];
+        if (pthread_create(&thread->thread, NULL, jobWorkerMain, thread) != 0) {
+            printf("Job system creation failed: Could not start worker %u\n", i);
+            destroyJobSystem(outSystem);
+            return -1;
+        }
+        thread->started = true;
+    }
+
+    printf("Job system: %u workers + main thread\n", workerCount);
+    return 0;
+}
+
+void runJobs(JobSystem* system, const JobDecl* jobs, uint32_t count, JobCounter* counter) {
+    if (!system || !jobs || count == 0) return;
+    if (counter) {
+        atomic_fetch_add_explicit(&counter->pending, count, memory_order_relaxed);
+    }
+
+    JobThread* self = currentThread;
+    for (uint32_t i = 0; i < count; i++) {
+        if (!self) {
+            // Not a job system thread: nothing to queue on, so run in place
+            jobs[i].function(jobs[i].data);
+            if (counter) atomic_fetch_sub(&counter->pending, 1);
+            continue;
+        }
+
+        Job* job = allocateJob(system, self);
+        job->function = jobs[i].function;
+        job->data = jobs[i].data;
+        job->counter = counter;
+        atomic_store_explicit(&job->taken, false, memory_order_relaxed);
+
+        // Counted before the push so a thief never sees it negative
+        atomic_fetch_add(&system->queuedJobs, 1);
+        if (!dequePush(&self->deque, job)) {
+            atomic_fetch_sub(&system->queuedJobs, 1);
+            executeJob(system, job);
+        }
+    }
+    wakeWorkers(system);
+}
+
+void runMainThreadJob(JobSystem* system, JobDecl job, JobCounter* counter) {
+    if (!system || !job.function) return;
+    JobThread* self = currentThread;
+    if (!self || self->index == 0) {
+        // Already on the main thread (or outside the system)
+        job.function(job.data);
+        return;
+    }
+    if (counter) {
+        atomic_fetch_add_explicit(&counter->pending, 1, memory_order_relaxed);
+    }
+
+    Job* queued = allocateJob(system, self);
+    queued->function = job.function;
+    queued->data = job.data;
+    queued->counter = counter;
+    atomic_store_explicit(&queued->taken, false, memory_order_relaxed);
+
+    pthread_mutex_lock(&system->mainMutex);
+    while (system->mainCount == JOB_MAIN_QUEUE_CAPACITY) {
+        pthread_mutex_unlock(&system->mainMutex);
+        if (!helpWithJob(system, self)) {
+            sched_yield();
+        }
+        pthread_mutex_lock(&system->mainMutex);
+    }
+    system->mainQueue[(system->mainHead + system->mainCount) % JOB_MAIN_QUEUE_CAPACITY] = queued;
+    system->mainCount++;
+    pthread_mutex_unlock(&system->mainMutex);
+}
+
+void waitForCounter(JobSystem* system, JobCounter* counter) {
+    if (!system || !counter) return;
+    JobThread* self = currentThread;
+    while (atomic_load_explicit(&counter->pending, memory_order_acquire) > 0) {
+        if (!helpWithJob(system, self)) {
+            sched_yield();
+        }
+    }
+}
+
+uint32_t runMainThreadJobs(JobSystem* system) {
+    if (!system || !currentThread || currentThread->index != 0) return 0;
+
+    uint32_t ran = 0;
+    for (;;) {
+        pthread_mutex_lock(&system->mainMutex);
+        if (system->mainCount == 0) {
+            pthread_mutex_unlock(&system->mainMutex);
+            break;
+        }
+        Job* job = system->mainQueue[system->mainHead];
+        system->mainHead = (system->mainHead + 1) % JOB_MAIN_QUEUE_CAPACITY;
+        system->mainCount--;
+        pthread_mutex_unlock(&system->mainMutex);
+
+        executeJob(system, job);
+        ran++;
+    }
+    return ran;
+}
+
+uint32_t getJobThreadIndex(void) {
+    return currentThread ? currentThread->index : UINT32_MAX;
+}
+
+void destroyJobSystem(JobSystem* system) {
+    if (!system || !system->threads) return;
+
+    pthread_mutex_lock(&system->sleepMutex);
+    atomic_store(&system->quit, true);
+    pthread_cond_broadcast(&system->wake);
+    pthread_mutex_unlock(&system->sleepMutex);
+
+    for (uint32_t i = 1; i < system->threadCount; i++) {
+        if (system->threads[i].started) {
+            pthread_join(system->threads[i].thread, NULL);
+        }
+    }
+    if (currentThread == &system->threads[0]) {
+        currentThread = NULL;
+    }
+
+    pthread_cond_destroy(&system->wake);
+    pthread_mutex_destroy(&system->sleepMutex);
+    pthread_mutex_destroy(&system->mainMutex);
+    free(system->threads);
+    memset(system, 0, sizeof(JobSystem));
+}
@@ -0,0 +1,172 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Threads including the main thread
+#define JOB_SYSTEM_MAX_THREADS 64
+
+// Jobs one thread can have queued (power of two); beyond it runJobs executes inline
+#define JOB_DEQUE_CAPACITY 4096
+
+// Jobs one thread can have queued and not yet started before it helps drain them
+#define JOB_POOL_CAPACITY 4096
+
+// Jobs queued for the main thread only
+#define JOB_MAIN_QUEUE_CAPACITY 1024
+
+/**
+ * Work function of a job
+ *
+ * @param data - Pointer given in the JobDecl
+ */
+typedef void (*JobFunction)(void* data);
+
+/**
+ * A job to run: a function and its argument
+ */
+typedef struct {
+    JobFunction function;
+    void* data;
+} JobDecl;
+
+/**
+ * Counts unfinished jobs; zero-initialize before first use
+ * Every job submitted with a counter increments it and decrements it when done,
+ * so waiting for a counter waits for a whole batch and counters chain batches
+ * that depend on each other.
+ */
+typedef struct {
+    atomic_uint pending;
+} JobCounter;
+
+/**
+ * Queued job, one cache line so neighbouring jobs never share one
+ */
+typedef struct {
+    JobFunction function;
+    void* data;
+    JobCounter* counter;
+    atomic_bool taken;                // Set once a thread dequeued it, lets the pool slot be reused
+    char _pad[64 - 2 * sizeof(void*) - sizeof(JobCounter*) - sizeof(atomic_bool)];
+} Job;
+
+/**
+ * Chase-Lev work-stealing deque
+ * The owning thread pushes and pops at the bottom (LIFO, cache-warm); other
+ * threads steal from the top (FIFO, oldest and usually largest work first).
+ */
+typedef struct {
+    _Alignas(64) atomic_int_fast64_t top;
+    _Alignas(64) atomic_int_fast64_t bottom;
+    _Alignas(64) _Atomic(Job*) slots[JOB_DEQUE_CAPACITY];
+} JobDeque;
+
+/**
+ * Per-thread state: its deque and the pool its submitted jobs live in
+ */
+typedef struct {
+    JobDeque deque;
+    Job pool[JOB_POOL_CAPACITY];
+    uint32_t poolNext;                // Owner only
+    uint32_t stealSeed;               // Victim selection, owner only
+    pthread_t thread;
+    bool started;
+    struct JobSystem* system;
+    uint32_t index;
+} JobThread;
+
+/**
+ * Work-stealing task scheduler
+ * Thread 0 is the thread that created the system (the main thread); it runs
+ * jobs while it waits and is the only one that runs main-thread jobs, for APIs
+ * such as SDL and presentation that must stay on it.
+ */
+typedef struct JobSystem {
+    JobThread* threads;               // threadCount entries, 64-byte aligned
+    uint32_t threadCount;
+
+    // Main-thread queue, guarded by mainMutex
+    pthread_mutex_t mainMutex;
+    Job* mainQueue[JOB_MAIN_QUEUE_CAPACITY];
+    uint32_t mainHead;
+    uint32_t mainCount;
+
+    // Idle workers sleep here until jobs are queued
+    pthread_mutex_t sleepMutex;
+    pthread_cond_t wake;
+    atomic_uint queuedJobs;           // Pushed but not yet taken, across all deques
+    atomic_uint sleepingCount;
+    atomic_bool quit;
+
+    // Statistics
+    atomic_uint_fast64_t executedCount;
+    atomic_uint_fast64_t stolenCount;
+} JobSystem;
+
+/**
+ * Start the worker threads; the calling thread becomes thread 0
+ *
+ * @param workerCount - Threads besides the caller, 0 for one per remaining core
+ * @param outSystem - Output system (must stay at the same address while it runs)
+ * @return 0 on success, -1 on failure
+ */
+int createJobSystem(uint32_t workerCount, JobSystem* outSystem);
+
+/**
+ * Queue jobs on the calling thread's deque; idle threads steal them
+ * Must be called from thread 0 or from inside a job.
+ *
+ * @param system - Job system
+ * @param jobs - Jobs to run
+ * @param count - Number of jobs
+ * @param counter - Incremented by count and decremented as each job finishes, may be NULL
+ */
+void runJobs(JobSystem* system, const JobDecl* jobs, uint32_t count, JobCounter* counter);
+
+/**
+ * Queue a job that only the main thread runs (in waitForCounter or runMainThreadJobs)
+ * Can be called from any job system thread.
+ *
+ * @param system - Job system
+ * @param job - Job to run
+ * @param counter - As for runJobs, may be NULL
+ */
+void runMainThreadJob(JobSystem* system, JobDecl job, JobCounter* counter);
+
+/**
+ * Run queued jobs on the calling thread until the counter reaches zero
+ * Waiting inside a job is allowed; the thread keeps executing other jobs meanwhile.
+ *
+ * @param system - Job system
+ * @param counter - Counter to wait for
+ */
+void waitForCounter(JobSystem* system, JobCounter* counter);
+
+/**
+ * Run the jobs queued for the main thread (call from thread 0, e.g. once per frame)
+ *
+ * @param system - Job system
+ * @return Number of jobs run
+ */
+uint32_t runMainThreadJobs(JobSystem* system);
+
+/**
+ * Index of the calling thread, for per-thread resources
+ *
+ * @return 0 for the main thread, 1.. for workers, UINT32_MAX outside the job system
+ */
+uint32_t getJobThreadIndex(void);
+
+/**
+ * Stop the workers and free the system
+ * Every submitted job must have finished.
+ *
+ * @param system - System to destroy
+ */
+void destroyJobSystem(JobSystem* system);
+
+#endif // JOB_SYSTEM_H
@@ -1,19 +1,223 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "application.h"
 #include "model_loaders/objloader.h"
+#include "model_loaders/obj_parallel.h"
+#include "model_loaders/mesh_cache.h"
+#include "model_loaders/mesh_optimizer.h"
+#include "profiling/cpu_profiler.h"
+#include "benchmark/benchmark.h"
+
+#define HEADLESS_DEFAULT_FRAMES 120u
+#define BENCHMARK_DEFAULT_OUTPUT "benchmark.json"
+
+// Procedural benchmark path: one revolution around the model every 10 simulated seconds
+#define BENCHMARK_ORBIT_RADIUS 3.0f
+#define BENCHMARK_ORBIT_HEIGHT 1.0f
+#define BENCHMARK_ORBIT_PERIOD 10.0f
+
+static void printUsage(const char* program) {
+    printf("Usage: %s [options] [model.obj]\n", program);
+    printf("  --optimize    Reorder the mesh for vertex cache, overdraw and vertex fetch\n");
+    printf("  --mesh-cache DIR  Directory of baked meshes, reused while the OBJ is unchanged (default %s)\n",
+           MESH_CACHE_DEFAULT_DIR);
+    printf("  --no-mesh-cache   Always parse the OBJ and do not bake it\n");
+    printf("  --trace FILE  Record CPU zones and write a Chrome trace (chrome://tracing, Perfetto)\n");
+    printf("  --headless    Render offscreen without a window (no display or WSI needed)\n");
+    printf("  --frames N    Number of frames to render headless (default %u)\n", HEADLESS_DEFAULT_FRAMES);
+    printf("  --size WxH    Headless image size (default %ux%u)\n", WINDOW_WIDTH, WINDOW_HEIGHT);
+    printf("  --output FILE Stream headless frames to FILE (.ppm, .y4m, otherwise raw RGBA8); implies --headless\n");
+    printf("  --instances N Draw N copies of the mesh on a grid with one instanced draw\n");
+    printf("  --scene N     Draw N objects on a grid, one draw each with push constants\n");
+    printf("  --record-threads N  Record the --scene draws as N jobs into secondary command buffers\n");
+    printf("  --job-threads N  Worker threads for the job system (default: one per remaining core)\n");
+    printf("  --no-cull     Draw every scene object or instance, even outside the view\n");
+    printf("  --gpu-cull    Cull the --instances field in a compute pass and draw it indirectly\n");
+    printf("  --no-occlusion  With --gpu-cull, skip the depth pyramid test against the previous frame\n");
+    printf("  --benchmark orbit|FILE  Play a camera path at a fixed timestep and report frame times\n");
+    printf("                --frames N measured frames (default %u), --warmup N (default %u)\n",
+           BENCHMARK_DEFAULT_FRAMES, BENCHMARK_DEFAULT_WARMUP);
+    printf("  --benchmark-output FILE  Benchmark JSON report (default %s)\n", BENCHMARK_DEFAULT_OUTPUT);
+    printf("  --record-path FILE       Record the interactive camera as a path for --benchmark\n");
+}
 
 int main(int argc, char* argv[]) {
     ApplicationContext app = {0};
     
+    // Parse options; the first non-option argument is the OBJ file
+    const char* objPath = NULL;
+    const char* tracePath = NULL;
+    const char* benchmarkPathName = NULL;
+    const char* recordPath = NULL;
+    const char* meshCacheDir = MESH_CACHE_DEFAULT_DIR;
+    bool optimizeMesh = false;
+    bool framesGiven = false;
+    uint32_t warmupFrames = BENCHMARK_DEFAULT_WARMUP;
+    app.benchmarkOutputPath = BENCHMARK_DEFAULT_OUTPUT;
+    app.headlessExtent = (VkExtent2D){WINDOW_WIDTH, WINDOW_HEIGHT};
+    app.headlessFrameCount = HEADLESS_DEFAULT_FRAMES;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--optimize") == 0) {
+            optimizeMesh = true;
+        } else if (strcmp(argv[i], "--mesh-cache") == 0 && i + 1 < argc) {
+            meshCacheDir = argv[++i];
+        } else if (strcmp(argv[i], "--no-mesh-cache") == 0) {
+            meshCacheDir = NULL;
+        } else if (strcmp(argv[i], "--headless") == 0) {
+            app.headless = true;
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            app.headlessFrameCount = (uint32_t)strtoul(argv[++i], NULL, 10);
+            framesGiven = true;
+        } else if (strcmp(argv[i], "--instances") == 0 && i + 1 < argc) {
+            app.instanceCount = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--no-cull") == 0) {
+            app.cullingDisabled = true;
+        } else if (strcmp(argv[i], "--gpu-cull") == 0) {
+            app.gpuCulling = true;
+        } else if (strcmp(argv[i], "--no-occlusion") == 0) {
+            app.occlusionDisabled = true;
+        } else if (strcmp(argv[i], "--scene") == 0 && i + 1 < argc) {
+            app.sceneObjectCount = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--record-threads") == 0 && i + 1 < argc) {
+            app.recordChunkCount = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--job-threads") == 0 && i + 1 < argc) {
+            app.jobThreadCount = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            warmupFrames = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--benchmark") == 0 && i + 1 < argc) {
+            benchmarkPathName = argv[++i];
+        } else if (strcmp(argv[i], "--benchmark-output") == 0 && i + 1 < argc) {
+            app.benchmarkOutputPath = argv[++i];
+        } else if (strcmp(argv[i], "--record-path") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            unsigned int width = 0, height = 0;
+            if (sscanf(argv[++i], "%ux%u", &width, &height) != 2 || width == 0 || height == 0) {
+                printf("Invalid --size %s, expected WxH\n", argv[i]);
+                return -1;
+            }
+            app.headlessExtent = (VkExtent2D){width, height};
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            app.headlessOutputPath = argv[++i];
+            app.headless = true;
+        } else if (strcmp(argv[i], "--trace") == 0) {
+            if (i + 1 >= argc) {
+                printf("--trace requires an output file\n");
+                return -1;
+            }
+            tracePath = argv[++i];
+        } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else if (strncmp(argv[i], "--", 2) == 0) {
+            printf("Unknown option: %s\n", argv[i]);
+            printUsage(argv[0]);
+            return -1;
+        } else if (!objPath) {
+            objPath = argv[i];
+        }
+    }
+
+    if (app.sceneObjectCount > 0 && app.instanceCount > 0) {
+        printf("--scene and --instances cannot be combined\n");
+        return -1;
+    }
+    if (app.gpuCulling && (app.instanceCount == 0 || app.cullingDisabled)) {
+        printf("--gpu-cull needs --instances and cannot be combined with --no-cull\n");
+        return -1;
+    }
+    if (app.recordChunkCount > 0 && app.sceneObjectCount == 0) {
+        printf("--record-threads needs --scene\n");
+        return -1;
+    }
+    if (app.recordChunkCount > PARALLEL_RECORD_MAX_CHUNKS) {
+        printf("--record-threads is limited to %u chunks\n", PARALLEL_RECORD_MAX_CHUNKS);
+        return -1;
+    }
+    if (app.occlusionDisabled && !app.gpuCulling) {
+        printf("--no-occlusion only applies to --gpu-cull\n");
+        return -1;
+    }
+
+    if (tracePath) {
+        cpuProfilerInit(0);
+        cpuProfilerSetThreadName("main");
+    }
+
+    // The main thread becomes job thread 0, which keeps SDL and presentation on it
+    if (createJobSystem(app.jobThreadCount, &app.jobSystem) != 0) {
+        cpuProfilerShutdown();
+        return -1;
+    }
+
+    Benchmark benchmark = {0};
+    if (benchmarkPathName) {
+        CameraPath cameraPath;
+        if (strcmp(benchmarkPathName, "orbit") == 0) {
+            createOrbitCameraPath(BENCHMARK_ORBIT_RADIUS, BENCHMARK_ORBIT_HEIGHT, BENCHMARK_ORBIT_PERIOD, &cameraPath);
+        } else if (loadCameraPath(benchmarkPathName, &cameraPath) != 0) {
+            destroyJobSystem(&app.jobSystem);
+            cpuProfilerShutdown();
+            return -1;
+        }
+        uint32_t measuredFrames = framesGiven ? app.headlessFrameCount : BENCHMARK_DEFAULT_FRAMES;
+        if (createBenchmark(cameraPath, measuredFrames, warmupFrames, BENCHMARK_DEFAULT_TIMESTEP, &benchmark) != 0) {
+            printf("Failed to create benchmark!\n");
+            freeCameraPath(&cameraPath);
+            destroyJobSystem(&app.jobSystem);
+            cpuProfilerShutdown();
+            return -1;
+        }
+        app.benchmark = &benchmark;
+    } else if (recordPath) {
+        app.cameraRecordFile = fopen(recordPath, "w");
+        if (!app.cameraRecordFile) {
+            printf("Failed to open camera path for recording: %s\n", recordPath);
+            destroyJobSystem(&app.jobSystem);
+            cpuProfilerShutdown();
+            return -1;
+        }
+        fprintf(app.cameraRecordFile, "# time x y z yaw pitch\n");
+    }
+
     // Check for OBJ file argument
     bool useMesh = false;
-    if (argc > 1) {
-        if (load_obj(argv[1], &app.mesh) == 0) {
+    if (objPath) {
+        // The baked streams reflect --optimize, so it is part of the cache key
+        uint32_t bakeFlags = optimizeMesh ? TMESH_FLAG_OPTIMIZED : 0;
+        char cachePath[1024];
+        bool cacheable = meshCacheDir &&
+                         get_mesh_cache_path(meshCacheDir, objPath, cachePath, sizeof(cachePath)) == 0;
+
+        cpuZoneBegin("load_obj");
+        if (cacheable && load_baked_mesh(cachePath, objPath, bakeFlags, &app.bakedMesh) == 0) {
+            // Uploaded straight from the mapping; only counts and bounds are needed on the CPU
+            get_baked_mesh_info(&app.bakedMesh, &app.mesh);
             useMesh = true;
-            printf("Loaded OBJ file: %s\n", argv[1]);
+            cpuZoneEnd();
         } else {
-            printf("Failed to load OBJ file: %s, using default cube\n", argv[1]);
+            int loadResult = load_obj_parallel(objPath, &app.jobSystem, &app.mesh);
+            if (loadResult != 0) {
+                // tinyobj skips what it cannot parse instead of rejecting the file
+                printf("Parallel OBJ parse failed, retrying with tinyobj: %s\n", objPath);
+                loadResult = load_obj(objPath, &app.mesh);
+            }
+            cpuZoneEnd();
+            if (loadResult == 0) {
+                useMesh = true;
+                printf("Loaded OBJ file: %s\n", objPath);
+                if (optimizeMesh) {
+                    optimize_mesh(&app.mesh);
+                }
+                if (cacheable) {
+                    cpuZoneBegin("bake_mesh");
+                    bake_mesh(&app.mesh, objPath, bakeFlags, cachePath);
+                    cpuZoneEnd();
+                }
+            } else {
+                printf("Failed to load OBJ file: %s, using default cube\n", objPath);
+            }
         }
     } else {
         printf("No OBJ file specified, using default cube\n");
@@ -27,16 +231,38 @@ int main(int argc, char* argv[]) {
     if (initializeApplication(&app) != 0) {
         printf("Failed to initialize application!\n");
         if (useMesh) {
+            unload_baked_mesh(&app.bakedMesh);
             free_mesh(&app.mesh);
         }
+        destroyBenchmark(&benchmark);
+        if (app.cameraRecordFile) {
+            fclose(app.cameraRecordFile);
+        }
+        destroyJobSystem(&app.jobSystem);
+        cpuProfilerShutdown();
         return -1;
     }
     
+    // The vertex and index streams are on the GPU now
+    unload_baked_mesh(&app.bakedMesh);
+
     printDeviceInfo(&app);
     
     runApplication(&app);
     
     cleanupApplication(&app);
+    destroyJobSystem(&app.jobSystem);
+
+    destroyBenchmark(&benchmark);
+    if (app.cameraRecordFile) {
+        fclose(app.cameraRecordFile);
+        printf("Camera path recorded to %s\n", recordPath);
+    }
+
+    if (tracePath) {
+        cpuProfilerWriteChromeTrace(tracePath);
+        cpuProfilerShutdown();
+    }
     
     if (useMesh) {
         free_mesh(&app.mesh);
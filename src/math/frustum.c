@@ -0,0 +1,125 @@
+#include "frustum.h"
+#include "simd_lanes.h"
+#include <math.h>
+
+Frustum frustum_from_matrix(mat4 viewProj) {
+    const float* m = viewProj.m;
+    Frustum frustum;
+
+    // Clip-space inequalities -w <= x, y, z <= w written as combinations of the matrix rows
+    for (int axis = 0; axis < 3; axis++) {
+        for (int k = 0; k < 4; k++) {
+            float row3 = m[k * 4 + 3];
+            float rowAxis = m[k * 4 + axis];
+            frustum.planes[axis * 2 + 0][k] = row3 + rowAxis;
+            frustum.planes[axis * 2 + 1][k] = row3 - rowAxis;
+        }
+    }
+
+    for (int i = 0; i < FRUSTUM_PLANE_COUNT; i++) {
+        float* plane = frustum.planes[i];
+        float length = sqrtf(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        if (length > 0.0f) {
+            float invLength = 1.0f / length;
+            plane[0] *= invLength;
+            plane[1] *= invLength;
+            plane[2] *= invLength;
+            plane[3] *= invLength;
+        }
+    }
+    return frustum;
+}
+
+// Signed distance of the box corner furthest along the plane normal
+static inline float planeMaxDistance(const float* plane, float minX, float minY, float minZ,
+                                     float maxX, float maxY, float maxZ) {
+    return (plane[0] >= 0.0f ? plane[0] * maxX : plane[0] * minX) +
+           (plane[1] >= 0.0f ? plane[1] * maxY : plane[1] * minY) +
+           (plane[2] >= 0.0f ? plane[2] * maxZ : plane[2] * minZ) +
+           plane[3];
+}
+
+bool frustum_test_aabb(const Frustum* frustum, vec3 min, vec3 max) {
+    for (int i = 0; i < FRUSTUM_PLANE_COUNT; i++) {
+        if (planeMaxDistance(frustum->planes[i], min.x, min.y, min.z, max.x, max.y, max.z) < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+FrustumClass frustum_classify_aabb(const Frustum* frustum, const float min[3], const float max[3], uint32_t* planeMask) {
+    uint32_t mask = *planeMask;
+    for (int i = 0; i < FRUSTUM_PLANE_COUNT; i++) {
+        uint32_t bit = 1u << i;
+        if (!(mask & bit)) continue;
+        const float* plane = frustum->planes[i];
+        if (planeMaxDistance(plane, min[0], min[1], min[2], max[0], max[1], max[2]) < 0.0f) {
+            return FRUSTUM_OUTSIDE;
+        }
+        // If even the corner least far along the normal is inside, the whole box is
+        float nearest = (plane[0] >= 0.0f ? plane[0] * min[0] : plane[0] * max[0]) +
+                        (plane[1] >= 0.0f ? plane[1] * min[1] : plane[1] * max[1]) +
+                        (plane[2] >= 0.0f ? plane[2] * min[2] : plane[2] * max[2]) +
+                        plane[3];
+        if (nearest >= 0.0f) mask &= ~bit;
+    }
+    *planeMask = mask;
+    return mask ? FRUSTUM_INTERSECTS : FRUSTUM_INSIDE;
+}
+
+size_t frustum_cull_aabbs_soa_scalar(const Frustum* frustum, AabbSoA boxes, size_t count, uint8_t* outVisible) {
+    size_t visibleCount = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint8_t visible = 1;
+        for (int p = 0; p < FRUSTUM_PLANE_COUNT && visible; p++) {
+            visible = planeMaxDistance(frustum->planes[p], boxes.minX[i], boxes.minY[i], boxes.minZ[i],
+                                       boxes.maxX[i], boxes.maxY[i], boxes.maxZ[i]) >= 0.0f;
+        }
+        outVisible[i] = visible;
+        visibleCount += visible;
+    }
+    return visibleCount;
+}
+
+#if defined(LANES)
+
+size_t frustum_cull_aabbs_soa(const Frustum* frustum, AabbSoA boxes, size_t count, uint8_t* outVisible) {
+    const int allOutside = (1 << LANES) - 1;
+    size_t visibleCount = 0;
+
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        floatN minX = fLoad(boxes.minX + i), maxX = fLoad(boxes.maxX + i);
+        floatN minY = fLoad(boxes.minY + i), maxY = fLoad(boxes.maxY + i);
+        floatN minZ = fLoad(boxes.minZ + i), maxZ = fLoad(boxes.maxZ + i);
+
+        // max(n * min, n * max) picks the furthest corner per axis without branching on the normal's sign
+        int outside = 0;
+        for (int p = 0; p < FRUSTUM_PLANE_COUNT && outside != allOutside; p++) {
+            const float* plane = frustum->planes[p];
+            floatN nx = fSplat(plane[0]), ny = fSplat(plane[1]), nz = fSplat(plane[2]);
+            floatN distance = fAdd(fAdd(fMax(fMul(nx, minX), fMul(nx, maxX)),
+                                        fMax(fMul(ny, minY), fMul(ny, maxY))),
+                                   fAdd(fMax(fMul(nz, minZ), fMul(nz, maxZ)), fSplat(plane[3])));
+            outside |= fNegativeMask(distance);
+        }
+
+        for (int lane = 0; lane < LANES; lane++) {
+            uint8_t visible = !((outside >> lane) & 1);
+            outVisible[i + lane] = visible;
+            visibleCount += visible;
+        }
+    }
+
+    AabbSoA tail = {boxes.minX + i, boxes.minY + i, boxes.minZ + i, boxes.maxX + i, boxes.maxY + i, boxes.maxZ + i};
+    return visibleCount + frustum_cull_aabbs_soa_scalar(frustum, tail, count - i, outVisible + i);
+}
+
+#else
+
+size_t frustum_cull_aabbs_soa(const Frustum* frustum, AabbSoA boxes, size_t count, uint8_t* outVisible) {
+    return frustum_cull_aabbs_soa_scalar(frustum, boxes, count, outVisible);
+}
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "matrix.h"
+#include "transform_batch.h"
+
+#define FRUSTUM_PLANE_COUNT 6
+
+/**
+ * View frustum as six inward-facing planes (left, right, bottom, top, near, far)
+ * A point p is inside plane i when dot(plane.xyz, p) + plane.w >= 0.
+ */
+typedef struct {
+    float planes[FRUSTUM_PLANE_COUNT][4];
+} Frustum;
+
+// Plane mask with every plane still to be tested
+#define FRUSTUM_ALL_PLANES ((1u << FRUSTUM_PLANE_COUNT) - 1)
+
+/**
+ * Result of classifying a box against the frustum
+ */
+typedef enum {
+    FRUSTUM_OUTSIDE,
+    FRUSTUM_INTERSECTS,
+    FRUSTUM_INSIDE
+} FrustumClass;
+
+/**
+ * Extract normalized planes from a view-projection matrix (Gribb-Hartmann)
+ * Uses the -w..w clip depth range of mat4_perspective, which is never tighter
+ * than the 0..w range Vulkan clips to, so culling stays conservative.
+ *
+ * @param viewProj - proj * view (world-space planes) or proj * view * model (object space)
+ * @return Frustum planes
+ */
+Frustum frustum_from_matrix(mat4 viewProj);
+
+/**
+ * Test one box against the frustum
+ *
+ * @param frustum - Frustum
+ * @param min - Box minimum corner
+ * @param max - Box maximum corner
+ * @return false only when the box is entirely outside one of the planes
+ */
+bool frustum_test_aabb(const Frustum* frustum, vec3 min, vec3 max);
+
+/**
+ * Classify a box against the planes in *planeMask, for hierarchical culling
+ * Planes the box is fully inside are cleared from the mask, so the box's
+ * children only need to be tested against the planes it straddles.
+ *
+ * @param frustum - Frustum
+ * @param min - Box minimum corner (x, y, z)
+ * @param max - Box maximum corner (x, y, z)
+ * @param planeMask - In: planes to test (bit i = plane i); out: planes still straddled
+ * @return FRUSTUM_INSIDE once no planes remain, FRUSTUM_OUTSIDE if outside any plane
+ */
+FrustumClass frustum_classify_aabb(const Frustum* frustum, const float min[3], const float max[3], uint32_t* planeMask);
+
+/**
+ * Test many boxes; for each plane only the corner furthest along its normal is checked
+ * Boxes crossing a plane corner-to-corner may be kept even though they are outside,
+ * which is the usual conservative result of a plane-by-plane test.
+ *
+ * @param frustum - Frustum
+ * @param boxes - World-space boxes
+ * @param count - Number of boxes
+ * @param outVisible - count bytes, 1 where the box may be visible and 0 where it is culled
+ * @return Number of visible boxes
+ */
+size_t frustum_cull_aabbs_soa(const Frustum* frustum, AabbSoA boxes, size_t count, uint8_t* outVisible);
+
+/**
+ * Portable reference version of frustum_cull_aabbs_soa
+ */
+size_t frustum_cull_aabbs_soa_scalar(const Frustum* frustum, AabbSoA boxes, size_t count, uint8_t* outVisible);
+
+#endif // FRUSTUM_H
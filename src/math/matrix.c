@@ -1,4 +1,5 @@
 #include "matrix.h"
+#include "matrix_simd.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -109,69 +110,48 @@ mat4 mat4_scale(vec3 scale) {
     return result;
 }
 
+// The operations below dispatch to the SSE/AVX/NEON kernels in matrix_simd.c
+
 mat4 mat4_multiply(mat4 a, mat4 b) {
-    mat4 result = {0};
-    for (int i = 0; i < 4; i++) {
-        for (int j = 0; j < 4; j++) {
-            for (int k = 0; k < 4; k++) {
-                result.m[i * 4 + j] += a.m[k * 4 + j] * b.m[i * 4 + k];
-            }
-        }
-    }
+    mat4 result;
+    mat4_simd_multiply(result.m, a.m, b.m);
     return result;
 }
 
 vec4 mat4_multiply_vec4(mat4 m, vec4 v) {
-    vec4 result;
-    result.x = m.m[0] * v.x + m.m[4] * v.y + m.m[8] * v.z + m.m[12] * v.w;
-    result.y = m.m[1] * v.x + m.m[5] * v.y + m.m[9] * v.z + m.m[13] * v.w;
-    result.z = m.m[2] * v.x + m.m[6] * v.y + m.m[10] * v.z + m.m[14] * v.w;
-    result.w = m.m[3] * v.x + m.m[7] * v.y + m.m[11] * v.z + m.m[15] * v.w;
-    return result;
+    float in[4] = {v.x, v.y, v.z, v.w};
+    float out[4];
+    mat4_simd_multiply_vec4(out, m.m, in);
+    return (vec4){out[0], out[1], out[2], out[3]};
 }
 
 mat4 mat4_transpose(mat4 m) {
     mat4 result;
-    for (int i = 0; i < 4; i++) {
-        for (int j = 0; j < 4; j++) {
-            result.m[i * 4 + j] = m.m[j * 4 + i];
-        }
-    }
+    mat4_simd_transpose(result.m, m.m);
     return result;
 }
 
 mat4 mat4_inverse(mat4 m) {
-    // Simplified inverse for affine matrices (translation, rotation, scale)
-    // For full inverse, would need more complex implementation
-    mat4 result = mat4_identity();
+    mat4 result;
+    mat4_simd_inverse(result.m, m.m);
+    return result;
+}
 
-    // Extract rotation/scale part (3x3)
-    float rot_scale[9] = {
-        m.m[0], m.m[1], m.m[2],
-        m.m[4], m.m[5], m.m[6],
-        m.m[8], m.m[9], m.m[10]
-    };
-
-    // Transpose rotation/scale
-    result.m[0] = rot_scale[0];
-    result.m[1] = rot_scale[3];
-    result.m[2] = rot_scale[6];
-    result.m[4] = rot_scale[1];
-    result.m[5] = rot_scale[4];
-    result.m[6] = rot_scale[7];
-    result.m[8] = rot_scale[2];
-    result.m[9] = rot_scale[5];
-    result.m[10] = rot_scale[8];
-
-    // Handle translation
-    vec3 translation = {m.m[12], m.m[13], m.m[14]};
-    vec3 inv_translation = vec3_mul(translation, -1.0f);
-    vec4 inv_trans_vec4 = {inv_translation.x, inv_translation.y, inv_translation.z, 1.0f};
-    vec4 transformed = mat4_multiply_vec4(result, inv_trans_vec4);
-    result.m[12] = transformed.x;
-    result.m[13] = transformed.y;
-    result.m[14] = transformed.z;
+mat4 mat4_inverse_rigid(mat4 m) {
+    mat4 result;
+    mat4_simd_inverse_rigid(result.m, m.m);
+    return result;
+}
 
+mat4 mat4_normal_matrix(mat4 model) {
+    // Inverse-transpose keeps normals perpendicular under non-uniform scale;
+    // translation is dropped since normals are directions
+    mat4 result;
+    mat4_simd_inverse(result.m, model.m);
+    mat4_simd_transpose(result.m, result.m);
+    result.m[3] = result.m[7] = result.m[11] = 0.0f;
+    result.m[12] = result.m[13] = result.m[14] = 0.0f;
+    result.m[15] = 1.0f;
     return result;
 }
 
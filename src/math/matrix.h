@@ -31,7 +31,9 @@ mat4 mat4_scale(vec3 scale);
 mat4 mat4_multiply(mat4 a, mat4 b);
 vec4 mat4_multiply_vec4(mat4 m, vec4 v);
 mat4 mat4_transpose(mat4 m);
-mat4 mat4_inverse(mat4 m);
+mat4 mat4_inverse(mat4 m);          // General; singular matrices give the identity
+mat4 mat4_inverse_rigid(mat4 m);    // Rotation + translation only, cheaper
+mat4 mat4_normal_matrix(mat4 model); // transpose(inverse(model)) without translation, for normals
 
 /**
  * Utility functions
@@ -0,0 +1,401 @@
+#include "matrix_simd.h"
+
+#if defined(MATH_SIMD_SSE)
+#include <immintrin.h>
+#elif defined(MATH_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+// ============================================================================
+// Scalar reference
+// ============================================================================
+
+void mat4_scalar_multiply(float out[16], const float a[16], const float b[16]) {
+    float result[16] = {0};
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            for (int k = 0; k < 4; k++) {
+                result[i * 4 + j] += a[k * 4 + j] * b[i * 4 + k];
+            }
+        }
+    }
+    for (int i = 0; i < 16; i++) out[i] = result[i];
+}
+
+void mat4_scalar_multiply_vec4(float out[4], const float m[16], const float v[4]) {
+    float x = v[0], y = v[1], z = v[2], w = v[3];
+    out[0] = m[0] * x + m[4] * y + m[8] * z + m[12] * w;
+    out[1] = m[1] * x + m[5] * y + m[9] * z + m[13] * w;
+    out[2] = m[2] * x + m[6] * y + m[10] * z + m[14] * w;
+    out[3] = m[3] * x + m[7] * y + m[11] * z + m[15] * w;
+}
+
+void mat4_scalar_transpose(float out[16], const float m[16]) {
+    float result[16];
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            result[i * 4 + j] = m[j * 4 + i];
+        }
+    }
+    for (int i = 0; i < 16; i++) out[i] = result[i];
+}
+
+// Rigid inverse: transpose the rotation, rotate the negated translation
+void mat4_scalar_inverse_rigid(float out[16], const float m[16]) {
+    float tx = m[12], ty = m[13], tz = m[14];
+    float result[16] = {
+        m[0], m[4], m[8], 0.0f,
+        m[1], m[5], m[9], 0.0f,
+        m[2], m[6], m[10], 0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f
+    };
+    result[12] = -(result[0] * tx + result[4] * ty + result[8] * tz);
+    result[13] = -(result[1] * tx + result[5] * ty + result[9] * tz);
+    result[14] = -(result[2] * tx + result[6] * ty + result[10] * tz);
+    for (int i = 0; i < 16; i++) out[i] = result[i];
+}
+
+// General inverse by cofactor expansion; singular matrices give the identity
+void mat4_scalar_inverse(float out[16], const float m[16]) {
+    float inv[16];
+    inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+    inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+    inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+    inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+    inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+    inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+    inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+    inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+    inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+    inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+    inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+    inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+    inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+    inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+    inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+    inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+    float det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+    if (det == 0.0f) {
+        for (int i = 0; i < 16; i++) out[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+        return;
+    }
+    float invDet = 1.0f / det;
+    for (int i = 0; i < 16; i++) out[i] = inv[i] * invDet;
+}
+
+// ============================================================================
+// SSE / AVX
+// ============================================================================
+
+#if defined(MATH_SIMD_SSE)
+
+// Column i of a*b is a's columns weighted by column i of b
+static inline __m128 combineColumns(__m128 a0, __m128 a1, __m128 a2, __m128 a3, __m128 b) {
+    __m128 r = _mm_mul_ps(a0, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 0, 0, 0)));
+    r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 1, 1, 1))));
+    r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 2, 2, 2))));
+    r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 3, 3))));
+    return r;
+}
+
+void mat4_simd_multiply(float out[16], const float a[16], const float b[16]) {
+#if defined(MATH_SIMD_AVX)
+    // Two result columns per 256-bit register: a's columns are duplicated into
+    // both halves, and an in-lane permute broadcasts b's element per half.
+    __m256 a0 = _mm256_broadcast_ps((const __m128*)(a + 0));
+    __m256 a1 = _mm256_broadcast_ps((const __m128*)(a + 4));
+    __m256 a2 = _mm256_broadcast_ps((const __m128*)(a + 8));
+    __m256 a3 = _mm256_broadcast_ps((const __m128*)(a + 12));
+    __m256 b01 = _mm256_loadu_ps(b);
+    __m256 b23 = _mm256_loadu_ps(b + 8);
+
+    __m256 r01 = _mm256_mul_ps(a0, _mm256_permute_ps(b01, 0x00));
+    r01 = _mm256_add_ps(r01, _mm256_mul_ps(a1, _mm256_permute_ps(b01, 0x55)));
+    r01 = _mm256_add_ps(r01, _mm256_mul_ps(a2, _mm256_permute_ps(b01, 0xAA)));
+    r01 = _mm256_add_ps(r01, _mm256_mul_ps(a3, _mm256_permute_ps(b01, 0xFF)));
+
+    __m256 r23 = _mm256_mul_ps(a0, _mm256_permute_ps(b23, 0x00));
+    r23 = _mm256_add_ps(r23, _mm256_mul_ps(a1, _mm256_permute_ps(b23, 0x55)));
+    r23 = _mm256_add_ps(r23, _mm256_mul_ps(a2, _mm256_permute_ps(b23, 0xAA)));
+    r23 = _mm256_add_ps(r23, _mm256_mul_ps(a3, _mm256_permute_ps(b23, 0xFF)));
+
+    _mm256_storeu_ps(out, r01);
+    _mm256_storeu_ps(out + 8, r23);
+#else
+    __m128 a0 = _mm_loadu_ps(a + 0);
+    __m128 a1 = _mm_loadu_ps(a + 4);
+    __m128 a2 = _mm_loadu_ps(a + 8);
+    __m128 a3 = _mm_loadu_ps(a + 12);
+    __m128 r0 = combineColumns(a0, a1, a2, a3, _mm_loadu_ps(b + 0));
+    __m128 r1 = combineColumns(a0, a1, a2, a3, _mm_loadu_ps(b + 4));
+    __m128 r2 = combineColumns(a0, a1, a2, a3, _mm_loadu_ps(b + 8));
+    __m128 r3 = combineColumns(a0, a1, a2, a3, _mm_loadu_ps(b + 12));
+    _mm_storeu_ps(out + 0, r0);
+    _mm_storeu_ps(out + 4, r1);
+    _mm_storeu_ps(out + 8, r2);
+    _mm_storeu_ps(out + 12, r3);
+#endif
+}
+
+void mat4_simd_multiply_vec4(float out[4], const float m[16], const float v[4]) {
+    __m128 r = combineColumns(
+        _mm_loadu_ps(m + 0), _mm_loadu_ps(m + 4), _mm_loadu_ps(m + 8), _mm_loadu_ps(m + 12),
+        _mm_loadu_ps(v)
+    );
+    _mm_storeu_ps(out, r);
+}
+
+void mat4_simd_transpose(float out[16], const float m[16]) {
+    __m128 c0 = _mm_loadu_ps(m + 0);
+    __m128 c1 = _mm_loadu_ps(m + 4);
+    __m128 c2 = _mm_loadu_ps(m + 8);
+    __m128 c3 = _mm_loadu_ps(m + 12);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    _mm_storeu_ps(out + 0, c0);
+    _mm_storeu_ps(out + 4, c1);
+    _mm_storeu_ps(out + 8, c2);
+    _mm_storeu_ps(out + 12, c3);
+}
+
+void mat4_simd_inverse_rigid(float out[16], const float m[16]) {
+    // Transpose the 3x3 block by transposing the whole matrix with the
+    // translation column replaced by (0,0,0,1) and w components cleared
+    __m128 wMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+    __m128 c0 = _mm_and_ps(_mm_loadu_ps(m + 0), wMask);
+    __m128 c1 = _mm_and_ps(_mm_loadu_ps(m + 4), wMask);
+    __m128 c2 = _mm_and_ps(_mm_loadu_ps(m + 8), wMask);
+    __m128 t = _mm_loadu_ps(m + 12);
+    __m128 c3 = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+    // New translation = -(R^T * t), w = 1 comes from c3
+    __m128 rt = _mm_mul_ps(c0, _mm_shuffle_ps(t, t, _MM_SHUFFLE(0, 0, 0, 0)));
+    rt = _mm_add_ps(rt, _mm_mul_ps(c1, _mm_shuffle_ps(t, t, _MM_SHUFFLE(1, 1, 1, 1))));
+    rt = _mm_add_ps(rt, _mm_mul_ps(c2, _mm_shuffle_ps(t, t, _MM_SHUFFLE(2, 2, 2, 2))));
+    c3 = _mm_sub_ps(c3, rt);
+
+    _mm_storeu_ps(out + 0, c0);
+    _mm_storeu_ps(out + 4, c1);
+    _mm_storeu_ps(out + 8, c2);
+    _mm_storeu_ps(out + 12, c3);
+}
+
+// 4-wide helpers shared with the NEON build by the cofactor inverse below
+typedef __m128 float4;
+static inline float4 f4Mul(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+static inline float4 f4Add(float4 a, float4 b) { return _mm_add_ps(a, b); }
+static inline float4 f4Sub(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+static inline float4 f4SwapPairs(float4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)); }
+static inline float4 f4SwapHalves(float4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)); }
+static inline float4 f4Splat(float x) { return _mm_set1_ps(x); }
+static inline float f4First(float4 v) { return _mm_cvtss_f32(v); }
+static inline void f4Store(float* p, float4 v) { _mm_storeu_ps(p, v); }
+
+static inline void f4LoadRows(const float m[16], float4 rows[4]) {
+    rows[0] = _mm_loadu_ps(m + 0);
+    rows[1] = _mm_loadu_ps(m + 4);
+    rows[2] = _mm_loadu_ps(m + 8);
+    rows[3] = _mm_loadu_ps(m + 12);
+    _MM_TRANSPOSE4_PS(rows[0], rows[1], rows[2], rows[3]);
+}
+
+// ============================================================================
+// NEON
+// ============================================================================
+
+#elif defined(MATH_SIMD_NEON)
+
+static inline float32x4_t combineColumns(float32x4_t a0, float32x4_t a1, float32x4_t a2, float32x4_t a3, float32x4_t b) {
+    float32x4_t r = vmulq_lane_f32(a0, vget_low_f32(b), 0);
+    r = vmlaq_lane_f32(r, a1, vget_low_f32(b), 1);
+    r = vmlaq_lane_f32(r, a2, vget_high_f32(b), 0);
+    r = vmlaq_lane_f32(r, a3, vget_high_f32(b), 1);
+    return r;
+}
+
+void mat4_simd_multiply(float out[16], const float a[16], const float b[16]) {
+    float32x4_t a0 = vld1q_f32(a + 0);
+    float32x4_t a1 = vld1q_f32(a + 4);
+    float32x4_t a2 = vld1q_f32(a + 8);
+    float32x4_t a3 = vld1q_f32(a + 12);
+    float32x4_t r0 = combineColumns(a0, a1, a2, a3, vld1q_f32(b + 0));
+    float32x4_t r1 = combineColumns(a0, a1, a2, a3, vld1q_f32(b + 4));
+    float32x4_t r2 = combineColumns(a0, a1, a2, a3, vld1q_f32(b + 8));
+    float32x4_t r3 = combineColumns(a0, a1, a2, a3, vld1q_f32(b + 12));
+    vst1q_f32(out + 0, r0);
+    vst1q_f32(out + 4, r1);
+    vst1q_f32(out + 8, r2);
+    vst1q_f32(out + 12, r3);
+}
+
+void mat4_simd_multiply_vec4(float out[4], const float m[16], const float v[4]) {
+    float32x4_t r = combineColumns(
+        vld1q_f32(m + 0), vld1q_f32(m + 4), vld1q_f32(m + 8), vld1q_f32(m + 12),
+        vld1q_f32(v)
+    );
+    vst1q_f32(out, r);
+}
+
+void mat4_simd_transpose(float out[16], const float m[16]) {
+    // De-interleaving load with stride 4 yields the rows
+    float32x4x4_t rows = vld4q_f32(m);
+    vst1q_f32(out + 0, rows.val[0]);
+    vst1q_f32(out + 4, rows.val[1]);
+    vst1q_f32(out + 8, rows.val[2]);
+    vst1q_f32(out + 12, rows.val[3]);
+}
+
+void mat4_simd_inverse_rigid(float out[16], const float m[16]) {
+    float32x4x4_t rows = vld4q_f32(m);
+    float32x4_t t = vld1q_f32(m + 12);
+
+    // Rows 0-2 of m restricted to xyz are the columns of R^T
+    float32x4_t c0 = vsetq_lane_f32(0.0f, rows.val[0], 3);
+    float32x4_t c1 = vsetq_lane_f32(0.0f, rows.val[1], 3);
+    float32x4_t c2 = vsetq_lane_f32(0.0f, rows.val[2], 3);
+    float32x4_t c3 = vsetq_lane_f32(1.0f, vdupq_n_f32(0.0f), 3);
+
+    float32x4_t rt = vmulq_lane_f32(c0, vget_low_f32(t), 0);
+    rt = vmlaq_lane_f32(rt, c1, vget_low_f32(t), 1);
+    rt = vmlaq_lane_f32(rt, c2, vget_high_f32(t), 0);
+    c3 = vsubq_f32(c3, rt);
+
+    vst1q_f32(out + 0, c0);
+    vst1q_f32(out + 4, c1);
+    vst1q_f32(out + 8, c2);
+    vst1q_f32(out + 12, c3);
+}
+
+typedef float32x4_t float4;
+static inline float4 f4Mul(float4 a, float4 b) { return vmulq_f32(a, b); }
+static inline float4 f4Add(float4 a, float4 b) { return vaddq_f32(a, b); }
+static inline float4 f4Sub(float4 a, float4 b) { return vsubq_f32(a, b); }
+static inline float4 f4SwapPairs(float4 v) { return vrev64q_f32(v); }
+static inline float4 f4SwapHalves(float4 v) { return vextq_f32(v, v, 2); }
+static inline float4 f4Splat(float x) { return vdupq_n_f32(x); }
+static inline float f4First(float4 v) { return vgetq_lane_f32(v, 0); }
+static inline void f4Store(float* p, float4 v) { vst1q_f32(p, v); }
+
+static inline void f4LoadRows(const float m[16], float4 rows[4]) {
+    float32x4x4_t t = vld4q_f32(m);
+    rows[0] = t.val[0];
+    rows[1] = t.val[1];
+    rows[2] = t.val[2];
+    rows[3] = t.val[3];
+}
+
+// ============================================================================
+// No SIMD available
+// ============================================================================
+
+#else
+
+void mat4_simd_multiply(float out[16], const float a[16], const float b[16]) {
+    mat4_scalar_multiply(out, a, b);
+}
+
+void mat4_simd_multiply_vec4(float out[4], const float m[16], const float v[4]) {
+    mat4_scalar_multiply_vec4(out, m, v);
+}
+
+void mat4_simd_transpose(float out[16], const float m[16]) {
+    mat4_scalar_transpose(out, m);
+}
+
+void mat4_simd_inverse(float out[16], const float m[16]) {
+    mat4_scalar_inverse(out, m);
+}
+
+void mat4_simd_inverse_rigid(float out[16], const float m[16]) {
+    mat4_scalar_inverse_rigid(out, m);
+}
+
+#endif
+
+// ============================================================================
+// General inverse (SSE/AVX and NEON)
+// ============================================================================
+
+#if defined(MATH_SIMD_SSE) || defined(MATH_SIMD_NEON)
+
+/*
+ * Cramer's rule with the cofactors computed four at a time, after Intel's
+ * "Streaming SIMD Extensions - Inverse of 4x4 Matrix" (AP-928). The rows are
+ * taken with their 2x2 halves arranged so that every cofactor term is a
+ * product of two rows plus a pair or half swap. inverse(M^T) = inverse(M)^T,
+ * so the column-major layout passes through unchanged.
+ */
+void mat4_simd_inverse(float out[16], const float m[16]) {
+    float4 rows[4];
+    f4LoadRows(m, rows);
+    float4 row0 = rows[0];
+    float4 row1 = f4SwapHalves(rows[1]);
+    float4 row2 = rows[2];
+    float4 row3 = f4SwapHalves(rows[3]);
+    float4 minor0, minor1, minor2, minor3, tmp;
+
+    tmp = f4SwapPairs(f4Mul(row2, row3));
+    minor0 = f4Mul(row1, tmp);
+    minor1 = f4Mul(row0, tmp);
+    tmp = f4SwapHalves(tmp);
+    minor0 = f4Sub(f4Mul(row1, tmp), minor0);
+    minor1 = f4Sub(f4Mul(row0, tmp), minor1);
+    minor1 = f4SwapHalves(minor1);
+
+    tmp = f4SwapPairs(f4Mul(row1, row2));
+    minor0 = f4Add(f4Mul(row3, tmp), minor0);
+    minor3 = f4Mul(row0, tmp);
+    tmp = f4SwapHalves(tmp);
+    minor0 = f4Sub(minor0, f4Mul(row3, tmp));
+    minor3 = f4Sub(f4Mul(row0, tmp), minor3);
+    minor3 = f4SwapHalves(minor3);
+
+    tmp = f4SwapPairs(f4Mul(f4SwapHalves(row1), row3));
+    row2 = f4SwapHalves(row2);
+    minor0 = f4Add(f4Mul(row2, tmp), minor0);
+    minor2 = f4Mul(row0, tmp);
+    tmp = f4SwapHalves(tmp);
+    minor0 = f4Sub(minor0, f4Mul(row2, tmp));
+    minor2 = f4Sub(f4Mul(row0, tmp), minor2);
+    minor2 = f4SwapHalves(minor2);
+
+    tmp = f4SwapPairs(f4Mul(row0, row1));
+    minor2 = f4Add(f4Mul(row3, tmp), minor2);
+    minor3 = f4Sub(f4Mul(row2, tmp), minor3);
+    tmp = f4SwapHalves(tmp);
+    minor2 = f4Sub(f4Mul(row3, tmp), minor2);
+    minor3 = f4Sub(minor3, f4Mul(row2, tmp));
+
+    tmp = f4SwapPairs(f4Mul(row0, row3));
+    minor1 = f4Sub(minor1, f4Mul(row2, tmp));
+    minor2 = f4Add(f4Mul(row1, tmp), minor2);
+    tmp = f4SwapHalves(tmp);
+    minor1 = f4Add(f4Mul(row2, tmp), minor1);
+    minor2 = f4Sub(minor2, f4Mul(row1, tmp));
+
+    tmp = f4SwapPairs(f4Mul(row0, row2));
+    minor1 = f4Add(f4Mul(row3, tmp), minor1);
+    minor3 = f4Sub(minor3, f4Mul(row1, tmp));
+    tmp = f4SwapHalves(tmp);
+    minor1 = f4Sub(minor1, f4Mul(row3, tmp));
+    minor3 = f4Add(f4Mul(row1, tmp), minor3);
+
+    // Determinant = row0 . minor0, summed horizontally into every lane
+    float4 det = f4Mul(row0, minor0);
+    det = f4Add(f4SwapHalves(det), det);
+    det = f4Add(f4SwapPairs(det), det);
+    float determinant = f4First(det);
+    if (determinant == 0.0f) {
+        for (int i = 0; i < 16; i++) out[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+        return;
+    }
+
+    float4 invDet = f4Splat(1.0f / determinant);
+    f4Store(out + 0, f4Mul(minor0, invDet));
+    f4Store(out + 4, f4Mul(minor1, invDet));
+    f4Store(out + 8, f4Mul(minor2, invDet));
+    f4Store(out + 12, f4Mul(minor3, invDet));
+}
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef MATRIX_SIMD_H
+#define MATRIX_SIMD_H
+
+#include "matrix.h"
+
+/**
+ * Instruction set used by the mat4 kernels, chosen at compile time.
+ * x86-64 always has SSE2; AVX needs -mavx (make ARCH_FLAGS=-mavx2).
+ * Define MATH_FORCE_SCALAR to build the portable loops only.
+ */
+#if defined(MATH_FORCE_SCALAR)
+    #define MATH_SIMD_NAME "scalar"
+#elif defined(__AVX__)
+    #define MATH_SIMD_AVX 1
+    #define MATH_SIMD_SSE 1
+    #define MATH_SIMD_NAME "AVX"
+#elif defined(__SSE2__) || defined(_M_X64)
+    #define MATH_SIMD_SSE 1
+    #define MATH_SIMD_NAME "SSE"
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define MATH_SIMD_NEON 1
+    #define MATH_SIMD_NAME "NEON"
+#else
+    #define MATH_SIMD_NAME "scalar"
+#endif
+
+/**
+ * 16-byte aligned variants for hot paths: every column is one aligned vector
+ * load and a matrix never straddles a cache line (mat4 only guarantees 4 bytes).
+ */
+typedef struct {
+    _Alignas(16) float m[16];  // Column-major, same layout as mat4
+} mat4a;
+
+typedef union {
+    _Alignas(16) float v[4];
+    struct {
+        float x, y, z, w;
+    };
+} vec4a;
+
+/**
+ * Kernels on raw column-major arrays (no alignment required).
+ * out may alias any input: every input is read before out is written.
+ * inverse is general (singular matrices give the identity); inverse_rigid
+ * assumes rotation + translation and is cheaper.
+ */
+void mat4_simd_multiply(float out[16], const float a[16], const float b[16]);
+void mat4_simd_multiply_vec4(float out[4], const float m[16], const float v[4]);
+void mat4_simd_transpose(float out[16], const float m[16]);
+void mat4_simd_inverse(float out[16], const float m[16]);
+void mat4_simd_inverse_rigid(float out[16], const float m[16]);
+
+/**
+ * Portable reference versions, always built (fallback and benchmark baseline)
+ */
+void mat4_scalar_multiply(float out[16], const float a[16], const float b[16]);
+void mat4_scalar_multiply_vec4(float out[4], const float m[16], const float v[4]);
+void mat4_scalar_transpose(float out[16], const float m[16]);
+void mat4_scalar_inverse(float out[16], const float m[16]);
+void mat4_scalar_inverse_rigid(float out[16], const float m[16]);
+
+/**
+ * Aligned variants, taking pointers instead of 64-byte structs by value
+ */
+static inline void mat4a_multiply(mat4a* out, const mat4a* a, const mat4a* b) {
+    mat4_simd_multiply(out->m, a->m, b->m);
+}
+
+static inline void mat4a_multiply_vec4(vec4a* out, const mat4a* m, const vec4a* v) {
+    mat4_simd_multiply_vec4(out->v, m->m, v->v);
+}
+
+static inline void mat4a_transpose(mat4a* out, const mat4a* m) {
+    mat4_simd_transpose(out->m, m->m);
+}
+
+static inline void mat4a_inverse(mat4a* out, const mat4a* m) {
+    mat4_simd_inverse(out->m, m->m);
+}
+
+static inline void mat4a_inverse_rigid(mat4a* out, const mat4a* m) {
+    mat4_simd_inverse_rigid(out->m, m->m);
+}
+
+static inline mat4a mat4a_from_mat4(mat4 m) {
+    mat4a result;
+    for (int i = 0; i < 16; i++) result.m[i] = m.m[i];
+    return result;
+}
+
+static inline mat4 mat4_from_mat4a(const mat4a* m) {
+    mat4 result;
+    for (int i = 0; i < 16; i++) result.m[i] = m->m[i];
+    return result;
+}
+
+#endif // MATRIX_SIMD_H
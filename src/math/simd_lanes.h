@@ -0,0 +1,95 @@
+#ifndef SIMD_LANES_H
+#define SIMD_LANES_H
+
+// Internal to src/math: one float vector type and the few operations the batch
+// kernels need, so each kernel is written once for every instruction set.
+// LANES is left undefined in scalar builds.
+
+#include <stdint.h>
+#include "matrix_simd.h"
+
+// ============================================================================
+// SIMD lanes: 8 floats with AVX, 4 with SSE/NEON
+// ============================================================================
+
+#if defined(MATH_SIMD_AVX)
+#include <immintrin.h>
+#define LANES 8
+typedef __m256 floatN;
+static inline floatN fLoad(const float* p) { return _mm256_loadu_ps(p); }
+static inline void fStore(float* p, floatN v) { _mm256_storeu_ps(p, v); }
+static inline floatN fLoadAligned(const float* p) { return _mm256_load_ps(p); }
+static inline void fStoreAligned(float* p, floatN v) { _mm256_store_ps(p, v); }
+static inline floatN fSplat(float x) { return _mm256_set1_ps(x); }
+static inline floatN fAdd(floatN a, floatN b) { return _mm256_add_ps(a, b); }
+static inline floatN fSub(floatN a, floatN b) { return _mm256_sub_ps(a, b); }
+static inline floatN fMul(floatN a, floatN b) { return _mm256_mul_ps(a, b); }
+static inline floatN fMax(floatN a, floatN b) { return _mm256_max_ps(a, b); }
+// Bit i set when lane i is negative
+static inline int fNegativeMask(floatN v) { return _mm256_movemask_ps(_mm256_cmp_ps(v, _mm256_setzero_ps(), _CMP_LT_OQ)); }
+static inline floatN fInvSqrt(floatN v) { return _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(v)); }
+#elif defined(MATH_SIMD_SSE)
+#include <immintrin.h>
+#define LANES 4
+typedef __m128 floatN;
+static inline floatN fLoad(const float* p) { return _mm_loadu_ps(p); }
+static inline void fStore(float* p, floatN v) { _mm_storeu_ps(p, v); }
+static inline floatN fLoadAligned(const float* p) { return _mm_load_ps(p); }
+static inline void fStoreAligned(float* p, floatN v) { _mm_store_ps(p, v); }
+static inline floatN fSplat(float x) { return _mm_set1_ps(x); }
+static inline floatN fAdd(floatN a, floatN b) { return _mm_add_ps(a, b); }
+static inline floatN fSub(floatN a, floatN b) { return _mm_sub_ps(a, b); }
+static inline floatN fMul(floatN a, floatN b) { return _mm_mul_ps(a, b); }
+static inline floatN fMax(floatN a, floatN b) { return _mm_max_ps(a, b); }
+static inline int fNegativeMask(floatN v) { return _mm_movemask_ps(_mm_cmplt_ps(v, _mm_setzero_ps())); }
+static inline floatN fInvSqrt(floatN v) { return _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(v)); }
+#elif defined(MATH_SIMD_NEON)
+#include <arm_neon.h>
+#define LANES 4
+typedef float32x4_t floatN;
+static inline floatN fLoad(const float* p) { return vld1q_f32(p); }
+static inline void fStore(float* p, floatN v) { vst1q_f32(p, v); }
+// NEON has no aligned-only form; the hint lets the compiler emit the aligned encoding
+static inline floatN fLoadAligned(const float* p) { return vld1q_f32(__builtin_assume_aligned(p, 16)); }
+static inline void fStoreAligned(float* p, floatN v) { vst1q_f32(__builtin_assume_aligned(p, 16), v); }
+static inline floatN fSplat(float x) { return vdupq_n_f32(x); }
+static inline floatN fAdd(floatN a, floatN b) { return vaddq_f32(a, b); }
+static inline floatN fSub(floatN a, floatN b) { return vsubq_f32(a, b); }
+static inline floatN fMul(floatN a, floatN b) { return vmulq_f32(a, b); }
+static inline floatN fMax(floatN a, floatN b) { return vmaxq_f32(a, b); }
+static inline int fNegativeMask(floatN v) {
+    static const uint32_t laneBits[4] = {1, 2, 4, 8};
+    uint32x4_t negative = vandq_u32(vcltq_f32(v, vdupq_n_f32(0.0f)), vld1q_u32(laneBits));
+    return (int)vaddvq_u32(negative);
+}
+static inline floatN fInvSqrt(floatN v) {
+    // Estimate refined by two Newton-Raphson steps (~23 bits, like the division path)
+    floatN r = vrsqrteq_f32(v);
+    r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(v, r), r));
+    r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(v, r), r));
+    return r;
+}
+#endif
+
+#if defined(LANES)
+#include <stdbool.h>
+
+// Bytes of one vector; arrays aligned to this take the aligned load/store path
+#define LANE_BYTES (LANES * sizeof(float))
+
+static inline bool fIsAligned(const float* p) { return ((uintptr_t)p & (LANE_BYTES - 1)) == 0; }
+
+// Called with a constant flag from kernels inlined once per path
+static inline floatN fLoadAs(const float* p, bool aligned) { return aligned ? fLoadAligned(p) : fLoad(p); }
+static inline void fStoreAs(float* p, floatN v, bool aligned) {
+    if (aligned) fStoreAligned(p, v);
+    else fStore(p, v);
+}
+
+// a * x + b * y + c * z
+static inline floatN fDot3(floatN a, floatN x, floatN b, floatN y, floatN c, floatN z) {
+    return fAdd(fAdd(fMul(a, x), fMul(b, y)), fMul(c, z));
+}
+#endif
+
+#endif // SIMD_LANES_H
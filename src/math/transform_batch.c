@@ -0,0 +1,205 @@
+#include "transform_batch.h"
+#include "simd_lanes.h"
+#include <math.h>
+#include <stdlib.h>
+
+// Squared lengths below this are treated as zero when renormalizing
+#define NORMAL_EPSILON_SQ 1e-30f
+
+float* soa_alloc_floats(size_t count) {
+    void* data = NULL;
+    size_t bytes = count * sizeof(float);
+    if (posix_memalign(&data, SOA_ALIGNMENT, bytes ? bytes : SOA_ALIGNMENT) != 0) {
+        return NULL;
+    }
+    return data;
+}
+
+void soa_free_floats(float* data) {
+    free(data);
+}
+
+static inline Vec3SoA offsetVec3(Vec3SoA v, size_t i) {
+    return (Vec3SoA){v.x + i, v.y + i, v.z + i};
+}
+
+static inline AabbSoA offsetAabb(AabbSoA b, size_t i) {
+    return (AabbSoA){b.minX + i, b.minY + i, b.minZ + i, b.maxX + i, b.maxY + i, b.maxZ + i};
+}
+
+// ============================================================================
+// Scalar reference
+// ============================================================================
+
+void transform_points_soa_scalar(const mat4* m, Vec3SoA in, Vec3SoA out, size_t count) {
+    const float* a = m->m;
+    for (size_t i = 0; i < count; i++) {
+        float x = in.x[i], y = in.y[i], z = in.z[i];
+        out.x[i] = a[0] * x + a[4] * y + a[8] * z + a[12];
+        out.y[i] = a[1] * x + a[5] * y + a[9] * z + a[13];
+        out.z[i] = a[2] * x + a[6] * y + a[10] * z + a[14];
+    }
+}
+
+void transform_normals_soa_scalar(const mat4* normalMatrix, Vec3SoA in, Vec3SoA out, size_t count) {
+    const float* a = normalMatrix->m;
+    for (size_t i = 0; i < count; i++) {
+        float x = in.x[i], y = in.y[i], z = in.z[i];
+        float nx = a[0] * x + a[4] * y + a[8] * z;
+        float ny = a[1] * x + a[5] * y + a[9] * z;
+        float nz = a[2] * x + a[6] * y + a[10] * z;
+        float lengthSq = nx * nx + ny * ny + nz * nz;
+        float invLength = 1.0f / sqrtf(lengthSq > NORMAL_EPSILON_SQ ? lengthSq : NORMAL_EPSILON_SQ);
+        out.x[i] = nx * invLength;
+        out.y[i] = ny * invLength;
+        out.z[i] = nz * invLength;
+    }
+}
+
+void transform_aabbs_soa_scalar(const mat4* m, AabbSoA in, AabbSoA out, size_t count) {
+    const float* a = m->m;
+    for (size_t i = 0; i < count; i++) {
+        float cx = (in.minX[i] + in.maxX[i]) * 0.5f;
+        float cy = (in.minY[i] + in.maxY[i]) * 0.5f;
+        float cz = (in.minZ[i] + in.maxZ[i]) * 0.5f;
+        float ex = (in.maxX[i] - in.minX[i]) * 0.5f;
+        float ey = (in.maxY[i] - in.minY[i]) * 0.5f;
+        float ez = (in.maxZ[i] - in.minZ[i]) * 0.5f;
+
+        float ncx = a[0] * cx + a[4] * cy + a[8] * cz + a[12];
+        float ncy = a[1] * cx + a[5] * cy + a[9] * cz + a[13];
+        float ncz = a[2] * cx + a[6] * cy + a[10] * cz + a[14];
+        float nex = fabsf(a[0]) * ex + fabsf(a[4]) * ey + fabsf(a[8]) * ez;
+        float ney = fabsf(a[1]) * ex + fabsf(a[5]) * ey + fabsf(a[9]) * ez;
+        float nez = fabsf(a[2]) * ex + fabsf(a[6]) * ey + fabsf(a[10]) * ez;
+
+        out.minX[i] = ncx - nex;
+        out.minY[i] = ncy - ney;
+        out.minZ[i] = ncz - nez;
+        out.maxX[i] = ncx + nex;
+        out.maxY[i] = ncy + ney;
+        out.maxZ[i] = ncz + nez;
+    }
+}
+
+#if defined(LANES)
+
+static inline void transform_points_lanes(const mat4* m, Vec3SoA in, Vec3SoA out, size_t count, bool aligned) {
+    const float* a = m->m;
+    floatN m0 = fSplat(a[0]), m1 = fSplat(a[1]), m2 = fSplat(a[2]);
+    floatN m4 = fSplat(a[4]), m5 = fSplat(a[5]), m6 = fSplat(a[6]);
+    floatN m8 = fSplat(a[8]), m9 = fSplat(a[9]), m10 = fSplat(a[10]);
+    floatN tx = fSplat(a[12]), ty = fSplat(a[13]), tz = fSplat(a[14]);
+
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        floatN x = fLoadAs(in.x + i, aligned);
+        floatN y = fLoadAs(in.y + i, aligned);
+        floatN z = fLoadAs(in.z + i, aligned);
+        fStoreAs(out.x + i, fAdd(fDot3(m0, x, m4, y, m8, z), tx), aligned);
+        fStoreAs(out.y + i, fAdd(fDot3(m1, x, m5, y, m9, z), ty), aligned);
+        fStoreAs(out.z + i, fAdd(fDot3(m2, x, m6, y, m10, z), tz), aligned);
+    }
+    transform_points_soa_scalar(m, offsetVec3(in, i), offsetVec3(out, i), count - i);
+}
+
+static inline void transform_normals_lanes(const mat4* normalMatrix, Vec3SoA in, Vec3SoA out, size_t count, bool aligned) {
+    const float* a = normalMatrix->m;
+    floatN m0 = fSplat(a[0]), m1 = fSplat(a[1]), m2 = fSplat(a[2]);
+    floatN m4 = fSplat(a[4]), m5 = fSplat(a[5]), m6 = fSplat(a[6]);
+    floatN m8 = fSplat(a[8]), m9 = fSplat(a[9]), m10 = fSplat(a[10]);
+    floatN epsilon = fSplat(NORMAL_EPSILON_SQ);
+
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        floatN x = fLoadAs(in.x + i, aligned);
+        floatN y = fLoadAs(in.y + i, aligned);
+        floatN z = fLoadAs(in.z + i, aligned);
+        floatN nx = fDot3(m0, x, m4, y, m8, z);
+        floatN ny = fDot3(m1, x, m5, y, m9, z);
+        floatN nz = fDot3(m2, x, m6, y, m10, z);
+        floatN invLength = fInvSqrt(fMax(fDot3(nx, nx, ny, ny, nz, nz), epsilon));
+        fStoreAs(out.x + i, fMul(nx, invLength), aligned);
+        fStoreAs(out.y + i, fMul(ny, invLength), aligned);
+        fStoreAs(out.z + i, fMul(nz, invLength), aligned);
+    }
+    transform_normals_soa_scalar(normalMatrix, offsetVec3(in, i), offsetVec3(out, i), count - i);
+}
+
+static inline void transform_aabbs_lanes(const mat4* m, AabbSoA in, AabbSoA out, size_t count, bool aligned) {
+    const float* a = m->m;
+    floatN m0 = fSplat(a[0]), m1 = fSplat(a[1]), m2 = fSplat(a[2]);
+    floatN m4 = fSplat(a[4]), m5 = fSplat(a[5]), m6 = fSplat(a[6]);
+    floatN m8 = fSplat(a[8]), m9 = fSplat(a[9]), m10 = fSplat(a[10]);
+    floatN tx = fSplat(a[12]), ty = fSplat(a[13]), tz = fSplat(a[14]);
+    floatN a0 = fSplat(fabsf(a[0])), a1 = fSplat(fabsf(a[1])), a2 = fSplat(fabsf(a[2]));
+    floatN a4 = fSplat(fabsf(a[4])), a5 = fSplat(fabsf(a[5])), a6 = fSplat(fabsf(a[6]));
+    floatN a8 = fSplat(fabsf(a[8])), a9 = fSplat(fabsf(a[9])), a10 = fSplat(fabsf(a[10]));
+    floatN half = fSplat(0.5f);
+
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        floatN minX = fLoadAs(in.minX + i, aligned), maxX = fLoadAs(in.maxX + i, aligned);
+        floatN minY = fLoadAs(in.minY + i, aligned), maxY = fLoadAs(in.maxY + i, aligned);
+        floatN minZ = fLoadAs(in.minZ + i, aligned), maxZ = fLoadAs(in.maxZ + i, aligned);
+        floatN cx = fMul(fAdd(minX, maxX), half), ex = fMul(fSub(maxX, minX), half);
+        floatN cy = fMul(fAdd(minY, maxY), half), ey = fMul(fSub(maxY, minY), half);
+        floatN cz = fMul(fAdd(minZ, maxZ), half), ez = fMul(fSub(maxZ, minZ), half);
+
+        floatN ncx = fAdd(fDot3(m0, cx, m4, cy, m8, cz), tx);
+        floatN ncy = fAdd(fDot3(m1, cx, m5, cy, m9, cz), ty);
+        floatN ncz = fAdd(fDot3(m2, cx, m6, cy, m10, cz), tz);
+        floatN nex = fDot3(a0, ex, a4, ey, a8, ez);
+        floatN ney = fDot3(a1, ex, a5, ey, a9, ez);
+        floatN nez = fDot3(a2, ex, a6, ey, a10, ez);
+
+        fStoreAs(out.minX + i, fSub(ncx, nex), aligned);
+        fStoreAs(out.minY + i, fSub(ncy, ney), aligned);
+        fStoreAs(out.minZ + i, fSub(ncz, nez), aligned);
+        fStoreAs(out.maxX + i, fAdd(ncx, nex), aligned);
+        fStoreAs(out.maxY + i, fAdd(ncy, ney), aligned);
+        fStoreAs(out.maxZ + i, fAdd(ncz, nez), aligned);
+    }
+    transform_aabbs_soa_scalar(m, offsetAabb(in, i), offsetAabb(out, i), count - i);
+}
+
+static inline bool vec3Aligned(Vec3SoA v) {
+    return fIsAligned(v.x) && fIsAligned(v.y) && fIsAligned(v.z);
+}
+
+static inline bool aabbAligned(AabbSoA b) {
+    return fIsAligned(b.minX) && fIsAligned(b.minY) && fIsAligned(b.minZ) &&
+           fIsAligned(b.maxX) && fIsAligned(b.maxY) && fIsAligned(b.maxZ);
+}
+
+// soa_alloc_floats arrays take the aligned path; other pointers are still accepted
+void transform_points_soa(const mat4* m, Vec3SoA in, Vec3SoA out, size_t count) {
+    if (vec3Aligned(in) && vec3Aligned(out)) transform_points_lanes(m, in, out, count, true);
+    else transform_points_lanes(m, in, out, count, false);
+}
+
+void transform_normals_soa(const mat4* normalMatrix, Vec3SoA in, Vec3SoA out, size_t count) {
+    if (vec3Aligned(in) && vec3Aligned(out)) transform_normals_lanes(normalMatrix, in, out, count, true);
+    else transform_normals_lanes(normalMatrix, in, out, count, false);
+}
+
+void transform_aabbs_soa(const mat4* m, AabbSoA in, AabbSoA out, size_t count) {
+    if (aabbAligned(in) && aabbAligned(out)) transform_aabbs_lanes(m, in, out, count, true);
+    else transform_aabbs_lanes(m, in, out, count, false);
+}
+
+#else
+
+void transform_points_soa(const mat4* m, Vec3SoA in, Vec3SoA out, size_t count) {
+    transform_points_soa_scalar(m, in, out, count);
+}
+
+void transform_normals_soa(const mat4* normalMatrix, Vec3SoA in, Vec3SoA out, size_t count) {
+    transform_normals_soa_scalar(normalMatrix, in, out, count);
+}
+
+void transform_aabbs_soa(const mat4* m, AabbSoA in, AabbSoA out, size_t count) {
+    transform_aabbs_soa_scalar(m, in, out, count);
+}
+
+#endif
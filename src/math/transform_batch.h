@@ -0,0 +1,89 @@
+#ifndef TRANSFORM_BATCH_H
+#define TRANSFORM_BATCH_H
+
+#include <stddef.h>
+#include "matrix.h"
+
+// Alignment of soa_alloc_floats arrays: one AVX register, so no load splits a cache line
+#define SOA_ALIGNMENT 32
+
+/**
+ * Structure-of-arrays 3D vectors: x[i], y[i], z[i] form element i.
+ * One component per array lets a SIMD register hold the same component of
+ * 4 (SSE/NEON) or 8 (AVX) elements, with no shuffling on load or store.
+ */
+typedef struct {
+    float* x;
+    float* y;
+    float* z;
+} Vec3SoA;
+
+/**
+ * Structure-of-arrays axis-aligned boxes
+ */
+typedef struct {
+    float* minX;
+    float* minY;
+    float* minZ;
+    float* maxX;
+    float* maxY;
+    float* maxZ;
+} AabbSoA;
+
+/**
+ * Allocate a float array aligned to SOA_ALIGNMENT
+ *
+ * @param count - Number of floats
+ * @return Array (free with soa_free_floats), NULL on failure
+ */
+float* soa_alloc_floats(size_t count);
+
+/**
+ * Free an array from soa_alloc_floats
+ *
+ * @param data - Array (may be NULL)
+ */
+void soa_free_floats(float* data);
+
+/**
+ * Transform points by an affine matrix (w = 1; the bottom row is ignored)
+ * All batch functions walk their arrays front to back once, and out may be in.
+ * Any float pointers work; arrays from soa_alloc_floats use aligned loads and stores.
+ *
+ * @param m - Transform
+ * @param in - Input points
+ * @param out - Output points
+ * @param count - Number of points
+ */
+void transform_points_soa(const mat4* m, Vec3SoA in, Vec3SoA out, size_t count);
+
+/**
+ * Transform normals by the upper 3x3 of a normal matrix (see mat4_normal_matrix)
+ * and renormalize; zero-length normals stay zero
+ *
+ * @param normalMatrix - Normal matrix
+ * @param in - Input normals
+ * @param out - Output normals
+ * @param count - Number of normals
+ */
+void transform_normals_soa(const mat4* normalMatrix, Vec3SoA in, Vec3SoA out, size_t count);
+
+/**
+ * Transform boxes by an affine matrix and re-fit axis-aligned bounds
+ * (Arvo: the new half-extents are |M| times the old ones)
+ *
+ * @param m - Transform
+ * @param in - Input boxes
+ * @param out - Output boxes
+ * @param count - Number of boxes
+ */
+void transform_aabbs_soa(const mat4* m, AabbSoA in, AabbSoA out, size_t count);
+
+/**
+ * Portable reference versions, always built (tail handling and benchmark baseline)
+ */
+void transform_points_soa_scalar(const mat4* m, Vec3SoA in, Vec3SoA out, size_t count);
+void transform_normals_soa_scalar(const mat4* normalMatrix, Vec3SoA in, Vec3SoA out, size_t count);
+void transform_aabbs_soa_scalar(const mat4* m, AabbSoA in, AabbSoA out, size_t count);
+
+#endif // TRANSFORM_BATCH_H
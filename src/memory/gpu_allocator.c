@@ -0,0 +1,361 @@
+#include "gpu_allocator.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static uint32_t findAllocatorMemoryType(
+    const GpuAllocator* allocator,
+    uint32_t typeFilter,
+    VkMemoryPropertyFlags properties
+) {
+    for (uint32_t i = 0; i < allocator->memoryProperties.memoryTypeCount; i++) {
+        if ((typeFilter & (1u << i)) &&
+            (allocator->memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+            return i;
+        }
+    }
+    return UINT32_MAX;
+}
+
+static VkResult insertFreeRange(GpuMemoryBlock* block, uint32_t index, VkDeviceSize offset, VkDeviceSize size) {
+    if (block->freeRangeCount == block->freeRangeCapacity) {
+        uint32_t newCapacity = block->freeRangeCapacity ? block->freeRangeCapacity * 2 : 16;
+        GpuFreeRange* ranges = (GpuFreeRange*)realloc(block->freeRanges, sizeof(GpuFreeRange) * newCapacity);
+        if (!ranges) {
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
+        block->freeRanges = ranges;
+        block->freeRangeCapacity = newCapacity;
+    }
+
+    memmove(&block->freeRanges[index + 1], &block->freeRanges[index],
+            sizeof(GpuFreeRange) * (block->freeRangeCount - index));
+    block->freeRanges[index].offset = offset;
+    block->freeRanges[index].size = size;
+    block->freeRangeCount++;
+    return VK_SUCCESS;
+}
+
+static void removeFreeRange(GpuMemoryBlock* block, uint32_t index) {
+    memmove(&block->freeRanges[index], &block->freeRanges[index + 1],
+            sizeof(GpuFreeRange) * (block->freeRangeCount - index - 1));
+    block->freeRangeCount--;
+}
+
+static VkResult createMemoryBlock(
+    GpuAllocator* allocator,
+    uint32_t memoryTypeIndex,
+    VkDeviceSize size,
+    bool dedicated,
+    GpuMemoryBlock** outBlock
+) {
+    GpuMemoryBlock* block = (GpuMemoryBlock*)calloc(1, sizeof(GpuMemoryBlock));
+    if (!block) {
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    VkMemoryAllocateInfo allocInfo = {0};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+    VkResult result = vkAllocateMemory(allocator->device, &allocInfo, NULL, &block->memory);
+    if (result != VK_SUCCESS) {
+        printf("  GPU allocator: vkAllocateMemory(%llu bytes, type %u) failed! Error: %d\n",
+               (unsigned long long)size, memoryTypeIndex, result);
+        free(block);
+        return result;
+    }
+
+    // Host-visible blocks are mapped once; sub-allocations hand out pointers into the mapping
+    VkMemoryPropertyFlags flags = allocator->memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
+    if (flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        result = vkMapMemory(allocator->device, block->memory, 0, VK_WHOLE_SIZE, 0, &block->mapped);
+        if (result != VK_SUCCESS) {
+            printf("  GPU allocator: failed to map block! Error: %d\n", result);
+            vkFreeMemory(allocator->device, block->memory, NULL);
+            free(block);
+            return result;
+        }
+    }
+
+    block->owner = allocator;
+    block->size = size;
+    block->memoryTypeIndex = memoryTypeIndex;
+    block->dedicated = dedicated;
+
+    result = insertFreeRange(block, 0, 0, size);
+    if (result != VK_SUCCESS) {
+        if (block->mapped) vkUnmapMemory(allocator->device, block->memory);
+        vkFreeMemory(allocator->device, block->memory, NULL);
+        free(block);
+        return result;
+    }
+
+    GpuMemoryPool* pool = &allocator->pools[memoryTypeIndex];
+    if (pool->blockCount == pool->blockCapacity) {
+        uint32_t newCapacity = pool->blockCapacity ? pool->blockCapacity * 2 : 4;
+        GpuMemoryBlock** blocks = (GpuMemoryBlock**)realloc(pool->blocks, sizeof(GpuMemoryBlock*) * newCapacity);
+        if (!blocks) {
+            if (block->mapped) vkUnmapMemory(allocator->device, block->memory);
+            vkFreeMemory(allocator->device, block->memory, NULL);
+            free(block->freeRanges);
+            free(block);
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
+        pool->blocks = blocks;
+        pool->blockCapacity = newCapacity;
+    }
+    pool->blocks[pool->blockCount++] = block;
+
+    allocator->deviceMemoryCount++;
+    allocator->bytesAllocated += size;
+
+    printf("  GPU allocator: new %s block, type %u, %llu bytes (%u device allocations)\n",
+           dedicated ? "dedicated" : "shared", memoryTypeIndex,
+           (unsigned long long)size, allocator->deviceMemoryCount);
+
+    *outBlock = block;
+    return VK_SUCCESS;
+}
+
+static void destroyMemoryBlock(GpuAllocator* allocator, GpuMemoryBlock* block) {
+    GpuMemoryPool* pool = &allocator->pools[block->memoryTypeIndex];
+    for (uint32_t i = 0; i < pool->blockCount; i++) {
+        if (pool->blocks[i] == block) {
+            pool->blocks[i] = pool->blocks[--pool->blockCount];
+            break;
+        }
+    }
+
+    if (block->mapped) {
+        vkUnmapMemory(allocator->device, block->memory);
+    }
+    vkFreeMemory(allocator->device, block->memory, NULL);
+
+    allocator->deviceMemoryCount--;
+    allocator->bytesAllocated -= block->size;
+
+    free(block->freeRanges);
+    free(block);
+}
+
+// First fit over the offset-sorted free list; the alignment padding stays free
+static bool allocateFromBlock(
+    GpuMemoryBlock* block,
+    VkDeviceSize size,
+    VkDeviceSize alignment,
+    VkDeviceSize* outOffset
+) {
+    for (uint32_t i = 0; i < block->freeRangeCount; i++) {
+        GpuFreeRange range = block->freeRanges[i];
+        VkDeviceSize aligned = (range.offset + alignment - 1) & ~(alignment - 1);
+        VkDeviceSize rangeEnd = range.offset + range.size;
+        if (aligned + size > rangeEnd) {
+            continue;
+        }
+
+        VkDeviceSize allocEnd = aligned + size;
+        VkDeviceSize padding = aligned - range.offset;
+
+        if (padding == 0 && allocEnd == rangeEnd) {
+            removeFreeRange(block, i);
+        } else if (padding == 0) {
+            block->freeRanges[i].offset = allocEnd;
+            block->freeRanges[i].size = rangeEnd - allocEnd;
+        } else if (allocEnd == rangeEnd) {
+            block->freeRanges[i].size = padding;
+        } else {
+            // Split into leading padding and trailing remainder
+            if (insertFreeRange(block, i + 1, allocEnd, rangeEnd - allocEnd) != VK_SUCCESS) {
+                return false;
+            }
+            block->freeRanges[i].size = padding;
+        }
+
+        block->used += size;
+        block->allocationCount++;
+        *outOffset = aligned;
+        return true;
+    }
+    return false;
+}
+
+VkResult createGpuAllocator(
+    VkDevice device,
+    VkPhysicalDevice physicalDevice,
+    VkDeviceSize blockSize,
+    GpuAllocator* outAllocator
+) {
+    if (!device || !physicalDevice || !outAllocator) {
+        printf("GPU allocator creation failed: Invalid parameters\n");
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    memset(outAllocator, 0, sizeof(GpuAllocator));
+    outAllocator->device = device;
+    outAllocator->blockSize = blockSize ? blockSize : GPU_ALLOCATOR_BLOCK_SIZE;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &outAllocator->memoryProperties);
+
+    printf("  GPU allocator: %u memory types, %llu byte blocks\n",
+           outAllocator->memoryProperties.memoryTypeCount, (unsigned long long)outAllocator->blockSize);
+    return VK_SUCCESS;
+}
+
+VkResult gpuAllocate(
+    GpuAllocator* allocator,
+    const VkMemoryRequirements* requirements,
+    VkMemoryPropertyFlags properties,
+    GpuAllocation* outAllocation
+) {
+    if (!allocator || !allocator->device || !requirements || requirements->size == 0 || !outAllocation) {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+    memset(outAllocation, 0, sizeof(GpuAllocation));
+
+    uint32_t memoryTypeIndex = findAllocatorMemoryType(allocator, requirements->memoryTypeBits, properties);
+    if (memoryTypeIndex == UINT32_MAX) {
+        printf("  GPU allocator: no memory type for properties 0x%x\n", properties);
+        return VK_ERROR_FEATURE_NOT_PRESENT;
+    }
+
+    VkDeviceSize alignment = requirements->alignment ? requirements->alignment : 1;
+    VkDeviceSize size = requirements->size;
+
+    GpuMemoryBlock* block = NULL;
+    VkDeviceSize offset = 0;
+
+    if (size > GPU_ALLOCATOR_DEDICATED_THRESHOLD || size > allocator->blockSize) {
+        VkResult result = createMemoryBlock(allocator, memoryTypeIndex, size, true, &block);
+        if (result != VK_SUCCESS) {
+            return result;
+        }
+        allocateFromBlock(block, size, alignment, &offset);
+    } else {
+        GpuMemoryPool* pool = &allocator->pools[memoryTypeIndex];
+        for (uint32_t i = 0; i < pool->blockCount; i++) {
+            GpuMemoryBlock* candidate = pool->blocks[i];
+            if (candidate->dedicated || candidate->size - candidate->used < size) {
+                continue;
+            }
+            if (allocateFromBlock(candidate, size, alignment, &offset)) {
+                block = candidate;
+                break;
+            }
+        }
+
+        if (!block) {
+            VkResult result = createMemoryBlock(allocator, memoryTypeIndex, allocator->blockSize, false, &block);
+            if (result != VK_SUCCESS) {
+                return result;
+            }
+            if (!allocateFromBlock(block, size, alignment, &offset)) {
+                destroyMemoryBlock(allocator, block);
+                return VK_ERROR_OUT_OF_HOST_MEMORY;
+            }
+        }
+    }
+
+    allocator->liveAllocations++;
+    allocator->bytesInUse += size;
+
+    outAllocation->block = block;
+    outAllocation->memory = block->memory;
+    outAllocation->offset = offset;
+    outAllocation->size = size;
+    outAllocation->mapped = block->mapped ? (char*)block->mapped + offset : NULL;
+    return VK_SUCCESS;
+}
+
+void gpuFree(GpuAllocation* allocation) {
+    if (!allocation || !allocation->block) return;
+
+    GpuMemoryBlock* block = allocation->block;
+    GpuAllocator* allocator = block->owner;
+    VkDeviceSize offset = allocation->offset;
+    VkDeviceSize size = allocation->size;
+
+    // Find the insertion point, then merge with the neighbours it touches
+    uint32_t index = 0;
+    while (index < block->freeRangeCount && block->freeRanges[index].offset < offset) {
+        index++;
+    }
+
+    bool mergePrev = index > 0 &&
+        block->freeRanges[index - 1].offset + block->freeRanges[index - 1].size == offset;
+    bool mergeNext = index < block->freeRangeCount &&
+        offset + size == block->freeRanges[index].offset;
+
+    if (mergePrev && mergeNext) {
+        block->freeRanges[index - 1].size += size + block->freeRanges[index].size;
+        removeFreeRange(block, index);
+    } else if (mergePrev) {
+        block->freeRanges[index - 1].size += size;
+    } else if (mergeNext) {
+        block->freeRanges[index].offset = offset;
+        block->freeRanges[index].size += size;
+    } else if (insertFreeRange(block, index, offset, size) != VK_SUCCESS) {
+        // Leaks the range until the block is destroyed, but keeps the list consistent
+        printf("  GPU allocator: out of host memory while freeing %llu bytes\n", (unsigned long long)size);
+    }
+
+    block->used -= size;
+    block->allocationCount--;
+    allocator->liveAllocations--;
+    allocator->bytesInUse -= size;
+
+    // Give empty blocks back to the driver, keeping one shared block per type to avoid churn
+    if (block->allocationCount == 0) {
+        GpuMemoryPool* pool = &allocator->pools[block->memoryTypeIndex];
+        uint32_t sharedBlocks = 0;
+        for (uint32_t i = 0; i < pool->blockCount; i++) {
+            if (!pool->blocks[i]->dedicated) sharedBlocks++;
+        }
+        if (block->dedicated || sharedBlocks > 1) {
+            destroyMemoryBlock(allocator, block);
+        }
+    }
+
+    memset(allocation, 0, sizeof(GpuAllocation));
+}
+
+void printGpuAllocatorStats(const GpuAllocator* allocator) {
+    if (!allocator) return;
+
+    printf("  Device Memory Allocations: %u\n", allocator->deviceMemoryCount);
+    printf("  Live Sub-allocations: %u\n", allocator->liveAllocations);
+    printf("  Bytes In Use: %llu / %llu\n",
+           (unsigned long long)allocator->bytesInUse, (unsigned long long)allocator->bytesAllocated);
+    for (uint32_t t = 0; t < allocator->memoryProperties.memoryTypeCount; t++) {
+        const GpuMemoryPool* pool = &allocator->pools[t];
+        if (pool->blockCount == 0) continue;
+
+        VkDeviceSize used = 0, size = 0;
+        uint32_t freeRanges = 0;
+        for (uint32_t i = 0; i < pool->blockCount; i++) {
+            used += pool->blocks[i]->used;
+            size += pool->blocks[i]->size;
+            freeRanges += pool->blocks[i]->freeRangeCount;
+        }
+        printf("  Type %u: %u blocks, %llu / %llu bytes used, %u free ranges\n",
+               t, pool->blockCount, (unsigned long long)used, (unsigned long long)size, freeRanges);
+    }
+}
+
+void destroyGpuAllocator(GpuAllocator* allocator) {
+    if (!allocator || !allocator->device) return;
+
+    if (allocator->liveAllocations > 0) {
+        printf("  GPU allocator: %u allocations still live at destruction\n", allocator->liveAllocations);
+    }
+
+    for (uint32_t t = 0; t < VK_MAX_MEMORY_TYPES; t++) {
+        GpuMemoryPool* pool = &allocator->pools[t];
+        while (pool->blockCount > 0) {
+            destroyMemoryBlock(allocator, pool->blocks[pool->blockCount - 1]);
+        }
+        free(pool->blocks);
+    }
+
+    memset(allocator, 0, sizeof(GpuAllocator));
+}
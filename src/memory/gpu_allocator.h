@@ -0,0 +1,130 @@
+#ifndef GPU_ALLOCATOR_H
+#define GPU_ALLOCATOR_H
+
+#include <vulkan/vulkan.h>
+#include <stdbool.h>
+
+// Size of the VkDeviceMemory blocks sub-allocations are carved from
+#define GPU_ALLOCATOR_BLOCK_SIZE (64ull * 1024 * 1024)
+
+// Requests larger than this get a dedicated block so they do not fragment the shared ones
+#define GPU_ALLOCATOR_DEDICATED_THRESHOLD (GPU_ALLOCATOR_BLOCK_SIZE / 2)
+
+typedef struct GpuAllocator GpuAllocator;
+
+/**
+ * Free byte range inside a memory block
+ */
+typedef struct {
+    VkDeviceSize offset;
+    VkDeviceSize size;
+} GpuFreeRange;
+
+/**
+ * One VkDeviceMemory allocation shared by many resources
+ * Free space is tracked as an offset-sorted list of ranges that are
+ * coalesced with their neighbours on free.
+ */
+typedef struct {
+    GpuAllocator* owner;
+    VkDeviceMemory memory;
+    VkDeviceSize size;
+    VkDeviceSize used;
+    uint32_t memoryTypeIndex;
+    uint32_t allocationCount;
+    void* mapped;                // Persistently mapped if the memory type is host-visible
+    bool dedicated;              // Holds exactly one oversized allocation
+    GpuFreeRange* freeRanges;
+    uint32_t freeRangeCount;
+    uint32_t freeRangeCapacity;
+} GpuMemoryBlock;
+
+/**
+ * Blocks of a single memory type
+ */
+typedef struct {
+    GpuMemoryBlock** blocks;     // Pointers so blocks keep their address when the array grows
+    uint32_t blockCount;
+    uint32_t blockCapacity;
+} GpuMemoryPool;
+
+/**
+ * Block sub-allocator for device memory
+ * Not thread-safe: allocate and free from one thread (resource creation happens on the main thread).
+ */
+struct GpuAllocator {
+    VkDevice device;
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    VkDeviceSize blockSize;
+    GpuMemoryPool pools[VK_MAX_MEMORY_TYPES];
+    uint32_t deviceMemoryCount;      // Live vkAllocateMemory calls
+    uint32_t liveAllocations;        // Live sub-allocations
+    VkDeviceSize bytesAllocated;     // Sum of block sizes
+    VkDeviceSize bytesInUse;         // Sum of sub-allocation sizes
+};
+
+/**
+ * A sub-allocation; block == NULL means the memory was not obtained from an allocator
+ */
+typedef struct {
+    GpuMemoryBlock* block;
+    VkDeviceMemory memory;
+    VkDeviceSize offset;
+    VkDeviceSize size;
+    void* mapped;                // CPU pointer at offset, NULL unless host-visible
+} GpuAllocation;
+
+/**
+ * Create a sub-allocator for a logical device
+ *
+ * @param device - VkDevice handle
+ * @param physicalDevice - VkPhysicalDevice for memory type properties
+ * @param blockSize - Size of shared blocks (0 selects GPU_ALLOCATOR_BLOCK_SIZE)
+ * @param outAllocator - Output allocator
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult createGpuAllocator(
+    VkDevice device,
+    VkPhysicalDevice physicalDevice,
+    VkDeviceSize blockSize,
+    GpuAllocator* outAllocator
+);
+
+/**
+ * Sub-allocate memory satisfying a resource's requirements
+ *
+ * @param allocator - Allocator
+ * @param requirements - Size, alignment and memory type bits from vkGet*MemoryRequirements
+ * @param properties - Required memory property flags
+ * @param outAllocation - Output allocation (memory handle + offset to bind at)
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult gpuAllocate(
+    GpuAllocator* allocator,
+    const VkMemoryRequirements* requirements,
+    VkMemoryPropertyFlags properties,
+    GpuAllocation* outAllocation
+);
+
+/**
+ * Return a sub-allocation to its block
+ *
+ * @param allocation - Allocation to free (reset to zero)
+ */
+void gpuFree(GpuAllocation* allocation);
+
+/**
+ * Print block and allocation counts per memory type
+ *
+ * @param allocator - Allocator
+ */
+void printGpuAllocatorStats(const GpuAllocator* allocator);
+
+/**
+ * Free every block; all resources bound to them must already be destroyed
+ *
+ * @param allocator - Allocator to destroy
+ */
+void destroyGpuAllocator(GpuAllocator* allocator);
+
+#endif // GPU_ALLOCATOR_H
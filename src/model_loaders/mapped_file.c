@@ -0,0 +1,46 @@
+#include "mapped_file.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+int map_file(const char* filename, MappedFileAccess access, MappedFile* out) {
+    if (!filename || !out) return -1;
+    memset(out, 0, sizeof(MappedFile));
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size <= 0) {
+        close(fd);
+        return -1;
+    }
+
+    size_t size = (size_t)info.st_size;
+    void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file
+    close(fd);
+    if (data == MAP_FAILED) {
+        printf("Failed to map %s (%zu bytes)\n", filename, size);
+        return -1;
+    }
+
+    // Advice only; a kernel that ignores it still maps the file correctly
+    madvise(data, size, access == MAPPED_FILE_SEQUENTIAL ? MADV_SEQUENTIAL : MADV_WILLNEED);
+
+    out->data = (const char*)data;
+    out->size = size;
+    return 0;
+}
+
+void unmap_file(MappedFile* file) {
+    if (!file || !file->data) return;
+    munmap((void*)file->data, file->size);
+    file->data = NULL;
+    file->size = 0;
+}
@@ -0,0 +1,25 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <stddef.h>
+
+// How the mapping will be read, passed to the kernel as madvise advice
+typedef enum {
+    MAPPED_FILE_SEQUENTIAL,   // Read front to back once: aggressive read-ahead, pages dropped behind
+    MAPPED_FILE_WILL_NEED     // Read soon and in no particular order: start paging the whole file in
+} MappedFileAccess;
+
+// Read-only view of a whole file; the pages come straight from the page cache, nothing is copied
+typedef struct {
+    const char* data;
+    size_t size;
+} MappedFile;
+
+// Map a file read-only (the data is not NUL-terminated)
+// Returns 0 on success, -1 if the file cannot be opened, is empty or cannot be mapped
+int map_file(const char* filename, MappedFileAccess access, MappedFile* out);
+
+// Unmap a file mapped by map_file
+void unmap_file(MappedFile* file);
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,430 @@
+#include "mesh_cache.h"
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define FNV_OFFSET_BASIS 14695981039346656037ull
+#define FNV_PRIME 1099511628211ull
+
+// Elements converted per fwrite when writing the vertex and 16-bit index streams
+#define TMESH_WRITE_BLOCK 1024
+
+static uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// The same model reached through different relative paths shares one cache file
+static int hash_source_path(const char* source_path, uint64_t* out) {
+    char canonical[PATH_MAX];
+    if (!realpath(source_path, canonical)) return -1;
+    *out = fnv1a(FNV_OFFSET_BASIS, canonical, strlen(canonical));
+    return 0;
+}
+
+static uint64_t align_stream(uint64_t offset) {
+    return (offset + TMESH_STREAM_ALIGNMENT - 1) & ~(uint64_t)(TMESH_STREAM_ALIGNMENT - 1);
+}
+
+// count elements of element_size bytes at offset lie inside the file, on a stream boundary
+static int stream_fits(uint64_t offset, uint64_t count, uint64_t element_size, uint64_t file_size) {
+    if (offset % TMESH_STREAM_ALIGNMENT != 0 || offset > file_size) return 0;
+    return count <= (file_size - offset) / element_size;
+}
+
+// Every index refers to one of vertex_count vertices; a corrupt file must not reach the index buffer
+static int indices_in_range(const void* indices, uint32_t index_size, uint64_t count, uint64_t vertex_count) {
+    if (index_size == 2) {
+        const uint16_t* indices16 = indices;
+        for (uint64_t i = 0; i < count; i++) {
+            if (indices16[i] >= vertex_count) return 0;
+        }
+    } else {
+        const uint32_t* indices32 = indices;
+        for (uint64_t i = 0; i < count; i++) {
+            if (indices32[i] >= vertex_count) return 0;
+        }
+    }
+    return 1;
+}
+
+int get_mesh_cache_path(const char* cache_dir, const char* source_path, char* out, size_t out_size) {
+    if (!cache_dir || !source_path || !out) return -1;
+    uint64_t hash;
+    if (hash_source_path(source_path, &hash) != 0) return -1;
+    int length = snprintf(out, out_size, "%s/%016llx.tmesh", cache_dir, (unsigned long long)hash);
+    return length > 0 && (size_t)length < out_size ? 0 : -1;
+}
+
+int load_baked_mesh(const char* cache_path, const char* source_path, uint32_t flags, BakedMesh* out) {
+    if (!cache_path || !source_path || !out) return -1;
+    memset(out, 0, sizeof(BakedMesh));
+
+    struct stat source;
+    uint64_t path_hash;
+    if (stat(source_path, &source) != 0 || hash_source_path(source_path, &path_hash) != 0) {
+        return -1;
+    }
+
+    // A missing file is the normal first run, not worth a message
+    MappedFile file;
+    if (map_file(cache_path, MAPPED_FILE_WILL_NEED, &file) != 0) {
+        return -1;
+    }
+
+    const TMeshHeader* header = (const TMeshHeader*)file.data;
+    const char* reason = NULL;
+    if (file.size < sizeof(TMeshHeader) || header->magic != TMESH_MAGIC) {
+        reason = "not a baked mesh";
+    } else if (header->version != TMESH_VERSION) {
+        reason = "other format version";
+    } else if (header->source_path_hash != path_hash || header->source_size != (uint64_t)source.st_size ||
+               header->source_mtime != (int64_t)source.st_mtime) {
+        reason = "source changed";
+    } else if (header->flags != flags) {
+        reason = "baked with other options";
+    } else if (header->file_size != file.size || header->vertex_stride != sizeof(TMeshVertex) ||
+               (header->index_size != 2 && header->index_size != 4) ||
+               header->vertex_count == 0 || header->index_count == 0 ||
+               !stream_fits(header->vertex_offset, header->vertex_count, sizeof(TMeshVertex), file.size) ||
+               !stream_fits(header->texcoord_offset, header->vertex_count, sizeof(float) * 2, file.size) ||
+               !stream_fits(header->index_offset, header->index_count, header->index_size, file.size) ||
+               !stream_fits(header->meshlet_offset, header->meshlet_count, sizeof(TMeshMeshlet), file.size) ||
+               !stream_fits(header->meshlet_vertex_offset, header->meshlet_vertex_count, sizeof(uint32_t), file.size) ||
+               !stream_fits(header->meshlet_triangle_offset, header->meshlet_triangle_count, 3, file.size)) {
+        reason = "truncated or malformed";
+    } else if (!indices_in_range(file.data + header->index_offset, header->index_size, header->index_count,
+                                 header->vertex_count) ||
+               !indices_in_range(file.data + header->meshlet_vertex_offset, 4, header->meshlet_vertex_count,
+                                 header->vertex_count)) {
+        reason = "index out of range";
+    }
+    if (reason) {
+        printf("  Mesh cache: %s, ignoring %s\n", reason, cache_path);
+        unmap_file(&file);
+        return -1;
+    }
+
+    out->file = file;
+    out->header = header;
+    out->vertices = (const TMeshVertex*)(file.data + header->vertex_offset);
+    out->texcoords = (const float*)(file.data + header->texcoord_offset);
+    out->indices = file.data + header->index_offset;
+    out->meshlets = (const TMeshMeshlet*)(file.data + header->meshlet_offset);
+    out->meshlet_vertices = (const uint32_t*)(file.data + header->meshlet_vertex_offset);
+    out->meshlet_triangles = (const uint8_t*)(file.data + header->meshlet_triangle_offset);
+
+    printf("Mesh cache hit: %s (%llu vertices, %llu indices, %u meshlets)\n", cache_path,
+           (unsigned long long)header->vertex_count, (unsigned long long)header->index_count, header->meshlet_count);
+    return 0;
+}
+
+// --- Meshlets ---
+
+typedef struct {
+    TMeshMeshlet* meshlets;
+    uint32_t* vertices;             // Mesh vertex index per meshlet vertex
+    uint8_t* triangles;             // Three meshlet-local indices per triangle
+    size_t meshlet_count;
+    size_t meshlet_capacity;
+    size_t vertex_count;
+    size_t vertex_capacity;
+    size_t triangle_count;
+} MeshletBuild;
+
+static void free_meshlets(MeshletBuild* build) {
+    free(build->meshlets);
+    free(build->vertices);
+    free(build->triangles);
+    memset(build, 0, sizeof(MeshletBuild));
+}
+
+// Bound the meshlet, release its vertices' local slots and append it
+static int finish_meshlet(const Mesh* mesh, MeshletBuild* build, TMeshMeshlet* meshlet, uint32_t* local) {
+    const uint32_t* vertices = &build->vertices[meshlet->vertex_offset];
+    float bounds_min[3], bounds_max[3];
+    for (int axis = 0; axis < 3; axis++) {
+        bounds_min[axis] = bounds_max[axis] = mesh->vertices[(size_t)vertices[0] * 3 + axis];
+    }
+    for (uint32_t i = 0; i < meshlet->vertex_count; i++) {
+        for (int axis = 0; axis < 3; axis++) {
+            float p = mesh->vertices[(size_t)vertices[i] * 3 + axis];
+            if (p < bounds_min[axis]) bounds_min[axis] = p;
+            if (p > bounds_max[axis]) bounds_max[axis] = p;
+        }
+    }
+    float radius_sq = 0.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        meshlet->center[axis] = (bounds_min[axis] + bounds_max[axis]) * 0.5f;
+    }
+    for (uint32_t i = 0; i < meshlet->vertex_count; i++) {
+        const float* p = &mesh->vertices[(size_t)vertices[i] * 3];
+        float dx = p[0] - meshlet->center[0];
+        float dy = p[1] - meshlet->center[1];
+        float dz = p[2] - meshlet->center[2];
+        float d_sq = dx * dx + dy * dy + dz * dz;
+        if (d_sq > radius_sq) radius_sq = d_sq;
+        local[vertices[i]] = UINT32_MAX;
+    }
+    meshlet->radius = sqrtf(radius_sq);
+
+    if (build->meshlet_count == build->meshlet_capacity) {
+        size_t capacity = build->meshlet_capacity ? build->meshlet_capacity * 2 : 256;
+        TMeshMeshlet* grown = (TMeshMeshlet*)realloc(build->meshlets, sizeof(TMeshMeshlet) * capacity);
+        if (!grown) return -1;
+        build->meshlets = grown;
+        build->meshlet_capacity = capacity;
+    }
+    build->meshlets[build->meshlet_count++] = *meshlet;
+    build->vertex_count += meshlet->vertex_count;
+
+    memset(meshlet, 0, sizeof(TMeshMeshlet));
+    meshlet->vertex_offset = (uint32_t)build->vertex_count;
+    meshlet->triangle_offset = (uint32_t)build->triangle_count;
+    return 0;
+}
+
+// Greedy clusters in index order: a meshlet closes when the next triangle would exceed a limit,
+// so an optimized (cache-local) index order gives compact meshlets
+static int build_meshlets(const Mesh* mesh, MeshletBuild* build) {
+    memset(build, 0, sizeof(MeshletBuild));
+    size_t triangle_total = mesh->num_indices / 3;
+    uint32_t* local = (uint32_t*)malloc(sizeof(uint32_t) * mesh->num_vertices);
+    build->triangles = (uint8_t*)malloc(triangle_total * 3 + 1);
+    build->vertex_capacity = 4096;
+    build->vertices = (uint32_t*)malloc(sizeof(uint32_t) * build->vertex_capacity);
+    if (!local || !build->triangles || !build->vertices) {
+        free(local);
+        free_meshlets(build);
+        return -1;
+    }
+    // Meshlet-local index of each mesh vertex, UINT32_MAX when not in the open meshlet
+    memset(local, 0xFF, sizeof(uint32_t) * mesh->num_vertices);
+
+    TMeshMeshlet meshlet = {0};
+    for (size_t t = 0; t < triangle_total; t++) {
+        const unsigned int* triangle = &mesh->indices[t * 3];
+        uint32_t added = 0;
+        for (int k = 0; k < 3; k++) {
+            unsigned int v = triangle[k];
+            if (local[v] == UINT32_MAX && (k < 1 || triangle[0] != v) && (k < 2 || triangle[1] != v)) added++;
+        }
+        if (meshlet.vertex_count + added > TMESH_MESHLET_MAX_VERTICES ||
+            meshlet.triangle_count == TMESH_MESHLET_MAX_TRIANGLES) {
+            if (finish_meshlet(mesh, build, &meshlet, local) != 0) {
+                free(local);
+                free_meshlets(build);
+                return -1;
+            }
+        }
+
+        if (build->vertex_count + meshlet.vertex_count + 3 > build->vertex_capacity) {
+            size_t capacity = build->vertex_capacity * 2;
+            uint32_t* grown = (uint32_t*)realloc(build->vertices, sizeof(uint32_t) * capacity);
+            if (!grown) {
+                free(local);
+                free_meshlets(build);
+                return -1;
+            }
+            build->vertices = grown;
+            build->vertex_capacity = capacity;
+        }
+        for (int k = 0; k < 3; k++) {
+            unsigned int v = triangle[k];
+            if (local[v] == UINT32_MAX) {
+                local[v] = meshlet.vertex_count++;
+                build->vertices[meshlet.vertex_offset + local[v]] = v;
+            }
+            build->triangles[build->triangle_count * 3 + k] = (uint8_t)local[v];
+        }
+        build->triangle_count++;
+        meshlet.triangle_count++;
+    }
+    int result = meshlet.triangle_count > 0 ? finish_meshlet(mesh, build, &meshlet, local) : 0;
+    free(local);
+    if (result != 0) free_meshlets(build);
+    return result;
+}
+
+// --- Writing ---
+
+// Zero-fill from *position up to offset
+static int write_padding(FILE* file, uint64_t* position, uint64_t offset) {
+    static const char zeros[TMESH_STREAM_ALIGNMENT] = {0};
+    size_t padding = (size_t)(offset - *position);
+    if (padding > 0 && fwrite(zeros, 1, padding, file) != padding) return -1;
+    *position = offset;
+    return 0;
+}
+
+static int write_stream(FILE* file, uint64_t* position, uint64_t offset, const void* data, size_t size) {
+    if (write_padding(file, position, offset) != 0) return -1;
+    if (size > 0 && fwrite(data, 1, size, file) != size) return -1;
+    *position += size;
+    return 0;
+}
+
+static int write_streams(FILE* file, const Mesh* mesh, const MeshletBuild* meshlets, const TMeshHeader* header) {
+    uint64_t position = 0;
+    if (write_stream(file, &position, 0, header, sizeof(TMeshHeader)) != 0) return -1;
+
+    // Vertices interleaved in blocks, written like updateVertexBufferWithMesh
+    if (write_padding(file, &position, header->vertex_offset) != 0) return -1;
+    TMeshVertex block[TMESH_WRITE_BLOCK];
+    for (size_t first = 0; first < mesh->num_vertices; first += TMESH_WRITE_BLOCK) {
+        size_t count = mesh->num_vertices - first < TMESH_WRITE_BLOCK ? mesh->num_vertices - first : TMESH_WRITE_BLOCK;
+        for (size_t i = 0; i < count; i++) {
+            memcpy(block[i].position, &mesh->vertices[(first + i) * 3], sizeof(float) * 3);
+            block[i].color[0] = block[i].color[1] = block[i].color[2] = 1.0f;
+            memcpy(block[i].normal, &mesh->normals[(first + i) * 3], sizeof(float) * 3);
+        }
+        if (fwrite(block, sizeof(TMeshVertex), count, file) != count) return -1;
+        position += sizeof(TMeshVertex) * count;
+    }
+
+    if (write_stream(file, &position, header->texcoord_offset, mesh->texcoords,
+                     sizeof(float) * 2 * mesh->num_vertices) != 0) return -1;
+
+    if (header->index_size == 2) {
+        if (write_padding(file, &position, header->index_offset) != 0) return -1;
+        uint16_t indices16[TMESH_WRITE_BLOCK];
+        for (size_t first = 0; first < mesh->num_indices; first += TMESH_WRITE_BLOCK) {
+            size_t count = mesh->num_indices - first < TMESH_WRITE_BLOCK ? mesh->num_indices - first : TMESH_WRITE_BLOCK;
+            for (size_t i = 0; i < count; i++) {
+                indices16[i] = (uint16_t)mesh->indices[first + i];
+            }
+            if (fwrite(indices16, sizeof(uint16_t), count, file) != count) return -1;
+            position += sizeof(uint16_t) * count;
+        }
+    } else if (write_stream(file, &position, header->index_offset, mesh->indices,
+                            sizeof(uint32_t) * mesh->num_indices) != 0) {
+        return -1;
+    }
+
+    if (write_stream(file, &position, header->meshlet_offset, meshlets->meshlets,
+                     sizeof(TMeshMeshlet) * meshlets->meshlet_count) != 0 ||
+        write_stream(file, &position, header->meshlet_vertex_offset, meshlets->vertices,
+                     sizeof(uint32_t) * meshlets->vertex_count) != 0 ||
+        write_stream(file, &position, header->meshlet_triangle_offset, meshlets->triangles,
+                     meshlets->triangle_count * 3) != 0 ||
+        write_padding(file, &position, header->file_size) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+// Create the directory holding cache_path (one level, like "mesh_cache/<hash>.tmesh")
+static int create_cache_directory(const char* cache_path) {
+    const char* slash = strrchr(cache_path, '/');
+    if (!slash || slash == cache_path) return 0;
+    char directory[PATH_MAX];
+    size_t length = (size_t)(slash - cache_path);
+    if (length >= sizeof(directory)) return -1;
+    memcpy(directory, cache_path, length);
+    directory[length] = '\0';
+    return mkdir(directory, 0755) == 0 || errno == EEXIST ? 0 : -1;
+}
+
+int bake_mesh(const Mesh* mesh, const char* source_path, uint32_t flags, const char* cache_path) {
+    if (!mesh || !source_path || !cache_path || !mesh->vertices || mesh->num_vertices == 0 ||
+        mesh->num_indices == 0) {
+        return -1;
+    }
+
+    TMeshHeader header = {0};
+    struct stat source;
+    if (stat(source_path, &source) != 0 || hash_source_path(source_path, &header.source_path_hash) != 0) {
+        return -1;
+    }
+    MappedFile text;
+    if (map_file(source_path, MAPPED_FILE_SEQUENTIAL, &text) != 0) {
+        return -1;
+    }
+    header.source_content_hash = fnv1a(FNV_OFFSET_BASIS, text.data, text.size);
+    unmap_file(&text);
+
+    MeshletBuild meshlets;
+    if (build_meshlets(mesh, &meshlets) != 0) {
+        printf("  Mesh cache: out of memory building meshlets\n");
+        return -1;
+    }
+
+    header.magic = TMESH_MAGIC;
+    header.version = TMESH_VERSION;
+    header.flags = flags;
+    header.vertex_stride = sizeof(TMeshVertex);
+    header.source_size = (uint64_t)source.st_size;
+    header.source_mtime = (int64_t)source.st_mtime;
+    header.vertex_count = mesh->num_vertices;
+    header.index_count = mesh->num_indices;
+    header.index_size = mesh->num_vertices <= 65536 ? 2 : 4;
+    header.meshlet_count = (uint32_t)meshlets.meshlet_count;
+    header.meshlet_vertex_count = meshlets.vertex_count;
+    header.meshlet_triangle_count = meshlets.triangle_count;
+    memcpy(header.bounds_min, mesh->bounds_min, sizeof(header.bounds_min));
+    memcpy(header.bounds_max, mesh->bounds_max, sizeof(header.bounds_max));
+    memcpy(header.bounds_center, mesh->bounds_center, sizeof(header.bounds_center));
+    header.bounds_radius = mesh->bounds_radius;
+
+    header.vertex_offset = align_stream(sizeof(TMeshHeader));
+    header.texcoord_offset = align_stream(header.vertex_offset + sizeof(TMeshVertex) * header.vertex_count);
+    header.index_offset = align_stream(header.texcoord_offset + sizeof(float) * 2 * header.vertex_count);
+    header.meshlet_offset = align_stream(header.index_offset + (uint64_t)header.index_size * header.index_count);
+    header.meshlet_vertex_offset = align_stream(header.meshlet_offset + sizeof(TMeshMeshlet) * header.meshlet_count);
+    header.meshlet_triangle_offset = align_stream(header.meshlet_vertex_offset +
+                                                  sizeof(uint32_t) * header.meshlet_vertex_count);
+    header.file_size = align_stream(header.meshlet_triangle_offset + 3 * header.meshlet_triangle_count);
+
+    // Written beside the final name, so a crash or a concurrent run never leaves a partial file there
+    char temporary_path[PATH_MAX];
+    int length = snprintf(temporary_path, sizeof(temporary_path), "%s.%ld.tmp", cache_path, (long)getpid());
+    FILE* file = NULL;
+    if (length > 0 && (size_t)length < sizeof(temporary_path) && create_cache_directory(cache_path) == 0) {
+        file = fopen(temporary_path, "wb");
+    }
+    if (!file) {
+        printf("  Mesh cache: cannot write %s\n", cache_path);
+        free_meshlets(&meshlets);
+        return -1;
+    }
+
+    int result = write_streams(file, mesh, &meshlets, &header);
+    free_meshlets(&meshlets);
+    if (fclose(file) != 0) result = -1;
+    if (result == 0 && rename(temporary_path, cache_path) != 0) result = -1;
+    if (result != 0) {
+        printf("  Mesh cache: failed writing %s\n", cache_path);
+        remove(temporary_path);
+        return -1;
+    }
+
+    printf("Baked mesh cache %s (%llu bytes, %u meshlets)\n", cache_path,
+           (unsigned long long)header.file_size, header.meshlet_count);
+    return 0;
+}
+
+void get_baked_mesh_info(const BakedMesh* baked, Mesh* out) {
+    if (!baked || !baked->header || !out) return;
+    memset(out, 0, sizeof(Mesh));
+    out->num_vertices = (size_t)baked->header->vertex_count;
+    out->num_indices = (size_t)baked->header->index_count;
+    memcpy(out->bounds_min, baked->header->bounds_min, sizeof(out->bounds_min));
+    memcpy(out->bounds_max, baked->header->bounds_max, sizeof(out->bounds_max));
+    memcpy(out->bounds_center, baked->header->bounds_center, sizeof(out->bounds_center));
+    out->bounds_radius = baked->header->bounds_radius;
+}
+
+void unload_baked_mesh(BakedMesh* baked) {
+    if (!baked) return;
+    unmap_file(&baked->file);
+    memset(baked, 0, sizeof(BakedMesh));
+}
@@ -0,0 +1,108 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "objloader.h"
+#include "mapped_file.h"
+
+// Baked meshes are written here, relative to the working directory like the shader paths
+#define MESH_CACHE_DEFAULT_DIR "mesh_cache"
+
+#define TMESH_MAGIC 0x48534D54u        // "TMSH"
+#define TMESH_VERSION 1u               // Bump whenever the layout or the baking changes
+
+// Every stream starts on this boundary so it can be read in place from the mapping
+#define TMESH_STREAM_ALIGNMENT 64
+
+// Meshlet limits, the common mesh shader sizes
+#define TMESH_MESHLET_MAX_VERTICES 64
+#define TMESH_MESHLET_MAX_TRIANGLES 124
+
+// Bake options that change the streams, part of the cache key
+#define TMESH_FLAG_OPTIMIZED 0x1u      // Reordered by optimize_mesh
+
+// Interleaved vertex as the vertex buffer consumes it (matches Vertex in vertex_buffer.h)
+typedef struct {
+    float position[3];
+    float color[3];
+    float normal[3];
+} TMeshVertex;
+
+// A cluster of nearby triangles with its own small vertex list
+typedef struct {
+    uint32_t vertex_offset;     // First entry in the meshlet vertex stream
+    uint32_t triangle_offset;   // First triangle in the meshlet triangle stream
+    uint32_t vertex_count;
+    uint32_t triangle_count;
+    float center[3];            // Bounding sphere of the meshlet's positions
+    float radius;
+} TMeshMeshlet;
+
+// File header; the streams follow at the given offsets
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t flags;                 // TMESH_FLAG_* the mesh was baked with
+    uint32_t vertex_stride;         // sizeof(TMeshVertex)
+
+    // Cache key: the file is stale when the source no longer matches
+    uint64_t source_path_hash;      // FNV-1a of the canonical source path
+    uint64_t source_size;
+    int64_t source_mtime;           // Seconds since the epoch
+    uint64_t source_content_hash;   // FNV-1a of the source bytes when baked (provenance, not checked on load)
+
+    uint64_t vertex_count;
+    uint64_t index_count;
+    uint32_t index_size;            // 2 or 4 bytes, chosen like chooseIndexType
+    uint32_t meshlet_count;
+    uint64_t meshlet_vertex_count;
+    uint64_t meshlet_triangle_count;
+
+    float bounds_min[3];
+    float bounds_max[3];
+    float bounds_center[3];
+    float bounds_radius;
+
+    // Byte offsets from the start of the file, each TMESH_STREAM_ALIGNMENT aligned
+    uint64_t vertex_offset;         // vertex_count TMeshVertex
+    uint64_t texcoord_offset;       // vertex_count u,v pairs
+    uint64_t index_offset;          // index_count indices of index_size bytes
+    uint64_t meshlet_offset;        // meshlet_count TMeshMeshlet
+    uint64_t meshlet_vertex_offset; // meshlet_vertex_count uint32 mesh vertex indices
+    uint64_t meshlet_triangle_offset; // meshlet_triangle_count * 3 uint8 meshlet-local indices
+    uint64_t file_size;
+} TMeshHeader;
+
+// A mapped baked mesh; the stream pointers point into the mapping
+typedef struct {
+    MappedFile file;
+    const TMeshHeader* header;      // NULL when nothing is loaded
+    const TMeshVertex* vertices;
+    const float* texcoords;
+    const void* indices;
+    const TMeshMeshlet* meshlets;
+    const uint32_t* meshlet_vertices;
+    const uint8_t* meshlet_triangles;
+} BakedMesh;
+
+// Cache file of a source: <cache_dir>/<FNV-1a of the canonical source path>.tmesh
+// Returns 0 on success, -1 if the source does not exist or the path does not fit
+int get_mesh_cache_path(const char* cache_dir, const char* source_path, char* out, size_t out_size);
+
+// Map a baked mesh if it is valid and matches the source's path, size and mtime and the flags
+// Returns 0 on a cache hit, -1 if the file is missing, stale or malformed
+int load_baked_mesh(const char* cache_path, const char* source_path, uint32_t flags, BakedMesh* out);
+
+// Bake a loaded mesh (with its meshlets) for the source, creating the cache directory
+// The file is written under a temporary name and renamed, so readers never map a partial file
+// Returns 0 on success, -1 on failure
+int bake_mesh(const Mesh* mesh, const char* source_path, uint32_t flags, const char* cache_path);
+
+// Fill a Mesh's counts and bounds from a baked mesh; its attribute arrays stay NULL
+void get_baked_mesh_info(const BakedMesh* baked, Mesh* out);
+
+// Unmap a baked mesh
+void unload_baked_mesh(BakedMesh* baked);
+
+#endif // MESH_CACHE_H
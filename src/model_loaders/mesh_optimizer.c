@@ -0,0 +1,440 @@
+#include "mesh_optimizer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+void analyze_vertex_cache(const unsigned int* indices, size_t index_count, size_t vertex_count,
+                          unsigned int cache_size, VertexCacheStats* stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(VertexCacheStats));
+    if (!indices || index_count < 3 || vertex_count == 0) return;
+
+    // A vertex is resident while fewer than cache_size misses happened since it was loaded
+    unsigned int* cache_time = (unsigned int*)calloc(vertex_count, sizeof(unsigned int));
+    unsigned char* referenced = (unsigned char*)calloc(vertex_count, 1);
+    if (!cache_time || !referenced) {
+        free(cache_time);
+        free(referenced);
+        return;
+    }
+
+    unsigned int timestamp = cache_size + 1;
+    size_t unique_vertices = 0;
+    for (size_t i = 0; i < index_count; ++i) {
+        unsigned int v = indices[i];
+        if (v >= vertex_count) continue;
+        if (timestamp - cache_time[v] > cache_size) {
+            cache_time[v] = timestamp++;
+            stats->cache_misses++;
+        }
+        if (!referenced[v]) {
+            referenced[v] = 1;
+            unique_vertices++;
+        }
+    }
+
+    stats->acmr = (float)stats->cache_misses / (float)(index_count / 3);
+    stats->atvr = unique_vertices ? (float)stats->cache_misses / (float)unique_vertices : 0.0f;
+
+    free(cache_time);
+    free(referenced);
+}
+
+// Vertex -> triangle adjacency in CSR layout
+typedef struct {
+    unsigned int* offsets;     // vertex_count + 1 entries
+    unsigned int* triangles;   // index_count entries
+    unsigned int* live;        // Triangles per vertex not yet emitted
+} TriangleAdjacency;
+
+static int build_adjacency(const unsigned int* indices, size_t index_count, size_t vertex_count,
+                           TriangleAdjacency* adj) {
+    adj->offsets = (unsigned int*)calloc(vertex_count + 1, sizeof(unsigned int));
+    adj->triangles = (unsigned int*)malloc(sizeof(unsigned int) * index_count);
+    adj->live = (unsigned int*)calloc(vertex_count, sizeof(unsigned int));
+    if (!adj->offsets || !adj->triangles || !adj->live) return -1;
+
+    for (size_t i = 0; i < index_count; ++i) {
+        adj->live[indices[i]]++;
+    }
+    for (size_t v = 0; v < vertex_count; ++v) {
+        adj->offsets[v + 1] = adj->offsets[v] + adj->live[v];
+    }
+
+    // Fill using offsets as cursors, then shift them back
+    for (size_t i = 0; i < index_count; ++i) {
+        unsigned int v = indices[i];
+        adj->triangles[adj->offsets[v]++] = (unsigned int)(i / 3);
+    }
+    for (size_t v = vertex_count; v > 0; --v) {
+        adj->offsets[v] = adj->offsets[v - 1];
+    }
+    adj->offsets[0] = 0;
+    return 0;
+}
+
+static void free_adjacency(TriangleAdjacency* adj) {
+    free(adj->offsets);
+    free(adj->triangles);
+    free(adj->live);
+}
+
+static int validate_mesh(const Mesh* mesh) {
+    if (!mesh || !mesh->indices || mesh->num_indices < 3 || mesh->num_indices % 3 != 0) return -1;
+    for (size_t i = 0; i < mesh->num_indices; ++i) {
+        if (mesh->indices[i] >= mesh->num_vertices) return -1;
+    }
+    return 0;
+}
+
+int optimize_vertex_cache(Mesh* mesh, unsigned int cache_size) {
+    if (validate_mesh(mesh) != 0 || cache_size < 3) return -1;
+
+    size_t index_count = mesh->num_indices;
+    size_t vertex_count = mesh->num_vertices;
+    size_t triangle_count = index_count / 3;
+
+    TriangleAdjacency adj = {0};
+    unsigned int* cache_time = (unsigned int*)calloc(vertex_count, sizeof(unsigned int));
+    unsigned char* emitted = (unsigned char*)calloc(triangle_count, 1);
+    unsigned int* dead_end = (unsigned int*)malloc(sizeof(unsigned int) * index_count);
+    unsigned int* output = (unsigned int*)malloc(sizeof(unsigned int) * index_count);
+
+    if (build_adjacency(mesh->indices, index_count, vertex_count, &adj) != 0 ||
+        !cache_time || !emitted || !dead_end || !output) {
+        free_adjacency(&adj);
+        free(cache_time);
+        free(emitted);
+        free(dead_end);
+        free(output);
+        return -1;
+    }
+
+    unsigned int max_valence = 0;
+    for (size_t v = 0; v < vertex_count; ++v) {
+        if (adj.live[v] > max_valence) max_valence = adj.live[v];
+    }
+    unsigned int* candidates = (unsigned int*)malloc(sizeof(unsigned int) * (max_valence * 3 + 1));
+    if (!candidates) {
+        free_adjacency(&adj);
+        free(cache_time);
+        free(emitted);
+        free(dead_end);
+        free(output);
+        return -1;
+    }
+
+    unsigned int timestamp = cache_size + 1;
+    size_t dead_end_top = 0;
+    size_t output_count = 0;
+    size_t scan_cursor = 0;
+    long fan_vertex = 0;
+
+    while (fan_vertex >= 0) {
+        size_t candidate_count = 0;
+
+        // Emit every remaining triangle around the fanning vertex
+        for (unsigned int a = adj.offsets[fan_vertex]; a < adj.offsets[fan_vertex + 1]; ++a) {
+            unsigned int t = adj.triangles[a];
+            if (emitted[t]) continue;
+            emitted[t] = 1;
+
+            for (int k = 0; k < 3; ++k) {
+                unsigned int v = mesh->indices[t * 3 + k];
+                output[output_count++] = v;
+                dead_end[dead_end_top++] = v;
+                candidates[candidate_count++] = v;
+                adj.live[v]--;
+
+                if (timestamp - cache_time[v] > cache_size) {
+                    cache_time[v] = timestamp++;
+                }
+            }
+        }
+
+        // Prefer the 1-ring vertex that stays in cache for all of its remaining triangles, oldest first
+        long best = -1;
+        int best_priority = -1;
+        for (size_t c = 0; c < candidate_count; ++c) {
+            unsigned int v = candidates[c];
+            if (adj.live[v] == 0) continue;
+
+            int priority = 0;
+            unsigned int age = timestamp - cache_time[v];
+            if (age + 2 * adj.live[v] <= cache_size) {
+                priority = (int)age;
+            }
+            if (priority > best_priority) {
+                best_priority = priority;
+                best = v;
+            }
+        }
+
+        if (best < 0) {
+            // Dead end: back up through recently emitted vertices, then fall back to a linear scan
+            while (dead_end_top > 0) {
+                unsigned int v = dead_end[--dead_end_top];
+                if (adj.live[v] > 0) {
+                    best = v;
+                    break;
+                }
+            }
+            while (best < 0 && scan_cursor < vertex_count) {
+                if (adj.live[scan_cursor] > 0) {
+                    best = (long)scan_cursor;
+                }
+                scan_cursor++;
+            }
+        }
+
+        fan_vertex = best;
+    }
+
+    memcpy(mesh->indices, output, sizeof(unsigned int) * index_count);
+
+    free(candidates);
+    free_adjacency(&adj);
+    free(cache_time);
+    free(emitted);
+    free(dead_end);
+    free(output);
+    return 0;
+}
+
+typedef struct {
+    float sort_key;
+    size_t start;
+    size_t count;   // Triangles in the cluster
+} TriangleCluster;
+
+static int compare_clusters(const void* a, const void* b) {
+    float ka = ((const TriangleCluster*)a)->sort_key;
+    float kb = ((const TriangleCluster*)b)->sort_key;
+    // Descending: outward-facing clusters are drawn first and occlude the rest
+    return (ka < kb) - (ka > kb);
+}
+
+// Returns the number of misses for triangle t and updates the simulated FIFO
+static unsigned int simulate_triangle(const unsigned int* indices, size_t t, unsigned int* cache_time,
+                                      unsigned int* timestamp, unsigned int cache_size) {
+    unsigned int misses = 0;
+    for (int k = 0; k < 3; ++k) {
+        unsigned int v = indices[t * 3 + k];
+        if (*timestamp - cache_time[v] > cache_size) {
+            cache_time[v] = (*timestamp)++;
+            misses++;
+        }
+    }
+    return misses;
+}
+
+int optimize_overdraw(Mesh* mesh, unsigned int cache_size, float threshold) {
+    if (validate_mesh(mesh) != 0 || !mesh->vertices || cache_size < 3) return -1;
+
+    size_t triangle_count = mesh->num_indices / 3;
+    unsigned int* cache_time = (unsigned int*)calloc(mesh->num_vertices, sizeof(unsigned int));
+    size_t* hard_starts = (size_t*)malloc(sizeof(size_t) * (triangle_count + 1));
+    TriangleCluster* clusters = (TriangleCluster*)malloc(sizeof(TriangleCluster) * triangle_count);
+    unsigned int* output = (unsigned int*)malloc(sizeof(unsigned int) * mesh->num_indices);
+    if (!cache_time || !hard_starts || !clusters || !output) {
+        free(cache_time);
+        free(hard_starts);
+        free(clusters);
+        free(output);
+        return -1;
+    }
+
+    // Hard boundaries: a triangle missing all three vertices starts a new fan after a cache flush
+    size_t hard_count = 0;
+    unsigned int timestamp = cache_size + 1;
+    for (size_t t = 0; t < triangle_count; ++t) {
+        if (simulate_triangle(mesh->indices, t, cache_time, &timestamp, cache_size) == 3) {
+            hard_starts[hard_count++] = t;
+        }
+    }
+    if (hard_count == 0 || hard_starts[0] != 0) {
+        // Cannot happen for a cold cache, but keep the first cluster anchored at triangle 0
+        memmove(hard_starts + 1, hard_starts, sizeof(size_t) * hard_count);
+        hard_starts[0] = 0;
+        hard_count++;
+    }
+    hard_starts[hard_count] = triangle_count;
+
+    // Soft boundaries: split a hard cluster wherever the running ACMR is already as good as the
+    // whole hard cluster's, so sorting the pieces costs little cache efficiency
+    size_t cluster_count = 0;
+    for (size_t h = 0; h < hard_count; ++h) {
+        size_t start = hard_starts[h];
+        size_t end = hard_starts[h + 1];
+
+        timestamp += cache_size + 1;
+        unsigned int hard_misses = 0;
+        for (size_t t = start; t < end; ++t) {
+            hard_misses += simulate_triangle(mesh->indices, t, cache_time, &timestamp, cache_size);
+        }
+        float cluster_threshold = threshold * (float)hard_misses / (float)(end - start);
+
+        timestamp += cache_size + 1;
+        size_t soft_start = start;
+        unsigned int running_misses = 0;
+        for (size_t t = start; t < end; ++t) {
+            running_misses += simulate_triangle(mesh->indices, t, cache_time, &timestamp, cache_size);
+            size_t running_count = t - soft_start + 1;
+            if (t + 1 == end || (float)running_misses / (float)running_count <= cluster_threshold) {
+                clusters[cluster_count].start = soft_start;
+                clusters[cluster_count].count = running_count;
+                cluster_count++;
+                soft_start = t + 1;
+                running_misses = 0;
+                timestamp += cache_size + 1;
+            }
+        }
+    }
+
+    // Mesh centroid from vertex positions
+    double mesh_centroid[3] = {0.0, 0.0, 0.0};
+    for (size_t v = 0; v < mesh->num_vertices; ++v) {
+        mesh_centroid[0] += mesh->vertices[v * 3 + 0];
+        mesh_centroid[1] += mesh->vertices[v * 3 + 1];
+        mesh_centroid[2] += mesh->vertices[v * 3 + 2];
+    }
+    for (int k = 0; k < 3; ++k) mesh_centroid[k] /= (double)mesh->num_vertices;
+
+    // Sort key: how far the cluster faces away from the mesh centre (Sander et al. 2007)
+    for (size_t c = 0; c < cluster_count; ++c) {
+        float centroid[3] = {0.0f, 0.0f, 0.0f};
+        float normal[3] = {0.0f, 0.0f, 0.0f};
+        float area_sum = 0.0f;
+
+        for (size_t t = clusters[c].start; t < clusters[c].start + clusters[c].count; ++t) {
+            const float* p0 = &mesh->vertices[mesh->indices[t * 3 + 0] * 3];
+            const float* p1 = &mesh->vertices[mesh->indices[t * 3 + 1] * 3];
+            const float* p2 = &mesh->vertices[mesh->indices[t * 3 + 2] * 3];
+
+            float e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+            float e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+            float n[3] = {
+                e1[1] * e2[2] - e1[2] * e2[1],
+                e1[2] * e2[0] - e1[0] * e2[2],
+                e1[0] * e2[1] - e1[1] * e2[0]
+            };
+            float area = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+            // Area-weighted, so slivers do not dominate the cluster orientation
+            for (int k = 0; k < 3; ++k) {
+                centroid[k] += (p0[k] + p1[k] + p2[k]) * (area / 3.0f);
+                normal[k] += n[k];
+            }
+            area_sum += area;
+        }
+
+        float normal_length = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (area_sum <= 0.0f || normal_length <= 0.0f) {
+            clusters[c].sort_key = 0.0f;
+            continue;
+        }
+
+        float key = 0.0f;
+        for (int k = 0; k < 3; ++k) {
+            key += (centroid[k] / area_sum - (float)mesh_centroid[k]) * (normal[k] / normal_length);
+        }
+        clusters[c].sort_key = key;
+    }
+
+    qsort(clusters, cluster_count, sizeof(TriangleCluster), compare_clusters);
+
+    size_t write = 0;
+    for (size_t c = 0; c < cluster_count; ++c) {
+        size_t count = clusters[c].count * 3;
+        memcpy(&output[write], &mesh->indices[clusters[c].start * 3], sizeof(unsigned int) * count);
+        write += count;
+    }
+    memcpy(mesh->indices, output, sizeof(unsigned int) * mesh->num_indices);
+
+    free(cache_time);
+    free(hard_starts);
+    free(clusters);
+    free(output);
+    return 0;
+}
+
+int optimize_vertex_fetch(Mesh* mesh) {
+    if (validate_mesh(mesh) != 0) return -1;
+
+    size_t vertex_count = mesh->num_vertices;
+    unsigned int* remap = (unsigned int*)malloc(sizeof(unsigned int) * vertex_count);
+    float* vertices = (float*)malloc(sizeof(float) * 3 * vertex_count);
+    float* normals = mesh->normals ? (float*)malloc(sizeof(float) * 3 * vertex_count) : NULL;
+    float* texcoords = mesh->texcoords ? (float*)malloc(sizeof(float) * 2 * vertex_count) : NULL;
+    if (!remap || !vertices || (mesh->normals && !normals) || (mesh->texcoords && !texcoords)) {
+        free(remap);
+        free(vertices);
+        free(normals);
+        free(texcoords);
+        return -1;
+    }
+    memset(remap, 0xff, sizeof(unsigned int) * vertex_count);
+
+    // Assign new slots in order of first reference
+    unsigned int next = 0;
+    for (size_t i = 0; i < mesh->num_indices; ++i) {
+        unsigned int v = mesh->indices[i];
+        if (remap[v] == 0xffffffffu) {
+            remap[v] = next;
+            memcpy(&vertices[next * 3], &mesh->vertices[v * 3], sizeof(float) * 3);
+            if (normals) memcpy(&normals[next * 3], &mesh->normals[v * 3], sizeof(float) * 3);
+            if (texcoords) memcpy(&texcoords[next * 2], &mesh->texcoords[v * 2], sizeof(float) * 2);
+            next++;
+        }
+        mesh->indices[i] = remap[v];
+    }
+
+    free(mesh->vertices);
+    free(mesh->normals);
+    free(mesh->texcoords);
+    mesh->vertices = vertices;
+    mesh->normals = normals;
+    mesh->texcoords = texcoords;
+    mesh->num_vertices = next;
+
+    free(remap);
+    return 0;
+}
+
+int optimize_mesh(Mesh* mesh) {
+    if (validate_mesh(mesh) != 0) {
+        printf("Mesh optimization skipped: invalid mesh\n");
+        return -1;
+    }
+
+    VertexCacheStats before;
+    analyze_vertex_cache(mesh->indices, mesh->num_indices, mesh->num_vertices, MESH_OPT_CACHE_SIZE, &before);
+
+    if (optimize_vertex_cache(mesh, MESH_OPT_CACHE_SIZE) != 0) {
+        printf("Mesh optimization failed: vertex cache pass\n");
+        return -1;
+    }
+
+    VertexCacheStats after_cache;
+    analyze_vertex_cache(mesh->indices, mesh->num_indices, mesh->num_vertices, MESH_OPT_CACHE_SIZE, &after_cache);
+
+    if (optimize_overdraw(mesh, MESH_OPT_CACHE_SIZE, MESH_OPT_OVERDRAW_THRESHOLD) != 0) {
+        printf("Mesh optimization failed: overdraw pass\n");
+        return -1;
+    }
+    if (optimize_vertex_fetch(mesh) != 0) {
+        printf("Mesh optimization failed: vertex fetch pass\n");
+        return -1;
+    }
+
+    VertexCacheStats after;
+    analyze_vertex_cache(mesh->indices, mesh->num_indices, mesh->num_vertices, MESH_OPT_CACHE_SIZE, &after);
+
+    printf("Mesh optimization (%zu triangles, %zu vertices, FIFO %u):\n",
+           mesh->num_indices / 3, mesh->num_vertices, MESH_OPT_CACHE_SIZE);
+    printf("  Original:          ACMR %.3f  ATVR %.3f\n", before.acmr, before.atvr);
+    printf("  Vertex cache:      ACMR %.3f  ATVR %.3f\n", after_cache.acmr, after_cache.atvr);
+    printf("  + Overdraw/fetch:  ACMR %.3f  ATVR %.3f\n", after.acmr, after.atvr);
+    return 0;
+}
@@ -0,0 +1,42 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <stddef.h>
+#include "objloader.h"
+
+// FIFO size used for reordering and analysis; close to the post-transform cache of current GPUs
+#define MESH_OPT_CACHE_SIZE 16
+
+// Clusters whose ACMR is within this factor of their hard cluster's ACMR may be split for overdraw sorting
+#define MESH_OPT_OVERDRAW_THRESHOLD 1.05f
+
+// Post-transform cache statistics for an index buffer
+typedef struct {
+    size_t cache_misses;   // Vertex shader invocations under a FIFO cache
+    float acmr;            // Misses per triangle (0.5 is ideal, 3.0 is worst)
+    float atvr;            // Misses per referenced vertex (1.0 is ideal)
+} VertexCacheStats;
+
+// Simulate a FIFO post-transform cache over an index buffer
+void analyze_vertex_cache(const unsigned int* indices, size_t index_count, size_t vertex_count,
+                          unsigned int cache_size, VertexCacheStats* stats);
+
+// Reorder triangles for post-transform cache locality (Tipsify)
+// Returns 0 on success, -1 on failure
+int optimize_vertex_cache(Mesh* mesh, unsigned int cache_size);
+
+// Split a cache-optimized triangle order into clusters and sort them outside-in to reduce overdraw
+// Keeps ACMR within threshold of the cache-optimized order
+// Returns 0 on success, -1 on failure
+int optimize_overdraw(Mesh* mesh, unsigned int cache_size, float threshold);
+
+// Reorder vertex attributes in order of first use so vertex fetch walks memory linearly
+// Unreferenced vertices are dropped
+// Returns 0 on success, -1 on failure
+int optimize_vertex_fetch(Mesh* mesh);
+
+// Run the vertex cache, overdraw and vertex fetch passes and print ACMR/ATVR before and after
+// Returns 0 on success, -1 on failure (mesh is left in a valid state either way)
+int optimize_mesh(Mesh* mesh);
+
+#endif // MESH_OPTIMIZER_H
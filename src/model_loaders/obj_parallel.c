@@ -0,0 +1,442 @@
+#include "obj_parallel.h"
+#include "mapped_file.h"
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef enum {
+    OBJ_LINE_OTHER,
+    OBJ_LINE_POSITION,
+    OBJ_LINE_NORMAL,
+    OBJ_LINE_TEXCOORD,
+    OBJ_LINE_FACE
+} ObjLineType;
+
+struct ObjParseContext;
+
+// A run of whole lines parsed by one job
+typedef struct {
+    const char* begin;
+    const char* end;
+    struct ObjParseContext* context;
+
+    // Elements in the chunk, from the counting pass
+    size_t num_positions;
+    size_t num_normals;
+    size_t num_texcoords;
+    size_t num_corners;
+
+    // Index of the chunk's first element in each output array (exclusive prefix sums of the counts)
+    size_t first_position;
+    size_t first_normal;
+    size_t first_texcoord;
+    size_t first_corner;
+
+    const char* error;      // Start of the first malformed line, NULL if none
+} ObjChunk;
+
+typedef struct ObjParseContext {
+    ObjAttributes* out;
+    ObjChunk chunks[OBJ_PARALLEL_MAX_CHUNKS];
+    JobDecl jobs[OBJ_PARALLEL_MAX_CHUNKS];
+    uint32_t chunk_count;
+} ObjParseContext;
+
+static int is_blank(char c) {
+    // '\r' of CRLF files ends up at the end of a line and is skipped like a space
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static const char* skip_blanks(const char* p, const char* end) {
+    while (p < end && is_blank(*p)) p++;
+    return p;
+}
+
+// Classify a line by its keyword; *rest points past the keyword
+static ObjLineType classify_line(const char* p, const char* end, const char** rest) {
+    p = skip_blanks(p, end);
+    if (end - p >= 2 && p[0] == 'v' && is_blank(p[1])) {
+        *rest = p + 1;
+        return OBJ_LINE_POSITION;
+    }
+    if (end - p >= 3 && p[0] == 'v' && is_blank(p[2])) {
+        *rest = p + 2;
+        if (p[1] == 'n') return OBJ_LINE_NORMAL;
+        if (p[1] == 't') return OBJ_LINE_TEXCOORD;
+        return OBJ_LINE_OTHER;
+    }
+    if (end - p >= 2 && p[0] == 'f' && is_blank(p[1])) {
+        *rest = p + 1;
+        return OBJ_LINE_FACE;
+    }
+    return OBJ_LINE_OTHER;
+}
+
+// End of a statement's arguments: a trailing "# comment" is not part of the element
+static const char* statement_end(const char* rest, const char* line_end) {
+    const char* comment = memchr(rest, '#', (size_t)(line_end - rest));
+    return comment ? comment : line_end;
+}
+
+// Decimal float with optional sign, fraction and exponent; returns 0 if there are no digits
+static int parse_float(const char** cursor, const char* end, float* out) {
+    static const double powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    const char* p = *cursor;
+    int negative = 0;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+
+    // Up to 19 significant digits fit the mantissa; further digits only shift the exponent
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    int any_digit = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; p++, any_digit = 1) {
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+            if (mantissa) digits++;
+        } else {
+            exponent++;
+        }
+    }
+    if (p < end && *p == '.') {
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++, any_digit = 1) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+                if (mantissa) digits++;
+                exponent--;
+            }
+        }
+    }
+    if (!any_digit) return 0;
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char* e = p + 1;
+        int exponent_negative = 0;
+        if (e < end && (*e == '-' || *e == '+')) {
+            exponent_negative = *e == '-';
+            e++;
+        }
+        if (e < end && *e >= '0' && *e <= '9') {
+            int value = 0;
+            for (; e < end && *e >= '0' && *e <= '9'; e++) {
+                if (value < 10000) value = value * 10 + (*e - '0');
+            }
+            exponent += exponent_negative ? -value : value;
+            p = e;
+        }
+    }
+
+    double result = (double)mantissa;
+    if (exponent < 0) {
+        result = -exponent <= 22 ? result / powers[-exponent] : result * pow(10.0, exponent);
+    } else if (exponent > 0) {
+        result = exponent <= 22 ? result * powers[exponent] : result * pow(10.0, exponent);
+    }
+    *out = (float)(negative ? -result : result);
+    *cursor = p;
+    return 1;
+}
+
+// Up to count floats separated by blanks; missing trailing values are 0 (as for "vt u")
+static int parse_floats(const char** cursor, const char* end, float* out, int count) {
+    const char* p = *cursor;
+    for (int i = 0; i < count; i++) {
+        out[i] = 0.0f;
+    }
+    for (int i = 0; i < count; i++) {
+        p = skip_blanks(p, end);
+        if (p == end) break;
+        if (!parse_float(&p, end, &out[i])) return 0;
+        if (p < end && !is_blank(*p)) return 0;
+    }
+    *cursor = p;
+    return 1;
+}
+
+static int parse_index(const char** cursor, const char* end, long long* out) {
+    const char* p = *cursor;
+    int negative = 0;
+    if (p < end && *p == '-') {
+        negative = 1;
+        p++;
+    }
+    if (p == end || *p < '0' || *p > '9') return 0;
+    long long value = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; p++) {
+        if (value < INT_MAX) value = value * 10 + (*p - '0');
+    }
+    *out = negative ? -value : value;
+    *cursor = p;
+    return 1;
+}
+
+// 1-based or, when negative, relative to the elements defined so far; -1 if out of range
+static int resolve_index(long long index, size_t defined) {
+    long long resolved = index > 0 ? index - 1 : (long long)defined + index;
+    return resolved >= 0 && resolved <= INT_MAX ? (int)resolved : -1;
+}
+
+// One face corner: v, v/vt, v//vn or v/vt/vn
+static int parse_corner(const char** cursor, const char* end, size_t positions, size_t texcoords,
+                        size_t normals, ObjCorner* out) {
+    const char* p = *cursor;
+    long long index;
+    if (!parse_index(&p, end, &index) || index == 0) return 0;
+    out->v = resolve_index(index, positions);
+    out->vt = -1;
+    out->vn = -1;
+
+    if (p < end && *p == '/') {
+        p++;
+        if (p < end && *p != '/') {
+            if (!parse_index(&p, end, &index) || index == 0) return 0;
+            out->vt = resolve_index(index, texcoords);
+        }
+        if (p < end && *p == '/') {
+            p++;
+            if (!parse_index(&p, end, &index) || index == 0) return 0;
+            out->vn = resolve_index(index, normals);
+        }
+    }
+    if (p < end && !is_blank(*p)) return 0;
+    *cursor = p;
+    return 1;
+}
+
+// Pass 1: count the elements so every chunk knows where its output starts
+static void count_chunk(void* data) {
+    ObjChunk* chunk = (ObjChunk*)data;
+    const char* p = chunk->begin;
+    while (p < chunk->end) {
+        const char* line_end = memchr(p, '\n', (size_t)(chunk->end - p));
+        if (!line_end) line_end = chunk->end;
+
+        const char* rest;
+        switch (classify_line(p, line_end, &rest)) {
+            case OBJ_LINE_POSITION: chunk->num_positions++; break;
+            case OBJ_LINE_NORMAL: chunk->num_normals++; break;
+            case OBJ_LINE_TEXCOORD: chunk->num_texcoords++; break;
+            case OBJ_LINE_FACE: {
+                const char* corners_end = statement_end(rest, line_end);
+                size_t tokens = 0;
+                for (const char* t = skip_blanks(rest, corners_end); t < corners_end; t = skip_blanks(t, corners_end)) {
+                    tokens++;
+                    while (t < corners_end && !is_blank(*t)) t++;
+                }
+                if (tokens >= 3) chunk->num_corners += (tokens - 2) * 3;
+                break;
+            }
+            default: break;
+        }
+        p = line_end + 1;
+    }
+}
+
+// Pass 2: parse into the chunk's slice of the output arrays
+static void parse_chunk(void* data) {
+    ObjChunk* chunk = (ObjChunk*)data;
+    ObjAttributes* out = chunk->context->out;
+    float* position = out->positions + chunk->first_position * 3;
+    float* normal = out->normals + chunk->first_normal * 3;
+    float* texcoord = out->texcoords + chunk->first_texcoord * 2;
+    ObjCorner* corner = out->corners + chunk->first_corner;
+
+    // Elements defined before the current line, for relative indices
+    size_t positions = chunk->first_position;
+    size_t normals = chunk->first_normal;
+    size_t texcoords = chunk->first_texcoord;
+
+    const char* p = chunk->begin;
+    while (p < chunk->end) {
+        const char* line_end = memchr(p, '\n', (size_t)(chunk->end - p));
+        if (!line_end) line_end = chunk->end;
+
+        const char* rest;
+        int ok = 1;
+        switch (classify_line(p, line_end, &rest)) {
+            case OBJ_LINE_POSITION:
+                ok = parse_floats(&rest, statement_end(rest, line_end), position, 3);
+                position += 3;
+                positions++;
+                break;
+            case OBJ_LINE_NORMAL:
+                ok = parse_floats(&rest, statement_end(rest, line_end), normal, 3);
+                normal += 3;
+                normals++;
+                break;
+            case OBJ_LINE_TEXCOORD:
+                ok = parse_floats(&rest, statement_end(rest, line_end), texcoord, 2);
+                texcoord += 2;
+                texcoords++;
+                break;
+            case OBJ_LINE_FACE: {
+                // Fan triangulation, as tinyobj does: (0, i-1, i) for every further corner
+                ObjCorner first = {0}, previous = {0}, current;
+                uint32_t count = 0;
+                const char* corners_end = statement_end(rest, line_end);
+                for (rest = skip_blanks(rest, corners_end); rest < corners_end && ok; rest = skip_blanks(rest, corners_end)) {
+                    ok = parse_corner(&rest, corners_end, positions, texcoords, normals, &current);
+                    if (!ok) break;
+                    if (count == 0) {
+                        first = current;
+                    } else if (count >= 2) {
+                        corner[0] = first;
+                        corner[1] = previous;
+                        corner[2] = current;
+                        corner += 3;
+                    }
+                    previous = current;
+                    count++;
+                }
+                // Faces of one or two corners were counted as no triangle and are dropped
+                break;
+            }
+            default: break;
+        }
+        if (!ok) {
+            chunk->error = p;
+            return;
+        }
+        p = line_end + 1;
+    }
+}
+
+static void run_chunk_jobs(JobSystem* jobs, ObjParseContext* context, JobFunction function) {
+    for (uint32_t i = 0; i < context->chunk_count; i++) {
+        context->jobs[i] = (JobDecl){function, &context->chunks[i]};
+    }
+    if (!jobs) {
+        for (uint32_t i = 0; i < context->chunk_count; i++) {
+            function(&context->chunks[i]);
+        }
+        return;
+    }
+    JobCounter counter = {0};
+    runJobs(jobs, context->jobs, context->chunk_count, &counter);
+    waitForCounter(jobs, &counter);
+}
+
+int parse_obj_parallel(const char* data, size_t size, JobSystem* jobs, ObjAttributes* out) {
+    if (!data || !out) return -1;
+    memset(out, 0, sizeof(ObjAttributes));
+
+    ObjParseContext* context = (ObjParseContext*)calloc(1, sizeof(ObjParseContext));
+    if (!context) return -1;
+    context->out = out;
+
+    // Enough chunks to balance the threads, but none smaller than the minimum
+    size_t chunk_count = (size_t)(jobs ? jobs->threadCount : 1) * OBJ_PARALLEL_CHUNKS_PER_THREAD;
+    size_t chunks_by_size = size / OBJ_PARALLEL_MIN_CHUNK_BYTES + 1;
+    if (chunk_count > chunks_by_size) chunk_count = chunks_by_size;
+    if (chunk_count > OBJ_PARALLEL_MAX_CHUNKS) chunk_count = OBJ_PARALLEL_MAX_CHUNKS;
+    context->chunk_count = (uint32_t)chunk_count;
+
+    // Cut at even offsets, each moved past the next newline so no line is split
+    const char* end = data + size;
+    const char* begin = data;
+    for (uint32_t i = 0; i < context->chunk_count; i++) {
+        const char* cut = end;
+        if (i + 1 < context->chunk_count) {
+            cut = data + size / chunk_count * (i + 1);
+            if (cut < begin) cut = begin;
+            const char* newline = memchr(cut, '\n', (size_t)(end - cut));
+            cut = newline ? newline + 1 : end;
+        }
+        context->chunks[i].begin = begin;
+        context->chunks[i].end = cut;
+        context->chunks[i].context = context;
+        begin = cut;
+    }
+
+    run_chunk_jobs(jobs, context, count_chunk);
+
+    for (uint32_t i = 0; i < context->chunk_count; i++) {
+        ObjChunk* chunk = &context->chunks[i];
+        chunk->first_position = out->num_positions;
+        chunk->first_normal = out->num_normals;
+        chunk->first_texcoord = out->num_texcoords;
+        chunk->first_corner = out->num_corners;
+        out->num_positions += chunk->num_positions;
+        out->num_normals += chunk->num_normals;
+        out->num_texcoords += chunk->num_texcoords;
+        out->num_corners += chunk->num_corners;
+    }
+
+    // One extra element keeps every allocation non-empty
+    out->positions = (float*)malloc(sizeof(float) * 3 * (out->num_positions + 1));
+    out->normals = (float*)malloc(sizeof(float) * 3 * (out->num_normals + 1));
+    out->texcoords = (float*)malloc(sizeof(float) * 2 * (out->num_texcoords + 1));
+    out->corners = (ObjCorner*)malloc(sizeof(ObjCorner) * (out->num_corners + 1));
+    if (!out->positions || !out->normals || !out->texcoords || !out->corners) {
+        printf("Out of memory parsing OBJ (%zu positions, %zu corners)\n", out->num_positions, out->num_corners);
+        free_obj_attributes(out);
+        free(context);
+        return -1;
+    }
+
+    run_chunk_jobs(jobs, context, parse_chunk);
+
+    for (uint32_t i = 0; i < context->chunk_count; i++) {
+        const char* error = context->chunks[i].error;
+        if (error) {
+            // Only on failure: find the line number for the message
+            size_t line = 1;
+            for (const char* p = data; p < error; p++) line += *p == '\n';
+            const char* line_end = memchr(error, '\n', (size_t)(end - error));
+            int length = (int)((line_end ? line_end : end) - error);
+            printf("OBJ parse error on line %zu: %.*s\n", line, length > 80 ? 80 : length, error);
+            free_obj_attributes(out);
+            free(context);
+            return -1;
+        }
+    }
+
+    printf("OBJ parsed in %u chunks: %zu positions, %zu normals, %zu texcoords, %zu triangles\n",
+           context->chunk_count, out->num_positions, out->num_normals, out->num_texcoords, out->num_corners / 3);
+    free(context);
+    return 0;
+}
+
+void free_obj_attributes(ObjAttributes* attributes) {
+    if (!attributes) return;
+    free(attributes->positions);
+    free(attributes->normals);
+    free(attributes->texcoords);
+    free(attributes->corners);
+    memset(attributes, 0, sizeof(ObjAttributes));
+}
+
+int load_obj_parallel(const char* filename, JobSystem* jobs, Mesh* mesh) {
+    if (!filename || !mesh) return -1;
+
+    // Parsed straight from the page cache; the chunk jobs each read their range front to back
+    MappedFile file;
+    if (map_file(filename, MAPPED_FILE_SEQUENTIAL, &file) != 0) {
+        return -1;
+    }
+
+    ObjAttributes attributes;
+    int result = parse_obj_parallel(file.data, file.size, jobs, &attributes);
+    unmap_file(&file);
+    if (result != 0) {
+        return -1;
+    }
+    if (attributes.num_corners == 0) {
+        free_obj_attributes(&attributes);
+        return -1;
+    }
+
+    result = build_indexed_mesh(attributes.positions, attributes.num_positions,
+                                attributes.normals, attributes.num_normals,
+                                attributes.texcoords, attributes.num_texcoords,
+                                attributes.corners, attributes.num_corners, mesh);
+    free_obj_attributes(&attributes);
+    return result;
+}
@@ -0,0 +1,43 @@
+#ifndef OBJ_PARALLEL_H
+#define OBJ_PARALLEL_H
+
+#include <stddef.h>
+#include "objloader.h"
+#include "../jobs/job_system.h"
+
+// Smallest piece of the file parsed by one job; smaller files use fewer chunks
+#define OBJ_PARALLEL_MIN_CHUNK_BYTES (1u << 20)
+
+// Chunks per job thread, so threads that finish early steal the remaining ones
+#define OBJ_PARALLEL_CHUNKS_PER_THREAD 4
+
+#define OBJ_PARALLEL_MAX_CHUNKS 1024
+
+// Attribute arrays of a parsed OBJ, in file order, indices resolved to 0-based
+typedef struct {
+    float* positions;       // x,y,z per "v"
+    float* normals;         // x,y,z per "vn"
+    float* texcoords;       // u,v per "vt"
+    ObjCorner* corners;     // Three per triangle, polygons fan-triangulated
+    size_t num_positions;
+    size_t num_normals;
+    size_t num_texcoords;
+    size_t num_corners;
+} ObjAttributes;
+
+// Parse OBJ text on the job system: the text is split into chunks at line boundaries,
+// each chunk counts its v/vn/vt/f elements, prefix sums over the counts give every
+// chunk its slice of the output arrays, and the chunks are parsed into them in parallel.
+// Only geometry is read; groups, materials and other statements are skipped.
+// jobs may be NULL to parse on the calling thread; data need not be NUL-terminated
+// Returns 0 on success, -1 on a malformed element or allocation failure
+int parse_obj_parallel(const char* data, size_t size, JobSystem* jobs, ObjAttributes* out);
+
+// Free the arrays of parse_obj_parallel
+void free_obj_attributes(ObjAttributes* attributes);
+
+// Load an OBJ file like load_obj, parsing it with parse_obj_parallel
+// Returns 0 on success, -1 on failure
+int load_obj_parallel(const char* filename, JobSystem* jobs, Mesh* mesh);
+
+#endif // OBJ_PARALLEL_H
@@ -1,31 +1,73 @@
 #include "objloader.h"
+#include "mapped_file.h"
 #define TINYOBJ_LOADER_C_IMPLEMENTATION
 #include "tinyobj_loader_c.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stddef.h>
+#include <math.h>
 
-// File reader callback for tinyobj
+// Files tinyobj can request per parse: the OBJ and its material library
+#define OBJ_READER_MAX_FILES 4
+
+// Mappings handed to tinyobj, unmapped once it has parsed them
+typedef struct {
+    MappedFile files[OBJ_READER_MAX_FILES];
+    unsigned int count;
+} ObjReaderContext;
+
+// File reader callback for tinyobj: maps the file instead of copying it to the heap,
+// tinyobj only reads the buffer
 static void my_file_reader(void* ctx, const char* filename, int is_mtl, const char* obj_filename, char** buf, size_t* len) {
-    FILE* file = fopen(filename, "rb");
-    if (!file) {
-        *buf = NULL;
-        *len = 0;
+    ObjReaderContext* reader = (ObjReaderContext*)ctx;
+    *buf = NULL;
+    *len = 0;
+    if (reader->count == OBJ_READER_MAX_FILES) {
         return;
     }
 
-    fseek(file, 0, SEEK_END);
-    *len = ftell(file);
-    fseek(file, 0, SEEK_SET);
+    MappedFile* file = &reader->files[reader->count];
+    if (map_file(filename, MAPPED_FILE_SEQUENTIAL, file) != 0) {
+        return;
+    }
+    reader->count++;
+    *buf = (char*)file->data;
+    *len = file->size;
+}
 
-    *buf = (char*)malloc(*len);
-    if (*buf) {
-        fread(*buf, 1, *len, file);
-    } else {
-        *len = 0;
+static void close_reader_files(ObjReaderContext* reader) {
+    for (unsigned int i = 0; i < reader->count; i++) {
+        unmap_file(&reader->files[i]);
     }
+    reader->count = 0;
+}
+
+// ObjCorner mirrors tinyobj's corner layout so its face array is used in place
+_Static_assert(sizeof(ObjCorner) == sizeof(tinyobj_vertex_index_t), "ObjCorner must match tinyobj_vertex_index_t");
+_Static_assert(offsetof(ObjCorner, vt) == offsetof(tinyobj_vertex_index_t, vt_idx), "ObjCorner must match tinyobj_vertex_index_t");
+_Static_assert(offsetof(ObjCorner, vn) == offsetof(tinyobj_vertex_index_t, vn_idx), "ObjCorner must match tinyobj_vertex_index_t");
+
+// Open-addressing table mapping a (v, vt, vn) tuple to its deduplicated vertex index
+typedef struct {
+    ObjCorner key;
+    unsigned int value;
+    int used;
+} VertexDedupSlot;
+
+static size_t hash_vertex_index(ObjCorner idx) {
+    // Offset by one so "missing" (-1) attributes hash differently from index 0
+    size_t h = (size_t)(unsigned int)(idx.v + 1) * 73856093u;
+    h ^= (size_t)(unsigned int)(idx.vt + 1) * 19349663u;
+    h ^= (size_t)(unsigned int)(idx.vn + 1) * 83492791u;
+    return h;
+}
 
-    fclose(file);
+static void free_parse_results(tinyobj_attrib_t* attrib, tinyobj_shape_t* shapes, size_t num_shapes,
+                               tinyobj_material_t* materials, size_t num_materials) {
+    tinyobj_attrib_free(attrib);
+    tinyobj_shapes_free(shapes, num_shapes);
+    tinyobj_materials_free(materials, num_materials);
 }
 
 int load_obj(const char* filename, Mesh* mesh) {
@@ -37,9 +79,12 @@ int load_obj(const char* filename, Mesh* mesh) {
     tinyobj_material_t* materials = NULL;
     size_t num_materials;
 
+    ObjReaderContext reader = {0};
     int result = tinyobj_parse_obj(&attrib, &shapes, &num_shapes, &materials,
                                    &num_materials, filename, my_file_reader,
-                                   NULL, TINYOBJ_FLAG_TRIANGULATE);
+                                   &reader, TINYOBJ_FLAG_TRIANGULATE);
+    // The parse results are copies, the text is no longer needed
+    close_reader_files(&reader);
 
     if (result != TINYOBJ_SUCCESS) {
         return -1;
@@ -47,66 +92,147 @@ int load_obj(const char* filename, Mesh* mesh) {
 
     // For simplicity, assume one shape and triangulated faces
     if (num_shapes == 0 || attrib.num_faces == 0) {
-        tinyobj_attrib_free(&attrib);
-        tinyobj_shapes_free(shapes, num_shapes);
-        tinyobj_materials_free(materials, num_materials);
+        free_parse_results(&attrib, shapes, num_shapes, materials, num_materials);
         return -1;
     }
 
-    // Allocate mesh data
-    mesh->num_vertices = attrib.num_vertices;
-    mesh->num_indices = attrib.num_faces * 3; // Assuming triangles
+    // attrib.faces holds one vertex-index tuple per triangle corner
+    result = build_indexed_mesh(attrib.vertices, attrib.num_vertices,
+                                attrib.normals, attrib.num_normals,
+                                attrib.texcoords, attrib.num_texcoords,
+                                (const ObjCorner*)attrib.faces, attrib.num_faces, mesh);
 
-    mesh->vertices = (float*)malloc(sizeof(float) * 3 * mesh->num_vertices);
-    mesh->normals = (float*)malloc(sizeof(float) * 3 * mesh->num_vertices);
-    mesh->texcoords = (float*)malloc(sizeof(float) * 2 * mesh->num_vertices);
-    mesh->indices = (unsigned int*)malloc(sizeof(unsigned int) * mesh->num_indices);
+    // Cleanup
+    free_parse_results(&attrib, shapes, num_shapes, materials, num_materials);
+
+    return result;
+}
+
+int build_indexed_mesh(const float* positions, size_t num_positions,
+                       const float* normals, size_t num_normals,
+                       const float* texcoords, size_t num_texcoords,
+                       const ObjCorner* corners, size_t num_corners, Mesh* mesh) {
+    if (!mesh || !corners || num_corners == 0) return -1;
+
+    mesh->num_vertices = 0;
+    mesh->num_indices = num_corners;
+
+    // Worst case every corner is unique; arrays are shrunk once the real count is known
+    mesh->vertices = (float*)malloc(sizeof(float) * 3 * num_corners);
+    mesh->normals = (float*)malloc(sizeof(float) * 3 * num_corners);
+    mesh->texcoords = (float*)malloc(sizeof(float) * 2 * num_corners);
+    mesh->indices = (unsigned int*)malloc(sizeof(unsigned int) * num_corners);
+
+    size_t table_capacity = 16;
+    while (table_capacity < num_corners * 2) table_capacity <<= 1;
+    VertexDedupSlot* table = (VertexDedupSlot*)calloc(table_capacity, sizeof(VertexDedupSlot));
 
-    if (!mesh->vertices || !mesh->normals || !mesh->texcoords || !mesh->indices) {
+    if (!mesh->vertices || !mesh->normals || !mesh->texcoords || !mesh->indices || !table) {
+        free(table);
         free_mesh(mesh);
-        tinyobj_attrib_free(&attrib);
-        tinyobj_shapes_free(shapes, num_shapes);
-        tinyobj_materials_free(materials, num_materials);
         return -1;
     }
 
-    // Copy vertices
-    memcpy(mesh->vertices, attrib.vertices, sizeof(float) * 3 * mesh->num_vertices);
-
-    // Copy normals if available
-    if (attrib.num_normals > 0) {
-        memcpy(mesh->normals, attrib.normals, sizeof(float) * 3 * mesh->num_vertices);
-    } else {
-        // Generate dummy normals (pointing up)
-        for (size_t i = 0; i < mesh->num_vertices; ++i) {
-            mesh->normals[i*3 + 0] = 0.0f;
-            mesh->normals[i*3 + 1] = 1.0f;
-            mesh->normals[i*3 + 2] = 0.0f;
+    for (size_t i = 0; i < num_corners; ++i) {
+        ObjCorner idx = corners[i];
+        if (idx.v < 0 || (size_t)idx.v >= num_positions) {
+            printf("OBJ face references invalid position index %d\n", idx.v);
+            free(table);
+            free_mesh(mesh);
+            return -1;
+        }
+        // Treat out-of-range optional attributes as missing rather than failing the load
+        if (idx.vn >= 0 && (size_t)idx.vn >= num_normals) idx.vn = -1;
+        if (idx.vt >= 0 && (size_t)idx.vt >= num_texcoords) idx.vt = -1;
+
+        size_t slot = hash_vertex_index(idx) & (table_capacity - 1);
+        while (table[slot].used &&
+               (table[slot].key.v != idx.v ||
+                table[slot].key.vt != idx.vt ||
+                table[slot].key.vn != idx.vn)) {
+            slot = (slot + 1) & (table_capacity - 1);
         }
-    }
 
-    // Copy texcoords if available
-    if (attrib.num_texcoords > 0) {
-        memcpy(mesh->texcoords, attrib.texcoords, sizeof(float) * 2 * mesh->num_vertices);
-    } else {
-        // Generate dummy texcoords
-        memset(mesh->texcoords, 0, sizeof(float) * 2 * mesh->num_vertices);
-    }
+        if (!table[slot].used) {
+            unsigned int v = (unsigned int)mesh->num_vertices++;
+            table[slot].used = 1;
+            table[slot].key = idx;
+            table[slot].value = v;
+
+            memcpy(&mesh->vertices[v * 3], &positions[(size_t)idx.v * 3], sizeof(float) * 3);
+
+            if (idx.vn >= 0) {
+                memcpy(&mesh->normals[v * 3], &normals[(size_t)idx.vn * 3], sizeof(float) * 3);
+            } else {
+                // Dummy normal (pointing up)
+                mesh->normals[v * 3 + 0] = 0.0f;
+                mesh->normals[v * 3 + 1] = 1.0f;
+                mesh->normals[v * 3 + 2] = 0.0f;
+            }
+
+            if (idx.vt >= 0) {
+                memcpy(&mesh->texcoords[v * 2], &texcoords[(size_t)idx.vt * 2], sizeof(float) * 2);
+            } else {
+                mesh->texcoords[v * 2 + 0] = 0.0f;
+                mesh->texcoords[v * 2 + 1] = 0.0f;
+            }
+        }
 
-    // Copy indices
-    for (size_t i = 0; i < attrib.num_faces; ++i) {
-        tinyobj_vertex_index_t idx = attrib.faces[i];
-        mesh->indices[i] = (unsigned int)idx.v_idx;
+        mesh->indices[i] = table[slot].value;
     }
 
-    // Cleanup
-    tinyobj_attrib_free(&attrib);
-    tinyobj_shapes_free(shapes, num_shapes);
-    tinyobj_materials_free(materials, num_materials);
+    free(table);
+
+    // Give back the worst-case reservation; a failed shrink keeps the larger block
+    float* shrunk = (float*)realloc(mesh->vertices, sizeof(float) * 3 * mesh->num_vertices);
+    if (shrunk) mesh->vertices = shrunk;
+    shrunk = (float*)realloc(mesh->normals, sizeof(float) * 3 * mesh->num_vertices);
+    if (shrunk) mesh->normals = shrunk;
+    shrunk = (float*)realloc(mesh->texcoords, sizeof(float) * 2 * mesh->num_vertices);
+    if (shrunk) mesh->texcoords = shrunk;
+
+    printf("OBJ loaded: %zu corners -> %zu unique vertices\n", num_corners, mesh->num_vertices);
+    compute_mesh_bounds(mesh);
 
     return 0;
 }
 
+void compute_mesh_bounds(Mesh* mesh) {
+    if (!mesh) return;
+    if (mesh->num_vertices == 0) {
+        memset(mesh->bounds_min, 0, sizeof(mesh->bounds_min));
+        memset(mesh->bounds_max, 0, sizeof(mesh->bounds_max));
+        memset(mesh->bounds_center, 0, sizeof(mesh->bounds_center));
+        mesh->bounds_radius = 0.0f;
+        return;
+    }
+
+    for (int axis = 0; axis < 3; ++axis) {
+        mesh->bounds_min[axis] = mesh->bounds_max[axis] = mesh->vertices[axis];
+    }
+    for (size_t v = 1; v < mesh->num_vertices; ++v) {
+        for (int axis = 0; axis < 3; ++axis) {
+            float p = mesh->vertices[v * 3 + axis];
+            if (p < mesh->bounds_min[axis]) mesh->bounds_min[axis] = p;
+            if (p > mesh->bounds_max[axis]) mesh->bounds_max[axis] = p;
+        }
+    }
+
+    // Radius to the farthest vertex, which is tighter than the half diagonal
+    float radius_sq = 0.0f;
+    for (int axis = 0; axis < 3; ++axis) {
+        mesh->bounds_center[axis] = (mesh->bounds_min[axis] + mesh->bounds_max[axis]) * 0.5f;
+    }
+    for (size_t v = 0; v < mesh->num_vertices; ++v) {
+        float dx = mesh->vertices[v * 3 + 0] - mesh->bounds_center[0];
+        float dy = mesh->vertices[v * 3 + 1] - mesh->bounds_center[1];
+        float dz = mesh->vertices[v * 3 + 2] - mesh->bounds_center[2];
+        float d_sq = dx * dx + dy * dy + dz * dz;
+        if (d_sq > radius_sq) radius_sq = d_sq;
+    }
+    mesh->bounds_radius = sqrtf(radius_sq);
+}
+
 void free_mesh(Mesh* mesh) {
     if (!mesh) return;
 
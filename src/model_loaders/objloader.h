@@ -3,20 +3,44 @@
 
 #include <stddef.h>
 
-// Simple mesh structure
+// Simple indexed mesh structure
+// Attribute arrays are parallel: one entry per unique (position, normal, texcoord) tuple
 typedef struct {
     float* vertices;    // x,y,z for each vertex
     float* normals;     // nx,ny,nz for each vertex
     float* texcoords;   // u,v for each vertex
-    unsigned int* indices; // triangle indices
+    unsigned int* indices; // triangle indices into the attribute arrays
     size_t num_vertices;
     size_t num_indices;
+    float bounds_min[3];    // Axis-aligned bounds of the positions
+    float bounds_max[3];
+    float bounds_center[3]; // Bounding sphere around the AABB center
+    float bounds_radius;
 } Mesh;
 
-// Load OBJ file
+// One triangle corner of a parsed OBJ: 0-based attribute indices, -1 when the attribute is missing
+typedef struct {
+    int v;
+    int vt;
+    int vn;
+} ObjCorner;
+
+// Load OBJ file with tinyobj, deduplicating identical face corners into shared vertices
+// More lenient than load_obj_parallel, so it is the fallback when that rejects a file
 // Returns 0 on success, -1 on failure
 int load_obj(const char* filename, Mesh* mesh);
 
+// Build the indexed mesh from parsed attribute arrays, deduplicating identical corners
+// (both OBJ parsers finish with this); the inputs are not modified or kept
+// Returns 0 on success, -1 on an invalid position index or allocation failure
+int build_indexed_mesh(const float* positions, size_t num_positions,
+                       const float* normals, size_t num_normals,
+                       const float* texcoords, size_t num_texcoords,
+                       const ObjCorner* corners, size_t num_corners, Mesh* mesh);
+
+// Recompute the AABB and bounding sphere from the positions (load_obj calls this)
+void compute_mesh_bounds(Mesh* mesh);
+
 // Free mesh data
 void free_mesh(Mesh* mesh);
 
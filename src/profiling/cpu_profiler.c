@@ -0,0 +1,185 @@
+#include "cpu_profiler.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static atomic_bool profilerEnabled;
+static atomic_uint profilerEventsPerThread;
+static atomic_uint profilerNextThreadId;
+static _Atomic(CpuProfilerThread*) profilerThreads;
+static uint64_t profilerEpochNs;
+
+static _Thread_local CpuProfilerThread* localThread;
+
+static uint64_t nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Allocate the calling thread's buffer and publish it on the global list
+static CpuProfilerThread* registerThread(void) {
+    CpuProfilerThread* thread = calloc(1, sizeof(CpuProfilerThread));
+    if (!thread) return NULL;
+
+    thread->eventCapacity = atomic_load_explicit(&profilerEventsPerThread, memory_order_relaxed);
+    thread->events = malloc(sizeof(CpuProfilerEvent) * thread->eventCapacity);
+    if (!thread->events) {
+        free(thread);
+        return NULL;
+    }
+    thread->threadId = atomic_fetch_add_explicit(&profilerNextThreadId, 1, memory_order_relaxed) + 1;
+
+    CpuProfilerThread* head = atomic_load_explicit(&profilerThreads, memory_order_relaxed);
+    do {
+        thread->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(&profilerThreads, &head, thread,
+                                                    memory_order_release, memory_order_relaxed));
+
+    localThread = thread;
+    return thread;
+}
+
+static inline CpuProfilerThread* getThread(void) {
+    if (localThread) return localThread;
+    return registerThread();
+}
+
+void cpuProfilerInit(uint32_t eventsPerThread) {
+    atomic_store_explicit(&profilerEventsPerThread,
+                          eventsPerThread ? eventsPerThread : CPU_PROFILER_DEFAULT_EVENTS,
+                          memory_order_relaxed);
+    profilerEpochNs = nowNs();
+    atomic_store_explicit(&profilerEnabled, true, memory_order_release);
+}
+
+bool cpuProfilerEnabled(void) {
+    return atomic_load_explicit(&profilerEnabled, memory_order_relaxed);
+}
+
+void cpuProfilerSetThreadName(const char* name) {
+    if (!cpuProfilerEnabled()) return;
+
+    CpuProfilerThread* thread = getThread();
+    if (thread) thread->threadName = name;
+}
+
+void cpuZoneBegin(const char* name) {
+    if (!atomic_load_explicit(&profilerEnabled, memory_order_relaxed)) return;
+
+    CpuProfilerThread* thread = getThread();
+    if (!thread) return;
+
+    // Zones deeper than the stack are counted so End stays balanced, but not timed
+    if (thread->depth < CPU_PROFILER_MAX_DEPTH) {
+        thread->openNames[thread->depth] = name;
+        thread->openStarts[thread->depth] = nowNs();
+    }
+    thread->depth++;
+}
+
+void cpuZoneEnd(void) {
+    if (!atomic_load_explicit(&profilerEnabled, memory_order_relaxed)) return;
+
+    CpuProfilerThread* thread = localThread;
+    if (!thread || thread->depth == 0) return;
+
+    uint64_t end = nowNs();
+    thread->depth--;
+    if (thread->depth >= CPU_PROFILER_MAX_DEPTH) return;
+
+    if (thread->eventCount == thread->eventCapacity) {
+        thread->droppedCount++;
+        return;
+    }
+
+    CpuProfilerEvent* event = &thread->events[thread->eventCount++];
+    event->name = thread->openNames[thread->depth];
+    event->startNs = thread->openStarts[thread->depth];
+    event->durationNs = end - event->startNs;
+}
+
+static void writeJsonString(FILE* file, const char* text) {
+    fputc('"', file);
+    for (const char* c = text; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            fputc('\\', file);
+            fputc(*c, file);
+        } else if ((unsigned char)*c < 0x20) {
+            fprintf(file, "\\u%04x", (unsigned char)*c);
+        } else {
+            fputc(*c, file);
+        }
+    }
+    fputc('"', file);
+}
+
+int cpuProfilerWriteChromeTrace(const char* path) {
+    if (!path) return -1;
+
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        printf("Failed to open trace file: %s\n", path);
+        return -1;
+    }
+
+    uint64_t totalEvents = 0;
+    uint32_t totalDropped = 0;
+    bool first = true;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (CpuProfilerThread* thread = atomic_load_explicit(&profilerThreads, memory_order_acquire);
+         thread; thread = thread->next) {
+        // Thread name metadata so the viewer labels each track
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                first ? "" : ",\n", thread->threadId);
+        if (thread->threadName) {
+            writeJsonString(file, thread->threadName);
+        } else {
+            fprintf(file, "\"thread %u\"", thread->threadId);
+        }
+        fprintf(file, "}}");
+        first = false;
+
+        for (uint32_t i = 0; i < thread->eventCount; i++) {
+            const CpuProfilerEvent* event = &thread->events[i];
+            fprintf(file, ",\n{\"name\":");
+            writeJsonString(file, event->name);
+            fprintf(file, ",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    thread->threadId,
+                    (double)(event->startNs - profilerEpochNs) / 1000.0,
+                    (double)event->durationNs / 1000.0);
+        }
+        totalEvents += thread->eventCount;
+        totalDropped += thread->droppedCount;
+    }
+    fprintf(file, "\n]}\n");
+
+    if (fclose(file) != 0) {
+        printf("Failed to write trace file: %s\n", path);
+        return -1;
+    }
+
+    printf("CPU trace: %llu zones written to %s", (unsigned long long)totalEvents, path);
+    if (totalDropped > 0) {
+        printf(" (%u dropped, buffers full)", totalDropped);
+    }
+    printf("\n");
+    return 0;
+}
+
+void cpuProfilerShutdown(void) {
+    atomic_store_explicit(&profilerEnabled, false, memory_order_release);
+
+    CpuProfilerThread* thread = atomic_exchange_explicit(&profilerThreads, NULL, memory_order_acq_rel);
+    while (thread) {
+        CpuProfilerThread* next = thread->next;
+        free(thread->events);
+        free(thread);
+        thread = next;
+    }
+    // Only the calling thread's cached pointer can be cleared here; others have exited
+    localThread = NULL;
+}
@@ -0,0 +1,90 @@
+#ifndef CPU_PROFILER_H
+#define CPU_PROFILER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Completed zones recorded per thread before new ones are dropped
+#define CPU_PROFILER_DEFAULT_EVENTS (1u << 18)
+
+// Maximum nesting depth of open zones on one thread
+#define CPU_PROFILER_MAX_DEPTH 32
+
+/**
+ * One completed zone
+ */
+typedef struct {
+    const char* name;
+    uint64_t startNs;
+    uint64_t durationNs;
+} CpuProfilerEvent;
+
+/**
+ * Per-thread event buffer
+ * Only the owning thread writes to it; buffers are linked into a global list
+ * with an atomic push, so recording never takes a lock.
+ */
+typedef struct CpuProfilerThread {
+    struct CpuProfilerThread* next;
+    uint32_t threadId;
+    const char* threadName;
+
+    CpuProfilerEvent* events;
+    uint32_t eventCapacity;
+    uint32_t eventCount;
+    uint32_t droppedCount;
+
+    const char* openNames[CPU_PROFILER_MAX_DEPTH];
+    uint64_t openStarts[CPU_PROFILER_MAX_DEPTH];
+    uint32_t depth;
+} CpuProfilerThread;
+
+/**
+ * Enable recording
+ *
+ * @param eventsPerThread - Buffer capacity per thread (0 selects CPU_PROFILER_DEFAULT_EVENTS)
+ */
+void cpuProfilerInit(uint32_t eventsPerThread);
+
+/**
+ * Whether zones are currently recorded
+ *
+ * @return true after cpuProfilerInit and before cpuProfilerShutdown
+ */
+bool cpuProfilerEnabled(void);
+
+/**
+ * Name the calling thread in the trace
+ *
+ * @param name - Thread name (string literal)
+ */
+void cpuProfilerSetThreadName(const char* name);
+
+/**
+ * Open a zone on the calling thread (zones nest)
+ *
+ * @param name - Zone name (string literal, stored by pointer)
+ */
+void cpuZoneBegin(const char* name);
+
+/**
+ * Close the innermost open zone on the calling thread
+ */
+void cpuZoneEnd(void);
+
+/**
+ * Write every recorded zone as Chrome trace-event JSON (chrome://tracing, Perfetto)
+ * Call while no other thread is recording.
+ *
+ * @param path - Output file path
+ * @return 0 on success, -1 on failure
+ */
+int cpuProfilerWriteChromeTrace(const char* path);
+
+/**
+ * Stop recording and free every thread buffer
+ * Call after all instrumented threads have stopped.
+ */
+void cpuProfilerShutdown(void);
+
+#endif // CPU_PROFILER_H
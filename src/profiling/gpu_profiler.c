@@ -0,0 +1,233 @@
+#include "gpu_profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GPU_PROFILER_QUERY_COUNT (GPU_PROFILER_MAX_SCOPES * 2)
+
+VkResult createGpuProfiler(
+    VkDevice device,
+    VkPhysicalDevice physicalDevice,
+    uint32_t queueFamilyIndex,
+    uint32_t slotCount,
+    GpuProfiler* outProfiler
+) {
+    if (!device || !physicalDevice || !outProfiler || slotCount == 0) {
+        printf("GPU profiler creation failed: Invalid parameters\n");
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    memset(outProfiler, 0, sizeof(GpuProfiler));
+    outProfiler->device = device;
+    outProfiler->slotCount = slotCount > MAX_FRAMES_IN_FLIGHT ? MAX_FRAMES_IN_FLIGHT : slotCount;
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(physicalDevice, &props);
+
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, NULL);
+    VkQueueFamilyProperties* families = malloc(sizeof(VkQueueFamilyProperties) * queueFamilyCount);
+    if (!families) {
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, families);
+    uint32_t validBits = queueFamilyIndex < queueFamilyCount ? families[queueFamilyIndex].timestampValidBits : 0;
+    free(families);
+
+    if (validBits == 0 || props.limits.timestampPeriod <= 0.0f) {
+        printf("  GPU profiler: timestamps not supported on this queue, profiling disabled\n");
+        return VK_SUCCESS;
+    }
+
+    outProfiler->supported = true;
+    outProfiler->timestampPeriod = props.limits.timestampPeriod;
+    outProfiler->timestampMask = validBits >= 64 ? UINT64_MAX : ((1ull << validBits) - 1);
+
+    VkQueryPoolCreateInfo poolInfo = {0};
+    poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    poolInfo.queryCount = GPU_PROFILER_QUERY_COUNT;
+
+    for (uint32_t i = 0; i < outProfiler->slotCount; i++) {
+        VkResult result = vkCreateQueryPool(device, &poolInfo, NULL, &outProfiler->slots[i].queryPool);
+        if (result != VK_SUCCESS) {
+            printf("  Failed to create timestamp query pool! Error: %d\n", result);
+            destroyGpuProfiler(outProfiler);
+            return result;
+        }
+    }
+
+    printf("  GPU profiler: %u query pools, %u-bit timestamps, %.2f ns/tick\n",
+           outProfiler->slotCount, validBits, outProfiler->timestampPeriod);
+    return VK_SUCCESS;
+}
+
+static uint32_t findOrAddScope(GpuProfiler* profiler, const char* name) {
+    for (uint32_t i = 0; i < profiler->scopeCount; i++) {
+        if (profiler->scopes[i].name == name || strcmp(profiler->scopes[i].name, name) == 0) {
+            return i;
+        }
+    }
+    if (profiler->scopeCount == GPU_PROFILER_MAX_SCOPES) {
+        return UINT32_MAX;
+    }
+    profiler->scopes[profiler->scopeCount].name = name;
+    return profiler->scopeCount++;
+}
+
+static void pushScopeSample(GpuProfilerScope* scope, float milliseconds) {
+    scope->history[scope->historyHead] = milliseconds;
+    scope->historyHead = (scope->historyHead + 1) % GPU_PROFILER_HISTORY;
+    if (scope->historyCount < GPU_PROFILER_HISTORY) {
+        scope->historyCount++;
+    }
+}
+
+// Read back the slot's last frame; its fence has signaled so this does not wait
+static void collectSlotResults(GpuProfiler* profiler, GpuProfilerSlot* slot) {
+    if (!slot->pending || slot->pairCount == 0) {
+        slot->pending = false;
+        return;
+    }
+    slot->pending = false;
+
+    uint64_t timestamps[GPU_PROFILER_QUERY_COUNT];
+    VkResult result = vkGetQueryPoolResults(
+        profiler->device,
+        slot->queryPool,
+        0,
+        slot->pairCount * 2,
+        sizeof(timestamps),
+        timestamps,
+        sizeof(uint64_t),
+        VK_QUERY_RESULT_64_BIT
+    );
+    if (result != VK_SUCCESS) {
+        // VK_NOT_READY: drop the frame rather than stall
+        return;
+    }
+
+    for (uint32_t i = 0; i < slot->pairCount; i++) {
+        uint64_t ticks = (timestamps[i * 2 + 1] - timestamps[i * 2]) & profiler->timestampMask;
+        float milliseconds = (float)((double)ticks * profiler->timestampPeriod / 1000000.0);
+        pushScopeSample(&profiler->scopes[slot->pairScopes[i]], milliseconds);
+    }
+}
+
+void beginGpuProfilerFrame(
+    GpuProfiler* profiler,
+    VkCommandBuffer commandBuffer,
+    uint32_t slotIndex
+) {
+    if (!profiler || !profiler->supported || slotIndex >= profiler->slotCount) return;
+
+    GpuProfilerSlot* slot = &profiler->slots[slotIndex];
+    collectSlotResults(profiler, slot);
+
+    vkCmdResetQueryPool(commandBuffer, slot->queryPool, 0, GPU_PROFILER_QUERY_COUNT);
+    slot->pairCount = 0;
+    slot->pending = true;
+    profiler->recording = slot;
+}
+
+uint32_t beginGpuScope(
+    GpuProfiler* profiler,
+    VkCommandBuffer commandBuffer,
+    const char* name
+) {
+    if (!profiler || !profiler->recording) return UINT32_MAX;
+
+    GpuProfilerSlot* slot = profiler->recording;
+    if (slot->pairCount == GPU_PROFILER_MAX_SCOPES) return UINT32_MAX;
+
+    uint32_t scopeIndex = findOrAddScope(profiler, name);
+    if (scopeIndex == UINT32_MAX) return UINT32_MAX;
+
+    uint32_t pair = slot->pairCount++;
+    slot->pairScopes[pair] = scopeIndex;
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, slot->queryPool, pair * 2);
+    return pair;
+}
+
+void endGpuScope(
+    GpuProfiler* profiler,
+    VkCommandBuffer commandBuffer,
+    uint32_t token
+) {
+    if (!profiler || !profiler->recording || token >= profiler->recording->pairCount) return;
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                        profiler->recording->queryPool, token * 2 + 1);
+}
+
+static int compareFloat(const void* a, const void* b) {
+    float fa = *(const float*)a;
+    float fb = *(const float*)b;
+    return (fa > fb) - (fa < fb);
+}
+
+static void computeScopeTiming(const GpuProfilerScope* scope, GpuScopeTiming* outTiming) {
+    memset(outTiming, 0, sizeof(GpuScopeTiming));
+    if (scope->historyCount == 0) return;
+
+    float sorted[GPU_PROFILER_HISTORY];
+    double sum = 0.0;
+    for (uint32_t i = 0; i < scope->historyCount; i++) {
+        sorted[i] = scope->history[i];
+        sum += scope->history[i];
+    }
+    qsort(sorted, scope->historyCount, sizeof(float), compareFloat);
+
+    uint32_t p99Index = (scope->historyCount * 99 + 99) / 100 - 1;
+    outTiming->lastMs = scope->history[(scope->historyHead + GPU_PROFILER_HISTORY - 1) % GPU_PROFILER_HISTORY];
+    outTiming->minMs = sorted[0];
+    outTiming->avgMs = (float)(sum / scope->historyCount);
+    outTiming->p99Ms = sorted[p99Index];
+    outTiming->samples = scope->historyCount;
+}
+
+bool getGpuScopeTiming(
+    const GpuProfiler* profiler,
+    const char* name,
+    GpuScopeTiming* outTiming
+) {
+    if (!profiler || !name || !outTiming) return false;
+
+    for (uint32_t i = 0; i < profiler->scopeCount; i++) {
+        if (strcmp(profiler->scopes[i].name, name) == 0) {
+            computeScopeTiming(&profiler->scopes[i], outTiming);
+            return outTiming->samples > 0;
+        }
+    }
+    memset(outTiming, 0, sizeof(GpuScopeTiming));
+    return false;
+}
+
+void printGpuProfilerStats(const GpuProfiler* profiler) {
+    if (!profiler) return;
+
+    printf("\nGPU Profiler (last %u frames):\n", GPU_PROFILER_HISTORY);
+    if (!profiler->supported) {
+        printf("  Timestamps not supported\n");
+        return;
+    }
+    for (uint32_t i = 0; i < profiler->scopeCount; i++) {
+        GpuScopeTiming timing;
+        computeScopeTiming(&profiler->scopes[i], &timing);
+        printf("  %-16s min %7.3f ms  avg %7.3f ms  p99 %7.3f ms  (%u samples)\n",
+               profiler->scopes[i].name, timing.minMs, timing.avgMs, timing.p99Ms, timing.samples);
+    }
+}
+
+void destroyGpuProfiler(GpuProfiler* profiler) {
+    if (!profiler || !profiler->device) return;
+
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        if (profiler->slots[i].queryPool != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(profiler->device, profiler->slots[i].queryPool, NULL);
+            profiler->slots[i].queryPool = VK_NULL_HANDLE;
+        }
+    }
+    profiler->recording = NULL;
+    profiler->supported = false;
+}
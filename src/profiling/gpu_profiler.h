@@ -0,0 +1,151 @@
+#ifndef GPU_PROFILER_H
+#define GPU_PROFILER_H
+
+#include <vulkan/vulkan.h>
+#include <stdbool.h>
+#include "../common.h"
+
+// Distinct scope names and begin/end pairs per frame
+#define GPU_PROFILER_MAX_SCOPES 16
+
+// Frames of history kept per scope for the rolling statistics
+#define GPU_PROFILER_HISTORY 256
+
+/**
+ * Rolling GPU time history of one named scope
+ */
+typedef struct {
+    const char* name;
+    float history[GPU_PROFILER_HISTORY];   // Milliseconds, ring buffer
+    uint32_t historyHead;                  // Next entry to overwrite
+    uint32_t historyCount;                 // Valid entries (<= GPU_PROFILER_HISTORY)
+} GpuProfilerScope;
+
+/**
+ * Summary of a scope over the history window
+ */
+typedef struct {
+    float lastMs;
+    float minMs;
+    float avgMs;
+    float p99Ms;
+    uint32_t samples;
+} GpuScopeTiming;
+
+/**
+ * Queries written by one frame slot
+ * Each frame slot owns its own pool so results are read back only after the
+ * slot's fence has been waited on, never stalling on the GPU.
+ */
+typedef struct {
+    VkQueryPool queryPool;
+    uint32_t pairScopes[GPU_PROFILER_MAX_SCOPES];  // Scope index of each begin/end query pair
+    uint32_t pairCount;                            // Pairs written in the last recording
+    bool pending;                                  // Results not read back yet
+} GpuProfilerSlot;
+
+/**
+ * Timestamp query profiler
+ */
+typedef struct {
+    VkDevice device;
+    bool supported;                 // Graphics queue writes timestamps
+    double timestampPeriod;         // Nanoseconds per timestamp tick
+    uint64_t timestampMask;         // Valid bits of a timestamp value
+
+    GpuProfilerSlot slots[MAX_FRAMES_IN_FLIGHT];
+    uint32_t slotCount;
+    GpuProfilerSlot* recording;     // Slot being recorded this frame, NULL outside a frame
+
+    GpuProfilerScope scopes[GPU_PROFILER_MAX_SCOPES];
+    uint32_t scopeCount;
+} GpuProfiler;
+
+/**
+ * Create one timestamp query pool per frame slot
+ *
+ * @param device - VkDevice handle
+ * @param physicalDevice - VkPhysicalDevice for timestampPeriod and timestamp support
+ * @param queueFamilyIndex - Queue family the profiled command buffers are submitted to
+ * @param slotCount - Number of frame slots (clamped to MAX_FRAMES_IN_FLIGHT)
+ * @param outProfiler - Output profiler (disabled, not an error, if timestamps are unsupported)
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult createGpuProfiler(
+    VkDevice device,
+    VkPhysicalDevice physicalDevice,
+    uint32_t queueFamilyIndex,
+    uint32_t slotCount,
+    GpuProfiler* outProfiler
+);
+
+/**
+ * Collect the slot's previous results and reset its queries
+ * Call after the slot's fence was waited on, outside a render pass.
+ *
+ * @param profiler - Profiler
+ * @param commandBuffer - Command buffer being recorded for the slot
+ * @param slotIndex - Frame slot index
+ */
+void beginGpuProfilerFrame(
+    GpuProfiler* profiler,
+    VkCommandBuffer commandBuffer,
+    uint32_t slotIndex
+);
+
+/**
+ * Write the start timestamp of a named scope (scopes may nest)
+ *
+ * @param profiler - Profiler
+ * @param commandBuffer - Command buffer being recorded
+ * @param name - Scope name (string literal; identifies the scope across frames)
+ * @return Token to pass to endGpuScope, UINT32_MAX if the scope was not recorded
+ */
+uint32_t beginGpuScope(
+    GpuProfiler* profiler,
+    VkCommandBuffer commandBuffer,
+    const char* name
+);
+
+/**
+ * Write the end timestamp of a scope
+ *
+ * @param profiler - Profiler
+ * @param commandBuffer - Command buffer being recorded
+ * @param token - Value returned by beginGpuScope
+ */
+void endGpuScope(
+    GpuProfiler* profiler,
+    VkCommandBuffer commandBuffer,
+    uint32_t token
+);
+
+/**
+ * Get rolling statistics of a scope
+ *
+ * @param profiler - Profiler
+ * @param name - Scope name
+ * @param outTiming - Output statistics
+ * @return true if the scope has samples
+ */
+bool getGpuScopeTiming(
+    const GpuProfiler* profiler,
+    const char* name,
+    GpuScopeTiming* outTiming
+);
+
+/**
+ * Print min/avg/p99 of every scope
+ *
+ * @param profiler - Profiler
+ */
+void printGpuProfilerStats(const GpuProfiler* profiler);
+
+/**
+ * Destroy the query pools
+ *
+ * @param profiler - Profiler to destroy
+ */
+void destroyGpuProfiler(GpuProfiler* profiler);
+
+#endif // GPU_PROFILER_H
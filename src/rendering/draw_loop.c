@@ -1,35 +1,120 @@
 #include "draw_loop.h"
+#include "../profiling/cpu_profiler.h"
 #include <stdio.h>
+#include <string.h>
 
-void draw_frame(ApplicationContext* app) {
-    // Wait for previous frame to finish
-    vkWaitForFences(app->logicalDevice.device, 1, &app->frameSync.inFlightFence, VK_TRUE, UINT64_MAX);
-    vkResetFences(app->logicalDevice.device, 1, &app->frameSync.inFlightFence);
+// Offsets of this frame's sub-allocations in the per-slot rings
+typedef struct {
+    uint32_t uniformOffset;
+    VkDeviceSize instanceOffset;
+} FrameOffsets;
 
-    // Acquire next swapchain image
-    uint32_t imageIndex;
-    VkResult result = vkAcquireNextImageKHR(app->logicalDevice.device, app->swapchain.swapchain, UINT64_MAX, app->frameSync.imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
-    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
-        // Recreate swapchain on resize (reuse toggle_vsync logic)
-        toggle_vsync(app, app->vsyncEnabled);
-        return;
-    } else if (result != VK_SUCCESS) {
-        printf("Failed to acquire swapchain image!\n");
-        app->running = false;
-        return;
+// Copy this frame's uniforms and instances into the slot's ring slices; the slot's fence must have signaled
+static VkResult uploadFrameUniforms(ApplicationContext* app, FrameOffsets* outOffsets) {
+    // The slot's ring slice is no longer read by the GPU, so its sub-allocations can be reused
+    cpuZoneBegin("uniform_upload");
+    beginBufferRingFrame(&app->uniformRing, app->frameSync.currentFrame);
+    outOffsets->uniformOffset = 0;
+    outOffsets->instanceOffset = 0;
+    VkResult result = updateUniformBuffer(&app->uniformRing, &app->frameUniforms, &outOffsets->uniformOffset);
+    if (result == VK_SUCCESS && app->gpuCulling) {
+        result = beginGpuCullFrame(&app->gpuCuller, app->frameSync.currentFrame);
+    } else if (result == VK_SUCCESS && app->instanceCount > 0) {
+        beginInstanceBufferFrame(&app->instanceBuffer, app->frameSync.currentFrame);
+        result = writeVisibleInstances(&app->instanceBuffer, app->instances, app->instanceVisible, app->instanceCount,
+                                       app->visibleInstanceCount, &outOffsets->instanceOffset);
     }
+    cpuZoneEnd();
+    return result;
+}
+
+// Shared by the jobs recording the scene's draw list, one chunk each
+typedef struct {
+    ApplicationContext* app;
+    uint32_t uniformOffset;
+    SceneDrawStats chunkStats[PARALLEL_RECORD_MAX_CHUNKS];
+} SceneChunkContext;
+
+// Set the viewport and scissor to the whole render area
+static void setFullViewport(const ApplicationContext* app, VkCommandBuffer cmdBuffer) {
+    VkViewport viewport = {0.0f, 0.0f, (float)app->swapchain.extent.width, (float)app->swapchain.extent.height, 0.0f, 1.0f};
+    vkCmdSetViewport(cmdBuffer, 0, 1, &viewport);
+    VkRect2D scissor = {{0, 0}, app->swapchain.extent};
+    vkCmdSetScissor(cmdBuffer, 0, 1, &scissor);
+}
+
+// Runs as a job: an even share of the sorted draw list into one secondary
+static void recordSceneChunk(void* context, VkCommandBuffer cmdBuffer, uint32_t chunkIndex, uint32_t chunkCount) {
+    SceneChunkContext* chunks = context;
+    ApplicationContext* app = chunks->app;
+
+    // Secondaries inherit no dynamic state or bindings from the primary
+    setFullViewport(app, cmdBuffer);
+    vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                            app->pipelineLayouts.pipelineLayout, 0, 1, &app->descriptorSet, 1, &chunks->uniformOffset);
+
+    uint32_t objectCount = app->scene.objectCount;
+    uint32_t first = (uint32_t)((uint64_t)objectCount * chunkIndex / chunkCount);
+    uint32_t end = (uint32_t)((uint64_t)objectCount * (chunkIndex + 1) / chunkCount);
+    recordSceneDrawRange(&app->scene, cmdBuffer, first, end - first, &app->graphicsPipeline.pipeline, 1,
+                         app->pipelineLayouts.pipelineLayout, &chunks->chunkStats[chunkIndex]);
+}
+
+// Record the scene's draws as jobs and execute them from the primary
+static VkResult recordParallelSceneDraws(ApplicationContext* app, VkCommandBuffer cmdBuffer, uint32_t imageIndex,
+                                         const FrameOffsets* offsets) {
+    // Sorted here so the jobs only read the scene
+    if (app->scene.drawListDirty) {
+        VkResult sortResult = sortSceneDrawList(&app->scene);
+        if (sortResult != VK_SUCCESS) return sortResult;
+    }
+
+    SceneChunkContext chunks;
+    memset(&chunks, 0, sizeof(chunks));
+    chunks.app = app;
+    chunks.uniformOffset = offsets->uniformOffset;
 
-    // Record command buffer for this frame
-    VkCommandBuffer cmdBuffer = app->commandBuffers[imageIndex];
+    VkCommandBuffer secondaries[PARALLEL_RECORD_MAX_CHUNKS];
+    cpuZoneBegin("parallel_record");
+    VkResult result = recordSecondaryChunks(&app->parallelRecorder, app->frameSync.currentFrame, app->renderPass,
+                                            app->framebuffers[imageIndex], recordSceneChunk, &chunks, secondaries);
+    cpuZoneEnd();
+    if (result != VK_SUCCESS) return result;
+    vkCmdExecuteCommands(cmdBuffer, app->parallelRecorder.chunkCount, secondaries);
+
+    SceneDrawStats stats = {0};
+    for (uint32_t i = 0; i < app->parallelRecorder.chunkCount; i++) {
+        stats.draws += chunks.chunkStats[i].draws;
+        stats.culled += chunks.chunkStats[i].culled;
+        stats.pipelineBinds += chunks.chunkStats[i].pipelineBinds;
+        stats.meshBinds += chunks.chunkStats[i].meshBinds;
+    }
+    app->scene.lastStats = stats;
+    return VK_SUCCESS;
+}
+
+// Begin the slot's command buffer and record the scene render pass; the caller ends it
+static VkResult recordScenePass(ApplicationContext* app, VkCommandBuffer cmdBuffer, uint32_t imageIndex, const FrameOffsets* offsets) {
     vkResetCommandBuffer(cmdBuffer, 0);
     VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
     VkResult beginResult = vkBeginCommandBuffer(cmdBuffer, &beginInfo);
     if (beginResult != VK_SUCCESS) {
         printf("Failed to begin command buffer: %d\n", beginResult);
-        app->running = false;
-        return;
+        return beginResult;
     }
 
+    // Read back this slot's previous timings and reset its queries (outside the render pass)
+    beginGpuProfilerFrame(&app->gpuProfiler, cmdBuffer, app->frameSync.currentFrame);
+
+    // Culling runs before the render pass so the draws below can consume its commands
+    if (app->gpuCulling) {
+        uint32_t cullScope = beginGpuScope(&app->gpuProfiler, cmdBuffer, "gpu_cull");
+        const DepthPyramid* occluder = app->occlusionDisabled ? NULL : &app->depthPyramid;
+        recordGpuCull(&app->gpuCuller, cmdBuffer, &app->frustum, occluder);
+        endGpuScope(&app->gpuProfiler, cmdBuffer, cullScope);
+    }
+    uint32_t renderPassScope = beginGpuScope(&app->gpuProfiler, cmdBuffer, "render_pass");
+
     // Begin render pass
     VkRenderPassBeginInfo renderPassInfo = {VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
     renderPassInfo.renderPass = app->renderPass;
@@ -39,48 +124,132 @@ void draw_frame(ApplicationContext* app) {
     VkClearValue clearValues[2] = {{{0.0f, 0.0f, 0.0f, 1.0f}}, {1.0f, 0}}; // Black background + depth
     renderPassInfo.clearValueCount = 2; // With depth
     renderPassInfo.pClearValues = clearValues;
-    vkCmdBeginRenderPass(cmdBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 
-    // Bind pipeline and draw (hardcoded triangle, no vertex buffers)
-    vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, app->graphicsPipeline.pipeline);
+    // With parallel recording the pass holds only the chunks' secondaries
+    bool parallelScene = app->sceneObjectCount > 0 && app->recordChunkCount > 0;
+    vkCmdBeginRenderPass(cmdBuffer, &renderPassInfo,
+                         parallelScene ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
+    if (parallelScene) {
+        // Timestamps cannot be written between secondaries, so there is no "draw" scope here
+        VkResult recordResult = recordParallelSceneDraws(app, cmdBuffer, imageIndex, offsets);
+        if (recordResult != VK_SUCCESS) {
+            printf("Failed to record scene draws in parallel: %d\n", recordResult);
+        }
+    } else {
+        // Set dynamic viewport and scissor
+        setFullViewport(app, cmdBuffer);
 
-    // Set dynamic viewport and scissor
-    VkViewport viewport = {0.0f, 0.0f, (float)app->swapchain.extent.width, (float)app->swapchain.extent.height, 0.0f, 1.0f};
-    vkCmdSetViewport(cmdBuffer, 0, 1, &viewport);
-    VkRect2D scissor = {{0, 0}, app->swapchain.extent};
-    vkCmdSetScissor(cmdBuffer, 0, 1, &scissor);
+        // Bind descriptor set (stays bound across pipeline changes with the same layout)
+        vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                               app->pipelineLayouts.pipelineLayout, 0, 1, &app->descriptorSet, 1, &offsets->uniformOffset);
 
-    // Bind vertex buffer
-    VkBuffer vertexBuffers[] = {app->vertexBuffer.buffer};
-    VkDeviceSize offsets[] = {0};
-    vkCmdBindVertexBuffers(cmdBuffer, 0, 1, vertexBuffers, offsets);
+        uint32_t drawScope = beginGpuScope(&app->gpuProfiler, cmdBuffer, "draw");
+        if (app->sceneObjectCount > 0) {
+            // The scene binds pipelines and meshes itself, in sorted order
+            VkResult sceneResult = recordSceneDraws(&app->scene, cmdBuffer, &app->graphicsPipeline.pipeline, 1,
+                                                    app->pipelineLayouts.pipelineLayout);
+            if (sceneResult != VK_SUCCESS) {
+                printf("Failed to record scene draws: %d\n", sceneResult);
+            }
+        } else {
+            vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, app->graphicsPipeline.pipeline);
 
-    // Bind descriptor set
-    vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, 
-                           app->pipelineLayouts.pipelineLayout, 0, 1, &app->descriptorSet, 0, NULL);
+            // Bind vertex buffer
+            VkBuffer vertexBuffers[] = {app->vertexBuffer.buffer};
+            VkDeviceSize vertexOffsets[] = {0};
+            vkCmdBindVertexBuffers(cmdBuffer, 0, 1, vertexBuffers, vertexOffsets);
+            vkCmdBindIndexBuffer(cmdBuffer, app->indexBuffer.buffer, 0, app->indexType);
 
-    vkCmdDraw(cmdBuffer, app->vertexCount, 1, 0, 0); // Draw vertices
+            if (app->gpuCulling) {
+                cmdDrawGpuCulled(&app->gpuCuller, cmdBuffer);
+            } else if (app->instanceCount > 0) {
+                cmdDrawMeshInstanced(cmdBuffer, &app->instanceBuffer, offsets->instanceOffset, app->indexCount, app->visibleInstanceCount);
+            } else {
+                vkCmdDrawIndexed(cmdBuffer, app->indexCount, 1, 0, 0, 0); // Draw indexed triangles
+            }
+        }
+        endGpuScope(&app->gpuProfiler, cmdBuffer, drawScope);
+    }
 
     vkCmdEndRenderPass(cmdBuffer);
+    endGpuScope(&app->gpuProfiler, cmdBuffer, renderPassScope);
+
+    // This frame's depth becomes the occluder the next frame's cull tests against
+    if (app->gpuCulling && !app->occlusionDisabled) {
+        uint32_t pyramidScope = beginGpuScope(&app->gpuProfiler, cmdBuffer, "depth_pyramid");
+        recordDepthPyramidBuild(&app->depthPyramid, cmdBuffer, app->cullViewProj);
+        endGpuScope(&app->gpuProfiler, cmdBuffer, pyramidScope);
+    }
+    return VK_SUCCESS;
+}
+
+void draw_frame(ApplicationContext* app) {
+    FrameSlot* slot = getCurrentFrameSlot(&app->frameSync);
 
-    VkResult endResult = vkEndCommandBuffer(cmdBuffer);
+    // Wait until this slot's previous submission has retired; other slots keep the GPU busy meanwhile
+    cpuZoneBegin("fence_wait");
+    vkWaitForFences(app->logicalDevice.device, 1, &slot->inFlightFence, VK_TRUE, UINT64_MAX);
+    cpuZoneEnd();
+
+    // Acquire next swapchain image
+    uint32_t imageIndex;
+    cpuZoneBegin("acquire");
+    VkResult result = vkAcquireNextImageKHR(app->logicalDevice.device, app->swapchain.swapchain, UINT64_MAX, slot->imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
+    cpuZoneEnd();
+    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
+        // Recreate swapchain on resize (reuse toggle_vsync logic)
+        toggle_vsync(app, app->vsyncEnabled);
+        return;
+    } else if (result != VK_SUCCESS) {
+        printf("Failed to acquire swapchain image!\n");
+        app->running = false;
+        return;
+    }
+
+    // The image may still be in use by a different slot if the swapchain returns images out of order
+    if (app->frameSync.imagesInFlight[imageIndex] != VK_NULL_HANDLE) {
+        cpuZoneBegin("image_fence_wait");
+        vkWaitForFences(app->logicalDevice.device, 1, &app->frameSync.imagesInFlight[imageIndex], VK_TRUE, UINT64_MAX);
+        cpuZoneEnd();
+    }
+    app->frameSync.imagesInFlight[imageIndex] = slot->inFlightFence;
+
+    FrameOffsets offsets;
+    if (uploadFrameUniforms(app, &offsets) != VK_SUCCESS) {
+        app->running = false;
+        return;
+    }
+
+    // Record command buffer for this frame slot
+    cpuZoneBegin("record_commands");
+    VkCommandBuffer cmdBuffer = slot->commandBuffer;
+    VkResult recordResult = recordScenePass(app, cmdBuffer, imageIndex, &offsets);
+    VkResult endResult = recordResult == VK_SUCCESS ? vkEndCommandBuffer(cmdBuffer) : recordResult;
+    cpuZoneEnd();
     if (endResult != VK_SUCCESS) {
         printf("Failed to end command buffer: %d\n", endResult);
         app->running = false;
         return;
-    }    // Submit to queue
+    }
+
+    // Submit to queue
     VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
-    VkSemaphore waitSemaphores[] = {app->frameSync.imageAvailableSemaphore};
+    VkSemaphore waitSemaphores[] = {slot->imageAvailableSemaphore};
     VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
     submitInfo.waitSemaphoreCount = 1;
     submitInfo.pWaitSemaphores = waitSemaphores;
     submitInfo.pWaitDstStageMask = waitStages;
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &cmdBuffer;
-    VkSemaphore signalSemaphores[] = {app->frameSync.renderFinishedSemaphore};
+    // Per image: the slot's fence does not cover the previous present still waiting on it
+    VkSemaphore signalSemaphores[] = {app->frameSync.renderFinishedSemaphores[imageIndex]};
     submitInfo.signalSemaphoreCount = 1;
     submitInfo.pSignalSemaphores = signalSemaphores;
-    VkResult submitResult = vkQueueSubmit(app->logicalDevice.graphicsQueue, 1, &submitInfo, app->frameSync.inFlightFence);
+    // Only reset once we know work will be submitted, otherwise the next wait on this slot would deadlock
+    vkResetFences(app->logicalDevice.device, 1, &slot->inFlightFence);
+    cpuZoneBegin("submit");
+    VkResult submitResult = vkQueueSubmit(app->logicalDevice.graphicsQueue, 1, &submitInfo, slot->inFlightFence);
+    cpuZoneEnd();
     if (submitResult != VK_SUCCESS) {
         printf("Failed to submit queue: %d\n", submitResult);
         app->running = false;
@@ -95,10 +264,70 @@ void draw_frame(ApplicationContext* app) {
     presentInfo.swapchainCount = 1;
     presentInfo.pSwapchains = swapchains;
     presentInfo.pImageIndices = &imageIndex;
+    cpuZoneBegin("present");
     VkResult presentResult = vkQueuePresentKHR(app->logicalDevice.presentQueue, &presentInfo);
-    if (presentResult != VK_SUCCESS) {
+    cpuZoneEnd();
+    advanceFrameSlot(&app->frameSync);
+    if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR) {
+        // The window resize event recreates the swapchain; the frame was still submitted
+        return;
+    } else if (presentResult != VK_SUCCESS) {
         printf("Failed to present: %d\n", presentResult);
         app->running = false;
         return;
     }
-}
\ No newline at end of file
+}
+
+void draw_offscreen_frame(ApplicationContext* app, ReadbackRing* readback, FrameWriter* writer) {
+    uint32_t slotIndex = app->frameSync.currentFrame;
+    FrameSlot* slot = getCurrentFrameSlot(&app->frameSync);
+
+    // Each slot renders into its own offscreen image, so no acquire is needed
+    cpuZoneBegin("fence_wait");
+    vkWaitForFences(app->logicalDevice.device, 1, &slot->inFlightFence, VK_TRUE, UINT64_MAX);
+    cpuZoneEnd();
+
+    // The fence covers the copy too: the frame this slot rendered last time is now in host memory
+    cpuZoneBegin("readback");
+    VkResult readbackResult = collectReadback(readback, slotIndex, writer);
+    cpuZoneEnd();
+    if (readbackResult != VK_SUCCESS) {
+        app->running = false;
+        return;
+    }
+
+    FrameOffsets offsets;
+    if (uploadFrameUniforms(app, &offsets) != VK_SUCCESS) {
+        app->running = false;
+        return;
+    }
+
+    cpuZoneBegin("record_commands");
+    VkCommandBuffer cmdBuffer = slot->commandBuffer;
+    VkResult recordResult = recordScenePass(app, cmdBuffer, slotIndex, &offsets);
+    if (recordResult == VK_SUCCESS) {
+        recordReadbackCopy(readback, cmdBuffer, app->swapchain.images[slotIndex], slotIndex);
+    }
+    VkResult endResult = recordResult == VK_SUCCESS ? vkEndCommandBuffer(cmdBuffer) : recordResult;
+    cpuZoneEnd();
+    if (endResult != VK_SUCCESS) {
+        printf("Failed to end command buffer: %d\n", endResult);
+        app->running = false;
+        return;
+    }
+
+    VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &cmdBuffer;
+    vkResetFences(app->logicalDevice.device, 1, &slot->inFlightFence);
+    cpuZoneBegin("submit");
+    VkResult submitResult = vkQueueSubmit(app->logicalDevice.graphicsQueue, 1, &submitInfo, slot->inFlightFence);
+    cpuZoneEnd();
+    if (submitResult != VK_SUCCESS) {
+        printf("Failed to submit queue: %d\n", submitResult);
+        app->running = false;
+        return;
+    }
+
+    advanceFrameSlot(&app->frameSync);
+}
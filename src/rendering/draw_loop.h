@@ -2,7 +2,12 @@
 #define DRAW_LOOP_H
 
 #include "../application.h"
+#include "../headless/readback.h"
+#include "../headless/frame_writer.h"
 
 void draw_frame(ApplicationContext* app);
 
+// Headless: render into the slot's offscreen image and write out the frame it held before
+void draw_offscreen_frame(ApplicationContext* app, ReadbackRing* readback, FrameWriter* writer);
+
 #endif // DRAW_LOOP_H
\ No newline at end of file
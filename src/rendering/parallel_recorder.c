@@ -0,0 +1,141 @@
+#include "parallel_recorder.h"
+#include "../renderpass/commandbuffers/commandbuffers.h"
+#include "../profiling/cpu_profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Job: take a secondary from this thread's pool for the slot and record the chunk into it
+static void recordChunkJob(void* data) {
+    RecordChunk* chunk = data;
+    ParallelRecorder* recorder = chunk->recorder;
+    // Only this thread touches its pools while the call runs
+    RecordThreadPools* thread = &recorder->threads[getJobThreadIndex()];
+    VkCommandBuffer cmdBuffer = thread->secondaries[recorder->slot][thread->usedCount++];
+
+    cpuZoneBegin("record_chunk");
+    VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    beginInfo.pInheritanceInfo = &recorder->inheritance;
+    VkResult result = vkBeginCommandBuffer(cmdBuffer, &beginInfo);
+    if (result == VK_SUCCESS) {
+        recorder->function(recorder->context, cmdBuffer, chunk->index, recorder->chunkCount);
+        result = vkEndCommandBuffer(cmdBuffer);
+    }
+    cpuZoneEnd();
+
+    chunk->cmdBuffer = cmdBuffer;
+    chunk->result = result;
+}
+
+VkResult createParallelRecorder(
+    VkDevice device,
+    QueueFamilyIndices queueFamilyIndices,
+    JobSystem* jobs,
+    uint32_t chunkCount,
+    ParallelRecorder* outRecorder
+) {
+    if (!device || !jobs || jobs->threadCount == 0 || !outRecorder) {
+        printf("Parallel recorder creation failed: Invalid parameters\n");
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+    if (chunkCount == 0) chunkCount = 1;
+    if (chunkCount > PARALLEL_RECORD_MAX_CHUNKS) chunkCount = PARALLEL_RECORD_MAX_CHUNKS;
+
+    memset(outRecorder, 0, sizeof(ParallelRecorder));
+    outRecorder->device = device;
+    outRecorder->jobs = jobs;
+    outRecorder->chunkCount = chunkCount;
+    outRecorder->threads = calloc(jobs->threadCount, sizeof(RecordThreadPools));
+    if (!outRecorder->threads) {
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+    outRecorder->threadCount = jobs->threadCount;
+    printf("  Creating parallel recorder: %u chunks on %u job threads, %u command pools each\n",
+           chunkCount, jobs->threadCount, MAX_FRAMES_IN_FLIGHT);
+
+    VkResult result = VK_SUCCESS;
+    for (uint32_t i = 0; i < outRecorder->threadCount && result == VK_SUCCESS; i++) {
+        RecordThreadPools* thread = &outRecorder->threads[i];
+        for (uint32_t slot = 0; slot < MAX_FRAMES_IN_FLIGHT && result == VK_SUCCESS; slot++) {
+            result = createCommandPool(device, queueFamilyIndices, &thread->pools[slot]);
+            if (result == VK_SUCCESS) {
+                result = allocateSecondaryCommandBuffers(device, thread->pools[slot], chunkCount,
+                                                         thread->secondaries[slot]);
+            }
+        }
+    }
+    if (result != VK_SUCCESS) {
+        printf("    Failed to create parallel recorder! Error: %d\n", result);
+        destroyParallelRecorder(outRecorder);
+        return result;
+    }
+    return VK_SUCCESS;
+}
+
+VkResult recordSecondaryChunks(
+    ParallelRecorder* recorder,
+    uint32_t slot,
+    VkRenderPass renderPass,
+    VkFramebuffer framebuffer,
+    RecordChunkFunction function,
+    void* context,
+    VkCommandBuffer* outCommandBuffers
+) {
+    if (!recorder || !recorder->threads || slot >= MAX_FRAMES_IN_FLIGHT || !function || !outCommandBuffers) {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    // No job records between calls, so the pools can be reset from here
+    VkResult result = VK_SUCCESS;
+    for (uint32_t i = 0; i < recorder->threadCount; i++) {
+        VkResult resetResult = vkResetCommandPool(recorder->device, recorder->threads[i].pools[slot], 0);
+        if (result == VK_SUCCESS) result = resetResult;
+        recorder->threads[i].usedCount = 0;
+    }
+    if (result != VK_SUCCESS) return result;
+
+    recorder->slot = slot;
+    memset(&recorder->inheritance, 0, sizeof(recorder->inheritance));
+    recorder->inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    recorder->inheritance.renderPass = renderPass;
+    recorder->inheritance.subpass = 0;
+    recorder->inheritance.framebuffer = framebuffer;
+    recorder->function = function;
+    recorder->context = context;
+
+    JobDecl jobs[PARALLEL_RECORD_MAX_CHUNKS];
+    for (uint32_t i = 0; i < recorder->chunkCount; i++) {
+        RecordChunk* chunk = &recorder->chunks[i];
+        chunk->recorder = recorder;
+        chunk->index = i;
+        chunk->cmdBuffer = VK_NULL_HANDLE;
+        chunk->result = VK_SUCCESS;
+        jobs[i].function = recordChunkJob;
+        jobs[i].data = chunk;
+    }
+    JobCounter counter = {0};
+    runJobs(recorder->jobs, jobs, recorder->chunkCount, &counter);
+    waitForCounter(recorder->jobs, &counter);
+
+    for (uint32_t i = 0; i < recorder->chunkCount; i++) {
+        outCommandBuffers[i] = recorder->chunks[i].cmdBuffer;
+        if (result == VK_SUCCESS && recorder->chunks[i].result != VK_SUCCESS) {
+            result = recorder->chunks[i].result;
+        }
+    }
+    return result;
+}
+
+void destroyParallelRecorder(ParallelRecorder* recorder) {
+    if (!recorder || !recorder->device) return;
+
+    // Destroying a pool frees its command buffers
+    for (uint32_t i = 0; recorder->threads && i < recorder->threadCount; i++) {
+        for (uint32_t slot = 0; slot < MAX_FRAMES_IN_FLIGHT; slot++) {
+            destroyCommandPool(recorder->device, recorder->threads[i].pools[slot]);
+        }
+    }
+    free(recorder->threads);
+    memset(recorder, 0, sizeof(ParallelRecorder));
+}
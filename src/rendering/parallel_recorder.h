@@ -0,0 +1,118 @@
+#ifndef PARALLEL_RECORDER_H
+#define PARALLEL_RECORDER_H
+
+#include <vulkan/vulkan.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "../vulkan/vulkan_physical_device.h"
+#include "../jobs/job_system.h"
+#include "../common.h"
+
+// Upper bound on chunks one call records (one secondary command buffer each)
+#define PARALLEL_RECORD_MAX_CHUNKS 32
+
+/**
+ * Records one chunk into a secondary command buffer that continues the render pass
+ * Runs as a job on any job system thread; chunks of the same call run concurrently.
+ *
+ * @param context - Caller data passed to recordSecondaryChunks
+ * @param cmdBuffer - Secondary command buffer, already begun
+ * @param chunkIndex - This chunk (0..chunkCount-1)
+ * @param chunkCount - Number of chunks recorded by the call
+ */
+typedef void (*RecordChunkFunction)(void* context, VkCommandBuffer cmdBuffer, uint32_t chunkIndex, uint32_t chunkCount);
+
+struct ParallelRecorder;
+
+/**
+ * Command pools of one job thread
+ * Command pools are externally synchronized, so every job thread records from
+ * its own pool per frame slot. A thread may pick up several chunks of a call,
+ * so each pool holds one secondary per chunk.
+ */
+typedef struct {
+    VkCommandPool pools[MAX_FRAMES_IN_FLIGHT];
+    VkCommandBuffer secondaries[MAX_FRAMES_IN_FLIGHT][PARALLEL_RECORD_MAX_CHUNKS];
+    uint32_t usedCount;               // Secondaries taken from the current slot's pool in this call
+} RecordThreadPools;
+
+/**
+ * One chunk of the current call, the data of its job
+ */
+typedef struct {
+    struct ParallelRecorder* recorder;
+    uint32_t index;
+    VkCommandBuffer cmdBuffer;        // Secondary it was recorded into
+    VkResult result;
+} RecordChunk;
+
+/**
+ * Records secondary command buffers in parallel on the job system
+ * The caller submits one job per chunk and waits for them (running chunks
+ * itself meanwhile), then executes the secondaries from its primary command buffer.
+ */
+typedef struct ParallelRecorder {
+    VkDevice device;
+    JobSystem* jobs;
+    RecordThreadPools* threads;       // One per job system thread
+    uint32_t threadCount;
+    uint32_t chunkCount;
+
+    // Current call, read by the chunk jobs
+    uint32_t slot;
+    VkCommandBufferInheritanceInfo inheritance;
+    RecordChunkFunction function;
+    void* context;
+    RecordChunk chunks[PARALLEL_RECORD_MAX_CHUNKS];
+} ParallelRecorder;
+
+/**
+ * Create the command pools every job thread records chunks from
+ *
+ * @param device - VkDevice handle
+ * @param queueFamilyIndices - The graphics family the secondaries are executed on
+ * @param jobs - Job system the chunks run on (must outlive the recorder)
+ * @param chunkCount - Chunks per call (clamped to 1..PARALLEL_RECORD_MAX_CHUNKS)
+ * @param outRecorder - Output recorder
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult createParallelRecorder(
+    VkDevice device,
+    QueueFamilyIndices queueFamilyIndices,
+    JobSystem* jobs,
+    uint32_t chunkCount,
+    ParallelRecorder* outRecorder
+);
+
+/**
+ * Record every chunk as a job into the slot's secondary command buffers and wait for all of them
+ * Call from the main thread; the slot's previous submission must have completed.
+ *
+ * @param recorder - Parallel recorder
+ * @param slot - Frame slot index
+ * @param renderPass - Render pass the secondaries continue (subpass 0)
+ * @param framebuffer - Framebuffer of the pass, may be VK_NULL_HANDLE
+ * @param function - Records a chunk
+ * @param context - Passed to function
+ * @param outCommandBuffers - Receives chunkCount secondaries, in chunk order
+ * @return VK_SUCCESS on success, the first failing chunk's error otherwise
+ */
+VkResult recordSecondaryChunks(
+    ParallelRecorder* recorder,
+    uint32_t slot,
+    VkRenderPass renderPass,
+    VkFramebuffer framebuffer,
+    RecordChunkFunction function,
+    void* context,
+    VkCommandBuffer* outCommandBuffers
+);
+
+/**
+ * Destroy the command pools
+ * The device must be idle.
+ *
+ * @param recorder - Recorder to destroy
+ */
+void destroyParallelRecorder(ParallelRecorder* recorder);
+
+#endif // PARALLEL_RECORDER_H
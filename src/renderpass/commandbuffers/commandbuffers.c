@@ -58,6 +58,31 @@ VkResult allocateCommandBuffers(
     return VK_SUCCESS;
 }
 
+VkResult allocateSecondaryCommandBuffers(
+    VkDevice device,
+    VkCommandPool commandPool,
+    uint32_t count,
+    VkCommandBuffer* outCommandBuffers
+) {
+    if (!device || !commandPool || count == 0 || !outCommandBuffers) {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    VkCommandBufferAllocateInfo allocInfo = {0};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = commandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+    allocInfo.commandBufferCount = count;
+
+    VkResult result = vkAllocateCommandBuffers(device, &allocInfo, outCommandBuffers);
+    if (result != VK_SUCCESS) {
+        printf("Failed to allocate secondary command buffers!\n");
+        return result;
+    }
+
+    return VK_SUCCESS;
+}
+
 void freeCommandBuffers(
     VkDevice device,
     VkCommandPool commandPool,
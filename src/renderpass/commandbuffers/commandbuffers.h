@@ -21,6 +21,14 @@ VkResult allocateCommandBuffers(
     VkCommandBuffer** outCommandBuffers
 );
 
+// Allocate secondary command buffers, recorded separately and executed from a primary one
+VkResult allocateSecondaryCommandBuffers(
+    VkDevice device,
+    VkCommandPool commandPool,
+    uint32_t count,
+    VkCommandBuffer* outCommandBuffers
+);
+
 // Free command buffers
 void freeCommandBuffers(
     VkDevice device,
@@ -3,7 +3,7 @@
 #include <vulkan/vulkan.h>
 #include <stdio.h>
 
-VkResult createRenderPass(VkDevice device, VkFormat swapchainImageFormat, VkFormat depthFormat, VkRenderPass* renderPass) {
+VkResult createRenderPass(VkDevice device, VkFormat swapchainImageFormat, VkFormat depthFormat, VkImageLayout finalColorLayout, bool storeDepth, VkRenderPass* renderPass) {
     // --- Color attachment (the swapchain image) ---
     VkAttachmentDescription colorAttachment = {0}; // <=> memset(&colorAttachment, 0, sizeof(VkAttachmentDescription));
     colorAttachment.format = swapchainImageFormat;               
@@ -13,7 +13,7 @@ VkResult createRenderPass(VkDevice device, VkFormat swapchainImageFormat, VkForm
     colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;   
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR; 
+    colorAttachment.finalLayout = finalColorLayout;
 
     VkAttachmentReference colorAttachmentRef = {0};
     colorAttachmentRef.attachment = 0;                           
@@ -24,7 +24,7 @@ VkResult createRenderPass(VkDevice device, VkFormat swapchainImageFormat, VkForm
     depthAttachment.format = depthFormat;                        // Picked with findDepthFormat()
     depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
     depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;        
-    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;  
+    depthAttachment.storeOp = storeDepth ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
     depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -45,10 +45,24 @@ VkResult createRenderPass(VkDevice device, VkFormat swapchainImageFormat, VkForm
     VkSubpassDependency dependency = {0};
     dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
     dependency.dstSubpass = 0;
-    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    dependency.srcAccessMask = 0;
-    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    // Frames in flight share one depth image: its clear must wait for the previous frame's
+    // depth writes (write-after-write), not only the color output
+    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    // --- Outgoing dependency for offscreen targets that are copied after the pass ---
+    VkSubpassDependency readbackDependency = {0};
+    readbackDependency.srcSubpass = 0;
+    readbackDependency.dstSubpass = VK_SUBPASS_EXTERNAL;
+    readbackDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    readbackDependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    readbackDependency.dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    readbackDependency.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+    VkSubpassDependency dependencies[2] = { dependency, readbackDependency };
+    uint32_t dependencyCount = finalColorLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL ? 2 : 1;
 
     // --- Attachments array ---
     VkAttachmentDescription attachments[2] = { colorAttachment, depthAttachment };
@@ -59,8 +73,8 @@ VkResult createRenderPass(VkDevice device, VkFormat swapchainImageFormat, VkForm
     renderPassInfo.pAttachments = attachments;
     renderPassInfo.subpassCount = 1;
     renderPassInfo.pSubpasses = &subpass;
-    renderPassInfo.dependencyCount = 1;
-    renderPassInfo.pDependencies = &dependency;
+    renderPassInfo.dependencyCount = dependencyCount;
+    renderPassInfo.pDependencies = dependencies;
 
     if (vkCreateRenderPass(device, &renderPassInfo, NULL, renderPass) != VK_SUCCESS) {
         printf("Failed to create render pass!\n");
@@ -2,12 +2,17 @@
 #define RENDERPASS_H
 
 #include <vulkan/vulkan.h>
+#include <stdbool.h>
 
 // Create a render pass with one color attachment + one depth attachment
+// finalColorLayout is PRESENT_SRC_KHR for the swapchain, TRANSFER_SRC_OPTIMAL for offscreen readback
+// storeDepth keeps the depth buffer after the pass so it can be read (depth pyramid)
 VkResult createRenderPass(
     VkDevice device,
     VkFormat colorFormat,
     VkFormat depthFormat,
+    VkImageLayout finalColorLayout,
+    bool storeDepth,
     VkRenderPass* renderPass
 );
 
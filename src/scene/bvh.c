@@ -0,0 +1,409 @@
+#include "bvh.h"
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Node arrays are aligned so each sibling pair fills exactly one cache line
+#define BVH_NODE_ALIGNMENT 64
+
+// Traversal stacks hold at most one entry per level plus the sibling being pushed
+#define BVH_STACK_SIZE (BVH_MAX_DEPTH + 2)
+
+typedef struct {
+    float boundsMin[3];
+    float boundsMax[3];
+    uint32_t count;
+} BvhBin;
+
+// Build-time copy of a primitive; partitioning moves these so every pass reads memory in order
+typedef struct {
+    float boundsMin[3];
+    float boundsMax[3];
+    float centroid[3];
+    uint32_t primitive;
+} BvhBuildRef;
+
+static void resetBounds(float* boundsMin, float* boundsMax) {
+    for (int axis = 0; axis < 3; axis++) {
+        boundsMin[axis] = FLT_MAX;
+        boundsMax[axis] = -FLT_MAX;
+    }
+}
+
+static void growByPrimitive(float* boundsMin, float* boundsMax, AabbSoA bounds, uint32_t i) {
+    const float primitiveMin[3] = {bounds.minX[i], bounds.minY[i], bounds.minZ[i]};
+    const float primitiveMax[3] = {bounds.maxX[i], bounds.maxY[i], bounds.maxZ[i]};
+    for (int axis = 0; axis < 3; axis++) {
+        if (primitiveMin[axis] < boundsMin[axis]) boundsMin[axis] = primitiveMin[axis];
+        if (primitiveMax[axis] > boundsMax[axis]) boundsMax[axis] = primitiveMax[axis];
+    }
+}
+
+static void growByBounds(float* boundsMin, float* boundsMax, const float* otherMin, const float* otherMax) {
+    for (int axis = 0; axis < 3; axis++) {
+        if (otherMin[axis] < boundsMin[axis]) boundsMin[axis] = otherMin[axis];
+        if (otherMax[axis] > boundsMax[axis]) boundsMax[axis] = otherMax[axis];
+    }
+}
+
+// Half the surface area; the SAH only compares costs, so the factor 2 is dropped
+static float halfArea(const float* boundsMin, const float* boundsMax) {
+    float ex = boundsMax[0] - boundsMin[0];
+    float ey = boundsMax[1] - boundsMin[1];
+    float ez = boundsMax[2] - boundsMin[2];
+    if (ex < 0.0f || ey < 0.0f || ez < 0.0f) return 0.0f;
+    return ex * ey + ey * ez + ez * ex;
+}
+
+static void setLeafBounds(Bvh* bvh, BvhNode* node, AabbSoA bounds) {
+    resetBounds(node->boundsMin, node->boundsMax);
+    for (uint32_t i = 0; i < node->count; i++) {
+        growByPrimitive(node->boundsMin, node->boundsMax, bounds, bvh->primitives[node->leftOrFirst + i]);
+    }
+}
+
+static void setNodeBoundsFromRefs(BvhNode* node, const BvhBuildRef* refs) {
+    resetBounds(node->boundsMin, node->boundsMax);
+    for (uint32_t i = 0; i < node->count; i++) {
+        const BvhBuildRef* ref = &refs[node->leftOrFirst + i];
+        growByBounds(node->boundsMin, node->boundsMax, ref->boundsMin, ref->boundsMax);
+    }
+}
+
+static inline uint32_t binIndex(float centroid, float centroidMin, float scale) {
+    int bin = (int)((centroid - centroidMin) * scale);
+    if (bin < 0) bin = 0;
+    if (bin > BVH_BIN_COUNT - 1) bin = BVH_BIN_COUNT - 1;
+    return (uint32_t)bin;
+}
+
+// Best binned SAH split of a node; false when every centroid coincides
+static bool findSplit(const BvhNode* node, const BvhBuildRef* refs,
+                      int* outAxis, uint32_t* outSplitBin, float* outCentroidMin, float* outScale) {
+    const BvhBuildRef* nodeRefs = &refs[node->leftOrFirst];
+    float centroidMin[3], centroidMax[3];
+    resetBounds(centroidMin, centroidMax);
+    for (uint32_t i = 0; i < node->count; i++) {
+        growByBounds(centroidMin, centroidMax, nodeRefs[i].centroid, nodeRefs[i].centroid);
+    }
+
+    float bestCost = FLT_MAX;
+    bool found = false;
+    for (int axis = 0; axis < 3; axis++) {
+        float extent = centroidMax[axis] - centroidMin[axis];
+        if (extent <= 0.0f) continue;
+        float scale = BVH_BIN_COUNT / extent;
+
+        BvhBin bins[BVH_BIN_COUNT];
+        for (int b = 0; b < BVH_BIN_COUNT; b++) {
+            resetBounds(bins[b].boundsMin, bins[b].boundsMax);
+            bins[b].count = 0;
+        }
+        for (uint32_t i = 0; i < node->count; i++) {
+            BvhBin* bin = &bins[binIndex(nodeRefs[i].centroid[axis], centroidMin[axis], scale)];
+            growByBounds(bin->boundsMin, bin->boundsMax, nodeRefs[i].boundsMin, nodeRefs[i].boundsMax);
+            bin->count++;
+        }
+
+        // Sweep from both ends so every split plane costs O(1)
+        float leftArea[BVH_BIN_COUNT - 1], rightArea[BVH_BIN_COUNT - 1];
+        uint32_t leftCount[BVH_BIN_COUNT - 1], rightCount[BVH_BIN_COUNT - 1];
+        float sweepMin[3], sweepMax[3];
+        uint32_t sweepCount = 0;
+        resetBounds(sweepMin, sweepMax);
+        for (int b = 0; b < BVH_BIN_COUNT - 1; b++) {
+            sweepCount += bins[b].count;
+            growByBounds(sweepMin, sweepMax, bins[b].boundsMin, bins[b].boundsMax);
+            leftCount[b] = sweepCount;
+            leftArea[b] = halfArea(sweepMin, sweepMax);
+        }
+        sweepCount = 0;
+        resetBounds(sweepMin, sweepMax);
+        for (int b = BVH_BIN_COUNT - 1; b > 0; b--) {
+            sweepCount += bins[b].count;
+            growByBounds(sweepMin, sweepMax, bins[b].boundsMin, bins[b].boundsMax);
+            rightCount[b - 1] = sweepCount;
+            rightArea[b - 1] = halfArea(sweepMin, sweepMax);
+        }
+
+        for (int plane = 0; plane < BVH_BIN_COUNT - 1; plane++) {
+            if (leftCount[plane] == 0 || rightCount[plane] == 0) continue;
+            float cost = leftCount[plane] * leftArea[plane] + rightCount[plane] * rightArea[plane];
+            if (cost < bestCost) {
+                bestCost = cost;
+                *outAxis = axis;
+                *outSplitBin = (uint32_t)plane + 1;
+                *outCentroidMin = centroidMin[axis];
+                *outScale = scale;
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
+int buildBvh(Bvh* bvh, AabbSoA bounds, uint32_t count) {
+    destroyBvh(bvh);
+    if (count == 0) return 0;
+
+    // A binary tree with one primitive per leaf has 2n - 1 nodes, plus the padding node
+    void* nodeMemory = NULL;
+    if (posix_memalign(&nodeMemory, BVH_NODE_ALIGNMENT, sizeof(BvhNode) * 2 * (size_t)count) != 0) {
+        return -1;
+    }
+    bvh->nodes = nodeMemory;
+    bvh->primitives = malloc(sizeof(uint32_t) * count);
+    BvhBuildRef* refs = malloc(sizeof(BvhBuildRef) * count);
+    if (!bvh->primitives || !refs) {
+        free(refs);
+        destroyBvh(bvh);
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        BvhBuildRef* ref = &refs[i];
+        ref->boundsMin[0] = bounds.minX[i];
+        ref->boundsMin[1] = bounds.minY[i];
+        ref->boundsMin[2] = bounds.minZ[i];
+        ref->boundsMax[0] = bounds.maxX[i];
+        ref->boundsMax[1] = bounds.maxY[i];
+        ref->boundsMax[2] = bounds.maxZ[i];
+        for (int axis = 0; axis < 3; axis++) {
+            ref->centroid[axis] = (ref->boundsMin[axis] + ref->boundsMax[axis]) * 0.5f;
+        }
+        ref->primitive = i;
+    }
+    bvh->primitiveCount = count;
+
+    BvhNode* root = &bvh->nodes[0];
+    root->leftOrFirst = 0;
+    root->count = count;
+    setNodeBoundsFromRefs(root, refs);
+    memset(&bvh->nodes[1], 0, sizeof(BvhNode));
+    bvh->nodeCount = 2;
+    bvh->depth = 1;
+
+    struct { uint32_t node; uint32_t depth; } stack[BVH_STACK_SIZE];
+    uint32_t stackSize = 0;
+    stack[stackSize].node = 0;
+    stack[stackSize++].depth = 1;
+    while (stackSize > 0) {
+        stackSize--;
+        uint32_t nodeIndex = stack[stackSize].node;
+        uint32_t depth = stack[stackSize].depth;
+        BvhNode* node = &bvh->nodes[nodeIndex];
+        if (depth > bvh->depth) bvh->depth = depth;
+        if (node->count <= BVH_MAX_LEAF_SIZE || depth >= BVH_MAX_DEPTH) continue;
+
+        int axis = 0;
+        uint32_t splitBin = 0;
+        float centroidMin = 0.0f, scale = 0.0f;
+        if (!findSplit(node, refs, &axis, &splitBin, &centroidMin, &scale)) continue;
+
+        // Partition the node's range in place around the split plane
+        uint32_t first = node->leftOrFirst;
+        uint32_t i = first;
+        uint32_t j = first + node->count;
+        while (i < j) {
+            if (binIndex(refs[i].centroid[axis], centroidMin, scale) < splitBin) {
+                i++;
+            } else {
+                BvhBuildRef swap = refs[i];
+                refs[i] = refs[--j];
+                refs[j] = swap;
+            }
+        }
+        uint32_t leftCount = i - first;
+        if (leftCount == 0 || leftCount == node->count) continue;
+
+        uint32_t left = bvh->nodeCount;
+        bvh->nodeCount += 2;
+        bvh->nodes[left].leftOrFirst = first;
+        bvh->nodes[left].count = leftCount;
+        bvh->nodes[left + 1].leftOrFirst = i;
+        bvh->nodes[left + 1].count = node->count - leftCount;
+        setNodeBoundsFromRefs(&bvh->nodes[left], refs);
+        setNodeBoundsFromRefs(&bvh->nodes[left + 1], refs);
+        node->leftOrFirst = left;
+        node->count = 0;
+
+        stack[stackSize].node = left + 1;
+        stack[stackSize++].depth = depth + 1;
+        stack[stackSize].node = left;
+        stack[stackSize++].depth = depth + 1;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        bvh->primitives[i] = refs[i].primitive;
+    }
+    free(refs);
+    return 0;
+}
+
+void refitBvh(Bvh* bvh, AabbSoA bounds) {
+    if (!bvh || bvh->nodeCount == 0) return;
+
+    // Children always come after their parent, so a reverse sweep visits them first
+    for (uint32_t n = bvh->nodeCount; n-- > 0;) {
+        if (n == 1) continue;
+        BvhNode* node = &bvh->nodes[n];
+        if (node->count > 0) {
+            setLeafBounds(bvh, node, bounds);
+        } else {
+            const BvhNode* left = &bvh->nodes[node->leftOrFirst];
+            const BvhNode* right = left + 1;
+            memcpy(node->boundsMin, left->boundsMin, sizeof(node->boundsMin));
+            memcpy(node->boundsMax, left->boundsMax, sizeof(node->boundsMax));
+            growByBounds(node->boundsMin, node->boundsMax, right->boundsMin, right->boundsMax);
+        }
+    }
+}
+
+uint32_t cullBvh(const Bvh* bvh, AabbSoA bounds, const Frustum* frustum, uint8_t* outVisible) {
+    if (bvh->nodeCount == 0) return 0;
+    memset(outVisible, 0, bvh->primitiveCount);
+
+    struct { uint32_t node; uint32_t planeMask; } stack[BVH_STACK_SIZE];
+    uint32_t stackSize = 0;
+    stack[stackSize].node = 0;
+    stack[stackSize++].planeMask = FRUSTUM_ALL_PLANES;
+
+    uint32_t visibleCount = 0;
+    while (stackSize > 0) {
+        stackSize--;
+        const BvhNode* node = &bvh->nodes[stack[stackSize].node];
+        uint32_t planeMask = stack[stackSize].planeMask;
+
+        // An empty mask means an ancestor was already entirely inside
+        FrustumClass classification = FRUSTUM_INSIDE;
+        if (planeMask) {
+            classification = frustum_classify_aabb(frustum, node->boundsMin, node->boundsMax, &planeMask);
+            if (classification == FRUSTUM_OUTSIDE) continue;
+        }
+
+        if (node->count == 0) {
+            stack[stackSize].node = node->leftOrFirst + 1;
+            stack[stackSize++].planeMask = planeMask;
+            stack[stackSize].node = node->leftOrFirst;
+            stack[stackSize++].planeMask = planeMask;
+            continue;
+        }
+
+        for (uint32_t i = 0; i < node->count; i++) {
+            uint32_t primitive = bvh->primitives[node->leftOrFirst + i];
+            if (classification != FRUSTUM_INSIDE) {
+                const float primitiveMin[3] = {bounds.minX[primitive], bounds.minY[primitive], bounds.minZ[primitive]};
+                const float primitiveMax[3] = {bounds.maxX[primitive], bounds.maxY[primitive], bounds.maxZ[primitive]};
+                uint32_t primitiveMask = planeMask;
+                if (frustum_classify_aabb(frustum, primitiveMin, primitiveMax, &primitiveMask) == FRUSTUM_OUTSIDE) {
+                    continue;
+                }
+            }
+            outVisible[primitive] = 1;
+            visibleCount++;
+        }
+    }
+    return visibleCount;
+}
+
+// Slab test; the entry distance is clamped to 0 when the origin is inside the box
+static inline bool intersectRay(const float* boundsMin, const float* boundsMax, const float* origin,
+                                const float* invDirection, float maxDistance, float* outDistance) {
+    float tEnter = 0.0f;
+    float tExit = maxDistance;
+    for (int axis = 0; axis < 3; axis++) {
+        float t1 = (boundsMin[axis] - origin[axis]) * invDirection[axis];
+        float t2 = (boundsMax[axis] - origin[axis]) * invDirection[axis];
+        if (t1 > t2) {
+            float swap = t1;
+            t1 = t2;
+            t2 = swap;
+        }
+        if (t1 > tEnter) tEnter = t1;
+        if (t2 < tExit) tExit = t2;
+    }
+    *outDistance = tEnter;
+    return tEnter <= tExit;
+}
+
+bool raycastBvh(const Bvh* bvh, AabbSoA bounds, vec3 origin, vec3 direction, float maxDistance, BvhHit* outHit) {
+    if (bvh->nodeCount == 0) return false;
+
+    const float rayOrigin[3] = {origin.x, origin.y, origin.z};
+    const float rayDirection[3] = {direction.x, direction.y, direction.z};
+    float invDirection[3];
+    for (int axis = 0; axis < 3; axis++) {
+        // Axis-parallel rays get a huge finite inverse so 0 * inf never produces NaN
+        invDirection[axis] = rayDirection[axis] != 0.0f ? 1.0f / rayDirection[axis] : 1e30f;
+    }
+
+    float closest = maxDistance;
+    bool hit = false;
+    float rootDistance;
+    if (!intersectRay(bvh->nodes[0].boundsMin, bvh->nodes[0].boundsMax, rayOrigin, invDirection, closest, &rootDistance)) {
+        return false;
+    }
+
+    struct { uint32_t node; float distance; } stack[BVH_STACK_SIZE];
+    uint32_t stackSize = 0;
+    stack[stackSize].node = 0;
+    stack[stackSize++].distance = rootDistance;
+    while (stackSize > 0) {
+        stackSize--;
+        if (stack[stackSize].distance > closest) continue;
+        const BvhNode* node = &bvh->nodes[stack[stackSize].node];
+
+        if (node->count > 0) {
+            for (uint32_t i = 0; i < node->count; i++) {
+                uint32_t primitive = bvh->primitives[node->leftOrFirst + i];
+                const float primitiveMin[3] = {bounds.minX[primitive], bounds.minY[primitive], bounds.minZ[primitive]};
+                const float primitiveMax[3] = {bounds.maxX[primitive], bounds.maxY[primitive], bounds.maxZ[primitive]};
+                float distance;
+                if (intersectRay(primitiveMin, primitiveMax, rayOrigin, invDirection, closest, &distance) &&
+                    (!hit || distance < closest)) {
+                    closest = distance;
+                    outHit->primitive = primitive;
+                    outHit->distance = distance;
+                    hit = true;
+                }
+            }
+            continue;
+        }
+
+        // Push the farther child first so the nearer one is popped next and tightens closest sooner
+        uint32_t near = node->leftOrFirst;
+        uint32_t far = near + 1;
+        float nearDistance, farDistance;
+        bool nearHit = intersectRay(bvh->nodes[near].boundsMin, bvh->nodes[near].boundsMax, rayOrigin, invDirection, closest, &nearDistance);
+        bool farHit = intersectRay(bvh->nodes[far].boundsMin, bvh->nodes[far].boundsMax, rayOrigin, invDirection, closest, &farDistance);
+        if (nearHit && farHit && farDistance < nearDistance) {
+            uint32_t swapNode = near;
+            near = far;
+            far = swapNode;
+            float swapDistance = nearDistance;
+            nearDistance = farDistance;
+            farDistance = swapDistance;
+        } else if (!nearHit && farHit) {
+            near = far;
+            nearDistance = farDistance;
+            nearHit = true;
+            farHit = false;
+        }
+        if (farHit) {
+            stack[stackSize].node = far;
+            stack[stackSize++].distance = farDistance;
+        }
+        if (nearHit) {
+            stack[stackSize].node = near;
+            stack[stackSize++].distance = nearDistance;
+        }
+    }
+    return hit;
+}
+
+void destroyBvh(Bvh* bvh) {
+    if (!bvh) return;
+    free(bvh->nodes);
+    free(bvh->primitives);
+    memset(bvh, 0, sizeof(Bvh));
+}
@@ -0,0 +1,104 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../math/vector.h"
+#include "../math/frustum.h"
+#include "../math/transform_batch.h"
+
+// Leaves stop splitting at this many primitives
+#define BVH_MAX_LEAF_SIZE 4
+
+// Centroid bins evaluated per axis by the SAH build
+#define BVH_BIN_COUNT 12
+
+// Deeper nodes become leaves, which bounds the traversal stacks
+#define BVH_MAX_DEPTH 48
+
+/**
+ * Flattened BVH node (32 bytes)
+ * Siblings are stored next to each other (right = left + 1) and pairs start
+ * on even indices, so with a 64-byte aligned array both children of a node
+ * share one cache line.
+ */
+typedef struct {
+    float boundsMin[3];
+    uint32_t leftOrFirst;     // Interior: index of the left child; leaf: first entry in primitives
+    float boundsMax[3];
+    uint32_t count;           // Primitives in the leaf, 0 for interior nodes
+} BvhNode;
+
+/**
+ * Bounding volume hierarchy over a set of AABBs
+ * Primitives are referenced by their index in the AabbSoA the tree was built from.
+ */
+typedef struct {
+    BvhNode* nodes;           // nodes[0] is the root, nodes[1] is unused padding
+    uint32_t nodeCount;
+    uint32_t* primitives;     // Primitive indices, each leaf owns a contiguous range
+    uint32_t primitiveCount;
+    uint32_t depth;
+} Bvh;
+
+/**
+ * Ray hit against primitive bounds
+ */
+typedef struct {
+    uint32_t primitive;
+    float distance;           // Along the ray direction, 0 when the origin is inside the box
+} BvhHit;
+
+/**
+ * Build a tree with the binned surface area heuristic (replaces any previous tree)
+ *
+ * @param bvh - Tree to build
+ * @param bounds - Primitive boxes
+ * @param count - Number of primitives
+ * @return 0 on success, -1 on allocation failure
+ */
+int buildBvh(Bvh* bvh, AabbSoA bounds, uint32_t count);
+
+/**
+ * Recompute node bounds bottom-up after primitives moved, keeping the topology
+ * Much cheaper than a rebuild; the tree degrades if objects move far, so rebuild
+ * after large changes.
+ *
+ * @param bvh - Built tree
+ * @param bounds - Updated primitive boxes (same count and order as the build)
+ */
+void refitBvh(Bvh* bvh, AabbSoA bounds);
+
+/**
+ * Hierarchical frustum culling: subtrees outside a plane are skipped, subtrees
+ * inside every plane are accepted without further tests
+ *
+ * @param bvh - Built tree
+ * @param bounds - Primitive boxes
+ * @param frustum - Frustum
+ * @param outVisible - primitiveCount flags, set to 1 for visible primitives and 0 otherwise
+ * @return Number of visible primitives
+ */
+uint32_t cullBvh(const Bvh* bvh, AabbSoA bounds, const Frustum* frustum, uint8_t* outVisible);
+
+/**
+ * Closest primitive box hit by a ray, visiting nearer children first
+ *
+ * @param bvh - Built tree
+ * @param bounds - Primitive boxes
+ * @param origin - Ray origin
+ * @param direction - Ray direction (need not be normalized; distances are in its units)
+ * @param maxDistance - Ignore hits further than this
+ * @param outHit - Closest hit
+ * @return true if anything was hit
+ */
+bool raycastBvh(const Bvh* bvh, AabbSoA bounds, vec3 origin, vec3 direction, float maxDistance, BvhHit* outHit);
+
+/**
+ * Free the tree
+ *
+ * @param bvh - Tree to destroy
+ */
+void destroyBvh(Bvh* bvh);
+
+#endif // BVH_H
@@ -0,0 +1,364 @@
+#include "scene.h"
+#include "../vertex_buffer/vertex_buffer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SCENE_INITIAL_CAPACITY 16
+
+// Default cube vertices span -0.5..0.5 on every axis
+#define CUBE_HALF_EXTENT 0.5f
+
+static uint64_t makeDrawKey(const SceneObject* object, uint32_t objectIndex) {
+    return ((uint64_t)object->pipelineIndex << 48) | ((uint64_t)object->meshIndex << 32) | objectIndex;
+}
+
+static int compareDrawKeys(const void* a, const void* b) {
+    uint64_t keyA = *(const uint64_t*)a;
+    uint64_t keyB = *(const uint64_t*)b;
+    return (keyA > keyB) - (keyA < keyB);
+}
+
+// Fill the cached push constants from a model matrix
+static void buildObjectConstants(SceneObject* object, uint32_t objectID) {
+    mat4 normal = mat4_normal_matrix(object->transform);
+    memset(&object->constants, 0, sizeof(PushConstants));
+    memcpy(object->constants.model, object->transform.m, sizeof(object->constants.model));
+    for (int column = 0; column < 3; column++) {
+        object->constants.normalMatrix[column * 4 + 0] = normal.m[column * 4 + 0];
+        object->constants.normalMatrix[column * 4 + 1] = normal.m[column * 4 + 1];
+        object->constants.normalMatrix[column * 4 + 2] = normal.m[column * 4 + 2];
+    }
+    object->constants.objectID = objectID;
+}
+
+// Transform the object's mesh bounds into its slot of worldBounds
+static void updateObjectBounds(Scene* scene, uint32_t objectIndex) {
+    const SceneObject* object = &scene->objects[objectIndex];
+    const SceneMesh* mesh = &scene->meshes[object->meshIndex];
+    float local[6] = {
+        mesh->boundsMin.x, mesh->boundsMin.y, mesh->boundsMin.z,
+        mesh->boundsMax.x, mesh->boundsMax.y, mesh->boundsMax.z
+    };
+    AabbSoA in = {&local[0], &local[1], &local[2], &local[3], &local[4], &local[5]};
+    AabbSoA* out = &scene->worldBounds;
+    AabbSoA slot = {out->minX + objectIndex, out->minY + objectIndex, out->minZ + objectIndex,
+                    out->maxX + objectIndex, out->maxY + objectIndex, out->maxZ + objectIndex};
+    transform_aabbs_soa_scalar(&object->transform, in, slot, 1);
+}
+
+// Grow every per-object array to newCapacity, keeping the first objectCount entries
+static VkResult growObjectArrays(Scene* scene, uint32_t newCapacity) {
+    SceneObject* objects = realloc(scene->objects, sizeof(SceneObject) * newCapacity);
+    if (!objects) return VK_ERROR_OUT_OF_HOST_MEMORY;
+    scene->objects = objects;
+
+    uint8_t* visible = realloc(scene->visible, newCapacity);
+    if (!visible) return VK_ERROR_OUT_OF_HOST_MEMORY;
+    scene->visible = visible;
+
+    // SoA arrays are aligned, so they are reallocated by hand
+    float** bounds[6] = {
+        &scene->worldBounds.minX, &scene->worldBounds.minY, &scene->worldBounds.minZ,
+        &scene->worldBounds.maxX, &scene->worldBounds.maxY, &scene->worldBounds.maxZ
+    };
+    for (int i = 0; i < 6; i++) {
+        float* grown = soa_alloc_floats(newCapacity);
+        if (!grown) return VK_ERROR_OUT_OF_HOST_MEMORY;
+        if (*bounds[i]) {
+            memcpy(grown, *bounds[i], sizeof(float) * scene->objectCount);
+            soa_free_floats(*bounds[i]);
+        }
+        *bounds[i] = grown;
+    }
+
+    scene->objectCapacity = newCapacity;
+    return VK_SUCCESS;
+}
+
+void initScene(Scene* scene) {
+    memset(scene, 0, sizeof(Scene));
+}
+
+VkResult addSceneMesh(
+    Scene* scene,
+    const Buffer* vertexBuffer,
+    const Buffer* indexBuffer,
+    uint32_t indexCount,
+    VkIndexType indexType,
+    vec3 boundsMin,
+    vec3 boundsMax,
+    bool takeOwnership,
+    uint32_t* outIndex
+) {
+    if (!scene || !vertexBuffer || !indexBuffer || !outIndex) {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+    if (scene->meshCount >= SCENE_MAX_MESHES) {
+        printf("Scene mesh limit reached (%u)\n", SCENE_MAX_MESHES);
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    if (scene->meshCount == scene->meshCapacity) {
+        uint32_t newCapacity = scene->meshCapacity ? scene->meshCapacity * 2 : SCENE_INITIAL_CAPACITY;
+        SceneMesh* meshes = realloc(scene->meshes, sizeof(SceneMesh) * newCapacity);
+        if (!meshes) return VK_ERROR_OUT_OF_HOST_MEMORY;
+        scene->meshes = meshes;
+        scene->meshCapacity = newCapacity;
+    }
+
+    SceneMesh* mesh = &scene->meshes[scene->meshCount];
+    mesh->vertexBuffer = *vertexBuffer;
+    mesh->indexBuffer = *indexBuffer;
+    mesh->indexCount = indexCount;
+    mesh->indexType = indexType;
+    mesh->boundsMin = boundsMin;
+    mesh->boundsMax = boundsMax;
+    mesh->ownsBuffers = takeOwnership;
+    *outIndex = scene->meshCount++;
+    return VK_SUCCESS;
+}
+
+VkResult uploadSceneMesh(
+    Scene* scene,
+    UploadBatch* batch,
+    const Mesh* mesh,
+    uint32_t* outIndex
+) {
+    if (!scene || !batch || !outIndex) {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    bool useCube = !mesh || mesh->num_vertices == 0;
+    VkDeviceSize vertexSize = useCube ? CUBE_VERTEX_COUNT * sizeof(Vertex) : mesh->num_vertices * sizeof(Vertex);
+    uint32_t indexCount = useCube ? CUBE_INDEX_COUNT : (uint32_t)mesh->num_indices;
+    VkIndexType indexType = useCube ? VK_INDEX_TYPE_UINT16 : chooseIndexType((uint32_t)mesh->num_vertices);
+
+    Buffer vertexBuffer = {0};
+    Buffer indexBuffer = {0};
+    VkResult result = createVertexBuffer(batch->device, batch->physicalDevice, batch->allocator, vertexSize, &vertexBuffer);
+    if (result == VK_SUCCESS) {
+        result = createIndexBuffer(batch->device, batch->physicalDevice, batch->allocator, indexCount, indexType, &indexBuffer);
+    }
+    if (result == VK_SUCCESS) {
+        if (useCube) {
+            result = updateVertexBufferWithCube(batch, &vertexBuffer);
+            if (result == VK_SUCCESS) {
+                result = updateIndexBufferWithCube(batch, &indexBuffer);
+            }
+        } else {
+            uint32_t vertexCount = 0;
+            result = updateVertexBufferWithMesh(batch, &vertexBuffer, (Mesh*)mesh, &vertexCount);
+            if (result == VK_SUCCESS) {
+                result = updateIndexBufferWithMesh(batch, &indexBuffer, (Mesh*)mesh, indexType);
+            }
+        }
+    }
+    if (result == VK_SUCCESS) {
+        vec3 boundsMin = useCube ? vec3_create(-CUBE_HALF_EXTENT, -CUBE_HALF_EXTENT, -CUBE_HALF_EXTENT)
+                                 : vec3_create(mesh->bounds_min[0], mesh->bounds_min[1], mesh->bounds_min[2]);
+        vec3 boundsMax = useCube ? vec3_create(CUBE_HALF_EXTENT, CUBE_HALF_EXTENT, CUBE_HALF_EXTENT)
+                                 : vec3_create(mesh->bounds_max[0], mesh->bounds_max[1], mesh->bounds_max[2]);
+        result = addSceneMesh(scene, &vertexBuffer, &indexBuffer, indexCount, indexType,
+                              boundsMin, boundsMax, true, outIndex);
+    }
+    if (result != VK_SUCCESS) {
+        printf("Failed to upload scene mesh!\n");
+        destroyBuffer(batch->device, &indexBuffer);
+        destroyBuffer(batch->device, &vertexBuffer);
+    }
+    return result;
+}
+
+VkResult addSceneObject(
+    Scene* scene,
+    uint32_t meshIndex,
+    uint32_t pipelineIndex,
+    mat4 transform,
+    uint32_t* outIndex
+) {
+    if (!scene || meshIndex >= scene->meshCount || pipelineIndex >= SCENE_MAX_PIPELINES) {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    if (scene->objectCount == scene->objectCapacity) {
+        uint32_t newCapacity = scene->objectCapacity ? scene->objectCapacity * 2 : SCENE_INITIAL_CAPACITY;
+        VkResult result = growObjectArrays(scene, newCapacity);
+        if (result != VK_SUCCESS) return result;
+    }
+
+    uint32_t index = scene->objectCount++;
+    SceneObject* object = &scene->objects[index];
+    object->meshIndex = meshIndex;
+    object->pipelineIndex = pipelineIndex;
+    object->transform = transform;
+    buildObjectConstants(object, index);
+    updateObjectBounds(scene, index);
+    scene->visible[index] = 1;
+    scene->visibleCount++;
+    scene->drawListDirty = true;
+    scene->bvhNeedsBuild = true;
+
+    if (outIndex) *outIndex = index;
+    return VK_SUCCESS;
+}
+
+void setSceneObjectTransform(Scene* scene, uint32_t objectIndex, mat4 transform) {
+    if (!scene || objectIndex >= scene->objectCount) return;
+    SceneObject* object = &scene->objects[objectIndex];
+    object->transform = transform;
+    buildObjectConstants(object, objectIndex);
+    updateObjectBounds(scene, objectIndex);
+    scene->bvhNeedsRefit = true;
+}
+
+VkResult updateSceneBvh(Scene* scene) {
+    if (!scene) return VK_ERROR_INITIALIZATION_FAILED;
+    if (scene->bvhNeedsBuild) {
+        if (buildBvh(&scene->bvh, scene->worldBounds, scene->objectCount) != 0) {
+            printf("Failed to build scene BVH!\n");
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
+        scene->bvhNeedsBuild = false;
+        scene->bvhNeedsRefit = false;
+    } else if (scene->bvhNeedsRefit) {
+        refitBvh(&scene->bvh, scene->worldBounds);
+        scene->bvhNeedsRefit = false;
+    }
+    return VK_SUCCESS;
+}
+
+uint32_t cullScene(Scene* scene, const Frustum* frustum) {
+    if (!scene || !frustum) return 0;
+    if (scene->objectCount >= SCENE_BVH_MIN_OBJECTS && updateSceneBvh(scene) == VK_SUCCESS) {
+        scene->visibleCount = cullBvh(&scene->bvh, scene->worldBounds, frustum, scene->visible);
+    } else {
+        scene->visibleCount = (uint32_t)frustum_cull_aabbs_soa(frustum, scene->worldBounds, scene->objectCount, scene->visible);
+    }
+    return scene->visibleCount;
+}
+
+bool pickScene(
+    Scene* scene,
+    vec3 origin,
+    vec3 direction,
+    float maxDistance,
+    uint32_t* outObject,
+    float* outDistance
+) {
+    if (!scene || !outObject || scene->objectCount == 0) return false;
+    if (updateSceneBvh(scene) != VK_SUCCESS) return false;
+
+    BvhHit hit;
+    if (!raycastBvh(&scene->bvh, scene->worldBounds, origin, direction, maxDistance, &hit)) {
+        return false;
+    }
+    *outObject = hit.primitive;
+    if (outDistance) *outDistance = hit.distance;
+    return true;
+}
+
+VkResult sortSceneDrawList(Scene* scene) {
+    uint64_t* keys = realloc(scene->drawKeys, sizeof(uint64_t) * (scene->objectCount ? scene->objectCount : 1));
+    if (!keys) return VK_ERROR_OUT_OF_HOST_MEMORY;
+    scene->drawKeys = keys;
+
+    for (uint32_t i = 0; i < scene->objectCount; i++) {
+        keys[i] = makeDrawKey(&scene->objects[i], i);
+    }
+    qsort(keys, scene->objectCount, sizeof(uint64_t), compareDrawKeys);
+    scene->drawListDirty = false;
+    return VK_SUCCESS;
+}
+
+VkResult recordSceneDraws(
+    Scene* scene,
+    VkCommandBuffer cmdBuffer,
+    const VkPipeline* pipelines,
+    uint32_t pipelineCount,
+    VkPipelineLayout pipelineLayout
+) {
+    if (!scene || !pipelines) {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+    if (scene->drawListDirty) {
+        VkResult result = sortSceneDrawList(scene);
+        if (result != VK_SUCCESS) return result;
+    }
+
+    recordSceneDrawRange(scene, cmdBuffer, 0, scene->objectCount, pipelines, pipelineCount, pipelineLayout,
+                         &scene->lastStats);
+    return VK_SUCCESS;
+}
+
+void recordSceneDrawRange(
+    const Scene* scene,
+    VkCommandBuffer cmdBuffer,
+    uint32_t first,
+    uint32_t count,
+    const VkPipeline* pipelines,
+    uint32_t pipelineCount,
+    VkPipelineLayout pipelineLayout,
+    SceneDrawStats* outStats
+) {
+    SceneDrawStats stats = {0};
+    uint32_t start = first < scene->objectCount ? first : scene->objectCount;
+    uint32_t end = count < scene->objectCount - start ? start + count : scene->objectCount;
+    uint32_t boundPipeline = UINT32_MAX;
+    uint32_t boundMesh = UINT32_MAX;
+    for (uint32_t i = start; i < end; i++) {
+        uint32_t objectIndex = (uint32_t)scene->drawKeys[i];
+        const SceneObject* object = &scene->objects[objectIndex];
+        if (!scene->visible[objectIndex]) {
+            stats.culled++;
+            continue;
+        }
+        if (object->pipelineIndex >= pipelineCount) continue;
+
+        if (object->pipelineIndex != boundPipeline) {
+            vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines[object->pipelineIndex]);
+            boundPipeline = object->pipelineIndex;
+            stats.pipelineBinds++;
+        }
+
+        const SceneMesh* mesh = &scene->meshes[object->meshIndex];
+        if (object->meshIndex != boundMesh) {
+            VkDeviceSize offset = 0;
+            vkCmdBindVertexBuffers(cmdBuffer, 0, 1, &mesh->vertexBuffer.buffer, &offset);
+            vkCmdBindIndexBuffer(cmdBuffer, mesh->indexBuffer.buffer, 0, mesh->indexType);
+            boundMesh = object->meshIndex;
+            stats.meshBinds++;
+        }
+
+        vkCmdPushConstants(cmdBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                           0, sizeof(PushConstants), &object->constants);
+        vkCmdDrawIndexed(cmdBuffer, mesh->indexCount, 1, 0, 0, 0);
+        stats.draws++;
+    }
+
+    if (outStats) {
+        *outStats = stats;
+    }
+}
+
+void destroyScene(VkDevice device, Scene* scene) {
+    if (!scene) return;
+    for (uint32_t i = 0; i < scene->meshCount; i++) {
+        if (scene->meshes[i].ownsBuffers) {
+            destroyBuffer(device, &scene->meshes[i].indexBuffer);
+            destroyBuffer(device, &scene->meshes[i].vertexBuffer);
+        }
+    }
+    free(scene->meshes);
+    free(scene->objects);
+    free(scene->drawKeys);
+    free(scene->visible);
+    destroyBvh(&scene->bvh);
+    soa_free_floats(scene->worldBounds.minX);
+    soa_free_floats(scene->worldBounds.minY);
+    soa_free_floats(scene->worldBounds.minZ);
+    soa_free_floats(scene->worldBounds.maxX);
+    soa_free_floats(scene->worldBounds.maxY);
+    soa_free_floats(scene->worldBounds.maxZ);
+    memset(scene, 0, sizeof(Scene));
+}
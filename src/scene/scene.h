@@ -0,0 +1,258 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <vulkan/vulkan.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "../graphics_pipeline/buffer.h"
+#include "../graphics_pipeline/pipeline_layout.h"
+#include "../math/matrix.h"
+#include "../math/frustum.h"
+#include "../model_loaders/objloader.h"
+#include "bvh.h"
+
+// Sort keys pack the pipeline and mesh into 16 bits each above a 32-bit object index
+#define SCENE_MAX_MESHES 0xFFFF
+#define SCENE_MAX_PIPELINES 0xFFFF
+
+// Below this many objects cullScene tests every box directly instead of walking the BVH
+#define SCENE_BVH_MIN_OBJECTS 64
+
+/**
+ * Geometry shared by any number of scene objects
+ */
+typedef struct {
+    Buffer vertexBuffer;
+    Buffer indexBuffer;
+    uint32_t indexCount;
+    VkIndexType indexType;
+    vec3 boundsMin;           // Object-space AABB
+    vec3 boundsMax;
+    bool ownsBuffers;         // false when the buffers belong to the caller
+} SceneMesh;
+
+/**
+ * One drawable: a mesh placed in the world with a pipeline
+ */
+typedef struct {
+    uint32_t meshIndex;
+    uint32_t pipelineIndex;   // Index into the pipeline array given to recordSceneDraws
+    mat4 transform;
+    PushConstants constants;  // Model, normal matrix and ID, rebuilt only when the transform changes
+} SceneObject;
+
+/**
+ * State changes issued by the last recordSceneDraws
+ */
+typedef struct {
+    uint32_t draws;
+    uint32_t culled;
+    uint32_t pipelineBinds;
+    uint32_t meshBinds;
+} SceneDrawStats;
+
+/**
+ * Meshes, objects and a draw list sorted by (pipeline, mesh)
+ * Sorting makes every object sharing a pipeline and mesh draw back to back,
+ * so binds scale with the number of distinct states instead of objects.
+ */
+typedef struct {
+    SceneMesh* meshes;
+    uint32_t meshCount;
+    uint32_t meshCapacity;
+
+    SceneObject* objects;
+    uint32_t objectCount;
+    uint32_t objectCapacity;
+
+    uint64_t* drawKeys;       // One sort key per object, valid when !drawListDirty
+    bool drawListDirty;       // Set when objects are added or change mesh/pipeline
+
+    AabbSoA worldBounds;      // Per-object world AABB, refreshed when its transform changes
+    uint8_t* visible;         // Per-object result of the last cullScene (1 = draw)
+    uint32_t visibleCount;
+
+    Bvh bvh;                  // Over worldBounds, used for culling and picking
+    bool bvhNeedsBuild;       // Set when objects are added
+    bool bvhNeedsRefit;       // Set when objects move
+
+    SceneDrawStats lastStats;
+} Scene;
+
+/**
+ * Initialize an empty scene
+ *
+ * @param scene - Scene to initialize
+ */
+void initScene(Scene* scene);
+
+/**
+ * Register existing vertex/index buffers as a mesh
+ *
+ * @param scene - Scene
+ * @param vertexBuffer - Vertex buffer holding Vertex structs
+ * @param indexBuffer - Index buffer
+ * @param indexCount - Number of indices
+ * @param indexType - Index width
+ * @param boundsMin - Object-space AABB minimum
+ * @param boundsMax - Object-space AABB maximum
+ * @param takeOwnership - true to destroy the buffers with the scene
+ * @param outIndex - Output mesh index
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult addSceneMesh(
+    Scene* scene,
+    const Buffer* vertexBuffer,
+    const Buffer* indexBuffer,
+    uint32_t indexCount,
+    VkIndexType indexType,
+    vec3 boundsMin,
+    vec3 boundsMax,
+    bool takeOwnership,
+    uint32_t* outIndex
+);
+
+/**
+ * Create device-local buffers for a mesh, stage its data and add it to the scene
+ * The data is on the GPU once the batch has been submitted.
+ *
+ * @param scene - Scene
+ * @param batch - Recording upload batch (its device and allocator create the buffers)
+ * @param mesh - Mesh to upload, NULL or empty for the default cube
+ * @param outIndex - Output mesh index
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult uploadSceneMesh(
+    Scene* scene,
+    UploadBatch* batch,
+    const Mesh* mesh,
+    uint32_t* outIndex
+);
+
+/**
+ * Add an object; its object ID is its index
+ *
+ * @param scene - Scene
+ * @param meshIndex - Mesh drawn by the object
+ * @param pipelineIndex - Pipeline drawn with
+ * @param transform - Model matrix
+ * @param outIndex - Output object index (may be NULL)
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult addSceneObject(
+    Scene* scene,
+    uint32_t meshIndex,
+    uint32_t pipelineIndex,
+    mat4 transform,
+    uint32_t* outIndex
+);
+
+/**
+ * Move an object (does not invalidate the draw order; the BVH is refit on the next cull)
+ *
+ * @param scene - Scene
+ * @param objectIndex - Object to move
+ * @param transform - New model matrix
+ */
+void setSceneObjectTransform(Scene* scene, uint32_t objectIndex, mat4 transform);
+
+/**
+ * Mark the objects whose world bounds intersect the frustum; the rest are skipped by recordSceneDraws
+ * Large scenes are culled through the BVH, skipping whole subtrees outside the frustum.
+ *
+ * @param scene - Scene
+ * @param frustum - World-space frustum
+ * @return Number of visible objects
+ */
+uint32_t cullScene(Scene* scene, const Frustum* frustum);
+
+/**
+ * Rebuild or refit the BVH if objects were added or moved; cullScene and pickScene do this when needed
+ *
+ * @param scene - Scene
+ * @return VK_SUCCESS on success, VK_ERROR_OUT_OF_HOST_MEMORY otherwise
+ */
+VkResult updateSceneBvh(Scene* scene);
+
+/**
+ * Find the object whose world bounds a ray hits first
+ *
+ * @param scene - Scene
+ * @param origin - Ray origin
+ * @param direction - Ray direction
+ * @param maxDistance - Ignore hits further than this
+ * @param outObject - Index of the hit object
+ * @param outDistance - Distance to the hit along the ray (may be NULL)
+ * @return true if an object was hit
+ */
+bool pickScene(
+    Scene* scene,
+    vec3 origin,
+    vec3 direction,
+    float maxDistance,
+    uint32_t* outObject,
+    float* outDistance
+);
+
+/**
+ * Re-sort the draw list by pipeline, then mesh; recordSceneDraws does this when needed
+ *
+ * @param scene - Scene
+ * @return VK_SUCCESS on success, VK_ERROR_OUT_OF_HOST_MEMORY otherwise
+ */
+VkResult sortSceneDrawList(Scene* scene);
+
+/**
+ * Record one indexed draw per visible object, binding pipelines and meshes only when they change
+ * Descriptor sets must already be bound with a layout compatible with pipelineLayout.
+ *
+ * @param scene - Scene
+ * @param cmdBuffer - Command buffer inside a render pass
+ * @param pipelines - Pipelines addressed by SceneObject.pipelineIndex
+ * @param pipelineCount - Number of pipelines
+ * @param pipelineLayout - Layout with the PushConstants range
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult recordSceneDraws(
+    Scene* scene,
+    VkCommandBuffer cmdBuffer,
+    const VkPipeline* pipelines,
+    uint32_t pipelineCount,
+    VkPipelineLayout pipelineLayout
+);
+
+/**
+ * Record the draws of a range of the sorted draw list
+ * Only reads the scene, so disjoint ranges can be recorded on different threads
+ * into different command buffers. The draw list must be sorted (sortSceneDrawList)
+ * and the command buffer starts with nothing bound.
+ *
+ * @param scene - Scene
+ * @param cmdBuffer - Command buffer inside a render pass (or continuing one)
+ * @param first - First draw list entry
+ * @param count - Number of entries, clamped to the list
+ * @param pipelines - Pipelines addressed by SceneObject.pipelineIndex
+ * @param pipelineCount - Number of pipelines
+ * @param pipelineLayout - Layout with the PushConstants range
+ * @param outStats - State changes of the range
+ */
+void recordSceneDrawRange(
+    const Scene* scene,
+    VkCommandBuffer cmdBuffer,
+    uint32_t first,
+    uint32_t count,
+    const VkPipeline* pipelines,
+    uint32_t pipelineCount,
+    VkPipelineLayout pipelineLayout,
+    SceneDrawStats* outStats
+);
+
+/**
+ * Destroy owned mesh buffers and free the scene arrays
+ *
+ * @param device - VkDevice handle
+ * @param scene - Scene to destroy
+ */
+void destroyScene(VkDevice device, Scene* scene);
+
+#endif // SCENE_H
@@ -1,4 +1,6 @@
 #include "swapchain.h"
+#include "../vulkan/vulkan_depth.h"  // findMemoryType
+#include <stdio.h>
 #include <stdlib.h>
 
 static VkPresentModeKHR choosePresentModeWithVsync(const VkPresentModeKHR* modes, uint32_t count, bool vsyncEnabled) {
@@ -75,6 +77,7 @@ VkResult createSwapchain(
     swapchain->images = (VkImage*)malloc(swapchain->imageCount * sizeof(VkImage));
     vkGetSwapchainImagesKHR(device, swapchain->swapchain, &swapchain->imageCount, swapchain->images);
     
+    swapchain->imageMemory = NULL;
     swapchain->imageFormat = surfaceFormat.format;
     swapchain->extent = extent;
     
@@ -114,22 +117,129 @@ VkResult createSwapchain(
     return VK_SUCCESS;
 }
 
+VkResult createOffscreenSwapchain(
+    VkDevice device,
+    VkPhysicalDevice physicalDevice,
+    VkExtent2D extent,
+    VkFormat format,
+    uint32_t imageCount,
+    Swapchain* swapchain
+) {
+    if (!device || !physicalDevice || !swapchain || imageCount == 0) {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    swapchain->swapchain = VK_NULL_HANDLE;
+    swapchain->imageCount = imageCount;
+    swapchain->imageFormat = format;
+    swapchain->extent = extent;
+    swapchain->images = (VkImage*)calloc(imageCount, sizeof(VkImage));
+    swapchain->imageViews = (VkImageView*)calloc(imageCount, sizeof(VkImageView));
+    swapchain->imageMemory = (VkDeviceMemory*)calloc(imageCount, sizeof(VkDeviceMemory));
+    if (!swapchain->images || !swapchain->imageViews || !swapchain->imageMemory) {
+        destroySwapchain(device, swapchain);
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    for (uint32_t i = 0; i < imageCount; i++) {
+        VkImageCreateInfo imageInfo = {0};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.extent.width = extent.width;
+        imageInfo.extent.height = extent.height;
+        imageInfo.extent.depth = 1;
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = format;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        VkResult result = vkCreateImage(device, &imageInfo, NULL, &swapchain->images[i]);
+        if (result != VK_SUCCESS) {
+            printf("Failed to create offscreen color image! Error: %d\n", result);
+            destroySwapchain(device, swapchain);
+            return result;
+        }
+
+        VkMemoryRequirements memRequirements;
+        vkGetImageMemoryRequirements(device, swapchain->images[i], &memRequirements);
+
+        VkMemoryAllocateInfo allocInfo = {0};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = memRequirements.size;
+        allocInfo.memoryTypeIndex = findMemoryType(
+            physicalDevice,
+            memRequirements.memoryTypeBits,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+        );
+
+        result = vkAllocateMemory(device, &allocInfo, NULL, &swapchain->imageMemory[i]);
+        if (result != VK_SUCCESS) {
+            printf("Failed to allocate offscreen color image memory! Error: %d\n", result);
+            destroySwapchain(device, swapchain);
+            return result;
+        }
+        vkBindImageMemory(device, swapchain->images[i], swapchain->imageMemory[i], 0);
+
+        VkImageViewCreateInfo viewCreateInfo = {0};
+        viewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewCreateInfo.image = swapchain->images[i];
+        viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewCreateInfo.format = format;
+        viewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewCreateInfo.subresourceRange.baseMipLevel = 0;
+        viewCreateInfo.subresourceRange.levelCount = 1;
+        viewCreateInfo.subresourceRange.baseArrayLayer = 0;
+        viewCreateInfo.subresourceRange.layerCount = 1;
+
+        result = vkCreateImageView(device, &viewCreateInfo, NULL, &swapchain->imageViews[i]);
+        if (result != VK_SUCCESS) {
+            printf("Failed to create offscreen color image view! Error: %d\n", result);
+            destroySwapchain(device, swapchain);
+            return result;
+        }
+    }
+
+    return VK_SUCCESS;
+}
+
 void destroySwapchain(VkDevice device, Swapchain* swapchain) {
     if (!swapchain) return;
     
     // Destroy image views
     if (swapchain->imageViews) {
         for (uint32_t i = 0; i < swapchain->imageCount; i++) {
-            vkDestroyImageView(device, swapchain->imageViews[i], NULL);
+            if (swapchain->imageViews[i] != VK_NULL_HANDLE) {
+                vkDestroyImageView(device, swapchain->imageViews[i], NULL);
+            }
         }
         free(swapchain->imageViews);
         swapchain->imageViews = NULL;
     }
     
     if (swapchain->images) {
+        // Offscreen images are ours to destroy; swapchain images belong to the swapchain
+        if (swapchain->imageMemory) {
+            for (uint32_t i = 0; i < swapchain->imageCount; i++) {
+                if (swapchain->images[i] != VK_NULL_HANDLE) {
+                    vkDestroyImage(device, swapchain->images[i], NULL);
+                }
+                if (swapchain->imageMemory[i] != VK_NULL_HANDLE) {
+                    vkFreeMemory(device, swapchain->imageMemory[i], NULL);
+                }
+            }
+        }
         free(swapchain->images);
         swapchain->images = NULL;
     }
+
+    if (swapchain->imageMemory) {
+        free(swapchain->imageMemory);
+        swapchain->imageMemory = NULL;
+    }
     
     if (swapchain->swapchain != VK_NULL_HANDLE) {
         vkDestroySwapchainKHR(device, swapchain->swapchain, NULL);
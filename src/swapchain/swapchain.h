@@ -6,9 +6,10 @@
 #include "../vulkan/vulkan_physical_device.h"
 
 typedef struct {
-    VkSwapchainKHR swapchain;
+    VkSwapchainKHR swapchain;       // VK_NULL_HANDLE for offscreen targets
     VkImage* images;
     VkImageView* imageViews;
+    VkDeviceMemory* imageMemory;    // Offscreen targets own their images; NULL for a real swapchain
     uint32_t imageCount;
     VkFormat imageFormat;
     VkExtent2D extent;
@@ -23,6 +24,17 @@ VkResult createSwapchain(
     bool vsyncEnabled
 );
 
+// Create color images that stand in for swapchain images when rendering headless
+// (usable as color attachment and transfer source, device-local)
+VkResult createOffscreenSwapchain(
+    VkDevice device,
+    VkPhysicalDevice physicalDevice,
+    VkExtent2D extent,
+    VkFormat format,
+    uint32_t imageCount,
+    Swapchain* swapchain
+);
+
 void destroySwapchain(VkDevice device, Swapchain* swapchain);
 
 #endif // SWAPCHAIN_H
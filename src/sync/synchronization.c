@@ -1,52 +1,114 @@
 #include "synchronization.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
-VkResult createFrameSync(
-    VkDevice device,
-    FrameSync* outSync
-) {
-    if (!device || !outSync) {
-        printf("Frame sync creation failed: Invalid parameters\n");
-        return VK_ERROR_INITIALIZATION_FAILED;
+static void destroyFrameSlot(VkDevice device, VkCommandPool commandPool, FrameSlot* slot) {
+    if (slot->inFlightFence != VK_NULL_HANDLE) {
+        vkDestroyFence(device, slot->inFlightFence, NULL);
+        slot->inFlightFence = VK_NULL_HANDLE;
     }
+    if (slot->imageAvailableSemaphore != VK_NULL_HANDLE) {
+        vkDestroySemaphore(device, slot->imageAvailableSemaphore, NULL);
+        slot->imageAvailableSemaphore = VK_NULL_HANDLE;
+    }
+    if (slot->commandBuffer != VK_NULL_HANDLE && commandPool != VK_NULL_HANDLE) {
+        vkFreeCommandBuffers(device, commandPool, 1, &slot->commandBuffer);
+        slot->commandBuffer = VK_NULL_HANDLE;
+    }
+}
 
-    memset(outSync, 0, sizeof(FrameSync));
-
-    printf("  Creating frame synchronization objects:\n");
+// Per-image state: the in-flight fence table and the render-finished semaphores
+static void destroyImageSemaphores(VkDevice device, FrameSync* sync) {
+    for (uint32_t i = 0; sync->renderFinishedSemaphores && i < sync->imageCount; i++) {
+        if (sync->renderFinishedSemaphores[i] != VK_NULL_HANDLE) {
+            vkDestroySemaphore(device, sync->renderFinishedSemaphores[i], NULL);
+        }
+    }
+    free(sync->renderFinishedSemaphores);
+    sync->renderFinishedSemaphores = NULL;
+    free(sync->imagesInFlight);
+    sync->imagesInFlight = NULL;
+    sync->imageCount = 0;
+}
 
+static VkResult createFrameSlot(VkDevice device, VkCommandPool commandPool, FrameSlot* slot) {
     // Create semaphores
     VkSemaphoreCreateInfo semaphoreInfo = {0};
     semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-    VkResult result = vkCreateSemaphore(device, &semaphoreInfo, NULL, &outSync->imageAvailableSemaphore);
+    VkResult result = vkCreateSemaphore(device, &semaphoreInfo, NULL, &slot->imageAvailableSemaphore);
     if (result != VK_SUCCESS) {
         printf("    Failed to create imageAvailable semaphore! Error: %d\n", result);
         return result;
     }
-    printf("    Image Available Semaphore: %p\n", (void*)outSync->imageAvailableSemaphore);
 
-    result = vkCreateSemaphore(device, &semaphoreInfo, NULL, &outSync->renderFinishedSemaphore);
-    if (result != VK_SUCCESS) {
-        printf("    Failed to create renderFinished semaphore! Error: %d\n", result);
-        vkDestroySemaphore(device, outSync->imageAvailableSemaphore, NULL);
-        return result;
-    }
-    printf("    Render Finished Semaphore: %p\n", (void*)outSync->renderFinishedSemaphore);
-
-    // Create fence (starts in signaled state so first frame doesn't wait)
+    // Create fence (starts in signaled state so the first use of the slot doesn't wait)
     VkFenceCreateInfo fenceInfo = {0};
     fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
     fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;  // Start signaled
 
-    result = vkCreateFence(device, &fenceInfo, NULL, &outSync->inFlightFence);
+    result = vkCreateFence(device, &fenceInfo, NULL, &slot->inFlightFence);
     if (result != VK_SUCCESS) {
         printf("    Failed to create inFlight fence! Error: %d\n", result);
-        vkDestroySemaphore(device, outSync->renderFinishedSemaphore, NULL);
-        vkDestroySemaphore(device, outSync->imageAvailableSemaphore, NULL);
         return result;
     }
-    printf("    In-Flight Fence: %p (created in signaled state)\n", (void*)outSync->inFlightFence);
+
+    // One primary command buffer per slot, reset and re-recorded every time the slot comes around
+    VkCommandBufferAllocateInfo allocInfo = {0};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = commandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+
+    result = vkAllocateCommandBuffers(device, &allocInfo, &slot->commandBuffer);
+    if (result != VK_SUCCESS) {
+        printf("    Failed to allocate frame command buffer! Error: %d\n", result);
+        return result;
+    }
+
+    return VK_SUCCESS;
+}
+
+VkResult createFrameSync(
+    VkDevice device,
+    VkCommandPool commandPool,
+    uint32_t frameCount,
+    uint32_t swapchainImageCount,
+    FrameSync* outSync
+) {
+    if (!device || !commandPool || !outSync) {
+        printf("Frame sync creation failed: Invalid parameters\n");
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    memset(outSync, 0, sizeof(FrameSync));
+
+    if (frameCount == 0) frameCount = 1;
+    if (frameCount > MAX_FRAMES_IN_FLIGHT) frameCount = MAX_FRAMES_IN_FLIGHT;
+    outSync->frameCount = frameCount;
+
+    printf("  Creating frame synchronization objects (%u frames in flight):\n", frameCount);
+
+    for (uint32_t i = 0; i < frameCount; i++) {
+        VkResult result = createFrameSlot(device, commandPool, &outSync->frames[i]);
+        if (result != VK_SUCCESS) {
+            for (uint32_t j = 0; j <= i; j++) {
+                destroyFrameSlot(device, commandPool, &outSync->frames[j]);
+            }
+            return result;
+        }
+        printf("    Slot[%u]: imageAvailable=%p fence=%p cmd=%p\n", i,
+               (void*)outSync->frames[i].imageAvailableSemaphore,
+               (void*)outSync->frames[i].inFlightFence,
+               (void*)outSync->frames[i].commandBuffer);
+    }
+
+    VkResult result = resetFrameSyncImages(device, outSync, swapchainImageCount);
+    if (result != VK_SUCCESS) {
+        destroyFrameSync(device, commandPool, outSync);
+        return result;
+    }
 
     printf("    Frame sync objects created successfully\n");
     return VK_SUCCESS;
@@ -54,31 +116,62 @@ VkResult createFrameSync(
 
 void destroyFrameSync(
     VkDevice device,
+    VkCommandPool commandPool,
     FrameSync* sync
 ) {
     if (!device || !sync) return;
 
     printf("  Destroying frame synchronization objects:\n");
 
-    if (sync->inFlightFence != VK_NULL_HANDLE) {
-        printf("    Destroying fence: %p\n", (void*)sync->inFlightFence);
-        vkDestroyFence(device, sync->inFlightFence, NULL);
-        sync->inFlightFence = VK_NULL_HANDLE;
+    for (uint32_t i = 0; i < sync->frameCount; i++) {
+        destroyFrameSlot(device, commandPool, &sync->frames[i]);
     }
 
-    if (sync->renderFinishedSemaphore != VK_NULL_HANDLE) {
-        printf("    Destroying renderFinished semaphore: %p\n", (void*)sync->renderFinishedSemaphore);
-        vkDestroySemaphore(device, sync->renderFinishedSemaphore, NULL);
-        sync->renderFinishedSemaphore = VK_NULL_HANDLE;
+    destroyImageSemaphores(device, sync);
+    sync->frameCount = 0;
+    sync->currentFrame = 0;
+
+    printf("    Frame sync cleanup complete\n");
+}
+
+VkResult resetFrameSyncImages(
+    VkDevice device,
+    FrameSync* sync,
+    uint32_t swapchainImageCount
+) {
+    if (!device || !sync) return VK_ERROR_INITIALIZATION_FAILED;
+
+    destroyImageSemaphores(device, sync);
+
+    if (swapchainImageCount == 0) return VK_SUCCESS;
+
+    sync->imagesInFlight = (VkFence*)calloc(swapchainImageCount, sizeof(VkFence));
+    sync->renderFinishedSemaphores = (VkSemaphore*)calloc(swapchainImageCount, sizeof(VkSemaphore));
+    if (!sync->imagesInFlight || !sync->renderFinishedSemaphores) {
+        destroyImageSemaphores(device, sync);
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
     }
+    sync->imageCount = swapchainImageCount;
 
-    if (sync->imageAvailableSemaphore != VK_NULL_HANDLE) {
-        printf("    Destroying imageAvailable semaphore: %p\n", (void*)sync->imageAvailableSemaphore);
-        vkDestroySemaphore(device, sync->imageAvailableSemaphore, NULL);
-        sync->imageAvailableSemaphore = VK_NULL_HANDLE;
+    VkSemaphoreCreateInfo semaphoreInfo = {0};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    for (uint32_t i = 0; i < swapchainImageCount; i++) {
+        VkResult result = vkCreateSemaphore(device, &semaphoreInfo, NULL, &sync->renderFinishedSemaphores[i]);
+        if (result != VK_SUCCESS) {
+            printf("    Failed to create renderFinished semaphore! Error: %d\n", result);
+            destroyImageSemaphores(device, sync);
+            return result;
+        }
     }
+    return VK_SUCCESS;
+}
 
-    printf("    Frame sync cleanup complete\n");
+FrameSlot* getCurrentFrameSlot(FrameSync* sync) {
+    return &sync->frames[sync->currentFrame];
+}
+
+void advanceFrameSlot(FrameSync* sync) {
+    sync->currentFrame = (sync->currentFrame + 1) % sync->frameCount;
 }
 
 VkResult waitForFence(
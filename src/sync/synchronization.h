@@ -3,40 +3,98 @@
 
 #include <vulkan/vulkan.h>
 #include <stdbool.h>
+#include "../common.h"
 
 /**
- * Frame synchronization objects
- * Used to coordinate GPU-GPU and CPU-GPU synchronization for frame rendering
+ * Per-frame slot
+ * Everything the CPU touches while recording a frame, so that frame N+1 can be
+ * recorded while the GPU is still working on frame N
  */
 typedef struct {
     VkSemaphore imageAvailableSemaphore;  // Signals when swapchain image is ready
-    VkSemaphore renderFinishedSemaphore;  // Signals when rendering is complete
-    VkFence inFlightFence;                // Signals when frame has finished rendering (CPU waits)
+    VkFence inFlightFence;                // Signals when this slot's frame has finished rendering (CPU waits)
+    VkCommandBuffer commandBuffer;        // Command buffer recorded for this slot
+} FrameSlot;
+
+/**
+ * Frame synchronization objects
+ * Ring of frameCount slots used to coordinate GPU-GPU and CPU-GPU synchronization
+ */
+typedef struct {
+    FrameSlot frames[MAX_FRAMES_IN_FLIGHT];
+    uint32_t frameCount;       // Number of slots in use (1..MAX_FRAMES_IN_FLIGHT)
+    uint32_t currentFrame;     // Slot that will be recorded next
+
+    VkFence* imagesInFlight;   // Per swapchain image: fence of the slot that last rendered to it
+    // Per swapchain image: signaled when rendering is complete, waited on by its present.
+    // A slot's fence does not show that the present consumed the semaphore, but the image
+    // is only acquired again after that present, so per-image semaphores are safe to reuse.
+    VkSemaphore* renderFinishedSemaphores;
+    uint32_t imageCount;
 } FrameSync;
 
 /**
- * Create synchronization objects for frame rendering
+ * Create synchronization objects and command buffers for every frame slot
  * 
  * @param device - VkDevice handle
+ * @param commandPool - Pool the per-slot command buffers are allocated from
+ * @param frameCount - Number of frames in flight (clamped to MAX_FRAMES_IN_FLIGHT)
+ * @param swapchainImageCount - Number of swapchain images to track
  * @param outSync - Output synchronization objects
  * @return VK_SUCCESS on success, error code otherwise
  */
 VkResult createFrameSync(
     VkDevice device,
+    VkCommandPool commandPool,
+    uint32_t frameCount,
+    uint32_t swapchainImageCount,
     FrameSync* outSync
 );
 
 /**
- * Destroy synchronization objects
+ * Destroy synchronization objects and free the per-slot command buffers
  * 
  * @param device - VkDevice handle
+ * @param commandPool - Pool the per-slot command buffers were allocated from
  * @param sync - Synchronization objects to destroy
  */
 void destroyFrameSync(
     VkDevice device,
+    VkCommandPool commandPool,
     FrameSync* sync
 );
 
+/**
+ * Reset swapchain image tracking and recreate the per-image semaphores after the
+ * swapchain has been recreated
+ * The device must be idle when this is called
+ * 
+ * @param device - VkDevice handle
+ * @param sync - Synchronization objects
+ * @param swapchainImageCount - Image count of the new swapchain
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult resetFrameSyncImages(
+    VkDevice device,
+    FrameSync* sync,
+    uint32_t swapchainImageCount
+);
+
+/**
+ * Get the slot that will be recorded next
+ * 
+ * @param sync - Synchronization objects
+ * @return Pointer to the current frame slot
+ */
+FrameSlot* getCurrentFrameSlot(FrameSync* sync);
+
+/**
+ * Move on to the next slot in the ring (call after presenting)
+ * 
+ * @param sync - Synchronization objects
+ */
+void advanceFrameSlot(FrameSync* sync);
+
 /**
  * Wait for a fence to be signaled
  * 
@@ -5,23 +5,33 @@
 VkResult createUniformBuffer(
     VkDevice device,
     VkPhysicalDevice physicalDevice,
-    Buffer* outBuffer
+    GpuAllocator* allocator,
+    uint32_t sliceCount,
+    BufferRing* outRing
 ) {
-    if (!device || !physicalDevice || !outBuffer) {
+    if (!device || !physicalDevice || sliceCount == 0 || !outRing) {
         printf("Uniform buffer creation failed: Invalid parameters\n");
         return VK_ERROR_INITIALIZATION_FAILED;
     }
 
-    printf("  Creating uniform buffer:\n");
-    printf("    Size: %zu bytes\n", sizeof(UniformBufferObject));
+    // Dynamic offsets must be multiples of the device's UBO alignment
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(physicalDevice, &props);
+    VkDeviceSize alignment = props.limits.minUniformBufferOffsetAlignment;
 
-    BufferCreateInfo createInfo = {0};
-    createInfo.size = sizeof(UniformBufferObject);
-    createInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-    createInfo.properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    printf("  Creating uniform buffer ring:\n");
+    printf("    UBO %zu bytes, offset alignment %llu bytes\n", sizeof(UniformBufferObject), (unsigned long long)alignment);
 
-    VkResult result = createBuffer(device, physicalDevice, &createInfo, outBuffer);
+    VkResult result = createBufferRing(
+        device,
+        physicalDevice,
+        allocator,
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+        alignment,
+        UNIFORM_RING_SLICE_SIZE,
+        sliceCount,
+        outRing
+    );
     if (result != VK_SUCCESS) {
         printf("    Failed to create uniform buffer!\n");
         return result;
@@ -32,20 +42,23 @@ VkResult createUniformBuffer(
 }
 
 VkResult updateUniformBuffer(
-    VkDevice device,
-    Buffer* buffer,
-    const UniformBufferObject* ubo
+    BufferRing* ring,
+    const UniformBufferObject* ubo,
+    uint32_t* outDynamicOffset
 ) {
-    if (!device || !buffer || !ubo) {
+    if (!ring || !ubo || !outDynamicOffset) {
         printf("Uniform buffer update failed: Invalid parameters\n");
         return VK_ERROR_INITIALIZATION_FAILED;
     }
 
-    VkResult result = updateBuffer(device, buffer, ubo, sizeof(UniformBufferObject), 0);
+    RingAllocation allocation;
+    VkResult result = allocateFromBufferRing(ring, sizeof(UniformBufferObject), &allocation);
     if (result != VK_SUCCESS) {
         printf("    Failed to update uniform buffer!\n");
         return result;
     }
 
+    memcpy(allocation.data, ubo, sizeof(UniformBufferObject));
+    *outDynamicOffset = (uint32_t)allocation.offset;
     return VK_SUCCESS;
-}
\ No newline at end of file
+}
@@ -11,6 +11,7 @@
  */
 typedef struct {
     mat4 model;        // Model matrix (64 bytes)
+    mat4 normalMatrix; // transpose(inverse(model)), upper 3x3 used (64 bytes)
     mat4 view;         // View matrix (64 bytes)
     mat4 proj;         // Projection matrix (64 bytes)
     vec3 lightPos;     // Light position in world space (12 bytes + 4 padding = 16 bytes)
@@ -21,32 +22,41 @@ typedef struct {
     float _pad3;       // Padding for std140 alignment
 } UniformBufferObject;
 
+// Bytes of uniform data each frame slot may sub-allocate per frame
+#define UNIFORM_RING_SLICE_SIZE (64 * 1024)
+
 /**
- * Create a uniform buffer for storing MVP matrices
+ * Create the persistently mapped uniform ring
+ * One slice per frame in flight; sub-allocations are aligned to
+ * minUniformBufferOffsetAlignment so they can be bound as dynamic offsets
  *
  * @param device - VkDevice handle
- * @param physicalDevice - VkPhysicalDevice for querying memory properties
- * @param outBuffer - Output buffer handle
+ * @param physicalDevice - VkPhysicalDevice for querying memory properties and limits
+ * @param allocator - Allocator to sub-allocate from (NULL for a dedicated allocation)
+ * @param sliceCount - Number of slices (one per frame in flight)
+ * @param outRing - Output ring buffer
  * @return VK_SUCCESS on success, error code otherwise
  */
 VkResult createUniformBuffer(
     VkDevice device,
     VkPhysicalDevice physicalDevice,
-    Buffer* outBuffer
+    GpuAllocator* allocator,
+    uint32_t sliceCount,
+    BufferRing* outRing
 );
 
 /**
- * Update uniform buffer with new MVP matrices
+ * Write MVP matrices into a fresh sub-allocation of the current ring slice
  *
- * @param device - VkDevice handle
- * @param buffer - Uniform buffer to update
+ * @param ring - Uniform ring, already switched to the current frame slot
  * @param ubo - Uniform buffer object data
+ * @param outDynamicOffset - Offset to pass to vkCmdBindDescriptorSets
  * @return VK_SUCCESS on success, error code otherwise
  */
 VkResult updateUniformBuffer(
-    VkDevice device,
-    Buffer* buffer,
-    const UniformBufferObject* ubo
+    BufferRing* ring,
+    const UniformBufferObject* ubo,
+    uint32_t* outDynamicOffset
 );
 
 #endif // UNIFORM_BUFFER_H
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include "instance_buffer.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+VkResult createInstanceBuffer(
+    VkDevice device,
+    VkPhysicalDevice physicalDevice,
+    GpuAllocator* allocator,
+    uint32_t capacity,
+    uint32_t sliceCount,
+    InstanceBuffer* outBuffer
+) {
+    if (!device || !physicalDevice || capacity == 0 || sliceCount == 0 || !outBuffer) {
+        printf("Instance buffer creation failed: Invalid parameters\n");
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    memset(outBuffer, 0, sizeof(InstanceBuffer));
+    printf("  Creating instance buffer: %u instances x %zu bytes per frame slot\n",
+           capacity, sizeof(InstanceData));
+
+    VkResult result = createBufferRing(
+        device,
+        physicalDevice,
+        allocator,
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+        16,
+        (VkDeviceSize)capacity * sizeof(InstanceData),
+        sliceCount,
+        &outBuffer->ring
+    );
+    if (result != VK_SUCCESS) {
+        printf("    Failed to create instance buffer!\n");
+        return result;
+    }
+
+    outBuffer->capacity = capacity;
+    return VK_SUCCESS;
+}
+
+void setInstanceTransform(InstanceData* instance, mat4 model, uint32_t objectID) {
+    mat4 normal = mat4_normal_matrix(model);
+    memset(instance, 0, sizeof(InstanceData));
+    instance->model = model;
+    for (int column = 0; column < 3; column++) {
+        instance->normalMatrix[column * 4 + 0] = normal.m[column * 4 + 0];
+        instance->normalMatrix[column * 4 + 1] = normal.m[column * 4 + 1];
+        instance->normalMatrix[column * 4 + 2] = normal.m[column * 4 + 2];
+    }
+    instance->objectID = objectID;
+}
+
+void beginInstanceBufferFrame(InstanceBuffer* buffer, uint32_t slot) {
+    beginBufferRingFrame(&buffer->ring, slot);
+}
+
+VkResult writeInstances(
+    InstanceBuffer* buffer,
+    const InstanceData* instances,
+    uint32_t count,
+    VkDeviceSize* outOffset
+) {
+    if (!buffer || (!instances && count > 0) || !outOffset) {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    RingAllocation allocation;
+    VkResult result = allocateFromBufferRing(&buffer->ring, (VkDeviceSize)count * sizeof(InstanceData), &allocation);
+    if (result != VK_SUCCESS) {
+        printf("Instance buffer full: %u instances requested, capacity %u\n", count, buffer->capacity);
+        return result;
+    }
+
+    memcpy(allocation.data, instances, (size_t)count * sizeof(InstanceData));
+    *outOffset = allocation.offset;
+    return VK_SUCCESS;
+}
+
+VkResult writeVisibleInstances(
+    InstanceBuffer* buffer,
+    const InstanceData* instances,
+    const uint8_t* visible,
+    uint32_t count,
+    uint32_t visibleCount,
+    VkDeviceSize* outOffset
+) {
+    if (!buffer || (!instances && count > 0) || !visible || visibleCount > count || !outOffset) {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+    if (visibleCount == 0) {
+        // Everything was culled: nothing to write and nothing will be drawn
+        *outOffset = 0;
+        return VK_SUCCESS;
+    }
+
+    RingAllocation allocation;
+    VkResult result = allocateFromBufferRing(&buffer->ring, (VkDeviceSize)visibleCount * sizeof(InstanceData), &allocation);
+    if (result != VK_SUCCESS) {
+        printf("Instance buffer full: %u instances requested, capacity %u\n", visibleCount, buffer->capacity);
+        return result;
+    }
+
+    // Copy runs of consecutive visible instances with one memcpy each
+    InstanceData* dst = (InstanceData*)allocation.data;
+    uint32_t i = 0;
+    while (i < count) {
+        if (!visible[i]) {
+            i++;
+            continue;
+        }
+        uint32_t runStart = i;
+        while (i < count && visible[i]) i++;
+        memcpy(dst, &instances[runStart], (size_t)(i - runStart) * sizeof(InstanceData));
+        dst += i - runStart;
+    }
+
+    *outOffset = allocation.offset;
+    return VK_SUCCESS;
+}
+
+void getInstanceVertexInput(
+    VertexBindingDescription* outBinding,
+    VertexAttributeDescription* outAttributes
+) {
+    outBinding->binding = INSTANCE_BINDING;
+    outBinding->stride = sizeof(InstanceData);
+    outBinding->inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+    // A mat4 input takes one location per column
+    uint32_t location = INSTANCE_FIRST_LOCATION;
+    uint32_t index = 0;
+    for (uint32_t column = 0; column < 4; column++) {
+        outAttributes[index++] = (VertexAttributeDescription){
+            .location = location++,
+            .binding = INSTANCE_BINDING,
+            .format = VK_FORMAT_R32G32B32A32_SFLOAT,
+            .offset = (uint32_t)(offsetof(InstanceData, model) + column * 4 * sizeof(float))
+        };
+    }
+    for (uint32_t column = 0; column < 3; column++) {
+        outAttributes[index++] = (VertexAttributeDescription){
+            .location = location++,
+            .binding = INSTANCE_BINDING,
+            .format = VK_FORMAT_R32G32B32A32_SFLOAT,
+            .offset = (uint32_t)(offsetof(InstanceData, normalMatrix) + column * 4 * sizeof(float))
+        };
+    }
+    outAttributes[index++] = (VertexAttributeDescription){
+        .location = location++,
+        .binding = INSTANCE_BINDING,
+        .format = VK_FORMAT_R32_UINT,
+        .offset = offsetof(InstanceData, objectID)
+    };
+}
+
+void cmdDrawMeshInstanced(
+    VkCommandBuffer cmdBuffer,
+    const InstanceBuffer* buffer,
+    VkDeviceSize offset,
+    uint32_t indexCount,
+    uint32_t instanceCount
+) {
+    if (instanceCount == 0) return;
+    vkCmdBindVertexBuffers(cmdBuffer, INSTANCE_BINDING, 1, &buffer->ring.buffer.buffer, &offset);
+    vkCmdDrawIndexed(cmdBuffer, indexCount, instanceCount, 0, 0, 0);
+}
+
+void destroyInstanceBuffer(VkDevice device, InstanceBuffer* buffer) {
+    if (!buffer) return;
+    destroyBufferRing(device, &buffer->ring);
+    buffer->capacity = 0;
+}
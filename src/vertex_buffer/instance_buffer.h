@@ -0,0 +1,150 @@
+#ifndef INSTANCE_BUFFER_H
+#define INSTANCE_BUFFER_H
+
+#include <vulkan/vulkan.h>
+#include <stdint.h>
+#include "../graphics_pipeline/buffer.h"
+#include "../graphics_pipeline/graphics_pipeline.h"
+#include "../math/matrix.h"
+
+// Vertex binding the per-instance data is read from (binding 0 holds the mesh vertices)
+#define INSTANCE_BINDING 1
+
+// First shader location of the instance attributes; locations 0-2 are the Vertex attributes
+#define INSTANCE_FIRST_LOCATION 3
+
+// model (4 columns) + normal matrix (3 columns) + object ID
+#define INSTANCE_ATTRIBUTE_COUNT 8
+
+/**
+ * Per-instance data, read at VK_VERTEX_INPUT_RATE_INSTANCE (128 bytes)
+ * Matches the instance inputs in shaders/instanced.vert.
+ */
+typedef struct {
+    mat4 model;               // Locations 3-6, one column each
+    float normalMatrix[12];   // Locations 7-9: columns of transpose(inverse(model)), padded to vec4
+    uint32_t objectID;        // Location 10
+    uint32_t _pad[3];
+} InstanceData;
+
+/**
+ * Persistently mapped per-frame instance data
+ * One ring slice per frame slot, so instances can change every frame without
+ * touching memory the GPU is still reading.
+ */
+typedef struct {
+    BufferRing ring;
+    uint32_t capacity;        // Instances each frame slot can hold
+} InstanceBuffer;
+
+/**
+ * Create the instance ring
+ *
+ * @param device - VkDevice handle
+ * @param physicalDevice - VkPhysicalDevice for querying memory properties
+ * @param allocator - Allocator to sub-allocate from (NULL for a dedicated allocation)
+ * @param capacity - Maximum instances per frame
+ * @param sliceCount - Number of frame slots
+ * @param outBuffer - Output instance buffer
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult createInstanceBuffer(
+    VkDevice device,
+    VkPhysicalDevice physicalDevice,
+    GpuAllocator* allocator,
+    uint32_t capacity,
+    uint32_t sliceCount,
+    InstanceBuffer* outBuffer
+);
+
+/**
+ * Fill an instance from its model matrix (computes the normal matrix)
+ *
+ * @param instance - Instance to fill
+ * @param model - Model matrix
+ * @param objectID - Object identifier passed to the shader
+ */
+void setInstanceTransform(InstanceData* instance, mat4 model, uint32_t objectID);
+
+/**
+ * Switch to a frame slot's slice; call once its previous submission has completed
+ *
+ * @param buffer - Instance buffer
+ * @param slot - Frame slot index
+ */
+void beginInstanceBufferFrame(InstanceBuffer* buffer, uint32_t slot);
+
+/**
+ * Copy instances into the current slice
+ *
+ * @param buffer - Instance buffer
+ * @param instances - Instance data
+ * @param count - Number of instances
+ * @param outOffset - Byte offset to bind the instance binding at
+ * @return VK_SUCCESS on success, VK_ERROR_OUT_OF_DEVICE_MEMORY if the slice is full
+ */
+VkResult writeInstances(
+    InstanceBuffer* buffer,
+    const InstanceData* instances,
+    uint32_t count,
+    VkDeviceSize* outOffset
+);
+
+/**
+ * Copy only the instances flagged visible, packed, into the current slice
+ *
+ * @param buffer - Instance buffer
+ * @param instances - Instance data
+ * @param visible - count flags, non-zero for instances to draw
+ * @param count - Number of instances
+ * @param visibleCount - Number of non-zero flags
+ * @param outOffset - Byte offset to bind the instance binding at
+ * @return VK_SUCCESS on success, VK_ERROR_OUT_OF_DEVICE_MEMORY if the slice is full
+ */
+VkResult writeVisibleInstances(
+    InstanceBuffer* buffer,
+    const InstanceData* instances,
+    const uint8_t* visible,
+    uint32_t count,
+    uint32_t visibleCount,
+    VkDeviceSize* outOffset
+);
+
+/**
+ * Describe the instance binding and its attributes for GraphicsPipelineConfig
+ *
+ * @param outBinding - Binding at INSTANCE_BINDING with VK_VERTEX_INPUT_RATE_INSTANCE
+ * @param outAttributes - INSTANCE_ATTRIBUTE_COUNT attribute descriptions
+ */
+void getInstanceVertexInput(
+    VertexBindingDescription* outBinding,
+    VertexAttributeDescription* outAttributes
+);
+
+/**
+ * Draw instanceCount copies of the bound indexed mesh in one call
+ * The mesh vertex/index buffers and pipeline must already be bound.
+ *
+ * @param cmdBuffer - Command buffer inside a render pass
+ * @param buffer - Instance buffer
+ * @param offset - Offset returned by writeInstances
+ * @param indexCount - Indices per instance
+ * @param instanceCount - Number of instances
+ */
+void cmdDrawMeshInstanced(
+    VkCommandBuffer cmdBuffer,
+    const InstanceBuffer* buffer,
+    VkDeviceSize offset,
+    uint32_t indexCount,
+    uint32_t instanceCount
+);
+
+/**
+ * Destroy the instance ring
+ *
+ * @param device - VkDevice handle
+ * @param buffer - Instance buffer
+ */
+void destroyInstanceBuffer(VkDevice device, InstanceBuffer* buffer);
+
+#endif // INSTANCE_BUFFER_H
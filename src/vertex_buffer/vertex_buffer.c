@@ -1,11 +1,18 @@
 #include "vertex_buffer.h"
 #include "../model_loaders/objloader.h"
 #include <stdio.h>
+#include <stddef.h>
 #include <stdlib.h>
 
+// Baked vertex streams are uploaded as they are, so the layouts must be identical
+_Static_assert(sizeof(Vertex) == sizeof(TMeshVertex), "Vertex must match TMeshVertex");
+_Static_assert(offsetof(Vertex, color) == offsetof(TMeshVertex, color), "Vertex must match TMeshVertex");
+_Static_assert(offsetof(Vertex, normal) == offsetof(TMeshVertex, normal), "Vertex must match TMeshVertex");
+
 VkResult createVertexBuffer(
     VkDevice device,
     VkPhysicalDevice physicalDevice,
+    GpuAllocator* allocator,
     VkDeviceSize size,
     Buffer* outBuffer
 ) {
@@ -19,9 +26,10 @@ VkResult createVertexBuffer(
 
     BufferCreateInfo createInfo = {0};
     createInfo.size = size;
-    createInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
-    createInfo.properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | 
-                            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    // Device-local so vertex fetch never crosses PCIe; filled through an UploadBatch
+    createInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    createInfo.properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    createInfo.allocator = allocator;
 
     VkResult result = createBuffer(device, physicalDevice, &createInfo, outBuffer);
     if (result != VK_SUCCESS) {
@@ -33,119 +41,108 @@ VkResult createVertexBuffer(
     return VK_SUCCESS;
 }
 
+// Cube shared by the vertex and index updaters: 4 vertices per face so each face keeps a flat normal
+static const Vertex cubeVertices[CUBE_VERTEX_COUNT] = {
+    // Front face (z = 0.5) - normal: (0, 0, 1)
+    {{-0.5f, -0.5f,  0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 1.0f}},  // bottom-left
+    {{ 0.5f, -0.5f,  0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 1.0f}},  // bottom-right
+    {{ 0.5f,  0.5f,  0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 1.0f}},  // top-right
+    {{-0.5f,  0.5f,  0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 1.0f}},  // top-left
+
+    // Back face (z = -0.5) - normal: (0, 0, -1)
+    {{-0.5f, -0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, -1.0f}},  // bottom-left
+    {{ 0.5f, -0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, -1.0f}},  // bottom-right
+    {{ 0.5f,  0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, -1.0f}},  // top-right
+    {{-0.5f,  0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, -1.0f}},  // top-left
+
+    // Left face (x = -0.5) - normal: (-1, 0, 0)
+    {{-0.5f, -0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}, {-1.0f, 0.0f, 0.0f}},  // bottom-back
+    {{-0.5f, -0.5f,  0.5f}, {1.0f, 1.0f, 1.0f}, {-1.0f, 0.0f, 0.0f}},  // bottom-front
+    {{-0.5f,  0.5f,  0.5f}, {1.0f, 1.0f, 1.0f}, {-1.0f, 0.0f, 0.0f}},  // top-front
+    {{-0.5f,  0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}, {-1.0f, 0.0f, 0.0f}},  // top-back
+
+    // Right face (x = 0.5) - normal: (1, 0, 0)
+    {{ 0.5f, -0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}, {1.0f, 0.0f, 0.0f}},  // bottom-back
+    {{ 0.5f, -0.5f,  0.5f}, {1.0f, 1.0f, 1.0f}, {1.0f, 0.0f, 0.0f}},  // bottom-front
+    {{ 0.5f,  0.5f,  0.5f}, {1.0f, 1.0f, 1.0f}, {1.0f, 0.0f, 0.0f}},  // top-front
+    {{ 0.5f,  0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}, {1.0f, 0.0f, 0.0f}},  // top-back
+
+    // Top face (y = 0.5) - normal: (0, 1, 0)
+    {{-0.5f,  0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f, 0.0f}},  // back-left
+    {{ 0.5f,  0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f, 0.0f}},  // back-right
+    {{ 0.5f,  0.5f,  0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f, 0.0f}},  // front-right
+    {{-0.5f,  0.5f,  0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f, 0.0f}},  // front-left
+
+    // Bottom face (y = -0.5) - normal: (0, -1, 0)
+    {{-0.5f, -0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, -1.0f, 0.0f}},  // back-left
+    {{ 0.5f, -0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, -1.0f, 0.0f}},  // back-right
+    {{ 0.5f, -0.5f,  0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, -1.0f, 0.0f}},  // front-right
+    {{-0.5f, -0.5f,  0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, -1.0f, 0.0f}}   // front-left
+};
+
+// Two triangles per face, same winding as the original non-indexed cube (0-1-2, 2-3-0)
+static const uint16_t cubeIndices[CUBE_INDEX_COUNT] = {
+     0,  1,  2,   2,  3,  0,
+     4,  5,  6,   6,  7,  4,
+     8,  9, 10,  10, 11,  8,
+    12, 13, 14,  14, 15, 12,
+    16, 17, 18,  18, 19, 16,
+    20, 21, 22,  22, 23, 20
+};
+
 VkResult updateVertexBufferWithCube(
-    VkDevice device,
+    UploadBatch* batch,
     Buffer* buffer
 ) {
-    if (!device || !buffer) {
+    if (!batch || !buffer) {
         printf("Vertex buffer update failed: Invalid parameters\n");
         return VK_ERROR_INITIALIZATION_FAILED;
     }
 
-    // Define cube vertices with 3D positions, colors, and normals
-    // Cube has 8 corners, but we duplicate vertices for each face triangle
-    Vertex vertices[36] = {
-        // Front face (z = 0.5) - normal: (0, 0, 1)
-        {vec3_create(-0.5f, -0.5f,  0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(0.0f, 0.0f, 1.0f)},  // bottom-left
-        {vec3_create( 0.5f, -0.5f,  0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(0.0f, 0.0f, 1.0f)},  // bottom-right
-        {vec3_create( 0.5f,  0.5f,  0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(0.0f, 0.0f, 1.0f)},  // top-right
-        {vec3_create( 0.5f,  0.5f,  0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(0.0f, 0.0f, 1.0f)},  // top-right
-        {vec3_create(-0.5f,  0.5f,  0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(0.0f, 0.0f, 1.0f)},  // top-left
-        {vec3_create(-0.5f, -0.5f,  0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(0.0f, 0.0f, 1.0f)},  // bottom-left
-
-        // Back face (z = -0.5) - normal: (0, 0, -1)
-        {vec3_create(-0.5f, -0.5f, -0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(0.0f, 0.0f, -1.0f)},  // bottom-left
-        {vec3_create( 0.5f, -0.5f, -0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(0.0f, 0.0f, -1.0f)},  // bottom-right
-        {vec3_create( 0.5f,  0.5f, -0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(0.0f, 0.0f, -1.0f)},  // top-right
-        {vec3_create( 0.5f,  0.5f, -0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(0.0f, 0.0f, -1.0f)},  // top-right
-        {vec3_create(-0.5f,  0.5f, -0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(0.0f, 0.0f, -1.0f)},  // top-left
-        {vec3_create(-0.5f, -0.5f, -0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(0.0f, 0.0f, -1.0f)},  // bottom-left
-
-        // Left face (x = -0.5) - normal: (-1, 0, 0)
-        {vec3_create(-0.5f, -0.5f, -0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(-1.0f, 0.0f, 0.0f)},  // bottom-back
-        {vec3_create(-0.5f, -0.5f,  0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(-1.0f, 0.0f, 0.0f)},  // bottom-front
-        {vec3_create(-0.5f,  0.5f,  0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(-1.0f, 0.0f, 0.0f)},  // top-front
-        {vec3_create(-0.5f,  0.5f,  0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(-1.0f, 0.0f, 0.0f)},  // top-front
-        {vec3_create(-0.5f,  0.5f, -0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(-1.0f, 0.0f, 0.0f)},  // top-back
-        {vec3_create(-0.5f, -0.5f, -0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(-1.0f, 0.0f, 0.0f)},  // bottom-back
-
-        // Right face (x = 0.5) - normal: (1, 0, 0)
-        {vec3_create( 0.5f, -0.5f, -0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(1.0f, 0.0f, 0.0f)},  // bottom-back
-        {vec3_create( 0.5f, -0.5f,  0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(1.0f, 0.0f, 0.0f)},  // bottom-front
-        {vec3_create( 0.5f,  0.5f,  0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(1.0f, 0.0f, 0.0f)},  // top-front
-        {vec3_create( 0.5f,  0.5f,  0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(1.0f, 0.0f, 0.0f)},  // top-front
-        {vec3_create( 0.5f,  0.5f, -0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(1.0f, 0.0f, 0.0f)},  // top-back
-        {vec3_create( 0.5f, -0.5f, -0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(1.0f, 0.0f, 0.0f)},  // bottom-back
-
-        // Top face (y = 0.5) - normal: (0, 1, 0)
-        {vec3_create(-0.5f,  0.5f, -0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(0.0f, 1.0f, 0.0f)},  // back-left
-        {vec3_create( 0.5f,  0.5f, -0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(0.0f, 1.0f, 0.0f)},  // back-right
-        {vec3_create( 0.5f,  0.5f,  0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(0.0f, 1.0f, 0.0f)},  // front-right
-        {vec3_create( 0.5f,  0.5f,  0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(0.0f, 1.0f, 0.0f)},  // front-right
-        {vec3_create(-0.5f,  0.5f,  0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(0.0f, 1.0f, 0.0f)},  // front-left
-        {vec3_create(-0.5f,  0.5f, -0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(0.0f, 1.0f, 0.0f)},  // back-left
-
-        // Bottom face (y = -0.5) - normal: (0, -1, 0)
-        {vec3_create(-0.5f, -0.5f, -0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(0.0f, -1.0f, 0.0f)},  // back-left
-        {vec3_create( 0.5f, -0.5f, -0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(0.0f, -1.0f, 0.0f)},  // back-right
-        {vec3_create( 0.5f, -0.5f,  0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(0.0f, -1.0f, 0.0f)},  // front-right
-        {vec3_create( 0.5f, -0.5f,  0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(0.0f, -1.0f, 0.0f)},  // front-right
-        {vec3_create(-0.5f, -0.5f,  0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(0.0f, -1.0f, 0.0f)},  // front-left
-        {vec3_create(-0.5f, -0.5f, -0.5f), vec3_create(1.0f, 1.0f, 1.0f), vec3_create(0.0f, -1.0f, 0.0f)}   // back-left
-    };
-
     printf("  Updating vertex buffer with cube data:\n");
-    printf("    36 vertices, %zu bytes each\n", sizeof(Vertex));
-    printf("    Total size: %zu bytes\n", sizeof(vertices));
+    printf("    %d vertices, %zu bytes each\n", CUBE_VERTEX_COUNT, sizeof(Vertex));
+    printf("    Total size: %zu bytes\n", sizeof(cubeVertices));
 
-    VkResult result = updateBuffer(device, buffer, vertices, sizeof(vertices), 0);
+    VkResult result = stageBufferUpload(batch, buffer, cubeVertices, sizeof(cubeVertices), 0);
     if (result != VK_SUCCESS) {
         printf("    Failed to update vertex buffer!\n");
         return result;
     }
 
-    printf("    Vertex buffer updated with cube data\n");
+    printf("    Vertex buffer upload staged with cube data\n");
     return VK_SUCCESS;
 }
 
 VkResult updateVertexBufferWithMesh(
-    VkDevice device,
+    UploadBatch* batch,
     Buffer* buffer,
     Mesh* mesh,
     uint32_t* vertexCount
 ) {
-    if (!device || !buffer || !mesh || !vertexCount) {
+    if (!batch || !buffer || !mesh || !vertexCount) {
         printf("Vertex buffer update failed: Invalid parameters\n");
         return VK_ERROR_INITIALIZATION_FAILED;
     }
 
-    // For now, assume mesh has positions and normals, and we use indices to create vertices
-    // Since we don't have index buffer, we duplicate vertices
-    *vertexCount = mesh->num_indices;
+    // The loader already deduplicated corners, so there is one Vertex per unique attribute tuple
+    *vertexCount = (uint32_t)mesh->num_vertices;
 
-    Vertex* vertices = (Vertex*)malloc(sizeof(Vertex) * mesh->num_indices);
+    Vertex* vertices = (Vertex*)malloc(sizeof(Vertex) * mesh->num_vertices);
     if (!vertices) {
         printf("Failed to allocate memory for vertices\n");
         return VK_ERROR_OUT_OF_HOST_MEMORY;
     }
 
-    for (size_t i = 0; i < mesh->num_indices; ++i) {
-        unsigned int idx = mesh->indices[i];
-        if (idx >= mesh->num_vertices) {
-            printf("Invalid index %u >= %zu\n", idx, mesh->num_vertices);
-            free(vertices);
-            return VK_ERROR_INITIALIZATION_FAILED;
-        }
-
+    for (size_t i = 0; i < mesh->num_vertices; ++i) {
         vec3 pos = vec3_create(
-            mesh->vertices[idx * 3 + 0],
-            mesh->vertices[idx * 3 + 1],
-            mesh->vertices[idx * 3 + 2]
+            mesh->vertices[i * 3 + 0],
+            mesh->vertices[i * 3 + 1],
+            mesh->vertices[i * 3 + 2]
         );
         vec3 normal = vec3_create(
-            mesh->normals[idx * 3 + 0],
-            mesh->normals[idx * 3 + 1],
-            mesh->normals[idx * 3 + 2]
+            mesh->normals[i * 3 + 0],
+            mesh->normals[i * 3 + 1],
+            mesh->normals[i * 3 + 2]
         );
         vec3 color = vec3_create(1.0f, 1.0f, 1.0f); // White color
 
@@ -156,13 +153,157 @@ VkResult updateVertexBufferWithMesh(
     printf("    %u vertices, %zu bytes each\n", *vertexCount, sizeof(Vertex));
     printf("    Total size: %zu bytes\n", sizeof(Vertex) * (*vertexCount));
 
-    VkResult result = updateBuffer(device, buffer, vertices, sizeof(Vertex) * (*vertexCount), 0);
+    VkResult result = stageBufferUpload(batch, buffer, vertices, sizeof(Vertex) * (*vertexCount), 0);
     free(vertices);
     if (result != VK_SUCCESS) {
         printf("    Failed to update vertex buffer!\n");
         return result;
     }
 
-    printf("    Vertex buffer updated with mesh data\n");
+    printf("    Vertex buffer upload staged with mesh data\n");
+    return VK_SUCCESS;
+}
+
+VkResult updateVertexBufferWithBakedMesh(
+    UploadBatch* batch,
+    Buffer* buffer,
+    const BakedMesh* mesh,
+    uint32_t* vertexCount
+) {
+    if (!batch || !buffer || !mesh || !mesh->header || !vertexCount) {
+        printf("Vertex buffer update failed: Invalid parameters\n");
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    *vertexCount = (uint32_t)mesh->header->vertex_count;
+    printf("  Updating vertex buffer from baked mesh: %u vertices\n", *vertexCount);
+
+    VkResult result = stageBufferUpload(batch, buffer, mesh->vertices, sizeof(Vertex) * (*vertexCount), 0);
+    if (result != VK_SUCCESS) {
+        printf("    Failed to update vertex buffer!\n");
+        return result;
+    }
+    return VK_SUCCESS;
+}
+
+VkIndexType chooseIndexType(uint32_t vertexCount) {
+    // 16-bit indices halve index bandwidth whenever every vertex is addressable
+    return vertexCount <= 65536 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+}
+
+VkDeviceSize indexTypeSize(VkIndexType indexType) {
+    return indexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+VkResult createIndexBuffer(
+    VkDevice device,
+    VkPhysicalDevice physicalDevice,
+    GpuAllocator* allocator,
+    uint32_t indexCount,
+    VkIndexType indexType,
+    Buffer* outBuffer
+) {
+    if (!device || !physicalDevice || indexCount == 0 || !outBuffer) {
+        printf("Index buffer creation failed: Invalid parameters\n");
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    VkDeviceSize size = indexTypeSize(indexType) * indexCount;
+    printf("  Creating index buffer:\n");
+    printf("    %u indices, %s\n", indexCount, indexType == VK_INDEX_TYPE_UINT16 ? "16-bit" : "32-bit");
+    printf("    Size: %llu bytes\n", (unsigned long long)size);
+
+    BufferCreateInfo createInfo = {0};
+    createInfo.size = size;
+    createInfo.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    createInfo.properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    createInfo.allocator = allocator;
+
+    VkResult result = createBuffer(device, physicalDevice, &createInfo, outBuffer);
+    if (result != VK_SUCCESS) {
+        printf("    Failed to create index buffer!\n");
+        return result;
+    }
+
+    printf("    Index buffer created successfully\n");
+    return VK_SUCCESS;
+}
+
+VkResult updateIndexBufferWithCube(
+    UploadBatch* batch,
+    Buffer* buffer
+) {
+    if (!batch || !buffer) {
+        printf("Index buffer update failed: Invalid parameters\n");
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    VkResult result = stageBufferUpload(batch, buffer, cubeIndices, sizeof(cubeIndices), 0);
+    if (result != VK_SUCCESS) {
+        printf("    Failed to update index buffer!\n");
+        return result;
+    }
+
+    printf("    Index buffer upload staged with cube data (%d indices)\n", CUBE_INDEX_COUNT);
     return VK_SUCCESS;
-}
\ No newline at end of file
+}
+
+VkResult updateIndexBufferWithMesh(
+    UploadBatch* batch,
+    Buffer* buffer,
+    Mesh* mesh,
+    VkIndexType indexType
+) {
+    if (!batch || !buffer || !mesh || mesh->num_indices == 0) {
+        printf("Index buffer update failed: Invalid parameters\n");
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    VkResult result;
+    if (indexType == VK_INDEX_TYPE_UINT16) {
+        uint16_t* indices16 = (uint16_t*)malloc(sizeof(uint16_t) * mesh->num_indices);
+        if (!indices16) {
+            printf("Failed to allocate memory for 16-bit indices\n");
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
+        for (size_t i = 0; i < mesh->num_indices; ++i) {
+            indices16[i] = (uint16_t)mesh->indices[i];
+        }
+        result = stageBufferUpload(batch, buffer, indices16, sizeof(uint16_t) * mesh->num_indices, 0);
+        free(indices16);
+    } else {
+        result = stageBufferUpload(batch, buffer, mesh->indices, sizeof(uint32_t) * mesh->num_indices, 0);
+    }
+
+    if (result != VK_SUCCESS) {
+        printf("    Failed to update index buffer!\n");
+        return result;
+    }
+
+    printf("    Index buffer upload staged with mesh data (%zu indices)\n", mesh->num_indices);
+    return VK_SUCCESS;
+}
+
+VkResult updateIndexBufferWithBakedMesh(
+    UploadBatch* batch,
+    Buffer* buffer,
+    const BakedMesh* mesh,
+    VkIndexType indexType
+) {
+    if (!batch || !buffer || !mesh || !mesh->header ||
+        (VkDeviceSize)mesh->header->index_size != indexTypeSize(indexType)) {
+        printf("Index buffer update failed: Invalid parameters\n");
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    VkResult result = stageBufferUpload(batch, buffer, mesh->indices,
+                                        (VkDeviceSize)mesh->header->index_size * mesh->header->index_count, 0);
+    if (result != VK_SUCCESS) {
+        printf("    Failed to update index buffer!\n");
+        return result;
+    }
+
+    printf("    Index buffer upload staged from baked mesh (%llu indices)\n",
+           (unsigned long long)mesh->header->index_count);
+    return VK_SUCCESS;
+}
@@ -5,6 +5,7 @@
 #include "../graphics_pipeline/buffer.h"
 #include "../math/vector.h"
 #include "../model_loaders/objloader.h"
+#include "../model_loaders/mesh_cache.h"
 
 /**
  * Vertex structure for 3D rendering
@@ -18,11 +19,17 @@ typedef struct {
     vec3 normal;    // vec3 normal
 } Vertex;
 
+// Default cube when no OBJ is given: 4 vertices per face, 2 triangles per face
+#define CUBE_VERTEX_COUNT 24
+#define CUBE_INDEX_COUNT 36
+
 /**
- * Create a vertex buffer for storing vertex data
+ * Create a device-local vertex buffer for storing vertex data
+ * Contents must be uploaded through an UploadBatch.
  * 
  * @param device - VkDevice handle
  * @param physicalDevice - VkPhysicalDevice for querying memory properties
+ * @param allocator - Allocator to sub-allocate from (NULL for a dedicated allocation)
  * @param size - Size of the buffer in bytes
  * @param outBuffer - Output buffer handle
  * @return VK_SUCCESS on success, error code otherwise
@@ -30,37 +37,136 @@ typedef struct {
 VkResult createVertexBuffer(
     VkDevice device,
     VkPhysicalDevice physicalDevice,
+    GpuAllocator* allocator,
     VkDeviceSize size,
     Buffer* outBuffer
 );
 
 /**
- * Update vertex buffer with cube vertex data
+ * Stage cube vertex data for upload into the vertex buffer
  * Creates a colored cube with 6 faces
  * 
- * @param device - VkDevice handle
+ * @param batch - Recording upload batch
  * @param buffer - Vertex buffer to update
  * @return VK_SUCCESS on success, error code otherwise
  */
 VkResult updateVertexBufferWithCube(
-    VkDevice device,
+    UploadBatch* batch,
     Buffer* buffer
 );
 
 /**
- * Update vertex buffer with mesh vertex data
+ * Stage mesh vertex data for upload into the vertex buffer
  * 
- * @param device - VkDevice handle
+ * @param batch - Recording upload batch
  * @param buffer - Vertex buffer to update
  * @param mesh - Mesh data to load
  * @param vertexCount - Output vertex count
  * @return VK_SUCCESS on success, error code otherwise
  */
 VkResult updateVertexBufferWithMesh(
-    VkDevice device,
+    UploadBatch* batch,
     Buffer* buffer,
     Mesh* mesh,
     uint32_t* vertexCount
 );
 
+/**
+ * Stage a baked mesh's vertex stream for upload, copied straight from the mapping
+ * The stream is already in the Vertex layout, so nothing is converted or allocated.
+ *
+ * @param batch - Recording upload batch
+ * @param buffer - Vertex buffer to update
+ * @param mesh - Loaded baked mesh
+ * @param vertexCount - Output vertex count
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult updateVertexBufferWithBakedMesh(
+    UploadBatch* batch,
+    Buffer* buffer,
+    const BakedMesh* mesh,
+    uint32_t* vertexCount
+);
+
+/**
+ * Pick the narrowest index type able to address every vertex
+ *
+ * @param vertexCount - Number of vertices the indices refer to
+ * @return VK_INDEX_TYPE_UINT16 when possible, VK_INDEX_TYPE_UINT32 otherwise
+ */
+VkIndexType chooseIndexType(uint32_t vertexCount);
+
+/**
+ * Size in bytes of a single index of the given type
+ *
+ * @param indexType - VK_INDEX_TYPE_UINT16 or VK_INDEX_TYPE_UINT32
+ * @return Index size in bytes
+ */
+VkDeviceSize indexTypeSize(VkIndexType indexType);
+
+/**
+ * Create a device-local index buffer
+ * Contents must be uploaded through an UploadBatch.
+ *
+ * @param device - VkDevice handle
+ * @param physicalDevice - VkPhysicalDevice for querying memory properties
+ * @param allocator - Allocator to sub-allocate from (NULL for a dedicated allocation)
+ * @param indexCount - Number of indices the buffer holds
+ * @param indexType - Index width
+ * @param outBuffer - Output buffer handle
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult createIndexBuffer(
+    VkDevice device,
+    VkPhysicalDevice physicalDevice,
+    GpuAllocator* allocator,
+    uint32_t indexCount,
+    VkIndexType indexType,
+    Buffer* outBuffer
+);
+
+/**
+ * Stage the default cube's 16-bit indices for upload
+ *
+ * @param batch - Recording upload batch
+ * @param buffer - Index buffer created for CUBE_INDEX_COUNT 16-bit indices
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult updateIndexBufferWithCube(
+    UploadBatch* batch,
+    Buffer* buffer
+);
+
+/**
+ * Stage mesh indices for upload, narrowing to 16 bits when requested
+ *
+ * @param batch - Recording upload batch
+ * @param buffer - Index buffer to update
+ * @param mesh - Mesh whose indices are uploaded
+ * @param indexType - Index width the buffer was created with
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult updateIndexBufferWithMesh(
+    UploadBatch* batch,
+    Buffer* buffer,
+    Mesh* mesh,
+    VkIndexType indexType
+);
+
+/**
+ * Stage a baked mesh's index stream for upload, copied straight from the mapping
+ *
+ * @param batch - Recording upload batch
+ * @param buffer - Index buffer to update
+ * @param mesh - Loaded baked mesh
+ * @param indexType - Index width the buffer was created with, must match the baked width
+ * @return VK_SUCCESS on success, error code otherwise
+ */
+VkResult updateIndexBufferWithBakedMesh(
+    UploadBatch* batch,
+    Buffer* buffer,
+    const BakedMesh* mesh,
+    VkIndexType indexType
+);
+
 #endif // VERTEX_BUFFER_H
\ No newline at end of file
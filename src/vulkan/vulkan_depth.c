@@ -25,6 +25,7 @@ VkResult createDepthResources(
     VkDevice device,
     VkExtent2D extent,
     VkFormat depthFormat,
+    VkImageUsageFlags extraUsage,
     VkImage* depthImage,
     VkDeviceMemory* depthImageMemory,
     VkImageView* depthImageView
@@ -43,7 +44,7 @@ VkResult createDepthResources(
     imageInfo.format = depthFormat;
     imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
     imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | extraUsage;
     imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
     imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
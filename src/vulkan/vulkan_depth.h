@@ -11,11 +11,13 @@ uint32_t findMemoryType(
 );
 
 // Create a depth image, allocate memory, bind it, and create an image view
+// extraUsage is added to the attachment usage (e.g. SAMPLED to read the depth afterwards)
 VkResult createDepthResources(
     VkPhysicalDevice physicalDevice,
     VkDevice device,
     VkExtent2D extent,
     VkFormat depthFormat,
+    VkImageUsageFlags extraUsage,
     VkImage* depthImage,
     VkDeviceMemory* depthImageMemory,
     VkImageView* depthImageView
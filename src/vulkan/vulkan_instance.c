@@ -70,8 +70,9 @@ int initializeVulkanInstance(SDL_Window* window, VkInstance* vulkanInstance) {
     createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
     createInfo.pApplicationInfo = &appInfo;
     
-    unsigned int extensionCount;
-    if (!SDL_Vulkan_GetInstanceExtensions(window, &extensionCount, NULL)) {
+    // Headless instances render offscreen and need no surface extensions
+    unsigned int extensionCount = 0;
+    if (window && !SDL_Vulkan_GetInstanceExtensions(window, &extensionCount, NULL)) {
         printf("Failed to get SDL Vulkan instance extensions!\n");
         return -1;
     }
@@ -90,7 +91,7 @@ int initializeVulkanInstance(SDL_Window* window, VkInstance* vulkanInstance) {
     
     #ifdef PLATFORM_MACOS
         const char** extensions = malloc((extensionCount + 2) * sizeof(const char*)); // +2 for portability and debug utils
-        if (!SDL_Vulkan_GetInstanceExtensions(window, &extensionCount, extensions)) {
+        if (window && !SDL_Vulkan_GetInstanceExtensions(window, &extensionCount, extensions)) {
             free(extensions);
             return -1;
         }
@@ -101,7 +102,7 @@ int initializeVulkanInstance(SDL_Window* window, VkInstance* vulkanInstance) {
         createInfo.flags = VK_INSTANCE_CREATE_ENUMERATE_PORTABILITY_BIT_KHR;
     #else
         const char** extensions = malloc((extensionCount + 1) * sizeof(const char*)); // +1 for debug utils
-        if (!SDL_Vulkan_GetInstanceExtensions(window, &extensionCount, extensions)) {
+        if (window && !SDL_Vulkan_GetInstanceExtensions(window, &extensionCount, extensions)) {
             free(extensions);
             return -1;
         }
@@ -7,7 +7,7 @@
 
 /**
  * Initialize Vulkan instance with proper extensions for the given SDL window
- * @param window - SDL window that will be used for rendering
+ * @param window - SDL window that will be used for rendering (NULL for headless: no surface extensions)
  * @param vulkanInstance - Pointer to VkInstance to be created
  * @return 0 on success, -1 on failure
  */
@@ -35,10 +35,17 @@ VkResult createLogicalDevice(
     VkPhysicalDeviceFeatures deviceFeatures = {0};
     // Add required features here as we need them
 
-    // Required extensions
+    // GPU-driven culling issues every indirect draw in one call and offsets each into the compacted instances
+    VkPhysicalDeviceFeatures supportedFeatures;
+    vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+    deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+    deviceFeatures.drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance;
+
+    // Required extensions (headless devices present nothing and may lack WSI support)
     const char* deviceExtensions[] = {
         VK_KHR_SWAPCHAIN_EXTENSION_NAME
     };
+    uint32_t deviceExtensionCount = indices.hasPresent ? 1 : 0;
 
     // Create the logical device
     VkDeviceCreateInfo createInfo = {
@@ -46,7 +53,7 @@ VkResult createLogicalDevice(
         .queueCreateInfoCount = queueCreateInfoCount,
         .pQueueCreateInfos = queueCreateInfos,
         .pEnabledFeatures = &deviceFeatures,
-        .enabledExtensionCount = 1,
+        .enabledExtensionCount = deviceExtensionCount,
         .ppEnabledExtensionNames = deviceExtensions,
     };
 
@@ -56,6 +63,8 @@ VkResult createLogicalDevice(
         return result;
     }
 
+    logicalDevice->enabledFeatures = deviceFeatures;
+
     // Get queue handles
     vkGetDeviceQueue(logicalDevice->device, indices.graphicsFamily, 0, &logicalDevice->graphicsQueue);
     vkGetDeviceQueue(logicalDevice->device, indices.presentFamily, 0, &logicalDevice->presentQueue);
@@ -8,6 +8,7 @@ typedef struct {
     VkDevice device;
     VkQueue graphicsQueue;
     VkQueue presentQueue;
+    VkPhysicalDeviceFeatures enabledFeatures;  // Optional features turned on when the device has them
 } VulkanLogicalDevice;
 
 VkResult createLogicalDevice(
@@ -17,6 +17,11 @@ QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surfa
         if (queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
             indices.graphicsFamily = i;
             indices.hasGraphics = true;
+            indices.graphicsHasCompute = (queueFamilies[i].queueFlags & VK_QUEUE_COMPUTE_BIT) != 0;
+        }
+
+        if (surface == VK_NULL_HANDLE) {
+            continue;
         }
 
         VkBool32 presentSupport = false;
@@ -27,6 +32,11 @@ QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surfa
         }
     }
 
+    // Without a surface nothing is presented; alias the graphics queue so a single queue is created
+    if (surface == VK_NULL_HANDLE) {
+        indices.presentFamily = indices.graphicsFamily;
+    }
+
     free(queueFamilies);
     return indices;
 }
@@ -44,12 +54,13 @@ VkPhysicalDevice pickPhysicalDevice(VkInstance instance, VkSurfaceKHR surface) {
     vkEnumeratePhysicalDevices(instance, &deviceCount, devices);
     
     // ideally we try to find a device with queue family that supports both
+    bool headless = surface == VK_NULL_HANDLE;
     VkPhysicalDevice selectedDevice = VK_NULL_HANDLE;
     for (uint32_t i = 0; i < deviceCount; i++) {
         QueueFamilyIndices indices = findQueueFamilies(devices[i], surface);
 
         // checking for queue family
-        if (indices.hasGraphics && indices.hasPresent && 
+        if (indices.hasGraphics && (headless || indices.hasPresent) && 
             indices.graphicsFamily == indices.presentFamily) {
             selectedDevice = devices[i];
             break;
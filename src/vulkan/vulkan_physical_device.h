@@ -10,8 +10,10 @@ typedef struct {
     uint32_t presentFamily;
     bool hasGraphics;
     bool hasPresent;
+    bool graphicsHasCompute;  // The graphics queue can also run compute dispatches
 } QueueFamilyIndices;
 
+// surface may be VK_NULL_HANDLE (headless): only a graphics queue is required then
 QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surface);
 VkPhysicalDevice pickPhysicalDevice(VkInstance instance, VkSurfaceKHR surface);
 void enumeratePhysicalDevices(VkInstance instance, VkSurfaceKHR surface);